@@ -0,0 +1,427 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFBatchRunner.h"
+
+#include <algorithm>
+
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonObject>
+
+#include "SIMPLib/Filtering/FilterManager.h"
+
+#include "IMFViewer/IMFFilterFactory.h"
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFPipelineScheduler.h"
+#include "IMFViewer/IMFRegistrationCache.h"
+#include "IMFViewer/IMFStreamingStitcher.h"
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+#include "IMFViewer/IMFSessionLoader.h"
+#endif
+
+namespace
+{
+const char* k_DisplayTypeProperty = "DisplayType";
+const char* k_OutputFileProperty = "OutputFile";
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool isDream3dFile(const QString& filePath)
+{
+  return QFileInfo(filePath).suffix().compare("dream3d", Qt::CaseInsensitive) == 0;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFBatchRunner::IMFBatchRunner(QObject* parent)
+: QObject(parent)
+, m_Scheduler(new IMFPipelineScheduler(this))
+, m_Builder(new IMFMontagePipelineBuilder(this))
+, m_RegistrationCache(new IMFRegistrationCache(IMFRegistrationCache::DefaultCacheDirectory(), this))
+{
+  m_Builder->setRegistrationCache(m_RegistrationCache);
+
+  connect(m_Scheduler, &IMFPipelineScheduler::pipelineFinished, this, &IMFBatchRunner::handlePipelineFinished);
+  connect(m_Scheduler, &IMFPipelineScheduler::notifyStatusMessage, this, [=](const QString& msg) { qInfo().noquote() << msg; });
+  connect(m_Scheduler, &IMFPipelineScheduler::notifyErrorMessage, this,
+          [=](const QString& title, const QString& msg, int code) { qCritical().noquote() << title << ":" << msg << "(" << code << ")"; });
+  connect(m_Builder, &IMFMontagePipelineBuilder::notifyErrorMessage, this,
+          [=](const QString& title, const QString& msg, int code) { qCritical().noquote() << title << ":" << msg << "(" << code << ")"; });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFBatchRunner::~IMFBatchRunner()
+{
+  m_Scheduler->cancelAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBatchRunner::setJobCount(int count)
+{
+  m_Scheduler->setMaxWorkerCount(count);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBatchRunner::setRegistrationCacheEnabled(bool enabled)
+{
+  m_RegistrationCache->setEnabled(enabled);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBatchRunner::setStreamingEnabled(bool enabled)
+{
+  m_StreamingEnabled = enabled;
+}
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBatchRunner::setRenderOptions(const IMFOffscreenRenderer::Options& options)
+{
+  m_RenderImages = true;
+  m_RenderOptions = options;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFBatchRunner::getPendingCount() const
+{
+  return m_PendingCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFBatchRunner::getFailureCount() const
+{
+  return m_FailureCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFBatchRunner::addMontage(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& outputFilePath)
+{
+  bool writeImage = !isDream3dFile(outputFilePath);
+  bool renderImage = writeImage && m_RenderImages;
+  if(writeImage && !renderImage && settings.Display != IMFMontagePipelineBuilder::DisplayType::Montage)
+  {
+    qCritical().noquote() << tr("Montage '%1': only stitched montages can be written as an image.  Use a .dream3d output file instead.").arg(settings.MontageName);
+    m_FailureCount++;
+    return false;
+  }
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  if(renderImage && !IMFOffscreenRenderer::IsSupportedImageFile(outputFilePath))
+  {
+    qCritical().noquote() << tr("Montage '%1': rendered images must be PNG, TIFF, JPEG or BMP files.").arg(settings.MontageName);
+    m_FailureCount++;
+    return false;
+  }
+#endif
+
+  IMFMontagePipelineBuilder::MontageSettings montageSettings = settings;
+  if(m_StreamingEnabled && !writeImage && settings.Display == IMFMontagePipelineBuilder::DisplayType::Montage && settings.Type != IMFMontagePipelineBuilder::MontageType::DREAM3D)
+  {
+    montageSettings.StitchedOutputFile = outputFilePath;
+  }
+
+  std::vector<FilterPipeline::Pointer> pipelines = m_Builder->createPipelines(montageSettings);
+  if(pipelines.empty())
+  {
+    qCritical().noquote() << tr("Montage '%1': the montage pipeline could not be created.").arg(settings.MontageName);
+    m_FailureCount++;
+    return false;
+  }
+
+  for(const FilterPipeline::Pointer& pipeline : pipelines)
+  {
+    QString pipelineOutputPath = PipelineOutputPath(outputFilePath, pipeline, pipelines.size());
+    AbstractFilter::Pointer imageWriterFilter;
+    if(writeImage && !renderImage)
+    {
+      imageWriterFilter = IMFFilterFactory::CreateImageFileWriterFilter(pipelineOutputPath, IMFMontagePipelineBuilder::MontagePath());
+    }
+
+    pipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(settings.Display));
+    pipeline->setProperty(k_OutputFileProperty, pipelineOutputPath);
+
+    m_PendingCount++;
+    if(IMFStreamingStitcher::IsStitchingPipeline(pipeline))
+    {
+      // The montage only exists once the tiles have been stitched after the pipeline's filters
+      m_Scheduler->enqueue(pipeline, DataContainerArray::NullPointer(), [imageWriterFilter](const FilterPipeline::Pointer& stitchPipeline, const DataContainerArray::Pointer& dca) {
+        int err = IMFStreamingStitcher::ExecutePipeline(stitchPipeline, dca);
+        if(err < 0 || !imageWriterFilter)
+        {
+          return err;
+        }
+
+        imageWriterFilter->setDataContainerArray(dca);
+        imageWriterFilter->execute();
+        return imageWriterFilter->getErrorCode();
+      });
+    }
+    else
+    {
+      if(imageWriterFilter)
+      {
+        pipeline->pushBack(imageWriterFilter);
+      }
+      m_Scheduler->enqueue(pipeline);
+    }
+  }
+
+  return true;
+}
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFBatchRunner::addSession(const QString& sessionFilePath, const QString& outputFilePath)
+{
+  if(!IMFOffscreenRenderer::IsSupportedImageFile(outputFilePath))
+  {
+    qCritical().noquote() << tr("Session '%1': the output must be a PNG, TIFF, JPEG or BMP file.").arg(sessionFilePath);
+    m_FailureCount++;
+    return false;
+  }
+
+  QJsonObject sessionObj;
+  QString errorMessage;
+  if(IMFSessionLoader::ReadSessionFile(sessionFilePath, sessionObj, errorMessage) < 0)
+  {
+    qCritical().noquote() << errorMessage;
+    m_FailureCount++;
+    return false;
+  }
+
+  std::vector<FilterPipeline::Pointer> pipelines;
+  for(QJsonObject::const_iterator iter = sessionObj.constBegin(); iter != sessionObj.constEnd(); iter++)
+  {
+    FilterPipeline::Pointer pipeline = IMFSessionLoader::CreateReaderPipeline(iter.key(), iter.value().toObject());
+    if(!pipeline)
+    {
+      qWarning().noquote() << tr("Session '%1': '%2' is not a DREAM3D dataset and is not rendered").arg(sessionFilePath, iter.key());
+      continue;
+    }
+    pipelines.push_back(pipeline);
+  }
+  if(pipelines.empty())
+  {
+    qCritical().noquote() << tr("Session '%1' has no DREAM3D datasets to render").arg(sessionFilePath);
+    m_FailureCount++;
+    return false;
+  }
+
+  m_RenderGroups[outputFilePath].pendingCount += static_cast<int>(pipelines.size());
+  for(const FilterPipeline::Pointer& pipeline : pipelines)
+  {
+    pipeline->setProperty(k_OutputFileProperty, outputFilePath);
+    m_PendingCount++;
+    m_Scheduler->enqueue(pipeline);
+  }
+
+  return true;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFBatchRunner::PipelineOutputPath(const QString& outputFilePath, const FilterPipeline::Pointer& pipeline, size_t pipelineCount)
+{
+  if(pipelineCount <= 1)
+  {
+    return outputFilePath;
+  }
+
+  QString slice = pipeline->getName().section('_', -1);
+  QFileInfo fi(outputFilePath);
+  QString fileName = QString("%1_%2.%3").arg(fi.completeBaseName(), slice, fi.suffix());
+  return fi.dir().filePath(fileName);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBatchRunner::handlePipelineFinished(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled)
+{
+  m_PendingCount--;
+
+  QString outputFilePath = pipeline->property(k_OutputFileProperty).toString();
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  bool sessionPipeline = IMFSessionLoader::IsSessionPipeline(pipeline);
+#else
+  bool sessionPipeline = false;
+#endif
+  if(canceled)
+  {
+    qCritical().noquote() << tr("Montage '%1' was canceled").arg(pipeline->getName());
+    m_FailureCount++;
+    if(sessionPipeline)
+    {
+      renderPipelineOutput(pipeline, DataContainerArray::NullPointer());
+    }
+  }
+  else if(err < 0)
+  {
+    qCritical().noquote() << tr("Montage '%1' failed with error code %2").arg(pipeline->getName()).arg(err);
+    m_FailureCount++;
+    if(sessionPipeline)
+    {
+      renderPipelineOutput(pipeline, DataContainerArray::NullPointer());
+    }
+  }
+  else if(sessionPipeline)
+  {
+    err = renderPipelineOutput(pipeline, dca);
+  }
+  else
+  {
+    // The tile origins are only available until the tiles are removed from the stitched output
+    m_RegistrationCache->storePipelineResults(pipeline, dca);
+
+    // Streaming pipelines wrote their output while executing
+    bool writeDream3d = !IMFStreamingStitcher::IsStreamingPipeline(pipeline) && isDream3dFile(outputFilePath);
+    bool renderImage = m_RenderImages && !isDream3dFile(outputFilePath);
+    if(writeDream3d || renderImage)
+    {
+      IMFMontagePipelineBuilder::DisplayType displayType = static_cast<IMFMontagePipelineBuilder::DisplayType>(pipeline->property(k_DisplayTypeProperty).toInt());
+      IMFMontagePipelineBuilder::FinalizeMontageOutput(pipeline, dca, displayType);
+    }
+
+    if(writeDream3d)
+    {
+      err = writeDream3dFile(dca, outputFilePath);
+      if(err < 0)
+      {
+        qCritical().noquote() << tr("Montage '%1' could not be written to '%2' (error code %3)").arg(pipeline->getName(), outputFilePath).arg(err);
+        m_FailureCount++;
+      }
+    }
+    else if(renderImage)
+    {
+      err = renderPipelineOutput(pipeline, dca);
+    }
+  }
+
+  // Images of sessions are only written once their last dataset has been read
+  if(!canceled && err >= 0 && !m_RenderGroups.contains(outputFilePath))
+  {
+    qInfo().noquote() << tr("Montage '%1' written to '%2'").arg(pipeline->getName(), outputFilePath);
+  }
+
+  if(m_PendingCount == 0)
+  {
+    emit finished(m_FailureCount);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFBatchRunner::writeDream3dFile(const DataContainerArray::Pointer& dca, const QString& outputFilePath)
+{
+  IFilterFactory::Pointer writerFactory = FilterManager::Instance()->getFactoryFromClassName("DataContainerWriter");
+  if(writerFactory.get() == nullptr)
+  {
+    return -1;
+  }
+
+  AbstractFilter::Pointer writer = writerFactory->create();
+  writer->setProperty("OutputFile", outputFilePath);
+  writer->setProperty("WriteXdmfFile", false);
+  writer->setProperty("WriteTimeSeries", false);
+  writer->setDataContainerArray(dca);
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  writer->execute();
+  return writer->getErrorCode();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFBatchRunner::renderPipelineOutput(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca)
+{
+  QString outputFilePath = pipeline->property(k_OutputFileProperty).toString();
+  RenderGroup& renderGroup = m_RenderGroups[outputFilePath];
+  renderGroup.pendingCount = std::max(renderGroup.pendingCount - 1, 0);
+  if(dca != DataContainerArray::NullPointer())
+  {
+    for(const DataContainer::Pointer& dc : dca->getDataContainers())
+    {
+      renderGroup.dataContainers.push_back(dc);
+    }
+  }
+  if(renderGroup.pendingCount > 0)
+  {
+    return 0;
+  }
+
+  std::vector<DataContainer::Pointer> dataContainers = renderGroup.dataContainers;
+  m_RenderGroups.remove(outputFilePath);
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  int err = m_Renderer.render(dataContainers, outputFilePath, m_RenderOptions);
+#else
+  // Images are only rendered when the tool is built with rendering
+  int err = -1;
+#endif
+  if(err < 0)
+  {
+    qCritical().noquote() << tr("'%1' could not be rendered to '%2' (error code %3)").arg(pipeline->getName(), outputFilePath).arg(err);
+    m_FailureCount++;
+  }
+  return err;
+}
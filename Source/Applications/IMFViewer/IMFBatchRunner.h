@@ -0,0 +1,194 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+#include "IMFViewer/IMFOffscreenRenderer.h"
+#endif
+
+class IMFPipelineScheduler;
+class IMFRegistrationCache;
+
+/**
+ * @brief The IMFBatchRunner class executes montage pipelines without a user interface
+ * and writes the stitched result of each pipeline to disk.  Pipelines are executed by
+ * an IMFPipelineScheduler so that several montages run at the same time.
+ */
+class IMFBatchRunner : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFBatchRunner(QObject* parent = nullptr);
+  ~IMFBatchRunner() override;
+
+  /**
+   * @brief Sets the number of montage pipelines that may execute at the same time
+   * @param count
+   */
+  void setJobCount(int count);
+
+  /**
+   * @brief Sets whether registration results are reused from and stored in the registration cache
+   * @param enabled
+   */
+  void setRegistrationCacheEnabled(bool enabled);
+
+  /**
+   * @brief Sets whether stitched montages with a .dream3d output file are streamed to disk
+   * strip by strip instead of being stitched in memory
+   * @param enabled
+   */
+  void setStreamingEnabled(bool enabled);
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  /**
+   * @brief Renders image outputs offscreen with the options instead of writing the stitched
+   * image at full resolution.  Side by side montages can then be written as images as well.
+   * @param options
+   */
+  void setRenderOptions(const IMFOffscreenRenderer::Options& options);
+#endif
+
+  /**
+   * @brief Builds the pipelines for the montage and queues them for execution.  The
+   * output file extension selects the writer: ".dream3d" writes the data container array,
+   * any other extension writes the stitched image.
+   * @param settings
+   * @param outputFilePath
+   * @return false if no pipeline could be created for the montage
+   */
+  bool addMontage(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& outputFilePath);
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  /**
+   * @brief Queues the DREAM3D datasets of a session file for reading and renders all of
+   * them into one image once they have been read
+   * @param sessionFilePath
+   * @param outputFilePath
+   * @return false if the session could not be read or has no DREAM3D datasets
+   */
+  bool addSession(const QString& sessionFilePath, const QString& outputFilePath);
+#endif
+
+  /**
+   * @brief Returns the number of pipelines that are waiting or executing
+   * @return
+   */
+  int getPendingCount() const;
+
+  /**
+   * @brief Returns the number of pipelines that failed to execute or write their output
+   * @return
+   */
+  int getFailureCount() const;
+
+signals:
+  void finished(int failureCount);
+
+private slots:
+  /**
+   * @brief Writes the output of a finished pipeline
+   * @param pipeline
+   * @param dca
+   * @param err
+   * @param canceled
+   */
+  void handlePipelineFinished(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled);
+
+private:
+  IMFPipelineScheduler* m_Scheduler = nullptr;
+  IMFMontagePipelineBuilder* m_Builder = nullptr;
+  IMFRegistrationCache* m_RegistrationCache = nullptr;
+  int m_PendingCount = 0;
+  bool m_StreamingEnabled = false;
+  int m_FailureCount = 0;
+  bool m_RenderImages = false;
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  IMFOffscreenRenderer::Options m_RenderOptions;
+  IMFOffscreenRenderer m_Renderer;
+#endif
+
+  // Data containers of the pipelines drawn into the same image, by output file
+  struct RenderGroup
+  {
+    int pendingCount = 0;
+    std::vector<DataContainer::Pointer> dataContainers;
+  };
+  QMap<QString, RenderGroup> m_RenderGroups;
+
+  /**
+   * @brief Returns the output file path for the pipeline.  Montages that produce more
+   * than one pipeline append the slice number to the file name.
+   * @param outputFilePath
+   * @param pipeline
+   * @param pipelineCount
+   * @return
+   */
+  static QString PipelineOutputPath(const QString& outputFilePath, const FilterPipeline::Pointer& pipeline, size_t pipelineCount);
+
+  /**
+   * @brief Writes the data container array to a .dream3d file
+   * @param dca
+   * @param outputFilePath
+   * @return
+   */
+  int writeDream3dFile(const DataContainerArray::Pointer& dca, const QString& outputFilePath);
+
+  /**
+   * @brief Adds the data containers of a finished pipeline to the image of its output file
+   * and renders the image once every pipeline of the image has finished
+   * @param pipeline
+   * @param dca
+   * @return 0 while pipelines of the image are still executing, otherwise the render result
+   */
+  int renderPipelineOutput(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca);
+
+  IMFBatchRunner(const IMFBatchRunner&); // Copy Constructor Not Implemented
+  void operator=(const IMFBatchRunner&); // Operator '=' Not Implemented
+};
@@ -0,0 +1,654 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFBenchmark.h"
+
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#include <sys/resource.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QSysInfo>
+#include <QtCore/QTextStream>
+#include <QtCore/QThread>
+
+#include <QtGui/QImage>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+#include "SIMPLVtkLib/SIMPLBridge/SIMPLVtkBridge.h"
+#endif
+
+#include "IMFViewer/IMFPipelineScheduler.h"
+#include "IMFViewer/IMFStreamingStitcher.h"
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+#include "IMFViewer/IMFVtkArrayBridge.h"
+#endif
+
+const char* IMFBenchmark::PreflightPhase = "Preflight";
+const char* IMFBenchmark::ImportPhase = "Import";
+const char* IMFBenchmark::RegistrationPhase = "Registration";
+const char* IMFBenchmark::StitchingPhase = "Stitching";
+const char* IMFBenchmark::HandoffPhase = "Handoff";
+
+namespace
+{
+const QStringList k_MontageTypeNames = {"DREAM3D", "Fiji", "Robomet", "Zeiss", "ZeissZen"};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+uint8_t syntheticPixel(int x, int y)
+{
+  // Smooth structure for the phase correlation plus a little noise, both in montage
+  // coordinates so the overlapping edges of neighboring tiles match
+  uint32_t hash = (static_cast<uint32_t>(x) * 73856093u) ^ (static_cast<uint32_t>(y) * 19349663u);
+  hash ^= hash >> 13;
+  hash *= 0x5bd1e995u;
+  hash ^= hash >> 15;
+  double value = 128.0 + 50.0 * std::sin(x / 17.0) * std::cos(y / 23.0) + 30.0 * std::sin((x + 2 * y) / 53.0) + static_cast<double>(hash % 41) - 20.0;
+  return static_cast<uint8_t>(std::min(255.0, std::max(0.0, value)));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void fillSyntheticTile(uint8_t* pixels, int x0, int y0, int tileSize)
+{
+  for(int y = 0; y < tileSize; y++)
+  {
+    for(int x = 0; x < tileSize; x++)
+    {
+      pixels[y * tileSize + x] = syntheticPixel(x0 + x, y0 + y);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString filterPhase(const AbstractFilter::Pointer& filter)
+{
+  QString className = filter->getNameOfClass();
+  if(className.contains("Registration") || className.startsWith("SetOriginResolution"))
+  {
+    return IMFBenchmark::RegistrationPhase;
+  }
+  if(className.contains("Stitching"))
+  {
+    return IMFBenchmark::StitchingPhase;
+  }
+  return IMFBenchmark::ImportPhase;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void addElapsedTime(QMap<QString, double>& phaseTimes, const QString& phase, const QElapsedTimer& timer)
+{
+  phaseTimes[phase] += static_cast<double>(timer.nsecsElapsed()) / 1.0e6;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double median(std::vector<double> values)
+{
+  if(values.empty())
+  {
+    return 0.0;
+  }
+
+  std::sort(values.begin(), values.end());
+  size_t middle = values.size() / 2;
+  if(values.size() % 2 == 0)
+  {
+    return (values[middle - 1] + values[middle]) / 2.0;
+  }
+  return values[middle];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int executeFilters(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, QMap<QString, double>& phaseTimes, qint64& tileBytes)
+{
+  bool firstFilter = true;
+  for(const AbstractFilter::Pointer& filter : pipeline->getFilterContainer())
+  {
+    QElapsedTimer timer;
+    timer.start();
+    filter->setDataContainerArray(dca);
+    filter->execute();
+    addElapsedTime(phaseTimes, filterPhase(filter), timer);
+
+    int err = filter->getErrorCode();
+    if(err < 0)
+    {
+      return err;
+    }
+
+    // The first filter reads the tiles
+    if(firstFilter)
+    {
+      tileBytes += IMFPipelineScheduler::EstimateMemoryUsage(dca);
+      firstFilter = false;
+    }
+  }
+  return 0;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFBenchmark::IMFBenchmark() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFBenchmark::~IMFBenchmark() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBenchmark::setRepeatCount(int count)
+{
+  m_RepeatCount = std::max(1, count);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFBenchmark::setStreamingEnabled(bool enabled)
+{
+  m_StreamingEnabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFBenchmark::getWorkingDirectory() const
+{
+  return m_WorkingDirectory.path();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFBenchmark::IsSyntheticTypeSupported(IMFMontagePipelineBuilder::MontageType type)
+{
+  return type == IMFMontagePipelineBuilder::MontageType::Fiji || type == IMFMontagePipelineBuilder::MontageType::DREAM3D;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFBenchmark::createSyntheticMontage(IMFMontagePipelineBuilder::MontageType type, int rows, int columns, int tileSize, IMFMontagePipelineBuilder::MontageSettings& settings,
+                                          QString& errorMessage)
+{
+  if(!m_WorkingDirectory.isValid())
+  {
+    errorMessage = QObject::tr("The benchmark working directory could not be created");
+    return false;
+  }
+
+  QString montageName = QString("%1_%2x%3").arg(k_MontageTypeNames[static_cast<int>(type)]).arg(rows).arg(columns);
+  QDir montageDir(m_WorkingDirectory.path());
+  if(!montageDir.mkpath(montageName) || !montageDir.cd(montageName))
+  {
+    errorMessage = QObject::tr("The directory for '%1' could not be created").arg(montageName);
+    return false;
+  }
+
+  settings = IMFMontagePipelineBuilder::MontageSettings();
+  settings.Type = type;
+  settings.MontageName = montageName;
+  settings.MontageStart = {0, 0};
+  settings.MontageEnd = {columns - 1, rows - 1};
+
+  // Neighboring tiles overlap by 10%
+  int step = tileSize - tileSize / 10;
+
+  if(type == IMFMontagePipelineBuilder::MontageType::Fiji)
+  {
+    QFile configFile(montageDir.filePath("TileConfiguration.registered.txt"));
+    if(!configFile.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+      errorMessage = QObject::tr("Could not write '%1'").arg(configFile.fileName());
+      return false;
+    }
+
+    QTextStream out(&configFile);
+    out << "# Define the number of dimensions we are working on\n";
+    out << "dim = 2\n\n";
+    out << "# Define the image coordinates\n";
+
+    QImage image(tileSize, tileSize, QImage::Format_Grayscale8);
+    std::vector<uint8_t> pixels(static_cast<size_t>(tileSize) * tileSize);
+    for(int row = 0; row < rows; row++)
+    {
+      for(int col = 0; col < columns; col++)
+      {
+        fillSyntheticTile(pixels.data(), col * step, row * step, tileSize);
+        for(int y = 0; y < tileSize; y++)
+        {
+          std::copy_n(pixels.data() + y * tileSize, tileSize, image.scanLine(y));
+        }
+
+        QString fileName = QString("Tile_r%1_c%2.png").arg(row).arg(col);
+        if(!image.save(montageDir.filePath(fileName)))
+        {
+          errorMessage = QObject::tr("Could not write '%1'").arg(montageDir.filePath(fileName));
+          return false;
+        }
+        out << QString("%1; ; (%2, %3)\n").arg(fileName).arg(col * step, 0, 'f', 1).arg(row * step, 0, 'f', 1);
+      }
+    }
+
+    settings.InputFilePath = configFile.fileName();
+    return true;
+  }
+
+  if(type == IMFMontagePipelineBuilder::MontageType::DREAM3D)
+  {
+    settings.DataContainerPrefix = "UntitledMontage_";
+    std::vector<size_t> tupleDims = {static_cast<size_t>(tileSize), static_cast<size_t>(tileSize), 1};
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    for(int row = 0; row < rows; row++)
+    {
+      for(int col = 0; col < columns; col++)
+      {
+        QString dcName = IMFMontagePipelineBuilder::TileDataContainerName(settings.DataContainerPrefix, settings.MontageEnd, row, col);
+        DataContainer::Pointer dc = DataContainer::New(dcName);
+        ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+        imageGeom->setDimensions(SizeVec3Type(tileSize, tileSize, 1));
+        imageGeom->setSpacing(FloatVec3Type(1.0f, 1.0f, 1.0f));
+        imageGeom->setOrigin(FloatVec3Type(static_cast<float>(col * step), static_cast<float>(row * step), 0.0f));
+        dc->setGeometry(imageGeom);
+
+        AttributeMatrix::Pointer am = AttributeMatrix::New(tupleDims, settings.AttributeMatrixName, AttributeMatrix::Type::Cell);
+        UInt8ArrayType::Pointer array = UInt8ArrayType::CreateArray(static_cast<size_t>(tileSize) * tileSize, std::vector<size_t>(1, 1), settings.DataArrayName, true);
+        fillSyntheticTile(array->getPointer(0), col * step, row * step, tileSize);
+        am->addOrReplaceAttributeArray(array);
+        dc->addOrReplaceAttributeMatrix(am);
+        dca->addOrReplaceDataContainer(dc);
+      }
+    }
+
+    IFilterFactory::Pointer writerFactory = FilterManager::Instance()->getFactoryFromClassName("DataContainerWriter");
+    if(writerFactory.get() == nullptr)
+    {
+      errorMessage = QObject::tr("The DataContainerWriter filter is not available");
+      return false;
+    }
+
+    settings.InputFilePath = montageDir.filePath(montageName + ".dream3d");
+    AbstractFilter::Pointer writer = writerFactory->create();
+    writer->setProperty("OutputFile", settings.InputFilePath);
+    writer->setProperty("WriteXdmfFile", false);
+    writer->setProperty("WriteTimeSeries", false);
+    writer->setDataContainerArray(dca);
+    writer->execute();
+    if(writer->getErrorCode() < 0)
+    {
+      errorMessage = QObject::tr("Could not write '%1' (error code %2)").arg(settings.InputFilePath).arg(writer->getErrorCode());
+      return false;
+    }
+    return true;
+  }
+
+  errorMessage = QObject::tr("Synthetic %1 montages are not supported.  Benchmark them with a configuration file instead.").arg(k_MontageTypeNames[static_cast<int>(type)]);
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFBenchmark::Result IMFBenchmark::run(const IMFMontagePipelineBuilder::MontageSettings& settings)
+{
+  Result result;
+  result.Name = settings.MontageName;
+  result.Type = k_MontageTypeNames[static_cast<int>(settings.Type)];
+  result.Columns = settings.MontageEnd[0] - settings.MontageStart[0] + 1;
+  result.Rows = settings.MontageEnd[1] - settings.MontageStart[1] + 1;
+
+  std::map<QString, std::vector<double>> phaseRuns;
+  bool peakReset = ResetPeakResidentSetSize();
+  qint64 startResidentSetSize = ResidentSetSize();
+  qint64 startPeakResidentSetSize = PeakResidentSetSize();
+  for(int i = 0; i < m_RepeatCount && result.ErrorCode >= 0; i++)
+  {
+    QMap<QString, double> phaseTimes;
+    qint64 tileBytes = 0;
+
+    QElapsedTimer timer;
+    timer.start();
+    result.ErrorCode = runOnce(settings, phaseTimes, tileBytes);
+    result.WallTimes.push_back(static_cast<double>(timer.nsecsElapsed()) / 1.0e6);
+    result.TileBytes = tileBytes;
+
+    for(const QString& phase : {PreflightPhase, ImportPhase, RegistrationPhase, StitchingPhase, HandoffPhase})
+    {
+      phaseRuns[phase].push_back(phaseTimes.value(phase, 0.0));
+    }
+  }
+  result.PeakResidentSetSize = PeakResidentSetSize();
+
+  // Where the peak can not be restarted it covers every earlier montage too, so it only
+  // belongs to this one if it grew while this one ran
+  if(startResidentSetSize > 0 && result.PeakResidentSetSize > 0 && (peakReset || result.PeakResidentSetSize > startPeakResidentSetSize))
+  {
+    result.PeakResidentSetSizeIncrease = std::max<qint64>(result.PeakResidentSetSize - startResidentSetSize, 0);
+  }
+
+  for(const auto& phaseRun : phaseRuns)
+  {
+    result.PhaseTimes[phaseRun.first] = median(phaseRun.second);
+  }
+
+  return result;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFBenchmark::runOnce(const IMFMontagePipelineBuilder::MontageSettings& settings, QMap<QString, double>& phaseTimes, qint64& tileBytes)
+{
+  IMFMontagePipelineBuilder::MontageSettings montageSettings = settings;
+  if(m_StreamingEnabled && settings.Display == IMFMontagePipelineBuilder::DisplayType::Montage && settings.Type != IMFMontagePipelineBuilder::MontageType::DREAM3D)
+  {
+    montageSettings.StitchedOutputFile = QDir(m_WorkingDirectory.path()).filePath(settings.MontageName + "_Stitched.dream3d");
+  }
+
+  // No registration cache is set, so every run registers the tiles
+  IMFMontagePipelineBuilder builder;
+  std::vector<FilterPipeline::Pointer> pipelines = builder.createPipelines(montageSettings);
+  if(pipelines.empty())
+  {
+    return k_CreatePipelineError;
+  }
+
+  for(const FilterPipeline::Pointer& pipeline : pipelines)
+  {
+    QElapsedTimer timer;
+    timer.start();
+    DataContainerArray::Pointer preflightDca = DataContainerArray::New();
+    for(const AbstractFilter::Pointer& filter : pipeline->getFilterContainer())
+    {
+      filter->setDataContainerArray(preflightDca);
+      filter->setInPreflight(true);
+      filter->preflight();
+      filter->setInPreflight(false);
+      if(filter->getErrorCode() < 0)
+      {
+        return filter->getErrorCode();
+      }
+    }
+    addElapsedTime(phaseTimes, PreflightPhase, timer);
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    int err = executeFilters(pipeline, dca, phaseTimes, tileBytes);
+    if(err < 0)
+    {
+      return err;
+    }
+
+    if(IMFStreamingStitcher::IsStitchingPipeline(pipeline))
+    {
+      timer.restart();
+      err = IMFStreamingStitcher::ExecutePipeline(pipeline, dca);
+      addElapsedTime(phaseTimes, StitchingPhase, timer);
+      if(err < 0)
+      {
+        return err;
+      }
+    }
+
+    if(IMFStreamingStitcher::IsStreamingPipeline(pipeline))
+    {
+      // The viewer displays streamed montages by reading the stitched file back
+      timer.restart();
+      QString outputFilePath = pipeline->property(IMFStreamingStitcher::OutputFileProperty).toString();
+      FilterPipeline::Pointer readerPipeline = IMFMontagePipelineBuilder::CreateStitchedFileReaderPipeline(pipeline->getName(), outputFilePath);
+      if(readerPipeline == FilterPipeline::NullPointer())
+      {
+        return IMFStreamingStitcher::k_CreateFileError;
+      }
+      dca = DataContainerArray::New();
+      for(const AbstractFilter::Pointer& filter : readerPipeline->getFilterContainer())
+      {
+        filter->setDataContainerArray(dca);
+        filter->execute();
+        if(filter->getErrorCode() < 0)
+        {
+          return filter->getErrorCode();
+        }
+      }
+      addElapsedTime(phaseTimes, HandoffPhase, timer);
+    }
+
+    // Same conversion the viewer performs when the pipeline output is imported.  The VTK
+    // wrapping is only timed when the tool is built with rendering.
+    timer.restart();
+    IMFMontagePipelineBuilder::FinalizeMontageOutput(pipeline, dca, montageSettings.Display);
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+    std::vector<SIMPLVtkBridge::WrappedDataContainerPtr> wrappedDcs = SIMPLVtkBridge::WrapDataContainerArrayAsStruct(dca);
+    for(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc : wrappedDcs)
+    {
+      if(!IMFVtkArrayBridge::FinishWrappingDataContainer(wrappedDc))
+      {
+        SIMPLVtkBridge::FinishWrappingDataContainerStruct(wrappedDc);
+        IMFVtkArrayBridge::ShareWrappedDataContainer(wrappedDc);
+      }
+    }
+#endif
+    addElapsedTime(phaseTimes, HandoffPhase, timer);
+  }
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonObject IMFBenchmark::ToJson(const std::vector<Result>& results, const QString& label)
+{
+  QJsonArray resultsArray;
+  for(const Result& result : results)
+  {
+    QJsonObject phaseTimes;
+    for(auto iter = result.PhaseTimes.constBegin(); iter != result.PhaseTimes.constEnd(); iter++)
+    {
+      phaseTimes[iter.key()] = iter.value();
+    }
+
+    QJsonArray wallTimes;
+    for(double wallTime : result.WallTimes)
+    {
+      wallTimes.append(wallTime);
+    }
+
+    double wallTime = median(result.WallTimes);
+    double throughput = 0.0;
+    if(wallTime > 0.0)
+    {
+      throughput = (static_cast<double>(result.TileBytes) / (1024.0 * 1024.0)) / (wallTime / 1000.0);
+    }
+
+    QJsonObject resultObj;
+    resultObj["Name"] = result.Name;
+    resultObj["Type"] = result.Type;
+    resultObj["Rows"] = result.Rows;
+    resultObj["Columns"] = result.Columns;
+    resultObj["TileSize"] = result.TileSize;
+    resultObj["TileBytes"] = static_cast<double>(result.TileBytes);
+    resultObj["ErrorCode"] = result.ErrorCode;
+    resultObj["PhaseTimesMs"] = phaseTimes;
+    resultObj["WallTimeMs"] = wallTime;
+    resultObj["WallTimesMs"] = wallTimes;
+    resultObj["PeakRSSBytes"] = static_cast<double>(result.PeakResidentSetSize);
+    resultObj["PeakRSSIncreaseBytes"] = result.PeakResidentSetSizeIncrease >= 0 ? QJsonValue(static_cast<double>(result.PeakResidentSetSizeIncrease)) : QJsonValue();
+    resultObj["ThroughputMBps"] = throughput;
+    resultsArray.append(resultObj);
+  }
+
+  QJsonObject systemObj;
+  systemObj["OperatingSystem"] = QSysInfo::prettyProductName();
+  systemObj["CpuArchitecture"] = QSysInfo::currentCpuArchitecture();
+  systemObj["ThreadCount"] = QThread::idealThreadCount();
+  systemObj["PhysicalMemoryBytes"] = static_cast<double>(IMFPipelineScheduler::PhysicalMemorySize());
+
+  QJsonObject root;
+  root["Version"] = 1;
+  root["Label"] = label;
+  root["Date"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+  root["System"] = systemObj;
+  root["Results"] = resultsArray;
+  return root;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFBenchmark::PeakResidentSetSize()
+{
+#if defined(_MSC_VER)
+  PROCESS_MEMORY_COUNTERS counters;
+  if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0)
+  {
+    return 0;
+  }
+  return static_cast<qint64>(counters.PeakWorkingSetSize);
+#elif defined(__APPLE__)
+  struct rusage usage;
+  if(getrusage(RUSAGE_SELF, &usage) != 0)
+  {
+    return 0;
+  }
+  return static_cast<qint64>(usage.ru_maxrss);
+#else
+  QFile statusFile("/proc/self/status");
+  if(!statusFile.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return 0;
+  }
+
+  // VmHWM is the high water mark of the resident set in kB
+  for(const QByteArray& line : statusFile.readAll().split('\n'))
+  {
+    if(line.startsWith("VmHWM:"))
+    {
+      QList<QByteArray> tokens = line.simplified().split(' ');
+      return tokens.size() > 1 ? tokens[1].toLongLong() * 1024 : 0;
+    }
+  }
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFBenchmark::ResidentSetSize()
+{
+#if defined(_MSC_VER)
+  PROCESS_MEMORY_COUNTERS counters;
+  if(GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)) == 0)
+  {
+    return 0;
+  }
+  return static_cast<qint64>(counters.WorkingSetSize);
+#elif defined(__APPLE__)
+  mach_task_basic_info_data_t info;
+  mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+  if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+  {
+    return 0;
+  }
+  return static_cast<qint64>(info.resident_size);
+#else
+  QFile statusFile("/proc/self/status");
+  if(!statusFile.open(QIODevice::ReadOnly | QIODevice::Text))
+  {
+    return 0;
+  }
+
+  // VmRSS is the current resident set in kB
+  for(const QByteArray& line : statusFile.readAll().split('\n'))
+  {
+    if(line.startsWith("VmRSS:"))
+    {
+      QList<QByteArray> tokens = line.simplified().split(' ');
+      return tokens.size() > 1 ? tokens[1].toLongLong() * 1024 : 0;
+    }
+  }
+  return 0;
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFBenchmark::ResetPeakResidentSetSize()
+{
+#if !defined(_MSC_VER) && !defined(__APPLE__)
+  // Writing 5 resets VmHWM to the current resident set size
+  QFile clearRefsFile("/proc/self/clear_refs");
+  return clearRefsFile.open(QIODevice::WriteOnly) && clearRefsFile.write("5") == 1;
+#else
+  return false;
+#endif
+}
@@ -0,0 +1,179 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QMap>
+#include <QtCore/QString>
+#include <QtCore/QTemporaryDir>
+
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+/**
+ * @brief The IMFBenchmark class times the montage import paths of the viewer.  Each
+ * montage is built with IMFMontagePipelineBuilder and executed on the calling thread
+ * so the preflight, import, registration, stitching and handoff to the viewer can be
+ * timed separately.  Synthetic Fiji and DREAM3D tile grids of any size can be
+ * generated so results are comparable between machines and commits.
+ */
+class IMFBenchmark
+{
+public:
+  IMFBenchmark();
+  ~IMFBenchmark();
+
+  static const char* PreflightPhase;
+  static const char* ImportPhase;
+  static const char* RegistrationPhase;
+  static const char* StitchingPhase;
+  static const char* HandoffPhase;
+
+  static const int k_CreatePipelineError = -89100;
+
+  struct Result
+  {
+    QString Name;
+    QString Type;
+    int Rows = 0;
+    int Columns = 0;
+    int TileSize = 0;
+    qint64 TileBytes = 0;
+    int ErrorCode = 0;
+    QMap<QString, double> PhaseTimes;
+    std::vector<double> WallTimes;
+    qint64 PeakResidentSetSize = 0;
+
+    // Growth of the peak resident set size over the resident set size when the montage started,
+    // or -1 when the peak of this montage could not be told apart from the peak of earlier ones
+    qint64 PeakResidentSetSizeIncrease = -1;
+  };
+
+  /**
+   * @brief Sets how often each montage is imported.  Reported times are the median of all runs.
+   * @param count
+   */
+  void setRepeatCount(int count);
+
+  /**
+   * @brief Sets whether stitched montages are streamed to a file in the working directory
+   * @param enabled
+   */
+  void setStreamingEnabled(bool enabled);
+
+  /**
+   * @brief Returns the directory that holds the synthetic montages and streamed output.
+   * It is removed when the benchmark is destroyed.
+   * @return
+   */
+  QString getWorkingDirectory() const;
+
+  /**
+   * @brief Returns true for the montage types createSyntheticMontage can write.  Zeiss and
+   * Robomet metadata is written by the acquisition software and is not synthesized.
+   * @param type
+   * @return
+   */
+  static bool IsSyntheticTypeSupported(IMFMontagePipelineBuilder::MontageType type);
+
+  /**
+   * @brief Writes a synthetic grid of overlapping 8-bit tiles in the format of the montage
+   * type and fills in the settings that import it.  Fiji and DREAM3D grids are supported.
+   * @param type
+   * @param rows
+   * @param columns
+   * @param tileSize
+   * @param settings
+   * @param errorMessage
+   * @return
+   */
+  bool createSyntheticMontage(IMFMontagePipelineBuilder::MontageType type, int rows, int columns, int tileSize, IMFMontagePipelineBuilder::MontageSettings& settings, QString& errorMessage);
+
+  /**
+   * @brief Imports the montage the configured number of times and returns the timings
+   * @param settings
+   * @return
+   */
+  Result run(const IMFMontagePipelineBuilder::MontageSettings& settings);
+
+  /**
+   * @brief Returns the results and a description of this machine as a JSON object
+   * @param results
+   * @param label
+   * @return
+   */
+  static QJsonObject ToJson(const std::vector<Result>& results, const QString& label);
+
+  /**
+   * @brief Returns the largest resident set size of the process in bytes since the
+   * last call to ResetPeakResidentSetSize, or 0 if it could not be determined
+   * @return
+   */
+  static qint64 PeakResidentSetSize();
+
+  /**
+   * @brief Returns the current resident set size of the process in bytes, or 0 if it could
+   * not be determined
+   * @return
+   */
+  static qint64 ResidentSetSize();
+
+  /**
+   * @brief Restarts the peak resident set size measurement where the platform allows it.
+   * Otherwise the peak covers the lifetime of the process.
+   * @return false if the peak could not be restarted
+   */
+  static bool ResetPeakResidentSetSize();
+
+private:
+  QTemporaryDir m_WorkingDirectory;
+  int m_RepeatCount = 1;
+  bool m_StreamingEnabled = false;
+
+  /**
+   * @brief Imports the montage once and adds the time spent in each phase to the phase times
+   * @param settings
+   * @param phaseTimes
+   * @param tileBytes
+   * @return The error code of the import
+   */
+  int runOnce(const IMFMontagePipelineBuilder::MontageSettings& settings, QMap<QString, double>& phaseTimes, qint64& tileBytes);
+
+  IMFBenchmark(const IMFBenchmark&);   // Copy Constructor Not Implemented
+  void operator=(const IMFBenchmark&); // Operator '=' Not Implemented
+};
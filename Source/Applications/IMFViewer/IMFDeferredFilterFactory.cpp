@@ -0,0 +1,152 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFDeferredFilterFactory.h"
+
+#include "SIMPLib/Filtering/FilterManager.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFDeferredFilterFactory::IMFDeferredFilterFactory(const QString& pluginFilePath, const IMFPluginLoader::FilterRecord& filter)
+: m_PluginFilePath(pluginFilePath)
+, m_Filter(filter)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFDeferredFilterFactory::~IMFDeferredFilterFactory() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IFilterFactory::Pointer IMFDeferredFilterFactory::loadFactory() const
+{
+  IMFPluginLoader::LoadDeferredPlugin(m_PluginFilePath);
+
+  // A plugin that no longer provides the filter leaves this factory registered
+  IFilterFactory::Pointer factory = FilterManager::Instance()->getFactoryFromClassName(m_Filter.ClassName);
+  if(factory.get() == this)
+  {
+    return IFilterFactory::NullPointer();
+  }
+  return factory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFDeferredFilterFactory::create() const
+{
+  IFilterFactory::Pointer factory = loadFactory();
+  if(!factory)
+  {
+    return AbstractFilter::NullPointer();
+  }
+  return factory->create();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getFilterClassName() const
+{
+  return m_Filter.ClassName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getFilterGroup() const
+{
+  return m_Filter.GroupName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getFilterSubGroup() const
+{
+  return m_Filter.SubGroupName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getFilterHtmlSummary() const
+{
+  // The summary is only needed by the documentation, so it is not stored in the manifest
+  IFilterFactory::Pointer factory = loadFactory();
+  if(!factory)
+  {
+    return QString();
+  }
+  return factory->getFilterHtmlSummary();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getFilterHumanLabel() const
+{
+  return m_Filter.HumanLabel;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getBrandingString() const
+{
+  return m_Filter.BrandingString;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredFilterFactory::getCompiledLibraryName() const
+{
+  return m_Filter.CompiledLibraryName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid IMFDeferredFilterFactory::getUuid() const
+{
+  return m_Filter.Uuid;
+}
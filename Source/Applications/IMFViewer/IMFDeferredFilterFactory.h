@@ -0,0 +1,94 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include "SIMPLib/Filtering/IFilterFactory.hpp"
+
+#include "IMFViewer/IMFPluginLoader.h"
+
+/**
+ * @brief The IMFDeferredFilterFactory class stands in for a filter of a plugin that has
+ * not been loaded yet.  The filter names come from the plugin manifest, so the filter
+ * lists can be shown without loading the plugin.  The plugin is loaded the first time
+ * a filter is created, which replaces this factory with the plugin's own factory.
+ */
+class IMFDeferredFilterFactory : public IFilterFactory
+{
+public:
+  SIMPL_SHARED_POINTERS(IMFDeferredFilterFactory)
+
+  /**
+   * @brief Creates a factory for a filter listed in the manifest entry of the plugin
+   * @param pluginFilePath
+   * @param filter
+   * @return
+   */
+  static Pointer New(const QString& pluginFilePath, const IMFPluginLoader::FilterRecord& filter)
+  {
+    Pointer sharedPtr(new IMFDeferredFilterFactory(pluginFilePath, filter));
+    return sharedPtr;
+  }
+
+  ~IMFDeferredFilterFactory() override;
+
+  AbstractFilter::Pointer create() const override;
+
+  QString getFilterClassName() const override;
+  QString getFilterGroup() const override;
+  QString getFilterSubGroup() const override;
+  QString getFilterHtmlSummary() const override;
+  QString getFilterHumanLabel() const override;
+  QString getBrandingString() const override;
+  QString getCompiledLibraryName() const override;
+  QUuid getUuid() const override;
+
+protected:
+  IMFDeferredFilterFactory(const QString& pluginFilePath, const IMFPluginLoader::FilterRecord& filter);
+
+private:
+  QString m_PluginFilePath;
+  IMFPluginLoader::FilterRecord m_Filter;
+
+  /**
+   * @brief Loads the plugin and returns the factory it registered for the filter
+   * @return
+   */
+  IFilterFactory::Pointer loadFactory() const;
+
+  IMFDeferredFilterFactory(const IMFDeferredFilterFactory&); // Copy Constructor Not Implemented
+  void operator=(const IMFDeferredFilterFactory&);           // Operator '=' Not Implemented
+};
@@ -0,0 +1,249 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+
+#include "IMFDeferredPlugin.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFDeferredPlugin::IMFDeferredPlugin(const IMFPluginLoader::PluginRecord& record)
+: m_Record(record)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFDeferredPlugin::~IMFDeferredPlugin() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ISIMPLibPlugin* IMFDeferredPlugin::loadedPlugin() const
+{
+  return IMFPluginLoader::FindDeferredPlugin(m_Record.FilePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getPluginFileName()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getPluginFileName() : m_Record.PluginName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getPluginDisplayName()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getPluginDisplayName() : m_Record.DisplayName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getPluginBaseName()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getPluginBaseName() : m_Record.BaseName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getVersion()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getVersion() : m_Record.Version;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getCompatibilityVersion()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getCompatibilityVersion() : m_Record.CompatibilityVersion;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getVendor()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getVendor() : m_Record.Vendor;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getURL()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getURL() : m_Record.URL;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getLocation()
+{
+  return m_Record.FilePath;
+}
+
+// -----------------------------------------------------------------------------
+// The location is the plugin file the record was made for
+// -----------------------------------------------------------------------------
+void IMFDeferredPlugin::setLocation(QString filePath)
+{
+  Q_UNUSED(filePath)
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getDescription()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getDescription() : m_Record.Description;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getCopyright()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getCopyright() : m_Record.Copyright;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFDeferredPlugin::getLicense()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getLicense() : m_Record.License;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QList<QString> IMFDeferredPlugin::getFilters()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  if(plugin != nullptr)
+  {
+    return plugin->getFilters();
+  }
+
+  QList<QString> filters;
+  for(const IMFPluginLoader::FilterRecord& filter : m_Record.Filters)
+  {
+    filters.push_back(filter.ClassName);
+  }
+  return filters;
+}
+
+// -----------------------------------------------------------------------------
+// The manifest does not record the third party licenses
+// -----------------------------------------------------------------------------
+QMap<QString, QString> IMFDeferredPlugin::getThirdPartyLicenses()
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  return plugin != nullptr ? plugin->getThirdPartyLicenses() : QMap<QString, QString>();
+}
+
+// -----------------------------------------------------------------------------
+// Only enabled plugins are deferred, and their filters are registered from the start
+// -----------------------------------------------------------------------------
+bool IMFDeferredPlugin::getDidLoad()
+{
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFDeferredPlugin::setDidLoad(bool didLoad)
+{
+  Q_UNUSED(didLoad)
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFDeferredPlugin::writeSettings(QSettings& prefs)
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  if(plugin != nullptr)
+  {
+    plugin->writeSettings(prefs);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFDeferredPlugin::readSettings(QSettings& prefs)
+{
+  ISIMPLibPlugin* plugin = loadedPlugin();
+  if(plugin != nullptr)
+  {
+    plugin->readSettings(prefs);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// The filter widgets are registered by IMFPluginLoader once the plugin is loaded
+// -----------------------------------------------------------------------------
+void IMFDeferredPlugin::registerFilterWidgets(FilterWidgetManager* fwm)
+{
+  Q_UNUSED(fwm)
+}
+
+// -----------------------------------------------------------------------------
+// The filters are registered as deferred factories, and by the plugin once it is loaded
+// -----------------------------------------------------------------------------
+void IMFDeferredPlugin::registerFilters(FilterManager* fm)
+{
+  Q_UNUSED(fm)
+}
@@ -0,0 +1,679 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFDream3dWriter.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <hdf5.h>
+
+#include <QtConcurrent>
+
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QThread>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFTrace.h"
+
+namespace
+{
+// Uncompressed size of the chunks numeric arrays are split into
+const size_t k_ChunkBytes = 1024 * 1024;
+
+// Chunks compressed ahead of the HDF5 writes, per core
+const int k_ChunksPerThread = 4;
+
+/**
+ * @brief Chunks span every axis after the split axis, one index of each axis before it and
+ * a run of indices along it, so each chunk is one contiguous range of the array's buffer
+ */
+struct ChunkLayout
+{
+  std::vector<hsize_t> dims;
+  std::vector<hsize_t> chunkDims;
+  size_t splitAxis = 0;
+  size_t sliceBytes = 0;
+  size_t outerCount = 1;
+  size_t innerCount = 1;
+  size_t chunkBytes = 0;
+};
+
+struct Chunk
+{
+  size_t index = 0;
+  size_t bytes = 0;
+  QByteArray data;
+  int offset = 0;
+  uint32_t filterMask = 0;
+};
+
+struct WriteProgress
+{
+  qint64 totalBytes = 0;
+  qint64 writtenBytes = 0;
+  IMFDream3dWriter::ProgressFunction function;
+
+  // Returns false if the write was canceled.  The function is called for every batch, even when
+  // the percentage did not change, so a large array is not written to the end after a cancel.
+  bool advance(qint64 bytes)
+  {
+    writtenBytes += bytes;
+    if(!function)
+    {
+      return true;
+    }
+    int percent = totalBytes > 0 ? static_cast<int>(writtenBytes * 100 / totalBytes) : 100;
+    return function(percent);
+  }
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t nativeType(const IDataArray::Pointer& data)
+{
+  if(std::dynamic_pointer_cast<Int8ArrayType>(data))
+  {
+    return H5T_NATIVE_INT8;
+  }
+  if(std::dynamic_pointer_cast<UInt8ArrayType>(data))
+  {
+    return H5T_NATIVE_UINT8;
+  }
+  if(std::dynamic_pointer_cast<Int16ArrayType>(data))
+  {
+    return H5T_NATIVE_INT16;
+  }
+  if(std::dynamic_pointer_cast<UInt16ArrayType>(data))
+  {
+    return H5T_NATIVE_UINT16;
+  }
+  if(std::dynamic_pointer_cast<Int32ArrayType>(data))
+  {
+    return H5T_NATIVE_INT32;
+  }
+  if(std::dynamic_pointer_cast<UInt32ArrayType>(data))
+  {
+    return H5T_NATIVE_UINT32;
+  }
+  if(std::dynamic_pointer_cast<Int64ArrayType>(data))
+  {
+    return H5T_NATIVE_INT64;
+  }
+  if(std::dynamic_pointer_cast<UInt64ArrayType>(data))
+  {
+    return H5T_NATIVE_UINT64;
+  }
+  if(std::dynamic_pointer_cast<FloatArrayType>(data))
+  {
+    return H5T_NATIVE_FLOAT;
+  }
+  if(std::dynamic_pointer_cast<DoubleArrayType>(data))
+  {
+    return H5T_NATIVE_DOUBLE;
+  }
+  return -1;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t writeStringAttribute(hid_t objectId, const QString& name, const QString& value)
+{
+  QByteArray bytes = value.toLatin1();
+  hid_t typeId = H5Tcopy(H5T_C_S1);
+  H5Tset_size(typeId, static_cast<size_t>(bytes.size() + 1));
+  H5Tset_strpad(typeId, H5T_STR_NULLTERM);
+  hid_t spaceId = H5Screate(H5S_SCALAR);
+  hid_t attrId = H5Acreate(objectId, name.toLatin1().constData(), typeId, spaceId, H5P_DEFAULT, H5P_DEFAULT);
+  herr_t err = H5Awrite(attrId, typeId, bytes.constData());
+  H5Aclose(attrId);
+  H5Sclose(spaceId);
+  H5Tclose(typeId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+herr_t writeVectorAttribute(hid_t objectId, const QString& name, hid_t typeId, const std::vector<T>& values)
+{
+  hsize_t dims[1] = {static_cast<hsize_t>(values.size())};
+  hid_t spaceId = H5Screate_simple(1, dims, nullptr);
+  hid_t attrId = H5Acreate(objectId, name.toLatin1().constData(), typeId, spaceId, H5P_DEFAULT, H5P_DEFAULT);
+  herr_t err = H5Awrite(attrId, typeId, values.data());
+  H5Aclose(attrId);
+  H5Sclose(spaceId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ChunkLayout computeLayout(const std::vector<hsize_t>& dims, size_t typeSize)
+{
+  ChunkLayout layout;
+  layout.dims = dims;
+  layout.chunkDims = dims;
+
+  size_t remainingBytes = typeSize;
+  for(hsize_t dim : dims)
+  {
+    remainingBytes *= static_cast<size_t>(dim);
+  }
+
+  // Split along the slowest axis whose slices are smaller than a chunk
+  for(size_t axis = 0; axis < dims.size(); axis++)
+  {
+    size_t dim = static_cast<size_t>(dims[axis]);
+    layout.splitAxis = axis;
+    layout.sliceBytes = remainingBytes / dim;
+    if(remainingBytes <= k_ChunkBytes)
+    {
+      break;
+    }
+    if(layout.sliceBytes < k_ChunkBytes)
+    {
+      layout.chunkDims[axis] = static_cast<hsize_t>(std::max(static_cast<size_t>(1), k_ChunkBytes / layout.sliceBytes));
+      break;
+    }
+    layout.chunkDims[axis] = 1;
+    layout.outerCount *= dim;
+    remainingBytes = layout.sliceBytes;
+  }
+
+  size_t splitDim = static_cast<size_t>(dims[layout.splitAxis]);
+  size_t splitChunk = static_cast<size_t>(layout.chunkDims[layout.splitAxis]);
+  layout.innerCount = (splitDim + splitChunk - 1) / splitChunk;
+  layout.chunkBytes = splitChunk * layout.sliceBytes;
+  return layout;
+}
+
+// -----------------------------------------------------------------------------
+// Applies the dataset's filters to one chunk the way HDF5 would
+// -----------------------------------------------------------------------------
+void encodeChunk(Chunk& chunk, const char* buffer, const ChunkLayout& layout, size_t typeSize, const IMFDream3dWriter::Options& options)
+{
+  size_t outerIndex = chunk.index / layout.innerCount;
+  size_t innerIndex = chunk.index % layout.innerCount;
+  size_t splitDim = static_cast<size_t>(layout.dims[layout.splitAxis]);
+  size_t splitStart = innerIndex * static_cast<size_t>(layout.chunkDims[layout.splitAxis]);
+  const char* src = buffer + (outerIndex * splitDim + splitStart) * layout.sliceBytes;
+  size_t bytes = std::min(layout.chunkBytes, (splitDim - splitStart) * layout.sliceBytes);
+  chunk.bytes = bytes;
+
+  if(options.Filter == IMFDream3dWriter::Compression::None && bytes == layout.chunkBytes)
+  {
+    chunk.data = QByteArray::fromRawData(src, static_cast<int>(bytes));
+    return;
+  }
+
+  // Edge chunks are padded to the full chunk size
+  QByteArray raw(static_cast<int>(layout.chunkBytes), 0);
+  if(options.Filter == IMFDream3dWriter::Compression::ShuffleDeflate && typeSize > 1)
+  {
+    size_t count = bytes / typeSize;
+    size_t planeSize = layout.chunkBytes / typeSize;
+    char* dst = raw.data();
+    for(size_t i = 0; i < count; i++)
+    {
+      for(size_t b = 0; b < typeSize; b++)
+      {
+        dst[b * planeSize + i] = src[i * typeSize + b];
+      }
+    }
+  }
+  else
+  {
+    std::memcpy(raw.data(), src, bytes);
+  }
+
+  if(options.Filter == IMFDream3dWriter::Compression::None)
+  {
+    chunk.data = raw;
+    return;
+  }
+
+  // qCompress produces a zlib stream behind a four byte length, which is what the deflate filter stores
+  chunk.data = qCompress(reinterpret_cast<const uchar*>(raw.constData()), raw.size(), options.Level);
+  chunk.offset = 4;
+  if(chunk.data.size() - chunk.offset >= raw.size())
+  {
+    // Like the optional deflate filter, chunks that do not shrink are stored without it
+    int deflateIndex = options.Filter == IMFDream3dWriter::Compression::ShuffleDeflate ? 1 : 0;
+    chunk.filterMask = 1u << deflateIndex;
+    chunk.data = raw;
+    chunk.offset = 0;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t writeChunk(hid_t datasetId, const Chunk& chunk, const ChunkLayout& layout)
+{
+  std::vector<hsize_t> offset(layout.dims.size(), 0);
+  size_t outerIndex = chunk.index / layout.innerCount;
+  for(size_t axis = layout.splitAxis; axis > 0; axis--)
+  {
+    offset[axis - 1] = static_cast<hsize_t>(outerIndex % layout.dims[axis - 1]);
+    outerIndex /= static_cast<size_t>(layout.dims[axis - 1]);
+  }
+  offset[layout.splitAxis] = static_cast<hsize_t>(chunk.index % layout.innerCount) * layout.chunkDims[layout.splitAxis];
+
+  return H5Dwrite_chunk(datasetId, H5P_DEFAULT, chunk.filterMask, offset.data(), static_cast<size_t>(chunk.data.size() - chunk.offset), chunk.data.constData() + chunk.offset);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int writeChunkedArray(hid_t amGroupId, const IDataArray::Pointer& data, hid_t typeId, const std::vector<size_t>& tupleDims, const IMFDream3dWriter::Options& options, WriteProgress& progress)
+{
+  std::vector<size_t> compDims = data->getComponentDimensions();
+  std::vector<hsize_t> dims(tupleDims.rbegin(), tupleDims.rend());
+  dims.insert(dims.end(), compDims.begin(), compDims.end());
+  size_t typeSize = static_cast<size_t>(data->getTypeSize());
+  ChunkLayout layout = computeLayout(dims, typeSize);
+
+  // HDF5 is locked around each group of calls, so other pipelines can use it while chunks are compressed
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t spaceId = H5Screate_simple(static_cast<int>(dims.size()), dims.data(), nullptr);
+  hid_t plistId = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(plistId, static_cast<int>(layout.chunkDims.size()), layout.chunkDims.data());
+  if(options.Filter == IMFDream3dWriter::Compression::ShuffleDeflate)
+  {
+    H5Pset_shuffle(plistId);
+  }
+  if(options.Filter != IMFDream3dWriter::Compression::None)
+  {
+    H5Pset_deflate(plistId, static_cast<unsigned>(options.Level));
+  }
+  hid_t datasetId = H5Dcreate(amGroupId, data->getName().toLatin1().constData(), typeId, spaceId, H5P_DEFAULT, plistId, H5P_DEFAULT);
+  H5Pclose(plistId);
+  H5Sclose(spaceId);
+  if(datasetId < 0)
+  {
+    return IMFDream3dWriter::k_WriteError;
+  }
+
+  std::vector<uint64_t> compDimsAttr(compDims.begin(), compDims.end());
+  std::vector<uint64_t> tupleDimsAttr(tupleDims.begin(), tupleDims.end());
+  std::vector<int32_t> arrayVersion = {2};
+  writeVectorAttribute(datasetId, SIMPL::HDF5::ComponentDimensions, H5T_NATIVE_UINT64, compDimsAttr);
+  writeVectorAttribute(datasetId, SIMPL::HDF5::DataArrayVersion, H5T_NATIVE_INT32, arrayVersion);
+  writeStringAttribute(datasetId, SIMPL::HDF5::ObjectType, data->getNameOfClass());
+  writeVectorAttribute(datasetId, SIMPL::HDF5::TupleDimensions, H5T_NATIVE_UINT64, tupleDimsAttr);
+  hdf5Locker.unlock();
+
+  // The next batch is compressed on the thread pool while the current one is written
+  const char* buffer = static_cast<const char*>(data->getVoidPointer(0));
+  size_t chunkCount = layout.outerCount * layout.innerCount;
+  size_t batchSize = static_cast<size_t>(std::max(1, QThread::idealThreadCount() * k_ChunksPerThread));
+  std::vector<Chunk> batches[2];
+  auto startBatch = [&](std::vector<Chunk>& batch, size_t first) {
+    batch.resize(std::min(batchSize, chunkCount - first));
+    for(size_t i = 0; i < batch.size(); i++)
+    {
+      batch[i] = Chunk();
+      batch[i].index = first + i;
+    }
+    return QtConcurrent::map(batch, [&](Chunk& chunk) { encodeChunk(chunk, buffer, layout, typeSize, options); });
+  };
+
+  int err = 0;
+  int current = 0;
+  QFuture<void> encoding = startBatch(batches[current], 0);
+  for(size_t first = 0; first < chunkCount; first += batchSize)
+  {
+    encoding.waitForFinished();
+    if(first + batchSize < chunkCount)
+    {
+      encoding = startBatch(batches[1 - current], first + batchSize);
+    }
+
+    qint64 batchBytes = 0;
+    hdf5Locker.relock();
+    for(const Chunk& chunk : batches[current])
+    {
+      if(writeChunk(datasetId, chunk, layout) < 0)
+      {
+        err = IMFDream3dWriter::k_WriteError;
+        break;
+      }
+      batchBytes += static_cast<qint64>(chunk.bytes);
+    }
+    hdf5Locker.unlock();
+    batches[current].clear();
+
+    if(err >= 0 && !progress.advance(batchBytes))
+    {
+      err = IMFDream3dWriter::k_CanceledError;
+    }
+    if(err < 0)
+    {
+      encoding.waitForFinished();
+      break;
+    }
+    current = 1 - current;
+  }
+
+  hdf5Locker.relock();
+  H5Dclose(datasetId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int writeAttributeMatrix(hid_t dcGroupId, const AttributeMatrix::Pointer& am, const IMFDream3dWriter::Options& options, WriteProgress& progress)
+{
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t amGroupId = H5Gcreate(dcGroupId, am->getName().toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if(amGroupId < 0)
+  {
+    return IMFDream3dWriter::k_WriteError;
+  }
+
+  std::vector<size_t> tupleDims = am->getTupleDimensions();
+  std::vector<uint64_t> tupleDimsAttr(tupleDims.begin(), tupleDims.end());
+  std::vector<uint32_t> amType = {static_cast<uint32_t>(am->getType())};
+  writeVectorAttribute(amGroupId, SIMPL::StringConstants::AttributeMatrixType, H5T_NATIVE_UINT32, amType);
+  writeVectorAttribute(amGroupId, SIMPL::HDF5::TupleDimensions, H5T_NATIVE_UINT64, tupleDimsAttr);
+  hdf5Locker.unlock();
+
+  int err = 0;
+  for(const QString& arrayName : am->getAttributeArrayNames())
+  {
+    IDataArray::Pointer data = am->getAttributeArray(arrayName);
+    if(!data)
+    {
+      continue;
+    }
+
+    hid_t typeId = nativeType(data);
+    qint64 bytes = static_cast<qint64>(data->getNumberOfTuples()) * data->getNumberOfComponents() * data->getTypeSize();
+    if(typeId >= 0 && bytes > 0)
+    {
+      err = writeChunkedArray(amGroupId, data, typeId, tupleDims, options, progress);
+    }
+    else
+    {
+      // Strings, booleans and neighbor lists are small enough for SIMPL's own writer
+      hdf5Locker.relock();
+      err = data->writeH5Data(amGroupId, tupleDims) < 0 ? IMFDream3dWriter::k_WriteError : 0;
+      hdf5Locker.unlock();
+      if(err >= 0 && !progress.advance(bytes))
+      {
+        err = IMFDream3dWriter::k_CanceledError;
+      }
+    }
+
+    if(err < 0)
+    {
+      break;
+    }
+  }
+
+  hdf5Locker.relock();
+  H5Gclose(amGroupId);
+  return err;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFDream3dWriter::IMFDream3dWriter(QObject* parent)
+: QObject(parent)
+, m_Canceled(false)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFDream3dWriter::~IMFDream3dWriter()
+{
+  if(m_Watcher != nullptr)
+  {
+    m_Canceled = true;
+    m_Watcher->waitForFinished();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFDream3dWriter::WriteFile(const QString& filePath, const std::vector<DataContainer::Pointer>& dataContainers, const Options& options, const ProgressFunction& progress)
+{
+  if(dataContainers.empty())
+  {
+    return k_NoDataError;
+  }
+
+  WriteProgress writeProgress;
+  writeProgress.function = progress;
+  for(const DataContainer::Pointer& dc : dataContainers)
+  {
+    for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+    {
+      for(const QString& arrayName : am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer data = am->getAttributeArray(arrayName);
+        if(data)
+        {
+          writeProgress.totalBytes += static_cast<qint64>(data->getNumberOfTuples()) * data->getNumberOfComponents() * data->getTypeSize();
+        }
+      }
+    }
+  }
+
+  // An existing file is only replaced once the new one is complete
+  QString partialFilePath = filePath + ".part";
+  // HDF5 is held by IMFHdf5Lock around each group of calls but not while arrays are compressed
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t fileId = H5Fcreate(partialFilePath.toLocal8Bit().constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    return k_CreateFileError;
+  }
+
+  writeStringAttribute(fileId, SIMPL::HDF5::FileVersionName, SIMPL::HDF5::FileVersion);
+
+  int err = 0;
+  hid_t dcaGroupId = H5Gcreate(fileId, SIMPL::StringConstants::DataContainerGroupName.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  hdf5Locker.unlock();
+  for(const DataContainer::Pointer& dc : dataContainers)
+  {
+    hdf5Locker.relock();
+    hid_t dcGroupId = H5Gcreate(dcaGroupId, dc->getName().toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if(dcGroupId < 0 || (dc->getGeometry() && dc->writeMeshToHDF5(dcGroupId, false) < 0))
+    {
+      err = k_WriteError;
+    }
+    hdf5Locker.unlock();
+
+    for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+    {
+      if(err < 0)
+      {
+        break;
+      }
+      err = writeAttributeMatrix(dcGroupId, am, options, writeProgress);
+    }
+
+    hdf5Locker.relock();
+    if(dcGroupId >= 0)
+    {
+      H5Gclose(dcGroupId);
+    }
+    hdf5Locker.unlock();
+    if(err < 0)
+    {
+      break;
+    }
+  }
+
+  hdf5Locker.relock();
+  H5Gclose(dcaGroupId);
+
+  hid_t bundleGroupId = H5Gcreate(fileId, SIMPL::StringConstants::DataContainerBundleGroupName.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Gclose(bundleGroupId);
+
+  if(err >= 0 && WritePipelineGroup(fileId) < 0)
+  {
+    err = k_WriteError;
+  }
+
+  if(H5Fclose(fileId) < 0 && err >= 0)
+  {
+    err = k_WriteError;
+  }
+  hdf5Locker.unlock();
+
+  if(err >= 0)
+  {
+    QFile::remove(filePath);
+    if(!QFile::rename(partialFilePath, filePath))
+    {
+      err = k_WriteError;
+    }
+  }
+  if(err < 0)
+  {
+    QFile::remove(partialFilePath);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFDream3dWriter::WritePipelineGroup(hid_t fileId)
+{
+  // The layout DataContainerWriter uses: a version 2 pipeline stored as JSON, here without filters
+  QJsonObject builderObject;
+  builderObject["Name"] = QString("IMF Viewer");
+  builderObject["Number_Filters"] = 0;
+  builderObject["Version"] = 6;
+  QJsonObject pipelineObject;
+  pipelineObject["PipelineBuilder"] = builderObject;
+  QString pipelineJson = QString::fromUtf8(QJsonDocument(pipelineObject).toJson(QJsonDocument::Compact));
+
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t pipelineGroupId = H5Gcreate(fileId, SIMPL::StringConstants::PipelineGroupName.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if(pipelineGroupId < 0)
+  {
+    return k_WriteError;
+  }
+
+  int32_t pipelineVersion = 2;
+  hid_t spaceId = H5Screate(H5S_SCALAR);
+  hid_t attrId = H5Acreate(pipelineGroupId, SIMPL::StringConstants::PipelineVersionName.toLatin1().constData(), H5T_NATIVE_INT32, spaceId, H5P_DEFAULT, H5P_DEFAULT);
+  herr_t err = H5Awrite(attrId, H5T_NATIVE_INT32, &pipelineVersion);
+  H5Aclose(attrId);
+  H5Sclose(spaceId);
+  if(err >= 0)
+  {
+    err = writeStringAttribute(pipelineGroupId, SIMPL::StringConstants::PipelineGroupName, pipelineJson);
+  }
+
+  H5Gclose(pipelineGroupId);
+  return err < 0 ? k_WriteError : 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFDream3dWriter::save(const QString& filePath, const std::vector<DataContainer::Pointer>& dataContainers, const Options& options)
+{
+  if(isSaving())
+  {
+    return false;
+  }
+
+  m_Canceled = false;
+  m_Watcher = new QFutureWatcher<int>(this);
+  connect(m_Watcher, &QFutureWatcher<int>::finished, this, [=] {
+    int err = m_Watcher->result();
+    m_Watcher->deleteLater();
+    m_Watcher = nullptr;
+    emit saveFinished(filePath, err);
+  });
+
+  m_Watcher->setFuture(QtConcurrent::run([=]() {
+    IMFTraceSpan span(tr("Save %1").arg(QFileInfo(filePath).fileName()), IMFTrace::PipelineCategory);
+    span.setArg("Data Containers", static_cast<int>(dataContainers.size()));
+    span.setArg("Compression", static_cast<int>(options.Filter));
+    return WriteFile(filePath, dataContainers, options, [this, lastPercent = -1](int percent) mutable {
+      if(percent != lastPercent)
+      {
+        lastPercent = percent;
+        emit progressChanged(percent);
+      }
+      return !m_Canceled;
+    });
+  }));
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFDream3dWriter::cancel()
+{
+  m_Canceled = true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFDream3dWriter::isSaving() const
+{
+  return m_Watcher != nullptr;
+}
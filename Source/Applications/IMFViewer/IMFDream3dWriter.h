@@ -0,0 +1,138 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+/**
+ * @brief The IMFDream3dWriter class writes data containers to a .dream3d file on a worker
+ * thread.  Numeric arrays are stored in chunks of about a megabyte that are compressed on
+ * every core and handed to HDF5 already filtered, so compression no longer runs one chunk
+ * at a time inside the HDF5 write.  The file is written next to the destination and only
+ * replaces it once it is complete, so canceling a save leaves an existing file untouched.
+ * HDF5 calls hold IMFHdf5Lock, which is released while chunks are compressed.
+ */
+class IMFDream3dWriter : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFDream3dWriter(QObject* parent = nullptr);
+  ~IMFDream3dWriter() override;
+
+  static const int k_CreateFileError = -89030;
+  static const int k_WriteError = -89031;
+  static const int k_CanceledError = -89032;
+  static const int k_NoDataError = -89033;
+
+  enum class Compression : int
+  {
+    None,
+    Deflate,
+    ShuffleDeflate
+  };
+
+  struct Options
+  {
+    Compression Filter = Compression::ShuffleDeflate;
+    int Level = 4;
+  };
+
+  // Receives the percentage written after each batch of chunks and returns false to cancel the write
+  using ProgressFunction = std::function<bool(int)>;
+
+  /**
+   * @brief Writes the data containers to the file.  Arrays of types HDF5 can filter are
+   * chunked and compressed with the options; other arrays are written by SIMPL unchanged.
+   * @param filePath
+   * @param dataContainers
+   * @param options
+   * @param progress
+   * @return
+   */
+  static int WriteFile(const QString& filePath, const std::vector<DataContainer::Pointer>& dataContainers, const Options& options, const ProgressFunction& progress = ProgressFunction());
+
+  /**
+   * @brief Writes the Pipeline group DataContainerReader reads with every .dream3d file.
+   * The stored pipeline has no filters.
+   * @param fileId
+   * @return
+   */
+  static int WritePipelineGroup(hid_t fileId);
+
+  /**
+   * @brief Starts writing the data containers on a worker thread.  saveFinished is emitted
+   * when the file has been written, has failed or was canceled.
+   * @param filePath
+   * @param dataContainers
+   * @param options
+   * @return false if a save is already running
+   */
+  bool save(const QString& filePath, const std::vector<DataContainer::Pointer>& dataContainers, const Options& options);
+
+  /**
+   * @brief Cancels the running save
+   */
+  void cancel();
+
+  /**
+   * @brief Returns true while a save is running
+   * @return
+   */
+  bool isSaving() const;
+
+signals:
+  void progressChanged(int percent);
+  void saveFinished(const QString& filePath, int err);
+
+private:
+  QFutureWatcher<int>* m_Watcher = nullptr;
+  std::atomic<bool> m_Canceled;
+
+  IMFDream3dWriter(const IMFDream3dWriter&); // Copy Constructor Not Implemented
+  void operator=(const IMFDream3dWriter&);   // Operator '=' Not Implemented
+};
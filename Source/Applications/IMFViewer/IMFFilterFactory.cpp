@@ -0,0 +1,245 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFFilterFactory.h"
+
+#include <utility>
+#include <vector>
+
+#include <QtCore/QDebug>
+
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Filtering/IFilterFactory.hpp"
+
+namespace
+{
+using PropertyList = std::vector<std::pair<const char*, QVariant>>;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+QVariant toVariant(const T& value)
+{
+  QVariant var;
+  var.setValue(value);
+  return var;
+}
+
+// -----------------------------------------------------------------------------
+// Creates the filter and sets the properties in order.  A property the filter does not
+// declare would be added as a dynamic property and silently ignored, so it is an error.
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer createFilter(const QString& className, const PropertyList& properties)
+{
+  AbstractFilter::Pointer filter = IMFFilterFactory::CreateFilter(className);
+  if(!filter)
+  {
+    return AbstractFilter::NullPointer();
+  }
+
+  for(const auto& property : properties)
+  {
+    if(!filter->setProperty(property.first, property.second))
+    {
+      qWarning().noquote() << QObject::tr("The property '%1' of the filter '%2' could not be set.").arg(property.first, className);
+      return AbstractFilter::NullPointer();
+    }
+  }
+
+  return filter;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateFilter(const QString& className)
+{
+  IFilterFactory::Pointer factory = FilterManager::Instance()->getFactoryFromClassName(className);
+  if(!factory)
+  {
+    qWarning().noquote() << QObject::tr("The filter '%1' is not available.  Check that the plugin that provides it is loaded.").arg(className);
+    return AbstractFilter::NullPointer();
+  }
+
+  return factory->create();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateDataContainerReaderFilter(const QString& inputFile, const DataContainerArrayProxy& proxy)
+{
+  return createFilter("DataContainerReader", {{"InputFile", inputFile}, {"InputFileDataContainerArrayProxy", toVariant(proxy)}, {"OverwriteExistingDataContainers", true}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateSetOriginResolutionFilter(const DataArrayPath& dcPath, bool changeSpacing, bool changeOrigin, const FloatVec3Type& spacing,
+                                                                          const FloatVec3Type& origin)
+{
+  return createFilter("SetOriginResolutionImageGeom", {{"DataContainerName", toVariant(dcPath)},
+                                                       {"ChangeResolution", changeSpacing},
+                                                       {"Spacing", toVariant(spacing)},
+                                                       {"ChangeOrigin", changeOrigin},
+                                                       {"Origin", toVariant(origin)}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreatePCMTileRegistrationFilter(const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& dcPrefix, const QString& amName,
+                                                                          const QString& daName)
+{
+  return createFilter("ITKPCMTileRegistration", {{"MontageStart", toVariant(montageStart)},
+                                                 {"MontageEnd", toVariant(montageEnd)},
+                                                 {"DataContainerPrefix", dcPrefix},
+                                                 {"CommonAttributeMatrixName", amName},
+                                                 {"CommonDataArrayName", daName}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateTileStitchingFilter(const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& dcPrefix, const QString& amName,
+                                                                    const QString& daName, const DataArrayPath& montagePath)
+{
+  return createFilter("ITKStitchMontage", {{"MontageStart", toVariant(montageStart)},
+                                           {"MontageEnd", toVariant(montageEnd)},
+                                           {"DataContainerPrefix", dcPrefix},
+                                           {"CommonAttributeMatrixName", amName},
+                                           {"CommonDataArrayName", daName},
+                                           {"MontageDataContainerName", montagePath.getDataContainerName()},
+                                           {"MontageAttributeMatrixName", montagePath.getAttributeMatrixName()},
+                                           {"MontageDataArrayName", montagePath.getDataArrayName()}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateImportFijiMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName, bool changeOrigin,
+                                                                        const FloatVec3Type& origin, const IntVec2Type& montageStart, const IntVec2Type& montageEnd, bool changeSpacing,
+                                                                        const FloatVec3Type& spacing, int32_t lengthUnit)
+{
+  return createFilter("ITKImportFijiMontage", {{"InputFile", inputFile},
+                                               {"MontageStart", toVariant(montageStart)},
+                                               {"MontageEnd", toVariant(montageEnd)},
+                                               {"DataContainerPath", toVariant(dcPath)},
+                                               {"CellAttributeMatrixName", amName},
+                                               {"AttributeArrayName", daName},
+                                               {"ChangeOrigin", changeOrigin},
+                                               {"Origin", toVariant(origin)},
+                                               {"ChangeSpacing", changeSpacing},
+                                               {"Spacing", toVariant(spacing)},
+                                               {"LengthUnit", lengthUnit}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateImportRobometMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName, int slice,
+                                                                           const QString& imagePrefix, const QString& imageExtension, bool changeOrigin, const FloatVec3Type& origin,
+                                                                           const IntVec2Type& montageStart, const IntVec2Type& montageEnd, bool changeSpacing, const FloatVec3Type& spacing,
+                                                                           int32_t lengthUnit)
+{
+  return createFilter("ITKImportRoboMetMontage", {{"InputFile", inputFile},
+                                                  {"DataContainerPath", toVariant(dcPath)},
+                                                  {"CellAttributeMatrixName", amName},
+                                                  {"AttributeArrayName", daName},
+                                                  {"SliceNumber", slice},
+                                                  {"ImageFilePrefix", imagePrefix},
+                                                  {"ImageFileExtension", imageExtension},
+                                                  {"MontageStart", toVariant(montageStart)},
+                                                  {"MontageEnd", toVariant(montageEnd)},
+                                                  {"ChangeOrigin", changeOrigin},
+                                                  {"Origin", toVariant(origin)},
+                                                  {"ChangeSpacing", changeSpacing},
+                                                  {"Spacing", toVariant(spacing)},
+                                                  {"LengthUnit", lengthUnit}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateImportZeissMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName,
+                                                                         const QString& metadataAMName, bool importAllMetadata, bool convertToGrayscale, const FloatVec3Type& colorWeights,
+                                                                         bool changeOrigin, const FloatVec3Type& origin, const IntVec2Type& montageStart, const IntVec2Type& montageEnd,
+                                                                         bool changeSpacing, const FloatVec3Type& spacing)
+{
+  return createFilter("ImportAxioVisionV4Montage", {{"InputFile", inputFile},
+                                                    {"DataContainerPath", toVariant(dcPath)},
+                                                    {"CellAttributeMatrixName", amName},
+                                                    {"ImageDataArrayName", daName},
+                                                    {"MetaDataAttributeMatrixName", metadataAMName},
+                                                    {"ImportAllMetaData", importAllMetadata},
+                                                    {"ConvertToGrayScale", convertToGrayscale},
+                                                    {"ColorWeights", toVariant(colorWeights)},
+                                                    {"ChangeOrigin", changeOrigin},
+                                                    {"Origin", toVariant(origin)},
+                                                    {"ChangeSpacing", changeSpacing},
+                                                    {"Spacing", toVariant(spacing)},
+                                                    {"MontageStart", toVariant(montageStart)},
+                                                    {"MontageEnd", toVariant(montageEnd)}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateImportZeissZenMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName,
+                                                                            bool convertToGrayscale, const FloatVec3Type& colorWeights, bool changeOrigin, const FloatVec3Type& origin,
+                                                                            const IntVec2Type& montageStart, const IntVec2Type& montageEnd)
+{
+  return createFilter("ImportZenInfoMontage", {{"InputFile", inputFile},
+                                               {"DataContainerPath", toVariant(dcPath)},
+                                               {"CellAttributeMatrixName", amName},
+                                               {"ImageDataArrayName", daName},
+                                               {"ConvertToGrayScale", convertToGrayscale},
+                                               {"ColorWeights", toVariant(colorWeights)},
+                                               {"ChangeOrigin", changeOrigin},
+                                               {"Origin", toVariant(origin)},
+                                               {"MontageStart", toVariant(montageStart)},
+                                               {"MontageEnd", toVariant(montageEnd)}});
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer IMFFilterFactory::CreateImageFileWriterFilter(const QString& outputFile, const DataArrayPath& imageArrayPath)
+{
+  return createFilter("ITKImageWriter", {{"FileName", outputFile}, {"ImageArrayPath", toVariant(imageArrayPath)}});
+}
@@ -0,0 +1,200 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QString>
+#include <QtCore/QVariant>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArrayProxy.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The IMFFilterFactory class creates the SIMPL filters of the montage pipelines
+ * from the FilterManager by class name and sets their properties.  It only depends on
+ * SIMPLib so that IMFViewerBatch does not need SIMPLVtkLib unless it renders.  Every
+ * function returns a null pointer when the filter's plugin is not loaded or a property
+ * cannot be set.  The functions do not share any state and may be called from any thread.
+ */
+class IMFFilterFactory
+{
+public:
+  /**
+   * @brief Creates a filter by class name
+   * @param className
+   * @return
+   */
+  static AbstractFilter::Pointer CreateFilter(const QString& className);
+
+  /**
+   * @brief Creates a DataContainerReader that reads the checked items of the proxy
+   * @param inputFile
+   * @param proxy
+   * @return
+   */
+  static AbstractFilter::Pointer CreateDataContainerReaderFilter(const QString& inputFile, const DataContainerArrayProxy& proxy);
+
+  /**
+   * @brief Creates a filter that sets the origin and spacing of an image geometry
+   * @param dcPath
+   * @param changeSpacing
+   * @param changeOrigin
+   * @param spacing
+   * @param origin
+   * @return
+   */
+  static AbstractFilter::Pointer CreateSetOriginResolutionFilter(const DataArrayPath& dcPath, bool changeSpacing, bool changeOrigin, const FloatVec3Type& spacing, const FloatVec3Type& origin);
+
+  /**
+   * @brief Creates the phase correlation tile registration filter
+   * @param montageStart
+   * @param montageEnd
+   * @param dcPrefix
+   * @param amName
+   * @param daName
+   * @return
+   */
+  static AbstractFilter::Pointer CreatePCMTileRegistrationFilter(const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& dcPrefix, const QString& amName,
+                                                                 const QString& daName);
+
+  /**
+   * @brief Creates the tile stitching filter
+   * @param montageStart
+   * @param montageEnd
+   * @param dcPrefix
+   * @param amName
+   * @param daName
+   * @param montagePath
+   * @return
+   */
+  static AbstractFilter::Pointer CreateTileStitchingFilter(const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& dcPrefix, const QString& amName, const QString& daName,
+                                                           const DataArrayPath& montagePath);
+
+  /**
+   * @brief Creates the Fiji montage import filter
+   * @param inputFile
+   * @param dcPath
+   * @param amName
+   * @param daName
+   * @param changeOrigin
+   * @param origin
+   * @param montageStart
+   * @param montageEnd
+   * @param changeSpacing
+   * @param spacing
+   * @param lengthUnit
+   * @return
+   */
+  static AbstractFilter::Pointer CreateImportFijiMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName, bool changeOrigin,
+                                                               const FloatVec3Type& origin, const IntVec2Type& montageStart, const IntVec2Type& montageEnd, bool changeSpacing,
+                                                               const FloatVec3Type& spacing, int32_t lengthUnit);
+
+  /**
+   * @brief Creates the Robomet montage import filter for one slice
+   * @param inputFile
+   * @param dcPath
+   * @param amName
+   * @param daName
+   * @param slice
+   * @param imagePrefix
+   * @param imageExtension
+   * @param changeOrigin
+   * @param origin
+   * @param montageStart
+   * @param montageEnd
+   * @param changeSpacing
+   * @param spacing
+   * @param lengthUnit
+   * @return
+   */
+  static AbstractFilter::Pointer CreateImportRobometMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName, int slice,
+                                                                  const QString& imagePrefix, const QString& imageExtension, bool changeOrigin, const FloatVec3Type& origin,
+                                                                  const IntVec2Type& montageStart, const IntVec2Type& montageEnd, bool changeSpacing, const FloatVec3Type& spacing,
+                                                                  int32_t lengthUnit);
+
+  /**
+   * @brief Creates the Zeiss AxioVision montage import filter
+   * @param inputFile
+   * @param dcPath
+   * @param amName
+   * @param daName
+   * @param metadataAMName
+   * @param importAllMetadata
+   * @param convertToGrayscale
+   * @param colorWeights
+   * @param changeOrigin
+   * @param origin
+   * @param montageStart
+   * @param montageEnd
+   * @param changeSpacing
+   * @param spacing
+   * @return
+   */
+  static AbstractFilter::Pointer CreateImportZeissMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName, const QString& metadataAMName,
+                                                                bool importAllMetadata, bool convertToGrayscale, const FloatVec3Type& colorWeights, bool changeOrigin, const FloatVec3Type& origin,
+                                                                const IntVec2Type& montageStart, const IntVec2Type& montageEnd, bool changeSpacing, const FloatVec3Type& spacing);
+
+  /**
+   * @brief Creates the Zeiss Zen montage import filter
+   * @param inputFile
+   * @param dcPath
+   * @param amName
+   * @param daName
+   * @param convertToGrayscale
+   * @param colorWeights
+   * @param changeOrigin
+   * @param origin
+   * @param montageStart
+   * @param montageEnd
+   * @return
+   */
+  static AbstractFilter::Pointer CreateImportZeissZenMontageFilter(const QString& inputFile, const DataArrayPath& dcPath, const QString& amName, const QString& daName, bool convertToGrayscale,
+                                                                   const FloatVec3Type& colorWeights, bool changeOrigin, const FloatVec3Type& origin, const IntVec2Type& montageStart,
+                                                                   const IntVec2Type& montageEnd);
+
+  /**
+   * @brief Creates a filter that writes the image array to an image file
+   * @param outputFile
+   * @param imageArrayPath
+   * @return
+   */
+  static AbstractFilter::Pointer CreateImageFileWriterFilter(const QString& outputFile, const DataArrayPath& imageArrayPath);
+
+private:
+  IMFFilterFactory() = delete;
+};
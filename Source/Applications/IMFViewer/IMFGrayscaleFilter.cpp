@@ -0,0 +1,415 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFGrayscaleFilter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <QtConcurrent>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMF_GRAYSCALE_SSE2
+#include <emmintrin.h>
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define IMF_GRAYSCALE_AVX2
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define IMF_TARGET_AVX2
+#else
+#define IMF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+#endif
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Pixels whose four bytes starting at the pixel can be loaded without reading past the array
+// -----------------------------------------------------------------------------
+size_t wordSafeCount(size_t numComps, size_t count)
+{
+  if(numComps >= 4 || count == 0)
+  {
+    return count;
+  }
+  return count - 1;
+}
+
+// -----------------------------------------------------------------------------
+// Clamps before rounding so every path gives the same result for out of range sums
+// -----------------------------------------------------------------------------
+void convertScalar(const uint8_t* src, size_t numComps, size_t first, size_t last, const FloatVec3Type& weights, uint8_t* dst)
+{
+  for(size_t i = first; i < last; i++)
+  {
+    const uint8_t* pixel = src + i * numComps;
+    float value = static_cast<float>(pixel[0]) * weights[0] + static_cast<float>(pixel[1]) * weights[1];
+    value = value + static_cast<float>(pixel[2]) * weights[2];
+    value = std::min(std::max(value, 0.0f), 255.0f);
+    dst[i] = static_cast<uint8_t>(std::nearbyint(value));
+  }
+}
+
+#if defined(IMF_GRAYSCALE_SSE2)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+size_t convertSse2(const uint8_t* src, size_t numComps, size_t count, const FloatVec3Type& weights, uint8_t* dst)
+{
+  const __m128i byteMask = _mm_set1_epi32(0xff);
+  const __m128 weightR = _mm_set1_ps(weights[0]);
+  const __m128 weightG = _mm_set1_ps(weights[1]);
+  const __m128 weightB = _mm_set1_ps(weights[2]);
+  const __m128 minValue = _mm_setzero_ps();
+  const __m128 maxValue = _mm_set1_ps(255.0f);
+
+  size_t safeCount = wordSafeCount(numComps, count);
+  size_t i = 0;
+  for(; i + 4 <= safeCount; i += 4)
+  {
+    int32_t words[4];
+    for(size_t k = 0; k < 4; k++)
+    {
+      std::memcpy(&words[k], src + (i + k) * numComps, sizeof(int32_t));
+    }
+    __m128i pixels = _mm_setr_epi32(words[0], words[1], words[2], words[3]);
+    __m128 r = _mm_cvtepi32_ps(_mm_and_si128(pixels, byteMask));
+    __m128 g = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 8), byteMask));
+    __m128 b = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(pixels, 16), byteMask));
+    __m128 value = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r, weightR), _mm_mul_ps(g, weightG)), _mm_mul_ps(b, weightB));
+    value = _mm_min_ps(_mm_max_ps(value, minValue), maxValue);
+    __m128i gray = _mm_cvtps_epi32(value);
+    gray = _mm_packs_epi32(gray, gray);
+    gray = _mm_packus_epi16(gray, gray);
+    int32_t packed = _mm_cvtsi128_si32(gray);
+    std::memcpy(dst + i, &packed, sizeof(int32_t));
+  }
+  return i;
+}
+#endif
+
+#if defined(IMF_GRAYSCALE_AVX2)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool hasAvx2()
+{
+#if defined(_MSC_VER)
+  int info[4];
+  __cpuid(info, 0);
+  if(info[0] < 7)
+  {
+    return false;
+  }
+  // AVX state must also be enabled by the operating system
+  __cpuid(info, 1);
+  if((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+  {
+    return false;
+  }
+  __cpuidex(info, 7, 0);
+  return (info[1] & (1 << 5)) != 0;
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMF_TARGET_AVX2 size_t convertAvx2(const uint8_t* src, size_t numComps, size_t count, const FloatVec3Type& weights, uint8_t* dst)
+{
+  const __m256i byteMask = _mm256_set1_epi32(0xff);
+  const __m256 weightR = _mm256_set1_ps(weights[0]);
+  const __m256 weightG = _mm256_set1_ps(weights[1]);
+  const __m256 weightB = _mm256_set1_ps(weights[2]);
+  const __m256 minValue = _mm256_setzero_ps();
+  const __m256 maxValue = _mm256_set1_ps(255.0f);
+  const int stride = static_cast<int>(numComps);
+  const __m256i offsets = _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+
+  // After packing, the four bytes of each 128-bit lane are gathered into the low eight bytes
+  const __m256i lanePermutation = _mm256_setr_epi32(0, 4, 0, 4, 0, 4, 0, 4);
+
+  size_t safeCount = wordSafeCount(numComps, count);
+  size_t i = 0;
+  for(; i + 8 <= safeCount; i += 8)
+  {
+    __m256i pixels = _mm256_i32gather_epi32(reinterpret_cast<const int*>(src + i * numComps), offsets, 1);
+    __m256 r = _mm256_cvtepi32_ps(_mm256_and_si256(pixels, byteMask));
+    __m256 g = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), byteMask));
+    __m256 b = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), byteMask));
+    __m256 value = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(r, weightR), _mm256_mul_ps(g, weightG)), _mm256_mul_ps(b, weightB));
+    value = _mm256_min_ps(_mm256_max_ps(value, minValue), maxValue);
+    __m256i gray = _mm256_cvtps_epi32(value);
+    gray = _mm256_packs_epi32(gray, gray);
+    gray = _mm256_packus_epi16(gray, gray);
+    gray = _mm256_permutevar8x32_epi32(gray, lanePermutation);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm256_castsi256_si128(gray));
+  }
+  return i;
+}
+#endif
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFGrayscaleFilter::IMFGrayscaleFilter(const QString& tilePrefix, const QString& amName, const QString& daName, const FloatVec3Type& colorWeighting)
+: m_TilePrefix(tilePrefix)
+, m_AttributeMatrixName(amName)
+, m_DataArrayName(daName)
+, m_ColorWeighting(colorWeighting)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFGrayscaleFilter::~IMFGrayscaleFilter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFGrayscaleFilter::Pointer IMFGrayscaleFilter::New(const QString& tilePrefix, const QString& amName, const QString& daName, const FloatVec3Type& colorWeighting)
+{
+  Pointer sharedPtr(new IMFGrayscaleFilter(tilePrefix, amName, daName, colorWeighting));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFGrayscaleFilter::IsKernelAvailable(Kernel kernel)
+{
+  switch(kernel)
+  {
+  case Kernel::Automatic:
+  case Kernel::Scalar:
+    return true;
+  case Kernel::SSE2:
+#if defined(IMF_GRAYSCALE_SSE2)
+    return true;
+#else
+    return false;
+#endif
+  case Kernel::AVX2:
+  {
+#if defined(IMF_GRAYSCALE_AVX2)
+    static const bool avx2 = hasAvx2();
+    return avx2;
+#else
+    return false;
+#endif
+  }
+  }
+  return false;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFGrayscaleFilter::ConvertToLuminance(const uint8_t* src, size_t numComps, size_t count, const FloatVec3Type& colorWeighting, uint8_t* dst, Kernel kernel)
+{
+  if(kernel == Kernel::Automatic)
+  {
+    kernel = IsKernelAvailable(Kernel::AVX2) ? Kernel::AVX2 : (IsKernelAvailable(Kernel::SSE2) ? Kernel::SSE2 : Kernel::Scalar);
+  }
+  else if(!IsKernelAvailable(kernel))
+  {
+    kernel = Kernel::Scalar;
+  }
+
+  size_t converted = 0;
+#if defined(IMF_GRAYSCALE_AVX2)
+  if(kernel == Kernel::AVX2)
+  {
+    converted = convertAvx2(src, numComps, count, colorWeighting, dst);
+  }
+#endif
+#if defined(IMF_GRAYSCALE_SSE2)
+  if(kernel == Kernel::SSE2)
+  {
+    converted = convertSse2(src, numComps, count, colorWeighting, dst);
+  }
+#endif
+  convertScalar(src, numComps, converted, count, colorWeighting, dst);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFGrayscaleFilter::ConvertTile(const DataContainer::Pointer& tileDC, const QString& amName, const QString& daName, const FloatVec3Type& colorWeighting)
+{
+  AttributeMatrix::Pointer am = tileDC ? tileDC->getAttributeMatrix(amName) : AttributeMatrix::NullPointer();
+  IDataArray::Pointer data = am ? am->getAttributeArray(daName) : IDataArray::NullPointer();
+  if(!data || data->getNumberOfComponents() == 1)
+  {
+    return 0;
+  }
+
+  UInt8ArrayType::Pointer color = std::dynamic_pointer_cast<UInt8ArrayType>(data);
+  if(!color || color->getNumberOfComponents() < 3)
+  {
+    return k_UnsupportedTypeError;
+  }
+
+  size_t numTuples = color->getNumberOfTuples();
+  std::vector<size_t> cDims(1, 1);
+  UInt8ArrayType::Pointer gray = UInt8ArrayType::CreateArray(numTuples, cDims, daName, true);
+  if(!gray)
+  {
+    return k_AllocationError;
+  }
+
+  ConvertToLuminance(color->getPointer(0), static_cast<size_t>(color->getNumberOfComponents()), numTuples, colorWeighting, gray->getPointer(0));
+  am->addOrReplaceAttributeArray(gray);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFGrayscaleFilter::getNameOfClass() const
+{
+  return QString("IMFGrayscaleFilter");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFGrayscaleFilter::getHumanLabel() const
+{
+  return QString("Convert Montage Tiles To Grayscale");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFGrayscaleFilter::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+
+  DataContainerArray::Pointer dca = getDataContainerArray();
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    if(!dc->getName().startsWith(m_TilePrefix) || !dc->getGeometryAs<ImageGeom>())
+    {
+      continue;
+    }
+
+    AttributeMatrix::Pointer am = dc->getAttributeMatrix(m_AttributeMatrixName);
+    IDataArray::Pointer data = am ? am->getAttributeArray(m_DataArrayName) : IDataArray::NullPointer();
+    if(!data || data->getNumberOfComponents() == 1)
+    {
+      continue;
+    }
+
+    if(!std::dynamic_pointer_cast<UInt8ArrayType>(data) || data->getNumberOfComponents() < 3)
+    {
+      setErrorCondition(k_UnsupportedTypeError, tr("The tile '%1' is not an 8-bit color image and cannot be converted to grayscale.").arg(dc->getName()));
+      return;
+    }
+
+    if(getInPreflight())
+    {
+      std::vector<size_t> cDims(1, 1);
+      am->addOrReplaceAttributeArray(UInt8ArrayType::CreateArray(data->getNumberOfTuples(), cDims, m_DataArrayName, false));
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFGrayscaleFilter::preflight()
+{
+  setInPreflight(true);
+  dataCheck();
+  setInPreflight(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFGrayscaleFilter::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  // Tiles converted while they were decoded are already grayscale and are skipped
+  std::vector<DataContainer::Pointer> tiles;
+  for(const DataContainer::Pointer& dc : getDataContainerArray()->getDataContainers())
+  {
+    if(dc->getName().startsWith(m_TilePrefix) && dc->getGeometryAs<ImageGeom>())
+    {
+      tiles.push_back(dc);
+    }
+  }
+
+  // Each color array is released as soon as its tile is converted
+  std::atomic_bool allocationFailed(false);
+  QtConcurrent::blockingMap(tiles, [&](const DataContainer::Pointer& dc) {
+    if(getCancel() || allocationFailed)
+    {
+      return;
+    }
+    if(ConvertTile(dc, m_AttributeMatrixName, m_DataArrayName, m_ColorWeighting) == k_AllocationError)
+    {
+      allocationFailed = true;
+    }
+  });
+
+  if(allocationFailed)
+  {
+    setErrorCondition(k_AllocationError, tr("There is not enough memory to convert the montage tiles to grayscale."));
+  }
+}
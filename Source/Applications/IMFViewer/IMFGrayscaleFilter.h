@@ -0,0 +1,143 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The IMFGrayscaleFilter class converts the 8-bit color tiles of a montage to
+ * luminance.  Montage imports hand ConvertTile to IMFParallelTileImportFilter, which converts
+ * each tile on its decoding thread as soon as it is decoded, so only the tiles in flight are
+ * ever held in color.  The filter itself follows the import to describe the converted tiles
+ * in preflight and to convert any tile that is still in color, such as the only tile of a
+ * single tile import.
+ *
+ * The weighted sum of the red, green and blue components is computed with AVX2 or SSE2
+ * when the processor supports them, eight or four pixels at a time.  Every path rounds the
+ * same way, so the result does not depend on the processor.
+ */
+class IMFGrayscaleFilter : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(IMFGrayscaleFilter)
+
+  /**
+   * @brief Creates a filter that converts the array of every image data container whose
+   * name starts with the tile prefix
+   * @param tilePrefix
+   * @param amName
+   * @param daName
+   * @param colorWeighting Weights of the red, green and blue components
+   * @return
+   */
+  static Pointer New(const QString& tilePrefix, const QString& amName, const QString& daName, const FloatVec3Type& colorWeighting);
+
+  ~IMFGrayscaleFilter() override;
+
+  static const int k_UnsupportedTypeError = -89080;
+  static const int k_AllocationError = -89081;
+
+  // Code paths of ConvertToLuminance.  Automatic picks the fastest one the processor supports.
+  enum class Kernel : int
+  {
+    Automatic,
+    Scalar,
+    SSE2,
+    AVX2
+  };
+
+  /**
+   * @brief Returns true if the kernel was compiled in and the processor supports it
+   * @param kernel
+   * @return
+   */
+  static bool IsKernelAvailable(Kernel kernel);
+
+  /**
+   * @brief Writes the weighted sum of the first three components of each pixel, rounded to
+   * the nearest integer and clamped to 0-255.  The pixels must have at least three components.
+   * @param src
+   * @param numComps
+   * @param count Number of pixels
+   * @param colorWeighting
+   * @param dst
+   * @param kernel The kernel to use.  Pixels the kernel does not handle, and every pixel when
+   * the kernel is not available, are converted by the scalar path.
+   */
+  static void ConvertToLuminance(const uint8_t* src, size_t numComps, size_t count, const FloatVec3Type& colorWeighting, uint8_t* dst, Kernel kernel = Kernel::Automatic);
+
+  /**
+   * @brief Replaces the color array of a decoded tile with its grayscale array.  Tiles that
+   * are already grayscale are left unchanged.
+   * @param tileDC
+   * @param amName
+   * @param daName
+   * @param colorWeighting
+   * @return 0, or k_UnsupportedTypeError or k_AllocationError
+   */
+  static int ConvertTile(const DataContainer::Pointer& tileDC, const QString& amName, const QString& daName, const FloatVec3Type& colorWeighting);
+
+  QString getNameOfClass() const override;
+  QString getHumanLabel() const override;
+  void preflight() override;
+  void execute() override;
+
+protected:
+  IMFGrayscaleFilter(const QString& tilePrefix, const QString& amName, const QString& daName, const FloatVec3Type& colorWeighting);
+
+private:
+  QString m_TilePrefix;
+  QString m_AttributeMatrixName;
+  QString m_DataArrayName;
+  FloatVec3Type m_ColorWeighting;
+
+  /**
+   * @brief Replaces the color arrays of the tiles with unallocated grayscale arrays so the
+   * preflighted tiles describe the converted montage
+   */
+  void dataCheck();
+
+  IMFGrayscaleFilter(const IMFGrayscaleFilter&); // Copy Constructor Not Implemented
+  void operator=(const IMFGrayscaleFilter&);     // Operator '=' Not Implemented
+};
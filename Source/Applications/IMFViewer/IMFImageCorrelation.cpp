@@ -0,0 +1,196 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFImageCorrelation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+void sampleGray(const IMFImageCorrelation::Image& image, size_t factor, IMFImageCorrelation::GrayRegion& region)
+{
+  typename DataArray<T>::Pointer array = std::dynamic_pointer_cast<DataArray<T>>(image.data);
+  const T* src = array->getPointer(0);
+  size_t numComps = static_cast<size_t>(array->getNumberOfComponents());
+  for(long long y = 0; y < region.height; y++)
+  {
+    size_t sy0 = static_cast<size_t>(region.y0 + y) * factor;
+    size_t sy1 = std::min(sy0 + factor, image.height);
+    for(long long x = 0; x < region.width; x++)
+    {
+      size_t sx0 = static_cast<size_t>(region.x0 + x) * factor;
+      size_t sx1 = std::min(sx0 + factor, image.width);
+      double sum = 0.0;
+      for(size_t sy = sy0; sy < sy1; sy++)
+      {
+        const T* row = src + sy * image.width * numComps;
+        for(size_t i = sx0 * numComps; i < sx1 * numComps; i++)
+        {
+          sum += static_cast<double>(row[i]);
+        }
+      }
+      region.pixels[static_cast<size_t>(y * region.width + x)] = static_cast<float>(sum / static_cast<double>((sy1 - sy0) * (sx1 - sx0) * numComps));
+    }
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFImageCorrelation::IsSupportedType(const IDataArray::Pointer& data)
+{
+  return std::dynamic_pointer_cast<UInt8ArrayType>(data) || std::dynamic_pointer_cast<UInt16ArrayType>(data) || std::dynamic_pointer_cast<UInt32ArrayType>(data) ||
+         std::dynamic_pointer_cast<FloatArrayType>(data);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+long long IMFImageCorrelation::LevelSize(size_t size, size_t factor)
+{
+  return static_cast<long long>((size + factor - 1) / factor);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFImageCorrelation::GrayRegion IMFImageCorrelation::SampleGray(const Image& image, size_t factor, long long x0, long long y0, long long width, long long height)
+{
+  GrayRegion region;
+  region.x0 = std::max(x0, 0LL);
+  region.y0 = std::max(y0, 0LL);
+  region.width = std::max(std::min(x0 + width, LevelSize(image.width, factor)) - region.x0, 0LL);
+  region.height = std::max(std::min(y0 + height, LevelSize(image.height, factor)) - region.y0, 0LL);
+  region.pixels.assign(static_cast<size_t>(region.width * region.height), 0.0f);
+
+  if(std::dynamic_pointer_cast<UInt8ArrayType>(image.data))
+  {
+    sampleGray<uint8_t>(image, factor, region);
+  }
+  else if(std::dynamic_pointer_cast<UInt16ArrayType>(image.data))
+  {
+    sampleGray<uint16_t>(image, factor, region);
+  }
+  else if(std::dynamic_pointer_cast<UInt32ArrayType>(image.data))
+  {
+    sampleGray<uint32_t>(image, factor, region);
+  }
+  else if(std::dynamic_pointer_cast<FloatArrayType>(image.data))
+  {
+    sampleGray<float>(image, factor, region);
+  }
+  return region;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double IMFImageCorrelation::Correlate(const GrayRegion& a, const GrayRegion& b, long long sx, long long sy, double minOverlapFraction)
+{
+  double sumA = 0.0;
+  double sumB = 0.0;
+  double sumAA = 0.0;
+  double sumBB = 0.0;
+  double sumAB = 0.0;
+  size_t count = 0;
+
+  long long xStart = std::max(a.x0, b.x0 + sx);
+  long long xEnd = std::min(a.x0 + a.width, b.x0 + b.width + sx);
+  for(long long y = std::max(a.y0, b.y0 + sy); y < std::min(a.y0 + a.height, b.y0 + b.height + sy); y++)
+  {
+    const float* rowA = a.pixels.data() + (y - a.y0) * a.width;
+    const float* rowB = b.pixels.data() + (y - sy - b.y0) * b.width;
+    for(long long x = xStart; x < xEnd; x++)
+    {
+      double va = rowA[x - a.x0];
+      double vb = rowB[x - sx - b.x0];
+      sumA += va;
+      sumB += vb;
+      sumAA += va * va;
+      sumBB += vb * vb;
+      sumAB += va * vb;
+    }
+    count += static_cast<size_t>(std::max(xEnd - xStart, 0LL));
+  }
+
+  if(count == 0 || static_cast<double>(count) < minOverlapFraction * static_cast<double>(a.pixels.size()))
+  {
+    return -std::numeric_limits<double>::infinity();
+  }
+
+  double n = static_cast<double>(count);
+  double varA = sumAA - sumA * sumA / n;
+  double varB = sumBB - sumB * sumB / n;
+  if(varA <= 0.0 || varB <= 0.0)
+  {
+    return -std::numeric_limits<double>::infinity();
+  }
+  return (sumAB - sumA * sumB / n) / std::sqrt(varA * varB);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageCorrelation::SearchTranslation(const GrayRegion& a, const GrayRegion& b, long long radius, double minOverlapFraction, long long& sx, long long& sy)
+{
+  double bestScore = -std::numeric_limits<double>::infinity();
+  long long bestX = sx;
+  long long bestY = sy;
+  for(long long dy = -radius; dy <= radius; dy++)
+  {
+    for(long long dx = -radius; dx <= radius; dx++)
+    {
+      double score = Correlate(a, b, sx + dx, sy + dy, minOverlapFraction);
+      if(score > bestScore)
+      {
+        bestScore = score;
+        bestX = sx + dx;
+        bestY = sy + dy;
+      }
+    }
+  }
+  sx = bestX;
+  sy = bestY;
+}
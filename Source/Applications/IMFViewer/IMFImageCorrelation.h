@@ -0,0 +1,124 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "SIMPLib/DataArrays/IDataArray.h"
+
+/**
+ * @brief The IMFImageCorrelation class finds the translation between two overlapping
+ * images by normalized cross-correlation.  Images are compared as grayscale regions
+ * averaged over blocks of pixels, so a translation can be searched coarsely over a wide
+ * range and then refined one power of two at a time.
+ */
+class IMFImageCorrelation
+{
+public:
+  struct Image
+  {
+    IDataArray::Pointer data;
+    size_t width = 0;
+    size_t height = 0;
+  };
+
+  // Grayscale region of an image at one downsampling factor, in the pixels of that factor
+  struct GrayRegion
+  {
+    long long x0 = 0;
+    long long y0 = 0;
+    long long width = 0;
+    long long height = 0;
+    std::vector<float> pixels;
+  };
+
+  /**
+   * @brief Returns true if the image data is of a type that can be sampled
+   * @param data
+   * @return
+   */
+  static bool IsSupportedType(const IDataArray::Pointer& data);
+
+  /**
+   * @brief Returns the number of pixels covering an edge of the given size at the downsampling factor
+   * @param size
+   * @param factor
+   * @return
+   */
+  static long long LevelSize(size_t size, size_t factor);
+
+  /**
+   * @brief Averages the components of each factor x factor block of the image inside the region.
+   * The region is given in the pixels of the factor and is clipped to the image.
+   * @param image
+   * @param factor
+   * @param x0
+   * @param y0
+   * @param width
+   * @param height
+   * @return
+   */
+  static GrayRegion SampleGray(const Image& image, size_t factor, long long x0, long long y0, long long width, long long height);
+
+  /**
+   * @brief Normalized cross-correlation of a with b placed at (sx, sy) in the pixels of a.
+   * Translations that compare less than minOverlapFraction of a return negative infinity.
+   * @param a
+   * @param b
+   * @param sx
+   * @param sy
+   * @param minOverlapFraction
+   * @return
+   */
+  static double Correlate(const GrayRegion& a, const GrayRegion& b, long long sx, long long sy, double minOverlapFraction);
+
+  /**
+   * @brief Moves (sx, sy) to the best translation within the radius, or leaves it if no translation correlates
+   * @param a
+   * @param b
+   * @param radius
+   * @param minOverlapFraction
+   * @param sx
+   * @param sy
+   */
+  static void SearchTranslation(const GrayRegion& a, const GrayRegion& b, long long radius, double minOverlapFraction, long long& sx, long long& sy);
+
+private:
+  IMFImageCorrelation(const IMFImageCorrelation&); // Copy Constructor Not Implemented
+  void operator=(const IMFImageCorrelation&);      // Operator '=' Not Implemented
+};
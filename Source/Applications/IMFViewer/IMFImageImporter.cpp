@@ -0,0 +1,346 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFImageImporter.h"
+
+#include <algorithm>
+
+#include <QtConcurrent>
+
+#include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QThread>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "SIMPLVtkLib/QtWidgets/VSFilterFactory.h"
+
+#include "IMFViewer/IMFMappedImageReader.h"
+#include "IMFViewer/IMFPipelineScheduler.h"
+#include "IMFViewer/IMFTileCache.h"
+#include "IMFViewer/IMFTrace.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFImageImporter::IMFImageImporter(QObject* parent)
+: QObject(parent)
+{
+  m_ThreadPool.setMaxThreadCount(QThread::idealThreadCount());
+
+  // Decoded images are handed to the main thread one at a time, so a quarter of the
+  // physical memory keeps the workers ahead without starving the rest of the application
+  m_MemoryBudget = IMFPipelineScheduler::PhysicalMemorySize() / 4;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFImageImporter::~IMFImageImporter()
+{
+  cancelAll();
+  m_ThreadPool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::setMaxThreadCount(int count)
+{
+  m_ThreadPool.setMaxThreadCount(std::max(1, count));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFImageImporter::getMaxThreadCount() const
+{
+  return m_ThreadPool.maxThreadCount();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::setMemoryBudget(qint64 bytes)
+{
+  QMutexLocker locker(&m_BudgetMutex);
+  m_MemoryBudget = std::max<qint64>(0, bytes);
+  m_BudgetCondition.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFImageImporter::getMemoryBudget() const
+{
+  QMutexLocker locker(&m_BudgetMutex);
+  return m_MemoryBudget;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::importImages(const QString& name, const QStringList& filePaths)
+{
+  BatchPointer batch = std::make_shared<Batch>();
+  batch->pipeline = FilterPipeline::New();
+  batch->pipeline->setName(name);
+  batch->results.resize(static_cast<size_t>(filePaths.size()));
+  m_Batches.push_back(batch);
+
+  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
+  std::vector<std::pair<size_t, AbstractFilter::Pointer>> readers;
+  for(int i = 0; i < filePaths.size(); i++)
+  {
+    QString filePath = filePaths[i];
+    QFileInfo fi(filePath);
+    DataArrayPath dcPath(fi.fileName(), "", "");
+    AbstractFilter::Pointer imageReaderFilter = filterFactory->createImageFileReaderFilter(filePath, dcPath);
+    if(!imageReaderFilter)
+    {
+      batch->errorMessages.push_back(tr("'%1' could not be opened by the image reader.").arg(filePath));
+      continue;
+    }
+
+    batch->pipeline->pushBack(imageReaderFilter);
+    readers.push_back(std::make_pair(static_cast<size_t>(i), imageReaderFilter));
+  }
+
+  batch->remaining = readers.size();
+  if(readers.empty())
+  {
+    finishBatch(batch);
+    return;
+  }
+
+  emit notifyStatusMessage(tr("Reading %1 images for '%2'").arg(readers.size()).arg(name));
+
+  for(const std::pair<size_t, AbstractFilter::Pointer>& reader : readers)
+  {
+    size_t index = reader.first;
+    AbstractFilter::Pointer filter = reader.second;
+    QString filePath = filePaths[static_cast<int>(index)];
+
+    QFutureWatcher<FileRead>* watcher = new QFutureWatcher<FileRead>(this);
+    connect(watcher, &QFutureWatcher<FileRead>::finished, this, [=] {
+      completeFile(batch, index, filePath, watcher->result());
+      watcher->deleteLater();
+    });
+
+    watcher->setFuture(QtConcurrent::run(&m_ThreadPool, [=] { return readImage(batch, filePath, filter); }));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFImageImporter::FileRead IMFImageImporter::readImage(const BatchPointer& batch, const QString& filePath, const AbstractFilter::Pointer& filter)
+{
+  FileRead fileRead;
+  if(batch->canceled)
+  {
+    fileRead.canceled = true;
+    return fileRead;
+  }
+
+  IMFTraceSpan readSpan(tr("Read Image"), IMFTrace::ImportCategory);
+  readSpan.setArg("Batch", batch->pipeline->getName());
+
+  // An image that was decoded before is taken from the tile cache without reading the file
+  QString cacheKey = IMFTileCache::ComputeFileKey(filePath);
+  DataContainer::Pointer cachedDC = IMFTileCache::Lookup(cacheKey);
+  if(cachedDC)
+  {
+    readSpan.setArg("Cached", true);
+    fileRead.dca = DataContainerArray::New();
+    fileRead.dca->addOrReplaceDataContainer(cachedDC);
+    return fileRead;
+  }
+
+  // The preflight reads the image header, which is enough to know the decoded size
+  DataContainerArray::Pointer preflightDca = DataContainerArray::New();
+  filter->setDataContainerArray(preflightDca);
+  filter->setInPreflight(true);
+  filter->preflight();
+  filter->setInPreflight(false);
+  fileRead.err = filter->getErrorCode();
+  if(fileRead.err < 0)
+  {
+    return fileRead;
+  }
+
+  // Uncompressed pixels are mapped instead of decoded, so they are neither copied nor counted against the memory budget
+  if(IMFMappedImageReader::MapImage(filePath, preflightDca))
+  {
+    readSpan.setArg("Mapped", true);
+    fileRead.dca = preflightDca;
+    return fileRead;
+  }
+
+  qint64 estimatedBytes = IMFPipelineScheduler::EstimateMemoryUsage(preflightDca);
+  if(!reserveMemory(batch, estimatedBytes))
+  {
+    fileRead.canceled = true;
+    return fileRead;
+  }
+  fileRead.reservedBytes = estimatedBytes;
+
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  filter->setDataContainerArray(dca);
+  filter->execute();
+  fileRead.err = filter->getErrorCode();
+  fileRead.dca = dca;
+  if(fileRead.err >= 0 && !dca->getDataContainers().empty())
+  {
+    IMFTileCache::Store(cacheKey, dca->getDataContainers().front());
+  }
+  return fileRead;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::completeFile(const BatchPointer& batch, size_t index, const QString& filePath, const FileRead& fileRead)
+{
+  if(fileRead.err < 0)
+  {
+    if(!batch->canceled)
+    {
+      batch->errorMessages.push_back(tr("'%1' could not be read (error %2).").arg(filePath).arg(fileRead.err));
+    }
+  }
+  else if(!fileRead.canceled)
+  {
+    batch->results[index] = fileRead.dca;
+  }
+
+  // The image now belongs to the assembled result and no longer counts as in flight
+  releaseMemory(fileRead.reservedBytes);
+
+  batch->remaining--;
+  if(batch->remaining == 0)
+  {
+    finishBatch(batch);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::finishBatch(const BatchPointer& batch)
+{
+  m_Batches.erase(std::remove(m_Batches.begin(), m_Batches.end(), batch), m_Batches.end());
+
+  QString name = batch->pipeline->getName();
+  if(batch->canceled)
+  {
+    emit notifyStatusMessage(tr("Canceled '%1'").arg(name));
+    return;
+  }
+
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  for(const DataContainerArray::Pointer& fileDca : batch->results)
+  {
+    if(fileDca == DataContainerArray::NullPointer())
+    {
+      continue;
+    }
+
+    for(const DataContainer::Pointer& dc : fileDca->getDataContainers())
+    {
+      dca->addOrReplaceDataContainer(dc);
+    }
+  }
+  batch->results.clear();
+
+  emit notifyStatusMessage(tr("Finished '%1'").arg(name));
+  emit importFinished(batch->pipeline, dca, batch->errorMessages);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::cancelAll()
+{
+  for(const BatchPointer& batch : m_Batches)
+  {
+    batch->canceled = true;
+    for(const AbstractFilter::Pointer& filter : batch->pipeline->getFilterContainer())
+    {
+      filter->setCancel(true);
+    }
+  }
+
+  QMutexLocker locker(&m_BudgetMutex);
+  m_BudgetCondition.wakeAll();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFImageImporter::reserveMemory(const BatchPointer& batch, qint64 bytes)
+{
+  QMutexLocker locker(&m_BudgetMutex);
+
+  // An image that is larger than the whole budget is still admitted once nothing else is in flight
+  while(!batch->canceled && m_MemoryBudget > 0 && m_ReservedBytes > 0 && m_ReservedBytes + bytes > m_MemoryBudget)
+  {
+    m_BudgetCondition.wait(&m_BudgetMutex);
+  }
+
+  if(batch->canceled)
+  {
+    return false;
+  }
+
+  m_ReservedBytes += bytes;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFImageImporter::releaseMemory(qint64 bytes)
+{
+  if(bytes == 0)
+  {
+    return;
+  }
+
+  QMutexLocker locker(&m_BudgetMutex);
+  m_ReservedBytes -= bytes;
+  m_BudgetCondition.wakeAll();
+}
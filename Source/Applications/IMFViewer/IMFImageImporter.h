@@ -0,0 +1,179 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QMutex>
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The IMFImageImporter class decodes a set of image files on a thread pool and
+ * assembles the resulting data containers into a single data container array.  The
+ * number of bytes decoded but not yet assembled is bounded by a memory budget.  Uncompressed
+ * images are mapped by IMFMappedImageReader instead of being decoded.
+ */
+class IMFImageImporter : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFImageImporter(QObject* parent = nullptr);
+  ~IMFImageImporter() override;
+
+  /**
+   * @brief Sets the number of images that may be decoded at the same time
+   * @param count
+   */
+  void setMaxThreadCount(int count);
+
+  /**
+   * @brief Returns the number of images that may be decoded at the same time
+   * @return
+   */
+  int getMaxThreadCount() const;
+
+  /**
+   * @brief Sets the number of bytes that may be decoded but not yet assembled.  A value
+   * of 0 disables the check.
+   * @param bytes
+   */
+  void setMemoryBudget(qint64 bytes);
+
+  /**
+   * @brief Returns the memory budget in bytes
+   * @return
+   */
+  qint64 getMemoryBudget() const;
+
+  /**
+   * @brief Starts decoding the image files.  importFinished is emitted once every file
+   * has been read or has failed.
+   * @param name
+   * @param filePaths
+   */
+  void importImages(const QString& name, const QStringList& filePaths);
+
+public slots:
+  /**
+   * @brief Cancels every image import that has not finished
+   */
+  void cancelAll();
+
+signals:
+  void importFinished(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const QStringList& errorMessages);
+  void notifyStatusMessage(const QString& msg);
+
+private:
+  struct Batch
+  {
+    FilterPipeline::Pointer pipeline;
+    std::vector<DataContainerArray::Pointer> results;
+    QStringList errorMessages;
+    std::atomic_bool canceled{false};
+    size_t remaining = 0;
+  };
+  using BatchPointer = std::shared_ptr<Batch>;
+
+  struct FileRead
+  {
+    DataContainerArray::Pointer dca;
+    qint64 reservedBytes = 0;
+    int err = 0;
+    bool canceled = false;
+  };
+
+  QThreadPool m_ThreadPool;
+  std::vector<BatchPointer> m_Batches;
+
+  mutable QMutex m_BudgetMutex;
+  QWaitCondition m_BudgetCondition;
+  qint64 m_MemoryBudget = 0;
+  qint64 m_ReservedBytes = 0;
+
+  /**
+   * @brief Takes the image from the tile cache if it was decoded before.  Otherwise preflights
+   * the reader filter, then maps the pixels of the file if they are stored uncompressed and
+   * executes the filter and caches the image if not.  This is called from a worker thread.
+   * @param batch
+   * @param filePath
+   * @param filter
+   * @return
+   */
+  FileRead readImage(const BatchPointer& batch, const QString& filePath, const AbstractFilter::Pointer& filter);
+
+  /**
+   * @brief Stores the decoded image in the batch and emits importFinished when it was the last one
+   * @param batch
+   * @param index
+   * @param filePath
+   * @param fileRead
+   */
+  void completeFile(const BatchPointer& batch, size_t index, const QString& filePath, const FileRead& fileRead);
+
+  /**
+   * @brief Assembles the decoded images in file order and emits importFinished
+   * @param batch
+   */
+  void finishBatch(const BatchPointer& batch);
+
+  /**
+   * @brief Blocks the calling worker until the requested bytes fit in the memory budget
+   * @param batch
+   * @param bytes
+   * @return false if the batch was canceled while waiting
+   */
+  bool reserveMemory(const BatchPointer& batch, qint64 bytes);
+
+  /**
+   * @brief Returns previously reserved bytes to the memory budget
+   * @param bytes
+   */
+  void releaseMemory(qint64 bytes);
+
+  IMFImageImporter(const IMFImageImporter&); // Copy Constructor Not Implemented
+  void operator=(const IMFImageImporter&);   // Operator '=' Not Implemented
+};
@@ -0,0 +1,297 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFIncrementalStitcher.h"
+
+#include <cmath>
+
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QHash>
+
+#include <QVTKOpenGLWidget.h>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "SIMPLVtkLib/QtWidgets/VSMainWidgetBase.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSSIMPLDataContainerFilter.h"
+
+#include "IMFViewer/IMFStreamingStitcher.h"
+#include "IMFViewer/IMFTrace.h"
+#include "IMFViewer/IMFVtkArrayBridge.h"
+
+namespace
+{
+// -----------------------------------------------------------------------------
+// Matches the tiles IMFStreamingStitcher composites
+// -----------------------------------------------------------------------------
+std::vector<DataContainer::Pointer> collectTileDataContainers(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName)
+{
+  std::vector<DataContainer::Pointer> tileDCs;
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    AttributeMatrix::Pointer am = dc->getAttributeMatrix(amName);
+    if(dc->getName().startsWith(tilePrefix) && dc->getGeometryAs<ImageGeom>() && am && am->getAttributeArray(daName))
+    {
+      tileDCs.push_back(dc);
+    }
+  }
+  return tileDCs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+VSSIMPLDataContainerFilter* findDataContainerFilter(const VSAbstractFilter::FilterListType& filters, const DataContainer::Pointer& dc)
+{
+  for(VSAbstractFilter* filter : filters)
+  {
+    VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(filter);
+    if(dcFilter != nullptr && dcFilter->getWrappedDataContainer() && dcFilter->getWrappedDataContainer()->m_DataContainer == dc)
+    {
+      return dcFilter;
+    }
+
+    dcFilter = findDataContainerFilter(filter->getChildren(), dc);
+    if(dcFilter != nullptr)
+    {
+      return dcFilter;
+    }
+  }
+  return nullptr;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFIncrementalStitcher::IMFIncrementalStitcher(VSMainWidgetBase* mainWidget, QObject* parent)
+: QObject(parent)
+, m_MainWidget(mainWidget)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFIncrementalStitcher::~IMFIncrementalStitcher() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFIncrementalStitcher::record(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const DataArrayPath& montagePath)
+{
+  clear();
+
+  DataContainer::Pointer montageDC = dca->getDataContainer(montagePath.getDataContainerName());
+  if(!montageDC || !montageDC->getGeometryAs<ImageGeom>())
+  {
+    return;
+  }
+
+  // The origins are copied because the next stitch moves the same geometries
+  for(const DataContainer::Pointer& dc : collectTileDataContainers(dca, tilePrefix, amName, daName))
+  {
+    ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+    TileRecord tile;
+    tile.dc = dc;
+    tile.origin = imageGeom->getOrigin();
+    tile.dims = imageGeom->getDimensions();
+    m_Tiles.push_back(tile);
+  }
+
+  if(m_Tiles.empty())
+  {
+    return;
+  }
+
+  m_MontageDC = montageDC;
+  m_MontagePath = montagePath;
+  m_TilePrefix = tilePrefix;
+  m_AttributeMatrixName = amName;
+  m_DataArrayName = daName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFIncrementalStitcher::canUpdate(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName) const
+{
+  if(!m_MontageDC || tilePrefix != m_TilePrefix || amName != m_AttributeMatrixName || daName != m_DataArrayName)
+  {
+    return false;
+  }
+
+  std::vector<DataContainer::Pointer> tileDCs = collectTileDataContainers(dca, tilePrefix, amName, daName);
+  if(tileDCs.size() != m_Tiles.size())
+  {
+    return false;
+  }
+
+  // A tile that was reloaded with a different size changes the montage's extent
+  QHash<DataContainer*, SizeVec3Type> recordedDims;
+  for(const TileRecord& tile : m_Tiles)
+  {
+    recordedDims.insert(tile.dc.get(), tile.dims);
+  }
+  for(const DataContainer::Pointer& dc : tileDCs)
+  {
+    if(!recordedDims.contains(dc.get()))
+    {
+      return false;
+    }
+
+    SizeVec3Type dims = dc->getGeometryAs<ImageGeom>()->getDimensions();
+    SizeVec3Type tileDims = recordedDims.value(dc.get());
+    if(dims[0] != tileDims[0] || dims[1] != tileDims[1])
+    {
+      return false;
+    }
+  }
+
+  return findMontageFilter() != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFIncrementalStitcher::update(const DataContainerArray::Pointer& dca)
+{
+  VSSIMPLDataContainerFilter* montageFilter = findMontageFilter();
+  if(montageFilter == nullptr)
+  {
+    return IMFStreamingStitcher::k_MontageChangedError;
+  }
+
+  QElapsedTimer timer;
+  timer.start();
+  IMFTraceSpan span(tr("Incremental Stitch"), IMFTrace::PipelineCategory);
+
+  ImageGeom::Pointer montageGeom = m_MontageDC->getGeometryAs<ImageGeom>();
+  FloatVec3Type montageOrigin = montageGeom->getOrigin();
+  FloatVec3Type spacing = montageGeom->getSpacing();
+
+  // Each moved tile dirties the region it left and the region it entered
+  std::vector<QRect> regions;
+  std::vector<FloatVec3Type> origins;
+  int movedCount = 0;
+  for(const TileRecord& tile : m_Tiles)
+  {
+    FloatVec3Type origin = tile.dc->getGeometryAs<ImageGeom>()->getOrigin();
+    origins.push_back(origin);
+
+    int oldX = static_cast<int>(std::lround((tile.origin[0] - montageOrigin[0]) / spacing[0]));
+    int oldY = static_cast<int>(std::lround((tile.origin[1] - montageOrigin[1]) / spacing[1]));
+    int newX = static_cast<int>(std::lround((origin[0] - montageOrigin[0]) / spacing[0]));
+    int newY = static_cast<int>(std::lround((origin[1] - montageOrigin[1]) / spacing[1]));
+    if(oldX == newX && oldY == newY)
+    {
+      continue;
+    }
+
+    QSize tileSize(static_cast<int>(tile.dims[0]), static_cast<int>(tile.dims[1]));
+    regions.push_back(QRect(QPoint(oldX, oldY), tileSize));
+    regions.push_back(QRect(QPoint(newX, newY), tileSize));
+    movedCount++;
+  }
+
+  span.setArg("Tiles", static_cast<int>(m_Tiles.size()));
+  span.setArg("Moved Tiles", movedCount);
+  if(movedCount > 0)
+  {
+    int err = IMFStreamingStitcher::RestitchRegions(dca, m_TilePrefix, m_AttributeMatrixName, m_DataArrayName, m_MontageDC, m_MontagePath, regions);
+    if(err < 0)
+    {
+      return err;
+    }
+
+    for(size_t i = 0; i < m_Tiles.size(); i++)
+    {
+      m_Tiles[i].origin = origins[i];
+    }
+    refreshMontage(montageFilter);
+  }
+
+  emit notifyStatusMessage(tr("Restitched %1 of %2 tiles in %3 ms").arg(movedCount).arg(m_Tiles.size()).arg(timer.elapsed()));
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFIncrementalStitcher::clear()
+{
+  m_Tiles.clear();
+  m_MontageDC.reset();
+  m_MontagePath = DataArrayPath();
+  m_TilePrefix.clear();
+  m_AttributeMatrixName.clear();
+  m_DataArrayName.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+VSSIMPLDataContainerFilter* IMFIncrementalStitcher::findMontageFilter() const
+{
+  if(!m_MontageDC)
+  {
+    return nullptr;
+  }
+  return findDataContainerFilter(m_MainWidget->getController()->getBaseFilters(), m_MontageDC);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFIncrementalStitcher::refreshMontage(VSSIMPLDataContainerFilter* montageFilter)
+{
+  // Arrays that render from the montage buffer only need to be marked as modified
+  SIMPLVtkBridge::WrappedDataContainerPtr wrappedDc = montageFilter->getWrappedDataContainer();
+  IMFVtkArrayBridge::ShareWrappedDataContainer(wrappedDc);
+  if(!IMFVtkArrayBridge::MarkCellArraysModified(wrappedDc))
+  {
+    montageFilter->reloadData();
+    IMFVtkArrayBridge::ShareWrappedDataContainer(montageFilter->getWrappedDataContainer());
+  }
+
+  QWidget* viewWidget = m_MainWidget->getActiveViewWidget();
+  QList<QVTKOpenGLWidget*> vtkWidgets = viewWidget != nullptr ? viewWidget->findChildren<QVTKOpenGLWidget*>() : QList<QVTKOpenGLWidget*>();
+  if(!vtkWidgets.isEmpty())
+  {
+    vtkWidgets.front()->update();
+  }
+}
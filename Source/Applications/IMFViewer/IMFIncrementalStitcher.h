@@ -0,0 +1,135 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+class VSMainWidgetBase;
+class VSSIMPLDataContainerFilter;
+
+/**
+ * @brief The IMFIncrementalStitcher class remembers where each tile was when a montage was
+ * last stitched from displayed datasets.  When the same tiles are stitched again after a few
+ * of them were nudged, only the regions those tiles left and entered are recomposited and the
+ * montage already in the view is updated in place instead of being stitched and imported again.
+ */
+class IMFIncrementalStitcher : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFIncrementalStitcher(VSMainWidgetBase* mainWidget, QObject* parent = nullptr);
+  ~IMFIncrementalStitcher() override;
+
+  /**
+   * @brief Remembers the tile origins and the montage of a stitched data container array.
+   * This must be called before the tiles are removed from the array.
+   * @param dca
+   * @param tilePrefix
+   * @param amName
+   * @param daName
+   * @param montagePath
+   */
+  void record(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const DataArrayPath& montagePath);
+
+  /**
+   * @brief Returns true if the tiles of the data container array are the ones that were last
+   * stitched and the montage they were stitched into is still displayed
+   * @param dca
+   * @param tilePrefix
+   * @param amName
+   * @param daName
+   * @return
+   */
+  bool canUpdate(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName) const;
+
+  /**
+   * @brief Recomposites the regions of the displayed montage that are covered by the tiles
+   * that moved since the last stitch and redraws it.  The montage is left unchanged if an
+   * error is returned, in which case the tiles have to be stitched again in full.
+   * @param dca
+   * @return
+   */
+  int update(const DataContainerArray::Pointer& dca);
+
+public slots:
+  /**
+   * @brief Forgets the last stitch
+   */
+  void clear();
+
+signals:
+  void notifyStatusMessage(const QString& msg);
+
+private:
+  struct TileRecord
+  {
+    DataContainer::Pointer dc;
+    FloatVec3Type origin = {0.0f, 0.0f, 0.0f};
+    SizeVec3Type dims = {0, 0, 0};
+  };
+
+  VSMainWidgetBase* m_MainWidget = nullptr;
+  std::vector<TileRecord> m_Tiles;
+  DataContainer::Pointer m_MontageDC;
+  DataArrayPath m_MontagePath;
+  QString m_TilePrefix;
+  QString m_AttributeMatrixName;
+  QString m_DataArrayName;
+
+  /**
+   * @brief Returns the filter that displays the recorded montage, or nullptr if it was removed
+   * @return
+   */
+  VSSIMPLDataContainerFilter* findMontageFilter() const;
+
+  /**
+   * @brief Redraws the montage after its array was written to in place
+   * @param montageFilter
+   */
+  void refreshMontage(VSSIMPLDataContainerFilter* montageFilter);
+
+  IMFIncrementalStitcher(const IMFIncrementalStitcher&); // Copy Constructor Not Implemented
+  void operator=(const IMFIncrementalStitcher&);         // Operator '=' Not Implemented
+};
@@ -0,0 +1,586 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFLazyTileLoader.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QtConcurrent>
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QMutex>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+
+#include <QVTKOpenGLWidget.h>
+#include <vtkCallbackCommand.h>
+#include <vtkCamera.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkRendererCollection.h>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "SIMPLVtkLib/QtWidgets/VSMainWidgetBase.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSSIMPLDataContainerFilter.h"
+
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFPipelineScheduler.h"
+#include "IMFViewer/IMFTileCache.h"
+#include "IMFViewer/IMFTrace.h"
+#include "IMFViewer/IMFVtkArrayBridge.h"
+
+namespace
+{
+// Tiles this far outside the view, as a fraction of the view size, are loaded ahead of panning
+const double k_ViewMargin = 0.25;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void removeAttributeMatrices(const DataContainer::Pointer& dc)
+{
+  QStringList amNames;
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    amNames.push_back(am->getName());
+  }
+
+  for(const QString& amName : amNames)
+  {
+    dc->removeAttributeMatrix(amName);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void collectDataContainerFilters(const VSAbstractFilter::FilterListType& filters, QMap<DataContainer*, VSSIMPLDataContainerFilter*>& dcFilters)
+{
+  for(VSAbstractFilter* filter : filters)
+  {
+    VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(filter);
+    if(dcFilter != nullptr && dcFilter->getWrappedDataContainer())
+    {
+      dcFilters.insert(dcFilter->getWrappedDataContainer()->m_DataContainer.get(), dcFilter);
+    }
+    collectDataContainerFilters(filter->getChildren(), dcFilters);
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFLazyTileLoader::IMFLazyTileLoader(VSMainWidgetBase* mainWidget, QObject* parent)
+: QObject(parent)
+, m_MainWidget(mainWidget)
+{
+  // Tile reads are mostly decoding, so half of the cores keep the view responsive
+  m_ThreadPool.setMaxThreadCount(std::max(1, QThread::idealThreadCount() / 2));
+
+  m_CacheSize = IMFPipelineScheduler::PhysicalMemorySize() / 8;
+
+  // Camera changes render many frames in a row, so the tiles are only updated once the view settles
+  m_UpdateTimer.setSingleShot(true);
+  m_UpdateTimer.setInterval(200);
+  connect(&m_UpdateTimer, &QTimer::timeout, this, &IMFLazyTileLoader::updateVisibleTiles);
+
+  m_RenderCallback = vtkSmartPointer<vtkCallbackCommand>::New();
+  m_RenderCallback->SetCallback(&IMFLazyTileLoader::RenderCallback);
+  m_RenderCallback->SetClientData(this);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFLazyTileLoader::~IMFLazyTileLoader()
+{
+  if(m_ObservedRenderer)
+  {
+    m_ObservedRenderer->RemoveObserver(m_ObserverTag);
+  }
+
+  clear();
+  m_ThreadPool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::StripAttributeMatrices(const DataContainerArray::Pointer& dca)
+{
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    removeAttributeMatrices(dc);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::setCacheSize(qint64 bytes)
+{
+  m_CacheSize = std::max<qint64>(0, bytes);
+  evictTiles();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFLazyTileLoader::getCacheSize() const
+{
+  return m_CacheSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFLazyTileLoader::getLoadedBytes() const
+{
+  return m_LoadedBytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::addMontage(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& pipelineName, const DataContainerArray::Pointer& geometryDca)
+{
+  MontagePointer montage = std::make_shared<Montage>();
+  montage->settings = settings;
+  montage->pipelineName = pipelineName;
+
+  // The import filters name their tiles <prefix>r<row>c<col>, zero padded to the largest index
+  QRegularExpression positionExpression("r(\\d+)c(\\d+)$");
+  for(const DataContainer::Pointer& dc : geometryDca->getDataContainers())
+  {
+    QRegularExpressionMatch match = positionExpression.match(dc->getName());
+    if(!match.hasMatch() || !dc->getGeometryAs<ImageGeom>())
+    {
+      continue;
+    }
+
+    Tile tile;
+    tile.dc = dc;
+    tile.position = {match.captured(2).toInt(), match.captured(1).toInt()};
+    montage->tiles.push_back(tile);
+  }
+
+  if(montage->tiles.empty())
+  {
+    return;
+  }
+
+  m_Montages.push_back(montage);
+  emit notifyStatusMessage(tr("'%1': %2 tiles will be read as they come into view").arg(pipelineName).arg(montage->tiles.size()));
+
+  observeActiveRenderer();
+
+  // The datasets are wrapped for display asynchronously, so the first update waits for the next render
+  m_UpdateTimer.start();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::clear()
+{
+  for(const MontagePointer& montage : m_Montages)
+  {
+    for(Tile& tile : montage->tiles)
+    {
+      if(tile.wanted)
+      {
+        *tile.wanted = false;
+      }
+    }
+  }
+
+  m_Montages.clear();
+  m_LoadedBytes = 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::updateVisibleTiles()
+{
+  observeActiveRenderer();
+  double bounds[4] = {0.0, 0.0, 0.0, 0.0};
+  if(m_Montages.empty() || !VisibleBounds(m_ObservedRenderer, bounds))
+  {
+    return;
+  }
+
+  m_UpdateCount++;
+  int queuedCount = 0;
+  for(const MontagePointer& montage : m_Montages)
+  {
+    for(size_t i = 0; i < montage->tiles.size(); i++)
+    {
+      Tile& tile = montage->tiles[i];
+      ImageGeom::Pointer imageGeom = tile.dc->getGeometryAs<ImageGeom>();
+      SizeVec3Type dims = imageGeom->getDimensions();
+      FloatVec3Type origin = imageGeom->getOrigin();
+      FloatVec3Type spacing = imageGeom->getSpacing();
+      double xMax = origin[0] + dims[0] * spacing[0];
+      double yMax = origin[1] + dims[1] * spacing[1];
+      bool visible = origin[0] <= bounds[1] && xMax >= bounds[0] && origin[1] <= bounds[3] && yMax >= bounds[2];
+      if(!visible)
+      {
+        // Skip reads that were queued for a view that has since moved on
+        if(tile.wanted)
+        {
+          *tile.wanted = false;
+          tile.wanted.reset();
+        }
+        continue;
+      }
+
+      tile.lastVisible = m_UpdateCount;
+      if(tile.loaded || tile.wanted)
+      {
+        continue;
+      }
+
+      std::shared_ptr<std::atomic_bool> wanted = std::make_shared<std::atomic_bool>(true);
+      tile.wanted = wanted;
+      queuedCount++;
+
+      IMFMontagePipelineBuilder::MontageSettings settings = montage->settings;
+      QString pipelineName = montage->pipelineName;
+      IntVec2Type position = tile.position;
+
+      QFutureWatcher<TileRead>* watcher = new QFutureWatcher<TileRead>(this);
+      connect(watcher, &QFutureWatcher<TileRead>::finished, this, [=] {
+        // A newer read may have been queued for the tile after this one was skipped
+        if(montage->tiles[i].wanted == wanted)
+        {
+          montage->tiles[i].wanted.reset();
+          completeTile(montage, i, watcher->result());
+        }
+        watcher->deleteLater();
+      });
+
+      watcher->setFuture(QtConcurrent::run(&m_ThreadPool, [=] { return ReadTile(settings, pipelineName, position, wanted); }));
+    }
+  }
+
+  if(queuedCount > 0)
+  {
+    emit notifyStatusMessage(tr("Reading %1 tiles in view").arg(queuedCount));
+  }
+
+  evictTiles();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFLazyTileLoader::TileRead IMFLazyTileLoader::ReadTile(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& pipelineName, const IntVec2Type& position,
+                                                        const std::shared_ptr<std::atomic_bool>& wanted)
+{
+  TileRead tileRead;
+  if(!*wanted)
+  {
+    tileRead.canceled = true;
+    return tileRead;
+  }
+
+  IMFTraceSpan readSpan(tr("Read Tile"), IMFTrace::ImportCategory);
+  readSpan.setArg("Pipeline", pipelineName);
+  readSpan.setArg("Column", position[0]);
+  readSpan.setArg("Row", position[1]);
+
+  // A tile decoded by an earlier import of the same files is taken from the tile cache
+  int slice = (settings.Type == IMFMontagePipelineBuilder::MontageType::Robomet) ? pipelineName.section('_', -1).toInt() : 0;
+  QString cacheKey = IMFTileCache::ComputeTileKey(settings, slice, IMFTileCache::TileStage, position);
+  DataContainer::Pointer cachedDC = IMFTileCache::Lookup(cacheKey);
+  if(cachedDC)
+  {
+    readSpan.setArg("Cached", true);
+    DataContainerArray::Pointer cachedDca = DataContainerArray::New();
+    cachedDca->addOrReplaceDataContainer(cachedDC);
+    tileRead.dc = cachedDC;
+    tileRead.bytes = IMFPipelineScheduler::EstimateMemoryUsage(cachedDca);
+    return tileRead;
+  }
+
+  // Side by side pipelines only contain the import filter
+  IMFMontagePipelineBuilder::MontageSettings tileSettings = settings;
+  tileSettings.MontageStart = position;
+  tileSettings.MontageEnd = position;
+  tileSettings.Display = IMFMontagePipelineBuilder::DisplayType::SideBySide;
+  tileSettings.StitchedOutputFile.clear();
+
+  IMFMontagePipelineBuilder builder;
+  std::vector<FilterPipeline::Pointer> pipelines = builder.createPipelines(tileSettings);
+  auto pipelineIter = std::find_if(pipelines.begin(), pipelines.end(), [=](const FilterPipeline::Pointer& pipeline) { return pipeline && pipeline->getName() == pipelineName; });
+  if(pipelineIter == pipelines.end())
+  {
+    tileRead.err = -1;
+    return tileRead;
+  }
+
+  DataContainerArray::Pointer dca = DataContainerArray::New();
+  for(const AbstractFilter::Pointer& filter : (*pipelineIter)->getFilterContainer())
+  {
+    filter->setDataContainerArray(dca);
+    {
+      QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(filter) ? IMFHdf5Lock::Mutex() : nullptr);
+      filter->execute();
+    }
+    tileRead.err = filter->getErrorCode();
+    if(tileRead.err < 0)
+    {
+      return tileRead;
+    }
+  }
+
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    if(dc->getGeometryAs<ImageGeom>())
+    {
+      tileRead.dc = dc;
+      break;
+    }
+  }
+
+  tileRead.bytes = IMFPipelineScheduler::EstimateMemoryUsage(dca);
+  IMFTileCache::Store(cacheKey, tileRead.dc);
+  return tileRead;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::completeTile(const MontagePointer& montage, size_t index, const TileRead& tileRead)
+{
+  if(std::find(m_Montages.begin(), m_Montages.end(), montage) == m_Montages.end())
+  {
+    return;
+  }
+
+  Tile& tile = montage->tiles[index];
+  if(tileRead.canceled || tileRead.err < 0 || !tileRead.dc)
+  {
+    if(!tileRead.canceled)
+    {
+      emit notifyStatusMessage(tr("Tile '%1' could not be read (error %2)").arg(tile.dc->getName()).arg(tileRead.err));
+    }
+    return;
+  }
+
+  // The displayed geometry keeps the origin found for the whole montage, which may
+  // differ from the origin a single tile import computes
+  for(const AttributeMatrix::Pointer& am : tileRead.dc->getAttributeMatrices())
+  {
+    tile.dc->addOrReplaceAttributeMatrix(am);
+  }
+
+  tile.loaded = true;
+  tile.bytes = tileRead.bytes;
+  m_LoadedBytes += tile.bytes;
+  reloadDataset(tile.dc);
+
+  evictTiles();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::evictTiles()
+{
+  if(m_LoadedBytes <= m_CacheSize)
+  {
+    return;
+  }
+
+  std::vector<std::pair<quint64, Tile*>> candidates;
+  for(const MontagePointer& montage : m_Montages)
+  {
+    for(Tile& tile : montage->tiles)
+    {
+      if(tile.loaded && tile.lastVisible < m_UpdateCount)
+      {
+        candidates.push_back(std::make_pair(tile.lastVisible, &tile));
+      }
+    }
+  }
+
+  std::sort(candidates.begin(), candidates.end(), [](const std::pair<quint64, Tile*>& a, const std::pair<quint64, Tile*>& b) { return a.first < b.first; });
+  for(const std::pair<quint64, Tile*>& candidate : candidates)
+  {
+    if(m_LoadedBytes <= m_CacheSize)
+    {
+      break;
+    }
+
+    Tile* tile = candidate.second;
+    removeAttributeMatrices(tile->dc);
+    tile->loaded = false;
+    m_LoadedBytes -= tile->bytes;
+    tile->bytes = 0;
+    reloadDataset(tile->dc);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::reloadDataset(const DataContainer::Pointer& dc)
+{
+  QMap<DataContainer*, VSSIMPLDataContainerFilter*> dcFilters;
+  collectDataContainerFilters(m_MainWidget->getController()->getBaseFilters(), dcFilters);
+
+  VSSIMPLDataContainerFilter* dcFilter = dcFilters.value(dc.get(), nullptr);
+  if(dcFilter != nullptr)
+  {
+    dcFilter->reloadData();
+    IMFVtkArrayBridge::ShareWrappedDataContainer(dcFilter->getWrappedDataContainer());
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkRenderer* IMFLazyTileLoader::activeRenderer() const
+{
+  QWidget* viewWidget = m_MainWidget->getActiveViewWidget();
+  if(viewWidget == nullptr)
+  {
+    return nullptr;
+  }
+
+  QList<QVTKOpenGLWidget*> vtkWidgets = viewWidget->findChildren<QVTKOpenGLWidget*>();
+  if(vtkWidgets.isEmpty() || vtkWidgets.front()->GetRenderWindow() == nullptr)
+  {
+    return nullptr;
+  }
+
+  return vtkWidgets.front()->GetRenderWindow()->GetRenderers()->GetFirstRenderer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::observeActiveRenderer()
+{
+  vtkRenderer* renderer = activeRenderer();
+  if(renderer == m_ObservedRenderer.GetPointer())
+  {
+    return;
+  }
+
+  if(m_ObservedRenderer)
+  {
+    m_ObservedRenderer->RemoveObserver(m_ObserverTag);
+  }
+
+  m_ObservedRenderer = renderer;
+  if(renderer != nullptr)
+  {
+    m_ObserverTag = renderer->AddObserver(vtkCommand::EndEvent, m_RenderCallback);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFLazyTileLoader::VisibleBounds(vtkRenderer* renderer, double bounds[4])
+{
+  if(renderer == nullptr || renderer->GetActiveCamera() == nullptr)
+  {
+    return false;
+  }
+
+  int* size = renderer->GetSize();
+  if(size[0] <= 0 || size[1] <= 0)
+  {
+    return false;
+  }
+
+  // Unproject the view corners at the depth of the focal point, where the tiles are drawn
+  double focalPoint[3];
+  renderer->GetActiveCamera()->GetFocalPoint(focalPoint);
+  renderer->SetWorldPoint(focalPoint[0], focalPoint[1], focalPoint[2], 1.0);
+  renderer->WorldToDisplay();
+  double focalDepth = renderer->GetDisplayPoint()[2];
+
+  bounds[0] = bounds[2] = std::numeric_limits<double>::max();
+  bounds[1] = bounds[3] = std::numeric_limits<double>::lowest();
+  int corners[4][2] = {{0, 0}, {size[0], 0}, {0, size[1]}, {size[0], size[1]}};
+  for(int* corner : corners)
+  {
+    renderer->SetDisplayPoint(corner[0], corner[1], focalDepth);
+    renderer->DisplayToWorld();
+    double* worldPoint = renderer->GetWorldPoint();
+    if(worldPoint[3] == 0.0)
+    {
+      return false;
+    }
+
+    double x = worldPoint[0] / worldPoint[3];
+    double y = worldPoint[1] / worldPoint[3];
+    bounds[0] = std::min(bounds[0], x);
+    bounds[1] = std::max(bounds[1], x);
+    bounds[2] = std::min(bounds[2], y);
+    bounds[3] = std::max(bounds[3], y);
+  }
+
+  double xMargin = (bounds[1] - bounds[0]) * k_ViewMargin;
+  double yMargin = (bounds[3] - bounds[2]) * k_ViewMargin;
+  bounds[0] -= xMargin;
+  bounds[1] += xMargin;
+  bounds[2] -= yMargin;
+  bounds[3] += yMargin;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFLazyTileLoader::RenderCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData)
+{
+  Q_UNUSED(caller)
+  Q_UNUSED(eventId)
+  Q_UNUSED(callData)
+
+  IMFLazyTileLoader* loader = static_cast<IMFLazyTileLoader*>(clientData);
+  loader->m_UpdateTimer.start();
+}
@@ -0,0 +1,226 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+#include <QtCore/QTimer>
+
+#include <vtkSmartPointer.h>
+#include <vtkWeakPointer.h>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+class VSMainWidgetBase;
+class vtkCallbackCommand;
+class vtkObject;
+class vtkRenderer;
+
+/**
+ * @brief The IMFLazyTileLoader class reads the pixels of side by side montage tiles only
+ * when they are in view.  Montages are imported with the geometry found by preflighting
+ * the import filter, and each tile that enters the view is read on a worker thread by
+ * an import pipeline restricted to that tile.  Tiles that leave the view stay loaded
+ * until the cache size is exceeded, after which the least recently visible ones are
+ * released.
+ */
+class IMFLazyTileLoader : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFLazyTileLoader(VSMainWidgetBase* mainWidget, QObject* parent = nullptr);
+  ~IMFLazyTileLoader() override;
+
+  /**
+   * @brief Removes the attribute matrices from every data container so that only the
+   * geometries of a preflighted montage remain.  The array is modified in place.
+   * @param dca
+   */
+  static void StripAttributeMatrices(const DataContainerArray::Pointer& dca);
+
+  struct TileRead
+  {
+    DataContainer::Pointer dc;
+    qint64 bytes = 0;
+    int err = 0;
+    bool canceled = false;
+  };
+
+  /**
+   * @brief Runs the import pipeline for a single tile unless the tile cache holds the tile.
+   * This is called from a worker thread.  Clearing the wanted flag before the read starts skips it.
+   * @param settings
+   * @param pipelineName
+   * @param position
+   * @param wanted
+   * @return
+   */
+  static TileRead ReadTile(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& pipelineName, const IntVec2Type& position, const std::shared_ptr<std::atomic_bool>& wanted);
+
+  /**
+   * @brief Sets the number of bytes of tile data kept loaded.  Visible tiles are never
+   * released, so the cache may grow past this size while many tiles are in view.
+   * @param bytes
+   */
+  void setCacheSize(qint64 bytes);
+
+  /**
+   * @brief Returns the cache size in bytes
+   * @return
+   */
+  qint64 getCacheSize() const;
+
+  /**
+   * @brief Returns the number of bytes of tile data currently loaded
+   * @return
+   */
+  qint64 getLoadedBytes() const;
+
+  /**
+   * @brief Tracks the tiles of a montage that has been imported with its geometry only.
+   * The settings and pipeline name are used to build the single tile import pipelines.
+   * @param settings
+   * @param pipelineName
+   * @param geometryDca
+   */
+  void addMontage(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& pipelineName, const DataContainerArray::Pointer& geometryDca);
+
+public slots:
+  /**
+   * @brief Loads the tiles that intersect the view and releases hidden tiles over the cache size
+   */
+  void updateVisibleTiles();
+
+  /**
+   * @brief Stops tracking every montage.  Loaded tile data stays with the displayed datasets.
+   */
+  void clear();
+
+signals:
+  void notifyStatusMessage(const QString& msg);
+
+private:
+  struct Tile
+  {
+    DataContainer::Pointer dc;
+    IntVec2Type position = {0, 0};
+    bool loaded = false;
+    qint64 bytes = 0;
+    quint64 lastVisible = 0;
+
+    // Set while a read is queued or running.  Clearing the flag skips a read that has not started.
+    std::shared_ptr<std::atomic_bool> wanted;
+  };
+
+  struct Montage
+  {
+    IMFMontagePipelineBuilder::MontageSettings settings;
+    QString pipelineName;
+    std::vector<Tile> tiles;
+  };
+  using MontagePointer = std::shared_ptr<Montage>;
+
+  VSMainWidgetBase* m_MainWidget = nullptr;
+  QThreadPool m_ThreadPool;
+  QTimer m_UpdateTimer;
+  std::vector<MontagePointer> m_Montages;
+
+  qint64 m_CacheSize = 0;
+  qint64 m_LoadedBytes = 0;
+  quint64 m_UpdateCount = 0;
+
+  vtkWeakPointer<vtkRenderer> m_ObservedRenderer;
+  vtkSmartPointer<vtkCallbackCommand> m_RenderCallback;
+  unsigned long m_ObserverTag = 0;
+
+  /**
+   * @brief Moves the tile data read on a worker thread into the displayed data container
+   * @param montage
+   * @param index
+   * @param tileRead
+   */
+  void completeTile(const MontagePointer& montage, size_t index, const TileRead& tileRead);
+
+  /**
+   * @brief Releases the least recently visible tiles until the loaded data fits the cache size
+   */
+  void evictTiles();
+
+  /**
+   * @brief Rewraps the displayed dataset of the data container after its data changed
+   * @param dc
+   */
+  void reloadDataset(const DataContainer::Pointer& dc);
+
+  /**
+   * @brief Returns the renderer of the active view, or nullptr if there is none
+   * @return
+   */
+  vtkRenderer* activeRenderer() const;
+
+  /**
+   * @brief Starts listening for renders of the active view so camera changes update the tiles
+   */
+  void observeActiveRenderer();
+
+  /**
+   * @brief Computes the x and y range of the world shown by the renderer at the focal plane
+   * @param renderer
+   * @param bounds xmin, xmax, ymin, ymax
+   * @return false if the range could not be computed
+   */
+  static bool VisibleBounds(vtkRenderer* renderer, double bounds[4]);
+
+  /**
+   * @brief Restarts the update timer.  Used as the render callback of the observed renderer.
+   * @param caller
+   * @param eventId
+   * @param clientData
+   * @param callData
+   */
+  static void RenderCallback(vtkObject* caller, unsigned long eventId, void* clientData, void* callData);
+
+  IMFLazyTileLoader(const IMFLazyTileLoader&); // Copy Constructor Not Implemented
+  void operator=(const IMFLazyTileLoader&);    // Operator '=' Not Implemented
+};
@@ -0,0 +1,497 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFMappedImageReader.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QFile>
+#include <QtCore/QSysInfo>
+#include <QtCore/QtEndian>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+namespace
+{
+// TIFF tags that describe the layout of the first page
+const quint16 k_ImageWidthTag = 256;
+const quint16 k_ImageLengthTag = 257;
+const quint16 k_BitsPerSampleTag = 258;
+const quint16 k_CompressionTag = 259;
+const quint16 k_PhotometricTag = 262;
+const quint16 k_StripOffsetsTag = 273;
+const quint16 k_OrientationTag = 274;
+const quint16 k_SamplesPerPixelTag = 277;
+const quint16 k_StripByteCountsTag = 279;
+const quint16 k_PlanarConfigurationTag = 284;
+const quint16 k_TileWidthTag = 322;
+const quint16 k_SampleFormatTag = 339;
+
+const quint16 k_TiffShortType = 3;
+const quint16 k_TiffLongType = 4;
+
+// Files with one strip per row have as many strip offsets as rows
+const quint32 k_MaxTiffValues = 1 << 20;
+
+const bool k_HostIsLittleEndian = (QSysInfo::ByteOrder == QSysInfo::LittleEndian);
+
+using TiffTags = std::map<quint16, std::vector<quint32>>;
+
+/**
+ * @brief The MappedPixels struct owns the mapping behind a wrapped array.  The array is
+ * released before the file, which unmaps the pixels when it is destroyed.
+ */
+template <typename T>
+struct MappedPixels
+{
+  QFile file;
+  typename DataArray<T>::Pointer array;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint16 readUInt16(const uchar* bytes, bool littleEndian)
+{
+  return littleEndian ? qFromLittleEndian<quint16>(bytes) : qFromBigEndian<quint16>(bytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint32 readUInt32(const uchar* bytes, bool littleEndian)
+{
+  return littleEndian ? qFromLittleEndian<quint32>(bytes) : qFromBigEndian<quint32>(bytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readTiffValues(QFile& file, const uchar* entry, bool littleEndian, std::vector<quint32>& values)
+{
+  quint16 type = readUInt16(entry + 2, littleEndian);
+  quint32 count = readUInt32(entry + 4, littleEndian);
+  qint64 valueSize = (type == k_TiffShortType) ? 2 : (type == k_TiffLongType ? 4 : 0);
+  if(valueSize == 0 || count == 0 || count > k_MaxTiffValues)
+  {
+    return false;
+  }
+
+  // Values that fit in four bytes are stored in the entry instead of at an offset
+  QByteArray storage;
+  const uchar* data = entry + 8;
+  if(count * valueSize > 4)
+  {
+    if(!file.seek(readUInt32(entry + 8, littleEndian)))
+    {
+      return false;
+    }
+
+    storage = file.read(count * valueSize);
+    if(storage.size() != count * valueSize)
+    {
+      return false;
+    }
+    data = reinterpret_cast<const uchar*>(storage.constData());
+  }
+
+  values.resize(count);
+  for(quint32 i = 0; i < count; i++)
+  {
+    values[i] = (valueSize == 2) ? readUInt16(data + 2 * i, littleEndian) : readUInt32(data + 4 * i, littleEndian);
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+quint32 tiffValue(const TiffTags& tags, quint16 tag, quint32 defaultValue)
+{
+  TiffTags::const_iterator iter = tags.find(tag);
+  return (iter == tags.end()) ? defaultValue : iter->second.front();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readTiffLayout(QFile& file, IMFMappedImageReader::PixelLayout& layout)
+{
+  QByteArray header = file.read(8);
+  if(header.size() != 8 || (!header.startsWith("II") && !header.startsWith("MM")))
+  {
+    return false;
+  }
+
+  // BigTIFF files use a different magic number and 64-bit offsets
+  bool littleEndian = header.startsWith("II");
+  const uchar* headerBytes = reinterpret_cast<const uchar*>(header.constData());
+  if(readUInt16(headerBytes + 2, littleEndian) != 42)
+  {
+    return false;
+  }
+
+  if(!file.seek(readUInt32(headerBytes + 4, littleEndian)))
+  {
+    return false;
+  }
+
+  QByteArray countBytes = file.read(2);
+  if(countBytes.size() != 2)
+  {
+    return false;
+  }
+
+  quint16 numEntries = readUInt16(reinterpret_cast<const uchar*>(countBytes.constData()), littleEndian);
+  QByteArray entries = file.read(numEntries * 12 + 4);
+  if(entries.size() != numEntries * 12 + 4)
+  {
+    return false;
+  }
+
+  // Files with more than one page are read as stacks by the filter
+  const uchar* entryBytes = reinterpret_cast<const uchar*>(entries.constData());
+  if(readUInt32(entryBytes + numEntries * 12, littleEndian) != 0)
+  {
+    return false;
+  }
+
+  TiffTags tags;
+  for(quint16 i = 0; i < numEntries; i++)
+  {
+    const uchar* entry = entryBytes + i * 12;
+    quint16 tag = readUInt16(entry, littleEndian);
+    switch(tag)
+    {
+    case k_ImageWidthTag:
+    case k_ImageLengthTag:
+    case k_BitsPerSampleTag:
+    case k_CompressionTag:
+    case k_PhotometricTag:
+    case k_StripOffsetsTag:
+    case k_OrientationTag:
+    case k_SamplesPerPixelTag:
+    case k_StripByteCountsTag:
+    case k_PlanarConfigurationTag:
+    case k_SampleFormatTag:
+      if(!readTiffValues(file, entry, littleEndian, tags[tag]))
+      {
+        return false;
+      }
+      break;
+    case k_TileWidthTag:
+      return false;
+    default:
+      break;
+    }
+  }
+
+  if(tags.count(k_ImageWidthTag) == 0 || tags.count(k_ImageLengthTag) == 0 || tags.count(k_PhotometricTag) == 0 || tags.count(k_StripOffsetsTag) == 0 ||
+     tags.count(k_StripByteCountsTag) == 0)
+  {
+    return false;
+  }
+
+  // Compressed, planar, flipped, inverted and palette images are converted by the filter
+  quint32 photometric = tiffValue(tags, k_PhotometricTag, 0);
+  if(tiffValue(tags, k_CompressionTag, 1) != 1 || tiffValue(tags, k_PlanarConfigurationTag, 1) != 1 || tiffValue(tags, k_OrientationTag, 1) != 1 || (photometric != 1 && photometric != 2))
+  {
+    return false;
+  }
+
+  quint32 samplesPerPixel = tiffValue(tags, k_SamplesPerPixelTag, 1);
+  std::vector<quint32> bitsPerSample = tags.count(k_BitsPerSampleTag) > 0 ? tags[k_BitsPerSampleTag] : std::vector<quint32>(1, 1);
+  quint32 bits = bitsPerSample.front();
+  for(quint32 sampleBits : bitsPerSample)
+  {
+    if(sampleBits != bits)
+    {
+      return false;
+    }
+  }
+
+  // Only unsigned integer and 32-bit float samples have a matching SIMPL array type
+  quint32 sampleFormat = tiffValue(tags, k_SampleFormatTag, 1);
+  bool isFloat = (sampleFormat == 3);
+  if((sampleFormat != 1 && !isFloat) || (bits != 8 && bits != 16 && bits != 32) || (isFloat && bits != 32))
+  {
+    return false;
+  }
+
+  // Samples wider than a byte are only usable in place if they are stored in the byte order of the machine
+  if(bits > 8 && littleEndian != k_HostIsLittleEndian)
+  {
+    return false;
+  }
+
+  layout.width = tiffValue(tags, k_ImageWidthTag, 0);
+  layout.height = tiffValue(tags, k_ImageLengthTag, 0);
+  layout.numComps = samplesPerPixel;
+  layout.bytesPerComponent = bits / 8;
+  layout.isFloat = isFloat;
+  if(layout.width == 0 || layout.height == 0 || samplesPerPixel == 0)
+  {
+    return false;
+  }
+
+  // The strips have to follow each other in the file to form a single pixel region
+  const std::vector<quint32>& stripOffsets = tags[k_StripOffsetsTag];
+  const std::vector<quint32>& stripByteCounts = tags[k_StripByteCountsTag];
+  if(stripOffsets.size() != stripByteCounts.size())
+  {
+    return false;
+  }
+
+  qint64 regionSize = 0;
+  for(size_t i = 0; i < stripOffsets.size(); i++)
+  {
+    if(stripOffsets[i] != stripOffsets.front() + regionSize)
+    {
+      return false;
+    }
+    regionSize += stripByteCounts[i];
+  }
+
+  layout.offset = stripOffsets.front();
+  return regionSize >= static_cast<qint64>(layout.width * layout.height * layout.numComps * layout.bytesPerComponent);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readBmpLayout(QFile& file, IMFMappedImageReader::PixelLayout& layout)
+{
+  QByteArray header = file.read(54);
+  if(header.size() != 54 || !header.startsWith("BM"))
+  {
+    return false;
+  }
+
+  const uchar* headerBytes = reinterpret_cast<const uchar*>(header.constData());
+  quint32 pixelOffset = readUInt32(headerBytes + 10, true);
+  quint32 infoSize = readUInt32(headerBytes + 14, true);
+  qint32 width = static_cast<qint32>(readUInt32(headerBytes + 18, true));
+  qint32 height = static_cast<qint32>(readUInt32(headerBytes + 22, true));
+  quint16 planes = readUInt16(headerBytes + 26, true);
+  quint16 bitCount = readUInt16(headerBytes + 28, true);
+  quint32 compression = readUInt32(headerBytes + 30, true);
+  quint32 colorsUsed = readUInt32(headerBytes + 46, true);
+
+  // Color files store BGR samples and most files store their rows bottom-up and padded to four
+  // bytes, which the filter reorders.  Only top-down 8-bit rows without padding are usable in place.
+  if(infoSize < 40 || planes != 1 || bitCount != 8 || compression != 0 || width <= 0 || width % 4 != 0 || height >= 0)
+  {
+    return false;
+  }
+
+  // The pixels are palette indices, so they are only the gray values if the palette maps every index onto itself
+  colorsUsed = (colorsUsed == 0) ? 256 : colorsUsed;
+  if(colorsUsed > 256 || !file.seek(14 + infoSize))
+  {
+    return false;
+  }
+
+  QByteArray palette = file.read(colorsUsed * 4);
+  if(palette.size() != static_cast<int>(colorsUsed * 4))
+  {
+    return false;
+  }
+
+  const uchar* paletteBytes = reinterpret_cast<const uchar*>(palette.constData());
+  for(quint32 i = 0; i < colorsUsed; i++)
+  {
+    const uchar* color = paletteBytes + i * 4;
+    if(color[0] != i || color[1] != i || color[2] != i)
+    {
+      return false;
+    }
+  }
+
+  layout.offset = pixelOffset;
+  layout.width = static_cast<size_t>(width);
+  layout.height = static_cast<size_t>(-static_cast<qint64>(height));
+  layout.numComps = 1;
+  layout.bytesPerComponent = 1;
+  layout.isFloat = false;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+IDataArray::Pointer mapPixels(const QString& filePath, const IMFMappedImageReader::PixelLayout& layout, const IDataArray::Pointer& preflightData)
+{
+  // The filter decides the array type, so a file that it reads into a different type is not mapped
+  if(!std::dynamic_pointer_cast<DataArray<T>>(preflightData))
+  {
+    return IDataArray::NullPointer();
+  }
+
+  std::shared_ptr<MappedPixels<T>> mapping = std::make_shared<MappedPixels<T>>();
+  mapping->file.setFileName(filePath);
+  if(!mapping->file.open(QIODevice::ReadOnly))
+  {
+    return IDataArray::NullPointer();
+  }
+
+  // A private mapping is copy-on-write, so modifying the array never writes back to the file
+  size_t numTuples = layout.width * layout.height;
+  qint64 numBytes = static_cast<qint64>(numTuples * layout.numComps * sizeof(T));
+  uchar* pixels = mapping->file.map(layout.offset, numBytes, QFileDevice::MapPrivateOption);
+  if(pixels == nullptr || reinterpret_cast<quintptr>(pixels) % alignof(T) != 0)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  // The mapping outlives the file handle, so a folder of many images does not run out of descriptors
+  mapping->file.close();
+
+  mapping->array = DataArray<T>::WrapPointer(reinterpret_cast<T*>(pixels), numTuples, preflightData->getComponentDimensions(), preflightData->getName(), false);
+
+  // The returned pointer shares ownership of the mapping, so the file is unmapped once the last user of the array is gone
+  return typename DataArray<T>::Pointer(mapping, mapping->array.get());
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFMappedImageReader::ReadPixelLayout(const QString& filePath, PixelLayout& layout)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QByteArray magic = file.peek(2);
+  bool mappable = false;
+  if(magic == "II" || magic == "MM")
+  {
+    mappable = readTiffLayout(file, layout);
+  }
+  else if(magic == "BM")
+  {
+    mappable = readBmpLayout(file, layout);
+  }
+
+  qint64 numBytes = static_cast<qint64>(layout.width * layout.height * layout.numComps * layout.bytesPerComponent);
+  return mappable && layout.offset + numBytes <= file.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFMappedImageReader::MapImage(const QString& filePath, const DataContainerArray::Pointer& dca)
+{
+  PixelLayout layout;
+  if(!ReadPixelLayout(filePath, layout))
+  {
+    return false;
+  }
+
+  // The reader filter creates a single image geometry with a single pixel array
+  if(dca->getDataContainers().size() != 1)
+  {
+    return false;
+  }
+
+  DataContainer::Pointer dc = dca->getDataContainers().front();
+  ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+  if(!imageGeom)
+  {
+    return false;
+  }
+
+  SizeVec3Type dims = imageGeom->getDimensions();
+  if(dims[0] != layout.width || dims[1] != layout.height || dims[2] != 1)
+  {
+    return false;
+  }
+
+  AttributeMatrix::Pointer pixelAM;
+  IDataArray::Pointer pixelData;
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      if(pixelData)
+      {
+        return false;
+      }
+      pixelAM = am;
+      pixelData = am->getAttributeArray(arrayName);
+    }
+  }
+
+  if(!pixelData || pixelData->getNumberOfTuples() != layout.width * layout.height || static_cast<size_t>(pixelData->getNumberOfComponents()) != layout.numComps)
+  {
+    return false;
+  }
+
+  IDataArray::Pointer mappedData;
+  if(layout.isFloat)
+  {
+    mappedData = mapPixels<float>(filePath, layout, pixelData);
+  }
+  else if(layout.bytesPerComponent == 1)
+  {
+    mappedData = mapPixels<uint8_t>(filePath, layout, pixelData);
+  }
+  else if(layout.bytesPerComponent == 2)
+  {
+    mappedData = mapPixels<uint16_t>(filePath, layout, pixelData);
+  }
+  else if(layout.bytesPerComponent == 4)
+  {
+    mappedData = mapPixels<uint32_t>(filePath, layout, pixelData);
+  }
+
+  if(!mappedData)
+  {
+    return false;
+  }
+
+  pixelAM->addOrReplaceAttributeArray(mappedData);
+  return true;
+}
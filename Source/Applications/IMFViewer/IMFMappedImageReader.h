@@ -0,0 +1,91 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+/**
+ * @brief The IMFMappedImageReader class backs the pixel array of an uncompressed image with a
+ * private memory mapping of the file instead of reading it into a new allocation.  Pages are
+ * only faulted in when the pixels are first touched, and writing to the array copies the
+ * touched pages rather than modifying the file.
+ *
+ * Only files whose pixels are stored exactly as SIMPL lays them out can be mapped: single page
+ * TIFF files without compression that store their samples interleaved in contiguous top-down
+ * strips, and BMP files with 8-bit grayscale rows stored top-down without padding.  Every other
+ * file is left to the image reader filter.
+ */
+class IMFMappedImageReader
+{
+public:
+  /**
+   * @brief The PixelLayout struct describes where and how the pixels are stored in a file
+   */
+  struct PixelLayout
+  {
+    qint64 offset = 0;
+    size_t width = 0;
+    size_t height = 0;
+    size_t numComps = 0;
+    size_t bytesPerComponent = 0;
+    bool isFloat = false;
+  };
+
+  /**
+   * @brief Reads the header of the image file and returns true if its pixels can be mapped
+   * @param filePath
+   * @param layout
+   * @return
+   */
+  static bool ReadPixelLayout(const QString& filePath, PixelLayout& layout);
+
+  /**
+   * @brief Replaces the unallocated pixel array that the image reader filter created during
+   * preflight with an array that maps the pixels of the file.  Returns false and leaves the
+   * data container array untouched if the file cannot be mapped or does not match the
+   * preflighted geometry and array, in which case the filter has to be executed.
+   * @param filePath
+   * @param dca
+   * @return
+   */
+  static bool MapImage(const QString& filePath, const DataContainerArray::Pointer& dca);
+
+private:
+  IMFMappedImageReader() = delete;
+};
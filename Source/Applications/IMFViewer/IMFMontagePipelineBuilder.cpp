@@ -0,0 +1,771 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "IMFMontagePipelineBuilder.h"
+
+#include <algorithm>
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Utilities/SIMPLH5DataReader.h"
+#include "SIMPLib/Utilities/SIMPLH5DataReaderRequirements.h"
+
+#include "IMFViewer/IMFFilterFactory.h"
+#include "IMFViewer/IMFGrayscaleFilter.h"
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFParallelTileImportFilter.h"
+#include "IMFViewer/IMFReadRegionFilter.h"
+#include "IMFViewer/IMFRegistrationCache.h"
+#include "IMFViewer/IMFStreamingStitcher.h"
+#include "IMFViewer/IMFTileCache.h"
+
+const char* IMFMontagePipelineBuilder::SliceProperty = "MontageSlice";
+const char* IMFMontagePipelineBuilder::PipelinedProperty = "PipelinedMontage";
+
+namespace
+{
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void readIntVec2(const QJsonObject& json, const QString& key, IntVec2Type& value)
+{
+  QJsonArray array = json[key].toArray();
+  if(array.size() == 2)
+  {
+    value = {array[0].toInt(), array[1].toInt()};
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readFloatVec3(const QJsonObject& json, const QString& key, FloatVec3Type& value)
+{
+  QJsonArray array = json[key].toArray();
+  if(array.size() != 3)
+  {
+    return false;
+  }
+
+  value = {static_cast<float>(array[0].toDouble()), static_cast<float>(array[1].toDouble()), static_cast<float>(array[2].toDouble())};
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void readRectF(const QJsonObject& json, const QString& key, QRectF& value)
+{
+  QJsonArray array = json[key].toArray();
+  if(array.size() == 4)
+  {
+    value = QRectF(array[0].toDouble(), array[1].toDouble(), array[2].toDouble(), array[3].toDouble());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Decodes each tile with its own import filter, on threadCount threads and through the tile
+// cache when it is enabled, so tiles decoded by an earlier import are not decoded again.
+// Tiles are converted by the convert function as soon as they are decoded.
+// -----------------------------------------------------------------------------
+AbstractFilter::Pointer wrapTileImportFilter(const AbstractFilter::Pointer& importFilter, const IMFParallelTileImportFilter::TileFilterFunction& tileFilterFunction,
+                                             const IMFMontagePipelineBuilder::MontageSettings& settings, int slice, int threadCount,
+                                             const IMFParallelTileImportFilter::TileConvertFunction& tileConvertFunction = IMFParallelTileImportFilter::TileConvertFunction())
+{
+  int tileCount = (settings.MontageEnd[0] - settings.MontageStart[0] + 1) * (settings.MontageEnd[1] - settings.MontageStart[1] + 1);
+  bool useTileCache = IMFTileCache::IsEnabled();
+  if(tileCount <= 1 || (threadCount <= 1 && !useTileCache && !tileConvertFunction))
+  {
+    return importFilter;
+  }
+
+  IMFParallelTileImportFilter::TileKeyFunction tileKeyFunction;
+  if(useTileCache)
+  {
+    tileKeyFunction = [=](const IntVec2Type& position) { return IMFTileCache::ComputeTileKey(settings, slice, IMFTileCache::ImportStage, position); };
+  }
+  return IMFParallelTileImportFilter::New(importFilter, tileFilterFunction, threadCount, tileKeyFunction, tileConvertFunction);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFParallelTileImportFilter::TileConvertFunction grayscaleConvertFunction(const IMFMontagePipelineBuilder::MontageSettings& settings, const QString& amName, const QString& daName)
+{
+  if(!settings.ConvertToGrayscale)
+  {
+    return IMFParallelTileImportFilter::TileConvertFunction();
+  }
+
+  FloatVec3Type colorWeighting = settings.ColorWeighting;
+  return [=](const DataContainer::Pointer& tileDC) { return IMFGrayscaleFilter::ConvertTile(tileDC, amName, daName, colorWeighting); };
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFMontagePipelineBuilder::IMFMontagePipelineBuilder(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFMontagePipelineBuilder::~IMFMontagePipelineBuilder() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFMontagePipelineBuilder::MontageType IMFMontagePipelineBuilder::MontageTypeFromString(const QString& name, bool* ok)
+{
+  QString lowerName = name.toLower();
+  bool found = true;
+  MontageType type = MontageType::Fiji;
+  if(lowerName == "dream3d")
+  {
+    type = MontageType::DREAM3D;
+  }
+  else if(lowerName == "fiji")
+  {
+    type = MontageType::Fiji;
+  }
+  else if(lowerName == "robomet")
+  {
+    type = MontageType::Robomet;
+  }
+  else if(lowerName == "zeiss")
+  {
+    type = MontageType::Zeiss;
+  }
+  else if(lowerName == "zeisszen")
+  {
+    type = MontageType::ZeissZen;
+  }
+  else
+  {
+    found = false;
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = found;
+  }
+  return type;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFMontagePipelineBuilder::DisplayType IMFMontagePipelineBuilder::DisplayTypeFromString(const QString& name, bool* ok)
+{
+  QString lowerName = name.toLower();
+  bool found = true;
+  DisplayType type = DisplayType::Montage;
+  if(lowerName == "montage")
+  {
+    type = DisplayType::Montage;
+  }
+  else if(lowerName == "sidebyside")
+  {
+    type = DisplayType::SideBySide;
+  }
+  else if(lowerName == "outline")
+  {
+    type = DisplayType::Outline;
+  }
+  else
+  {
+    found = false;
+  }
+
+  if(ok != nullptr)
+  {
+    *ok = found;
+  }
+  return type;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFMontagePipelineBuilder::ReadSettings(const QJsonObject& json, MontageSettings& settings)
+{
+  bool ok = false;
+  settings.Type = MontageTypeFromString(json["Type"].toString(), &ok);
+  if(!ok)
+  {
+    return false;
+  }
+
+  settings.MontageName = json["Name"].toString(settings.MontageName);
+  settings.InputFilePath = json["InputFile"].toString(settings.InputFilePath);
+  readIntVec2(json, "MontageStart", settings.MontageStart);
+  readIntVec2(json, "MontageEnd", settings.MontageEnd);
+  settings.OverrideSpacing = readFloatVec3(json, "Spacing", settings.Spacing);
+  settings.OverrideOrigin = readFloatVec3(json, "Origin", settings.Origin);
+  settings.LengthUnit = json["LengthUnit"].toInt(settings.LengthUnit);
+
+  if(json.contains("DisplayType"))
+  {
+    settings.Display = DisplayTypeFromString(json["DisplayType"].toString(), &ok);
+    if(!ok)
+    {
+      return false;
+    }
+  }
+
+  settings.StitchedOutputFile = json["StitchedOutputFile"].toString(settings.StitchedOutputFile);
+  settings.LowMemoryStitching = json["LowMemoryStitching"].toBool(settings.LowMemoryStitching);
+  settings.DecodeThreadCount = json["DecodeThreads"].toInt(settings.DecodeThreadCount);
+
+  settings.ConvertToGrayscale = json["ConvertToGrayscale"].toBool(settings.ConvertToGrayscale);
+  readFloatVec3(json, "ColorWeighting", settings.ColorWeighting);
+
+  settings.SliceMin = json["SliceMin"].toInt(settings.SliceMin);
+  settings.SliceMax = json["SliceMax"].toInt(settings.SliceMax);
+  settings.ImagePrefix = json["ImagePrefix"].toString(settings.ImagePrefix);
+  settings.ImageExtension = json["ImageExtension"].toString(settings.ImageExtension);
+
+  settings.DataContainerPrefix = json["DataContainerPrefix"].toString(settings.DataContainerPrefix);
+  settings.AttributeMatrixName = json["AttributeMatrixName"].toString(settings.AttributeMatrixName);
+  settings.DataArrayName = json["DataArrayName"].toString(settings.DataArrayName);
+  readRectF(json, "Region", settings.Region);
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataArrayPath IMFMontagePipelineBuilder::MontagePath()
+{
+  return DataArrayPath("MontageDC", "MontageAM", "MontageData");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFMontagePipelineBuilder::TileDataContainerName(const QString& dcPrefix, const IntVec2Type& montageEnd, int32_t row, int32_t col)
+{
+  int32_t largestIndex = std::max(montageEnd[0], montageEnd[1]);
+  int padding = 0;
+  for(int32_t value = largestIndex; value > 0; value /= 10)
+  {
+    padding++;
+  }
+
+  return QString("%1r%2c%3").arg(dcPrefix).arg(row, padding, 10, QChar('0')).arg(col, padding, 10, QChar('0'));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainerArrayProxy IMFMontagePipelineBuilder::CreateTileProxy(SIMPLH5DataReader& reader, const QString& filePath, const QStringList& dcNames)
+{
+  if(!reader.openFile(filePath))
+  {
+    return DataContainerArrayProxy();
+  }
+
+  int err = 0;
+  SIMPLH5DataReaderRequirements req(SIMPL::Defaults::AnyPrimitive, SIMPL::Defaults::AnyComponentSize, AttributeMatrix::Type::Any, IGeometry::Type::Image);
+  DataContainerArrayProxy proxy = reader.readDataContainerArrayStructure(&req, err);
+  reader.closeFile();
+  if(err < 0)
+  {
+    return DataContainerArrayProxy();
+  }
+
+  QMap<QString, DataContainerProxy>& dcProxies = proxy.getDataContainers();
+  for(const QString& dcName : dcNames)
+  {
+    if(!dcProxies.contains(dcName))
+    {
+      return DataContainerArrayProxy();
+    }
+  }
+
+  for(const QString& dcName : dcProxies.keys())
+  {
+    if(!dcNames.contains(dcName))
+    {
+      dcProxies.remove(dcName);
+    }
+  }
+
+  proxy.setAllFlags(Qt::Checked);
+  return proxy;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFMontagePipelineBuilder::CreateStitchedFileReaderPipeline(const QString& pipelineName, const QString& filePath, int pyramidLevel)
+{
+  SIMPLH5DataReader reader;
+  QString dcName = IMFStreamingStitcher::PyramidLevelName(MontagePath().getDataContainerName(), pyramidLevel);
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  DataContainerArrayProxy proxy = CreateTileProxy(reader, filePath, {dcName});
+  hdf5Locker.unlock();
+  if(proxy == DataContainerArrayProxy())
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  AbstractFilter::Pointer dataContainerReader = IMFFilterFactory::CreateDataContainerReaderFilter(filePath, proxy);
+  if(!dataContainerReader)
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(pipelineName);
+  pipeline->pushBack(dataContainerReader);
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFMontagePipelineBuilder::setRegistrationCache(IMFRegistrationCache* cache)
+{
+  m_RegistrationCache = cache;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<FilterPipeline::Pointer> IMFMontagePipelineBuilder::createPipelines(const MontageSettings& settings)
+{
+  std::vector<FilterPipeline::Pointer> pipelines;
+  switch(settings.Type)
+  {
+  case MontageType::DREAM3D:
+    pipelines.push_back(createDREAM3DPipeline(settings));
+    break;
+  case MontageType::Fiji:
+    pipelines.push_back(createFijiPipeline(settings));
+    break;
+  case MontageType::Robomet:
+    for(int slice = settings.SliceMin; slice <= settings.SliceMax; slice++)
+    {
+      pipelines.push_back(createRobometPipeline(settings, slice));
+    }
+    break;
+  case MontageType::Zeiss:
+    pipelines.push_back(createZeissPipeline(settings));
+    break;
+  case MontageType::ZeissZen:
+    pipelines.push_back(createZeissZenPipeline(settings));
+    break;
+  }
+
+  // Drop the pipelines that could not be created
+  pipelines.erase(std::remove(pipelines.begin(), pipelines.end(), FilterPipeline::NullPointer()), pipelines.end());
+  return pipelines;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFMontagePipelineBuilder::appendMontageFilters(const FilterPipeline::Pointer& pipeline, const MontageSettings& settings, const QString& dcPrefix, const QString& amName, const QString& daName)
+{
+  if(settings.Display == DisplayType::SideBySide || settings.Display == DisplayType::Outline)
+  {
+    return;
+  }
+
+
+  IMFRegistrationCache::TileOrigins tileOrigins;
+  QString cacheKey;
+  if(m_RegistrationCache != nullptr && m_RegistrationCache->isEnabled())
+  {
+    cacheKey = IMFRegistrationCache::ComputeKey(settings, pipeline->property(SliceProperty).toInt(), dcPrefix, amName, daName);
+  }
+
+  if(!cacheKey.isEmpty() && m_RegistrationCache->lookup(cacheKey, tileOrigins))
+  {
+    // Restore the registered tile origins instead of recomputing the phase correlations
+    FloatVec3Type unusedSpacing = {1.0f, 1.0f, 1.0f};
+    for(auto iter = tileOrigins.constBegin(); iter != tileOrigins.constEnd(); iter++)
+    {
+      DataArrayPath dcPath(iter.key(), "", "");
+      AbstractFilter::Pointer setOriginFilter = IMFFilterFactory::CreateSetOriginResolutionFilter(dcPath, false, true, unusedSpacing, iter.value());
+      pipeline->pushBack(setOriginFilter);
+    }
+  }
+  else if(settings.PipelinedImport && settings.Type != MontageType::DREAM3D)
+  {
+    // The pipeline keeps only its import filter, which is preflighted for the tile geometries
+    pipeline->setProperty(PipelinedProperty, true);
+    if(!cacheKey.isEmpty())
+    {
+      pipeline->setProperty(IMFRegistrationCache::KeyProperty, cacheKey);
+      pipeline->setProperty(IMFRegistrationCache::TilePrefixProperty, dcPrefix);
+    }
+  }
+  else
+  {
+    AbstractFilter::Pointer itkRegistrationFilter = IMFFilterFactory::CreatePCMTileRegistrationFilter(settings.MontageStart, settings.MontageEnd, dcPrefix, amName, daName);
+    pipeline->pushBack(itkRegistrationFilter);
+
+    if(!cacheKey.isEmpty())
+    {
+      pipeline->setProperty(IMFRegistrationCache::KeyProperty, cacheKey);
+      pipeline->setProperty(IMFRegistrationCache::TilePrefixProperty, dcPrefix);
+    }
+  }
+
+  // The ITK stitching filter blends the tile overlaps but needs every tile and the montage in
+  // memory at once.  Pipelined imports are always stitched by IMFStreamingStitcher.
+  bool pipelined = pipeline->property(PipelinedProperty).toBool();
+  if(settings.StitchedOutputFile.isEmpty() && !settings.LowMemoryStitching && !pipelined)
+  {
+    AbstractFilter::Pointer itkStitchingFilter = IMFFilterFactory::CreateTileStitchingFilter(settings.MontageStart, settings.MontageEnd, dcPrefix, amName, daName, MontagePath());
+    pipeline->pushBack(itkStitchingFilter);
+    return;
+  }
+
+  // IMFStreamingStitcher composites the tiles after the pipeline executed and releases each
+  // tile row once it has been written, into the output file when one is given and into
+  // the data container array otherwise
+  pipeline->setProperty(IMFStreamingStitcher::TilePrefixProperty, dcPrefix);
+  pipeline->setProperty(IMFStreamingStitcher::AttributeMatrixNameProperty, amName);
+  pipeline->setProperty(IMFStreamingStitcher::DataArrayNameProperty, daName);
+  if(settings.StitchedOutputFile.isEmpty())
+  {
+    return;
+  }
+
+  QString outputFilePath = settings.StitchedOutputFile;
+  if(settings.Type == MontageType::Robomet && settings.SliceMax > settings.SliceMin)
+  {
+    QFileInfo fi(outputFilePath);
+    QString slice = pipeline->getName().section('_', -1);
+    outputFilePath = fi.dir().filePath(QString("%1_%2.%3").arg(fi.completeBaseName(), slice, fi.suffix()));
+  }
+
+  pipeline->setProperty(IMFStreamingStitcher::OutputFileProperty, outputFilePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFMontagePipelineBuilder::createDREAM3DPipeline(const MontageSettings& settings)
+{
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(settings.MontageName);
+
+  QString dataFilePath = settings.InputFilePath;
+  QString dcPrefix = settings.DataContainerPrefix;
+  IntVec2Type montageStart = settings.MontageStart;
+  IntVec2Type montageEnd = settings.MontageEnd;
+
+  QStringList dcNames;
+  for(int32_t row = montageStart[1]; row <= montageEnd[1]; row++)
+  {
+    for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
+    {
+      dcNames.push_back(TileDataContainerName(dcPrefix, montageEnd, row, col));
+    }
+  }
+
+  if(!settings.Region.isEmpty())
+  {
+    // Only the tiles that overlap the region are read, each cropped to the region by a hyperslab
+    // selection.  The tiles are renamed to a grid that starts at the first overlapping tile so the
+    // registration and stitching filters see a complete montage.
+    IntVec2Type regionStart;
+    IntVec2Type regionEnd;
+    QStringList sourceNames;
+    QStringList targetNames;
+    int err = IMFReadRegionFilter::PlanRegion(dataFilePath, dcPrefix, montageStart, montageEnd, settings.AttributeMatrixName, settings.Region, regionStart, regionEnd, sourceNames, targetNames);
+    if(err < 0)
+    {
+      QString msg = (err == IMFReadRegionFilter::k_EmptyRegionError) ? tr("The region does not overlap any tile of the montage.") : tr("The tiles of the montage could not be read from '%1'.").arg(dataFilePath);
+      emit notifyErrorMessage("Import DREAM3D Montage", msg, err);
+      return FilterPipeline::NullPointer();
+    }
+
+    pipeline->pushBack(IMFReadRegionFilter::New(dataFilePath, settings.AttributeMatrixName, settings.DataArrayName, settings.Region, sourceNames, targetNames));
+
+    MontageSettings regionSettings = settings;
+    regionSettings.MontageStart = regionStart;
+    regionSettings.MontageEnd = regionEnd;
+    appendMontageFilters(pipeline, regionSettings, dcPrefix, settings.AttributeMatrixName, settings.DataArrayName);
+
+    return pipeline;
+  }
+
+  SIMPLH5DataReader reader;
+  connect(&reader, &SIMPLH5DataReader::errorGenerated, this, [=](const QString& title, const QString& msg, const int& code) { emit notifyErrorMessage(title, msg, code); });
+
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  DataContainerArrayProxy dream3dProxy = CreateTileProxy(reader, dataFilePath, dcNames);
+  hdf5Locker.unlock();
+  if(dream3dProxy == DataContainerArrayProxy())
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  AbstractFilter::Pointer dataContainerReader = IMFFilterFactory::CreateDataContainerReaderFilter(dataFilePath, dream3dProxy);
+  if(!dataContainerReader)
+  {
+    emit notifyErrorMessage("Import DREAM3D Montage", tr("The DataContainerReader filter could not be created."), -1);
+    return FilterPipeline::NullPointer();
+  }
+
+  // The HDF5 calls are serialized by IMFHdf5Lock anyway, so the tiles are read one at a time
+  IMFParallelTileImportFilter::TileFilterFunction tileFilterFunction = [=](const IntVec2Type& position) -> AbstractFilter::Pointer {
+    SIMPLH5DataReader tileReader;
+    QStringList tileNames = {TileDataContainerName(dcPrefix, montageEnd, position[1], position[0])};
+    QMutexLocker tileHdf5Locker(IMFHdf5Lock::Mutex());
+    DataContainerArrayProxy tileProxy = CreateTileProxy(tileReader, dataFilePath, tileNames);
+    tileHdf5Locker.unlock();
+    if(tileProxy == DataContainerArrayProxy())
+    {
+      return AbstractFilter::NullPointer();
+    }
+
+    return IMFFilterFactory::CreateDataContainerReaderFilter(dataFilePath, tileProxy);
+  };
+  dataContainerReader = wrapTileImportFilter(dataContainerReader, tileFilterFunction, settings, 0, 1);
+
+  pipeline->pushBack(dataContainerReader);
+
+  appendMontageFilters(pipeline, settings, dcPrefix, settings.AttributeMatrixName, settings.DataArrayName);
+
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFMontagePipelineBuilder::createFijiPipeline(const MontageSettings& settings)
+{
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(settings.MontageName);
+
+  DataArrayPath dcPath("UntitledMontage_", "", "");
+  QString amName = "Cell Attribute Matrix";
+  QString daName = "Image Data";
+  AbstractFilter::Pointer importFijiMontageFilter = IMFFilterFactory::CreateImportFijiMontageFilter(settings.InputFilePath, dcPath, amName, daName, settings.OverrideOrigin, settings.Origin,
+                                                                                                   settings.MontageStart, settings.MontageEnd, settings.OverrideSpacing, settings.Spacing, settings.LengthUnit);
+  if(!importFijiMontageFilter)
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  // Each tile is decoded by its own import filter so that several can be decoded at once
+  IMFParallelTileImportFilter::TileFilterFunction tileFilterFunction = [=](const IntVec2Type& position) {
+    return IMFFilterFactory::CreateImportFijiMontageFilter(settings.InputFilePath, dcPath, amName, daName, settings.OverrideOrigin, settings.Origin, position, position, settings.OverrideSpacing,
+                                                           settings.Spacing, settings.LengthUnit);
+  };
+  importFijiMontageFilter = wrapTileImportFilter(importFijiMontageFilter, tileFilterFunction, settings, 0, settings.DecodeThreadCount);
+
+  pipeline->pushBack(importFijiMontageFilter);
+
+  QString dcPrefix = dcPath.getDataContainerName() + "_";
+  appendMontageFilters(pipeline, settings, dcPrefix, amName, daName);
+
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFMontagePipelineBuilder::createRobometPipeline(const MontageSettings& settings, int slice)
+{
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  QString pipelineName = settings.MontageName;
+  pipelineName.append(tr("_%1").arg(slice));
+  pipeline->setName(pipelineName);
+  pipeline->setProperty(SliceProperty, slice);
+
+  DataArrayPath dcPath("UntitledMontage_", "", "");
+  QString amName = "Cell Attribute Matrix";
+  QString daName = "Image Data";
+  QString imagePrefix = settings.ImagePrefix;
+  if(!imagePrefix.endsWith("_"))
+  {
+    imagePrefix.append("_");
+  }
+
+  AbstractFilter::Pointer importRoboMetMontageFilter =
+      IMFFilterFactory::CreateImportRobometMontageFilter(settings.InputFilePath, dcPath, amName, daName, slice, imagePrefix, settings.ImageExtension, settings.OverrideOrigin, settings.Origin,
+                                                         settings.MontageStart, settings.MontageEnd, settings.OverrideSpacing, settings.Spacing, settings.LengthUnit);
+  if(!importRoboMetMontageFilter)
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  IMFParallelTileImportFilter::TileFilterFunction tileFilterFunction = [=](const IntVec2Type& position) {
+    return IMFFilterFactory::CreateImportRobometMontageFilter(settings.InputFilePath, dcPath, amName, daName, slice, imagePrefix, settings.ImageExtension, settings.OverrideOrigin, settings.Origin,
+                                                              position, position, settings.OverrideSpacing, settings.Spacing, settings.LengthUnit);
+  };
+  importRoboMetMontageFilter = wrapTileImportFilter(importRoboMetMontageFilter, tileFilterFunction, settings, slice, 1);
+
+  pipeline->pushBack(importRoboMetMontageFilter);
+
+  QString dcPrefix = dcPath.getDataContainerName() + "_";
+  appendMontageFilters(pipeline, settings, dcPrefix, amName, daName);
+
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFMontagePipelineBuilder::createZeissPipeline(const MontageSettings& settings)
+{
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(settings.MontageName);
+
+  QString dcPrefix = "UntitledMontage_";
+  DataArrayPath dcPath("UntitledMontage", "", "");
+  QString amName = "Cell Attribute Matrix";
+  QString daName = "Image Data";
+  QString metadataAMName = "Metadata Attribute Matrix";
+  bool importAllMetadata = true;
+
+  AbstractFilter::Pointer importZeissMontage =
+      IMFFilterFactory::CreateImportZeissMontageFilter(settings.InputFilePath, dcPath, amName, daName, metadataAMName, importAllMetadata, false, settings.ColorWeighting,
+                                                       settings.OverrideOrigin, settings.Origin, settings.MontageStart, settings.MontageEnd, settings.OverrideSpacing, settings.Spacing);
+  if(!importZeissMontage)
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  IMFParallelTileImportFilter::TileFilterFunction tileFilterFunction = [=](const IntVec2Type& position) {
+    return IMFFilterFactory::CreateImportZeissMontageFilter(settings.InputFilePath, dcPath, amName, daName, metadataAMName, importAllMetadata, false, settings.ColorWeighting, settings.OverrideOrigin,
+                                                            settings.Origin, position, position, settings.OverrideSpacing, settings.Spacing);
+  };
+  importZeissMontage = wrapTileImportFilter(importZeissMontage, tileFilterFunction, settings, 0, 1, grayscaleConvertFunction(settings, amName, daName));
+
+  pipeline->pushBack(importZeissMontage);
+
+  // The tiles are converted as they are decoded instead of by the import filter.  IMFGrayscaleFilter
+  // describes the converted tiles in preflight and converts a tile that was imported on its own.
+  if(settings.ConvertToGrayscale)
+  {
+    pipeline->pushBack(IMFGrayscaleFilter::New(dcPrefix, amName, daName, settings.ColorWeighting));
+  }
+
+  appendMontageFilters(pipeline, settings, dcPrefix, amName, daName);
+
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFMontagePipelineBuilder::createZeissZenPipeline(const MontageSettings& settings)
+{
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(settings.MontageName);
+
+  QString dcPrefix = "UntitledMontage_";
+  DataArrayPath dcPath("UntitledMontage", "", "");
+  QString amName = "Cell Attribute Matrix";
+  QString daName = "Image Data";
+
+  AbstractFilter::Pointer importZeissMontage = IMFFilterFactory::CreateImportZeissZenMontageFilter(settings.InputFilePath, dcPath, amName, daName, false, settings.ColorWeighting,
+                                                                                                   settings.OverrideOrigin, settings.Origin, settings.MontageStart, settings.MontageEnd);
+  if(!importZeissMontage)
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  IMFParallelTileImportFilter::TileFilterFunction tileFilterFunction = [=](const IntVec2Type& position) {
+    return IMFFilterFactory::CreateImportZeissZenMontageFilter(settings.InputFilePath, dcPath, amName, daName, false, settings.ColorWeighting, settings.OverrideOrigin, settings.Origin, position,
+                                                               position);
+  };
+  importZeissMontage = wrapTileImportFilter(importZeissMontage, tileFilterFunction, settings, 0, 1, grayscaleConvertFunction(settings, amName, daName));
+
+  pipeline->pushBack(importZeissMontage);
+
+  // The tiles are converted as they are decoded instead of by the import filter.  IMFGrayscaleFilter
+  // describes the converted tiles in preflight and converts a tile that was imported on its own.
+  if(settings.ConvertToGrayscale)
+  {
+    pipeline->pushBack(IMFGrayscaleFilter::New(dcPrefix, amName, daName, settings.ColorWeighting));
+  }
+
+  appendMontageFilters(pipeline, settings, dcPrefix, amName, daName);
+
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFMontagePipelineBuilder::FinalizeMontageOutput(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, DisplayType displayType)
+{
+  if(displayType != DisplayType::Montage)
+  {
+    return;
+  }
+
+  // Montage names may contain underscores themselves, so the slice is not parsed from the pipeline name
+  int slice = pipeline->property(SliceProperty).toInt();
+
+  // Remove non-stitched image data containers.  Pyramid levels read from a stitched file are kept.
+  QString montageDCName = MontagePath().getDataContainerName();
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    if(dc->getName() == montageDCName || dc->getName().startsWith(montageDCName + "_L"))
+    {
+      ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+      if(imageGeom)
+      {
+        FloatVec3Type origin = imageGeom->getOrigin();
+        origin[2] += slice;
+        imageGeom->setOrigin(origin);
+      }
+    }
+    else
+    {
+      dca->removeDataContainer(dc->getName());
+    }
+  }
+}
@@ -0,0 +1,287 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QObject>
+#include <QtCore/QRectF>
+#include <QtCore/QStringList>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/DataContainers/DataContainerArrayProxy.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+#include "SIMPLib/Geometry/IGeometry.h"
+
+#include "SIMPLVtkLib/Dialogs/AbstractImportMontageDialog.h"
+
+class IMFRegistrationCache;
+class SIMPLH5DataReader;
+
+/**
+ * @brief The IMFMontagePipelineBuilder class creates the import, registration and
+ * stitching filter chain for each supported montage type.  It does not touch any
+ * widgets so that the GUI importers and the batch tool build identical pipelines.
+ */
+class IMFMontagePipelineBuilder : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFMontagePipelineBuilder(QObject* parent = nullptr);
+  ~IMFMontagePipelineBuilder() override;
+
+  enum class MontageType : int
+  {
+    DREAM3D,
+    Fiji,
+    Robomet,
+    Zeiss,
+    ZeissZen
+  };
+
+  using DisplayType = AbstractImportMontageDialog::DisplayType;
+
+  // Slice number of a Robomet slice pipeline
+  static const char* SliceProperty;
+
+  // Set on montage pipelines whose tiles are registered and stitched by IMFPipelinedMontage
+  static const char* PipelinedProperty;
+
+  struct MontageSettings
+  {
+    MontageType Type = MontageType::Fiji;
+    QString MontageName = "UntitledMontage";
+    QString InputFilePath;
+    IntVec2Type MontageStart = {0, 0};
+    IntVec2Type MontageEnd = {0, 0};
+    bool OverrideSpacing = false;
+    FloatVec3Type Spacing = {1.0f, 1.0f, 1.0f};
+    bool OverrideOrigin = false;
+    FloatVec3Type Origin = {0.0f, 0.0f, 0.0f};
+    int32_t LengthUnit = static_cast<int32_t>(IGeometry::LengthUnit::Micrometer);
+    DisplayType Display = DisplayType::Montage;
+
+    // When set, the tiles are stitched strip by strip into this .dream3d file instead of in memory
+    QString StitchedOutputFile;
+
+    // When set, montages stitched in memory are composited strip by strip by IMFStreamingStitcher,
+    // which releases each tile row once it has been copied.  Overlaps are not blended: the later
+    // tile covers the earlier one.  Otherwise the ITK stitching filter stitches the montage.
+    bool LowMemoryStitching = false;
+
+    // When set, tiles that are not in the registration cache are read, registered and stitched
+    // as a dataflow by IMFPipelinedMontage instead of by the registration filter
+    bool PipelinedImport = false;
+
+    // Fiji: tiles are decoded by this many threads.  One leaves decoding to the import filter
+    // unless the tile cache is enabled.
+    int DecodeThreadCount = 1;
+
+    // Zeiss
+    bool ConvertToGrayscale = false;
+    FloatVec3Type ColorWeighting = {0.2125f, 0.7154f, 0.0721f};
+
+    // Robomet
+    int SliceMin = 0;
+    int SliceMax = 0;
+    QString ImagePrefix;
+    QString ImageExtension;
+
+    // Stitched slices are assembled into a single 3D volume by IMFVolumeAssembler instead of
+    // being displayed one by one, optionally aligned to each other
+    bool AssembleVolume = false;
+    bool AlignSlices = false;
+
+    // DREAM3D
+    QString DataContainerPrefix;
+    QString AttributeMatrixName = "Cell Attribute Matrix";
+    QString DataArrayName = "Image Data";
+
+    // When not empty, only the part of each tile inside this rectangle, in montage coordinates, is read
+    QRectF Region;
+  };
+
+  /**
+   * @brief Reads montage settings from a JSON object.  Keys that are missing keep
+   * their default values.
+   * @param json
+   * @param settings
+   * @return false if the montage type is missing or unknown
+   */
+  static bool ReadSettings(const QJsonObject& json, MontageSettings& settings);
+
+  /**
+   * @brief Returns the montage type that matches the name, case insensitive
+   * @param name
+   * @param ok
+   * @return
+   */
+  static MontageType MontageTypeFromString(const QString& name, bool* ok = nullptr);
+
+  /**
+   * @brief Returns the display type that matches the name, case insensitive
+   * @param name
+   * @param ok
+   * @return
+   */
+  static DisplayType DisplayTypeFromString(const QString& name, bool* ok = nullptr);
+
+  /**
+   * @brief Creates the pipelines for the montage.  Robomet montages produce one
+   * pipeline per slice, all other types produce a single pipeline.
+   * @param settings
+   * @return
+   */
+  std::vector<FilterPipeline::Pointer> createPipelines(const MontageSettings& settings);
+
+  /**
+   * @brief Prepares the output of an executed montage pipeline for display or saving.
+   * When the montage is displayed stitched, the tile data containers are removed and
+   * the stitched data container is offset by the slice number in the pipeline name.
+   * @param pipeline
+   * @param dca
+   * @param displayType
+   */
+  static void FinalizeMontageOutput(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, DisplayType displayType);
+
+  /**
+   * @brief Returns the path of the stitched montage array
+   * @return
+   */
+  static DataArrayPath MontagePath();
+
+  /**
+   * @brief Returns the name of the tile data container at the row and column.  The
+   * indices are zero padded to the number of digits of the largest montage index, the
+   * same names the montage import filters give their tiles.
+   * @param dcPrefix
+   * @param montageEnd
+   * @param row
+   * @param col
+   * @return
+   */
+  static QString TileDataContainerName(const QString& dcPrefix, const IntVec2Type& montageEnd, int32_t row, int32_t col);
+
+  /**
+   * @brief Reads the structure of a .dream3d file and returns a proxy in which only the
+   * named image data containers are checked.  The caller holds the HDF5 lock.
+   * @param reader
+   * @param filePath
+   * @param dcNames
+   * @return The proxy, or an empty proxy if the file could not be read
+   */
+  static DataContainerArrayProxy CreateTileProxy(SIMPLH5DataReader& reader, const QString& filePath, const QStringList& dcNames);
+
+  /**
+   * @brief Creates a pipeline that reads the stitched montage from a file written by
+   * IMFStreamingStitcher.  Pyramid levels above 0 read the downsampled copy instead of
+   * the full resolution montage.
+   * @param pipelineName
+   * @param filePath
+   * @param pyramidLevel
+   * @return The pipeline, or a null pointer if the file does not contain the level
+   */
+  static FilterPipeline::Pointer CreateStitchedFileReaderPipeline(const QString& pipelineName, const QString& filePath, int pyramidLevel = 0);
+
+  /**
+   * @brief Sets the cache that is checked for earlier registration results.  When a
+   * result is found, the registration filter is replaced by filters that restore the
+   * cached tile origins.
+   * @param cache
+   */
+  void setRegistrationCache(IMFRegistrationCache* cache);
+
+signals:
+  void notifyErrorMessage(const QString& title, const QString& msg, int code);
+
+private:
+  IMFRegistrationCache* m_RegistrationCache = nullptr;
+
+  /**
+   * @brief createDREAM3DPipeline
+   * @param settings
+   * @return
+   */
+  FilterPipeline::Pointer createDREAM3DPipeline(const MontageSettings& settings);
+
+  /**
+   * @brief createFijiPipeline
+   * @param settings
+   * @return
+   */
+  FilterPipeline::Pointer createFijiPipeline(const MontageSettings& settings);
+
+  /**
+   * @brief createRobometPipeline
+   * @param settings
+   * @param slice
+   * @return
+   */
+  FilterPipeline::Pointer createRobometPipeline(const MontageSettings& settings, int slice);
+
+  /**
+   * @brief createZeissPipeline
+   * @param settings
+   * @return
+   */
+  FilterPipeline::Pointer createZeissPipeline(const MontageSettings& settings);
+
+  /**
+   * @brief createZeissZenPipeline
+   * @param settings
+   * @return
+   */
+  FilterPipeline::Pointer createZeissZenPipeline(const MontageSettings& settings);
+
+  /**
+   * @brief Appends the registration filter and, when the montage is displayed stitched, the ITK
+   * stitching filter, or marks the pipeline for IMFStreamingStitcher when the montage is streamed
+   * to a file, imported pipelined or stitched with low memory.  Tile origins found in the
+   * registration cache replace the registration filter.
+   * @param pipeline
+   * @param settings
+   * @param dcPrefix
+   * @param amName
+   * @param daName
+   */
+  void appendMontageFilters(const FilterPipeline::Pointer& pipeline, const MontageSettings& settings, const QString& dcPrefix, const QString& amName, const QString& daName);
+
+  IMFMontagePipelineBuilder(const IMFMontagePipelineBuilder&); // Copy Constructor Not Implemented
+  void operator=(const IMFMontagePipelineBuilder&);            // Operator '=' Not Implemented
+};
@@ -0,0 +1,353 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFOffscreenRenderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <QtCore/QFileInfo>
+
+#include <vtkBMPWriter.h>
+#include <vtkCamera.h>
+#include <vtkDataArray.h>
+#include <vtkExtractVOI.h>
+#include <vtkImageData.h>
+#include <vtkImageProperty.h>
+#include <vtkImageSlice.h>
+#include <vtkImageSliceMapper.h>
+#include <vtkImageWriter.h>
+#include <vtkJPEGWriter.h>
+#include <vtkPNGWriter.h>
+#include <vtkPointData.h>
+#include <vtkRenderWindow.h>
+#include <vtkRenderer.h>
+#include <vtkTIFFWriter.h>
+#include <vtkType.h>
+#include <vtkWindowToImageFilter.h>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFTrace.h"
+#include "IMFViewer/IMFVtkArrayBridge.h"
+
+namespace
+{
+struct ImageBounds
+{
+  double xMin = std::numeric_limits<double>::max();
+  double xMax = std::numeric_limits<double>::lowest();
+  double yMin = std::numeric_limits<double>::max();
+  double yMax = std::numeric_limits<double>::lowest();
+  double finestSpacing = std::numeric_limits<double>::max();
+
+  bool isEmpty() const
+  {
+    return xMax <= xMin || yMax <= yMin;
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Returns the first cell array that holds one tuple per pixel of the image geometry
+// -----------------------------------------------------------------------------
+IDataArray::Pointer findImageArray(const DataContainer::Pointer& dc, size_t numPixels)
+{
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    if(am->getType() != AttributeMatrix::Type::Cell || am->getNumberOfTuples() != numPixels)
+    {
+      continue;
+    }
+
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      IDataArray::Pointer array = am->getAttributeArray(arrayName);
+      if(array != IDataArray::NullPointer())
+      {
+        return array;
+      }
+    }
+  }
+  return IDataArray::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ImageBounds findImageBounds(const std::vector<DataContainer::Pointer>& dataContainers)
+{
+  ImageBounds bounds;
+  for(const DataContainer::Pointer& dc : dataContainers)
+  {
+    ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+    if(!imageGeom)
+    {
+      continue;
+    }
+
+    SizeVec3Type dims = imageGeom->getDimensions();
+    FloatVec3Type origin = imageGeom->getOrigin();
+    FloatVec3Type spacing = imageGeom->getSpacing();
+    bounds.xMin = std::min(bounds.xMin, static_cast<double>(origin[0]));
+    bounds.yMin = std::min(bounds.yMin, static_cast<double>(origin[1]));
+    bounds.xMax = std::max(bounds.xMax, static_cast<double>(origin[0]) + static_cast<double>(spacing[0]) * dims[0]);
+    bounds.yMax = std::max(bounds.yMax, static_cast<double>(origin[1]) + static_cast<double>(spacing[1]) * dims[1]);
+    bounds.finestSpacing = std::min({bounds.finestSpacing, static_cast<double>(spacing[0]), static_cast<double>(spacing[1])});
+  }
+  return bounds;
+}
+
+// -----------------------------------------------------------------------------
+// Places the pixels of the image geometry at the cell centers, so that the image slice
+// covers the same area as the cells
+// -----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageSlice> createImageSlice(const DataContainer::Pointer& dc)
+{
+  ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+  if(!imageGeom)
+  {
+    return nullptr;
+  }
+
+  SizeVec3Type dims = imageGeom->getDimensions();
+  FloatVec3Type origin = imageGeom->getOrigin();
+  FloatVec3Type spacing = imageGeom->getSpacing();
+  vtkSmartPointer<vtkDataArray> scalars = IMFVtkArrayBridge::WrapDataArray(findImageArray(dc, dims[0] * dims[1] * dims[2]));
+  if(scalars == nullptr)
+  {
+    return nullptr;
+  }
+
+  vtkSmartPointer<vtkImageData> imageData = vtkSmartPointer<vtkImageData>::New();
+  imageData->SetDimensions(static_cast<int>(dims[0]), static_cast<int>(dims[1]), static_cast<int>(dims[2]));
+  imageData->SetSpacing(spacing[0], spacing[1], spacing[2]);
+  imageData->SetOrigin(origin[0] + spacing[0] * 0.5, origin[1] + spacing[1] * 0.5, origin[2] + spacing[2] * 0.5);
+  imageData->GetPointData()->SetScalars(scalars);
+
+  // Volumes are drawn through their middle slice
+  vtkSmartPointer<vtkImageSliceMapper> mapper = vtkSmartPointer<vtkImageSliceMapper>::New();
+  mapper->SetInputData(imageData);
+  mapper->SetOrientationToZ();
+  mapper->SetSliceNumber(static_cast<int>(dims[2] / 2));
+
+  vtkSmartPointer<vtkImageSlice> imageSlice = vtkSmartPointer<vtkImageSlice>::New();
+  imageSlice->SetMapper(mapper);
+
+  // 8-bit color images are drawn as they are, everything else is stretched over the value range
+  vtkImageProperty* property = imageSlice->GetProperty();
+  property->SetInterpolationTypeToLinear();
+  if(scalars->GetDataType() == VTK_UNSIGNED_CHAR)
+  {
+    property->SetColorWindow(255.0);
+    property->SetColorLevel(127.5);
+  }
+  else
+  {
+    double range[2];
+    scalars->GetRange(range, 0);
+    property->SetColorWindow(std::max(range[1] - range[0], 1.0));
+    property->SetColorLevel((range[0] + range[1]) * 0.5);
+  }
+
+  return imageSlice;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkSmartPointer<vtkImageWriter> createImageWriter(const QString& filePath)
+{
+  QString suffix = QFileInfo(filePath).suffix().toLower();
+  if(suffix == "png")
+  {
+    return vtkSmartPointer<vtkPNGWriter>::New();
+  }
+  if(suffix == "tif" || suffix == "tiff")
+  {
+    return vtkSmartPointer<vtkTIFFWriter>::New();
+  }
+  if(suffix == "jpg" || suffix == "jpeg")
+  {
+    return vtkSmartPointer<vtkJPEGWriter>::New();
+  }
+  if(suffix == "bmp")
+  {
+    return vtkSmartPointer<vtkBMPWriter>::New();
+  }
+  return nullptr;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFOffscreenRenderer::IMFOffscreenRenderer() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFOffscreenRenderer::~IMFOffscreenRenderer() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFOffscreenRenderer::IsSupportedImageFile(const QString& filePath)
+{
+  return createImageWriter(filePath) != nullptr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QSize IMFOffscreenRenderer::ImageSize(const std::vector<DataContainer::Pointer>& dataContainers, const Options& options)
+{
+  ImageBounds bounds = findImageBounds(dataContainers);
+  if(bounds.isEmpty())
+  {
+    return QSize();
+  }
+
+  double width = bounds.xMax - bounds.xMin;
+  double height = bounds.yMax - bounds.yMin;
+  if(options.Width > 0 && options.Height > 0)
+  {
+    return QSize(options.Width, options.Height);
+  }
+  if(options.Width > 0)
+  {
+    return QSize(options.Width, std::max(1, static_cast<int>(std::lround(options.Width * height / width))));
+  }
+  if(options.Height > 0)
+  {
+    return QSize(std::max(1, static_cast<int>(std::lround(options.Height * width / height))), options.Height);
+  }
+  return QSize(std::max(1, static_cast<int>(std::lround(width / bounds.finestSpacing))), std::max(1, static_cast<int>(std::lround(height / bounds.finestSpacing))));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFOffscreenRenderer::render(const std::vector<DataContainer::Pointer>& dataContainers, const QString& filePath, const Options& options)
+{
+  IMFTraceSpan renderSpan(QObject::tr("Offscreen Render"), IMFTrace::RenderCategory);
+  renderSpan.setArg("File", filePath);
+
+  vtkSmartPointer<vtkImageWriter> writer = createImageWriter(filePath);
+  if(writer == nullptr)
+  {
+    return k_UnsupportedFormatError;
+  }
+
+  QSize imageSize = ImageSize(dataContainers, options);
+  vtkSmartPointer<vtkRenderer> renderer = vtkSmartPointer<vtkRenderer>::New();
+  renderer->SetBackground(options.Background[0], options.Background[1], options.Background[2]);
+  int sliceCount = 0;
+  for(const DataContainer::Pointer& dc : dataContainers)
+  {
+    vtkSmartPointer<vtkImageSlice> imageSlice = createImageSlice(dc);
+    if(imageSlice != nullptr)
+    {
+      renderer->AddViewProp(imageSlice);
+      sliceCount++;
+    }
+  }
+  if(imageSize.isEmpty() || sliceCount == 0)
+  {
+    return k_NoImageDataError;
+  }
+  renderSpan.setArg("Width", imageSize.width());
+  renderSpan.setArg("Height", imageSize.height());
+
+  // The window draws one tile at a time.  The tiles may cover a few more pixels than were
+  // asked for, which are cropped evenly from both sides afterwards.
+  int maxTileSize = std::max(options.MaxTileSize, 64);
+  int xTiles = (imageSize.width() + maxTileSize - 1) / maxTileSize;
+  int yTiles = (imageSize.height() + maxTileSize - 1) / maxTileSize;
+  int tileWidth = (imageSize.width() + xTiles - 1) / xTiles;
+  int tileHeight = (imageSize.height() + yTiles - 1) / yTiles;
+  int fullWidth = tileWidth * xTiles;
+  int fullHeight = tileHeight * yTiles;
+
+  if(m_RenderWindow == nullptr)
+  {
+    m_RenderWindow = vtkSmartPointer<vtkRenderWindow>::New();
+    m_RenderWindow->SetOffScreenRendering(1);
+    m_RenderWindow->SetMultiSamples(0);
+  }
+  m_RenderWindow->AddRenderer(renderer);
+  m_RenderWindow->SetSize(tileWidth, tileHeight);
+
+  ImageBounds bounds = findImageBounds(dataContainers);
+  double boundsWidth = bounds.xMax - bounds.xMin;
+  double boundsHeight = bounds.yMax - bounds.yMin;
+  vtkCamera* camera = renderer->GetActiveCamera();
+  camera->ParallelProjectionOn();
+  camera->SetFocalPoint((bounds.xMin + bounds.xMax) * 0.5, (bounds.yMin + bounds.yMax) * 0.5, 0.0);
+  camera->SetPosition((bounds.xMin + bounds.xMax) * 0.5, (bounds.yMin + bounds.yMax) * 0.5, std::max(boundsWidth, boundsHeight) * 2.0);
+  camera->SetViewUp(0.0, 1.0, 0.0);
+  camera->SetParallelScale(std::max(boundsHeight, boundsWidth * fullHeight / fullWidth) * 0.5);
+  renderer->ResetCameraClippingRange();
+
+  m_RenderWindow->Render();
+  if(m_RenderWindow->SupportsOpenGL() == 0)
+  {
+    m_RenderWindow->RemoveRenderer(renderer);
+    return k_OpenGLError;
+  }
+
+  vtkSmartPointer<vtkWindowToImageFilter> windowToImage = vtkSmartPointer<vtkWindowToImageFilter>::New();
+  windowToImage->SetInput(m_RenderWindow);
+  windowToImage->SetScale(xTiles, yTiles);
+  windowToImage->SetInputBufferTypeToRGB();
+  windowToImage->ReadFrontBufferOff();
+
+  vtkSmartPointer<vtkExtractVOI> crop = vtkSmartPointer<vtkExtractVOI>::New();
+  crop->SetInputConnection(windowToImage->GetOutputPort());
+  int xOffset = (fullWidth - imageSize.width()) / 2;
+  int yOffset = (fullHeight - imageSize.height()) / 2;
+  crop->SetVOI(xOffset, xOffset + imageSize.width() - 1, yOffset, yOffset + imageSize.height() - 1, 0, 0);
+
+  writer->SetInputConnection(crop->GetOutputPort());
+  writer->SetFileName(filePath.toLocal8Bit().constData());
+  writer->Write();
+  int err = writer->GetErrorCode() != 0 ? k_WriteError : 0;
+
+  // The window is kept for the next image, but not the data of this one
+  m_RenderWindow->RemoveRenderer(renderer);
+  return err;
+}
@@ -0,0 +1,108 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QSize>
+#include <QtCore/QString>
+
+#include <vtkSmartPointer.h>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+class vtkRenderWindow;
+
+/**
+ * @brief The IMFOffscreenRenderer class draws the image geometries of data containers into an
+ * image file without showing a window.  Images larger than the render window are drawn in tiles
+ * and assembled, so the output size is only limited by memory.  The render window is created
+ * once and reused, so rendering many small images only pays for the OpenGL context once.  On
+ * machines without a display VTK needs to be built with OSMesa or EGL support.
+ */
+class IMFOffscreenRenderer
+{
+public:
+  IMFOffscreenRenderer();
+  ~IMFOffscreenRenderer();
+
+  static const int k_NoImageDataError = -89060;
+  static const int k_UnsupportedFormatError = -89061;
+  static const int k_OpenGLError = -89062;
+  static const int k_WriteError = -89063;
+
+  struct Options
+  {
+    // A size of 0 follows the other size and the aspect ratio of the data, and if both are
+    // 0 the image has one pixel per data pixel at the finest spacing
+    int Width = 0;
+    int Height = 0;
+    int MaxTileSize = 2048;
+    double Background[3] = {0.0, 0.0, 0.0};
+  };
+
+  /**
+   * @brief Returns true if the file extension selects a supported image format
+   * @param filePath
+   * @return
+   */
+  static bool IsSupportedImageFile(const QString& filePath);
+
+  /**
+   * @brief Returns the size of the image the options produce for the data containers
+   * @param dataContainers
+   * @param options
+   * @return An empty size if none of the data containers has an image geometry
+   */
+  static QSize ImageSize(const std::vector<DataContainer::Pointer>& dataContainers, const Options& options);
+
+  /**
+   * @brief Draws the image geometries of the data containers together, looking down the Z
+   * axis, and writes the result to the file.  The file extension selects PNG, TIFF, JPEG or BMP.
+   * @param dataContainers
+   * @param filePath
+   * @param options
+   * @return
+   */
+  int render(const std::vector<DataContainer::Pointer>& dataContainers, const QString& filePath, const Options& options);
+
+private:
+  vtkSmartPointer<vtkRenderWindow> m_RenderWindow;
+
+  IMFOffscreenRenderer(const IMFOffscreenRenderer&); // Copy Constructor Not Implemented
+  void operator=(const IMFOffscreenRenderer&);       // Operator '=' Not Implemented
+};
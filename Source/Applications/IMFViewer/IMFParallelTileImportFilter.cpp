@@ -0,0 +1,352 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFParallelTileImportFilter.h"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <QtConcurrent>
+
+#include <QtCore/QMutex>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFTileCache.h"
+#include "IMFViewer/IMFTrace.h"
+
+namespace
+{
+// Tiles queued for each decoding thread, counting the one it is decoding
+const int k_ReadAheadPerThread = 2;
+
+struct DecodedTile
+{
+  size_t index = 0;
+  DataContainer::Pointer dc;
+  int err = 0;
+};
+
+// Decoded tiles waiting to be moved into the montage
+struct DecodedQueue
+{
+  QMutex mutex;
+  QWaitCondition changed;
+  std::deque<DecodedTile> tiles;
+
+  void post(const DecodedTile& tile)
+  {
+    QMutexLocker locker(&mutex);
+    tiles.push_back(tile);
+    changed.wakeOne();
+  }
+
+  DecodedTile take()
+  {
+    QMutexLocker locker(&mutex);
+    while(tiles.empty())
+    {
+      changed.wait(&mutex);
+    }
+    DecodedTile tile = tiles.front();
+    tiles.pop_front();
+    return tile;
+  }
+};
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFParallelTileImportFilter::IMFParallelTileImportFilter(const AbstractFilter::Pointer& importFilter, const TileFilterFunction& tileFilterFunction, int threadCount,
+                                                         const TileKeyFunction& tileKeyFunction, const TileConvertFunction& tileConvertFunction)
+: m_ImportFilter(importFilter)
+, m_TileFilterFunction(tileFilterFunction)
+, m_ThreadCount(std::max(1, threadCount))
+, m_TileKeyFunction(tileKeyFunction)
+, m_TileConvertFunction(tileConvertFunction)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFParallelTileImportFilter::~IMFParallelTileImportFilter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFParallelTileImportFilter::Pointer IMFParallelTileImportFilter::New(const AbstractFilter::Pointer& importFilter, const TileFilterFunction& tileFilterFunction, int threadCount,
+                                                                     const TileKeyFunction& tileKeyFunction, const TileConvertFunction& tileConvertFunction)
+{
+  Pointer sharedPtr(new IMFParallelTileImportFilter(importFilter, tileFilterFunction, threadCount, tileKeyFunction, tileConvertFunction));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFParallelTileImportFilter::getNameOfClass() const
+{
+  return QString("IMFParallelTileImportFilter");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFParallelTileImportFilter::getHumanLabel() const
+{
+  return m_ImportFilter->getHumanLabel();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFParallelTileImportFilter::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+
+  m_ImportFilter->setDataContainerArray(getDataContainerArray());
+  {
+    QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(m_ImportFilter) ? IMFHdf5Lock::Mutex() : nullptr);
+    m_ImportFilter->preflight();
+  }
+  if(m_ImportFilter->getErrorCode() < 0)
+  {
+    setErrorCondition(m_ImportFilter->getErrorCode(), tr("'%1' could not read the montage tiles.").arg(m_ImportFilter->getHumanLabel()));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFParallelTileImportFilter::preflight()
+{
+  setInPreflight(true);
+  dataCheck();
+  setInPreflight(false);
+
+  m_PreflightedDca = getErrorCode() < 0 ? DataContainerArray::NullPointer() : getDataContainerArray();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFParallelTileImportFilter::execute()
+{
+  // Reading the tile configuration can take seconds, so the tiles of the last preflight are
+  // reused when the filter executes on another data container array
+  DataContainerArray::Pointer preflightedDca = m_PreflightedDca;
+  m_PreflightedDca = DataContainerArray::NullPointer();
+  if(preflightedDca == DataContainerArray::NullPointer())
+  {
+    dataCheck();
+    if(getErrorCode() < 0)
+    {
+      return;
+    }
+  }
+  else if(preflightedDca != getDataContainerArray())
+  {
+    clearErrorCode();
+    clearWarningCode();
+    for(const DataContainer::Pointer& dc : preflightedDca->getDataContainers())
+    {
+      getDataContainerArray()->addOrReplaceDataContainer(dc);
+    }
+    preflightedDca->clearDataContainers();
+  }
+
+  // The import filters name their tiles <prefix>r<row>c<col>, zero padded to the largest index,
+  // so single tile imports are matched to the preflighted tiles by position rather than by name
+  QRegularExpression positionExpression("r(\\d+)c(\\d+)$");
+  std::vector<DataContainer::Pointer> tiles;
+  std::vector<IntVec2Type> positions;
+  for(const DataContainer::Pointer& dc : getDataContainerArray()->getDataContainers())
+  {
+    QRegularExpressionMatch match = positionExpression.match(dc->getName());
+    if(match.hasMatch() && dc->getGeometryAs<ImageGeom>())
+    {
+      tiles.push_back(dc);
+      positions.push_back({match.captured(2).toInt(), match.captured(1).toInt()});
+    }
+  }
+
+  std::vector<size_t> order(tiles.size());
+  for(size_t i = 0; i < order.size(); i++)
+  {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) { return std::make_pair(positions[lhs][1], positions[lhs][0]) < std::make_pair(positions[rhs][1], positions[rhs][0]); });
+
+  IMFTraceSpan importSpan(tr("Parallel Tile Import"), IMFTrace::ImportCategory);
+  importSpan.setArg("Tiles", static_cast<int>(tiles.size()));
+  importSpan.setArg("Threads", m_ThreadCount);
+
+  std::shared_ptr<DecodedQueue> decoded = std::make_shared<DecodedQueue>();
+  std::shared_ptr<std::atomic_bool> canceled = std::make_shared<std::atomic_bool>(false);
+  QThreadPool threadPool;
+  threadPool.setMaxThreadCount(m_ThreadCount);
+
+  TileFilterFunction tileFilterFunction = m_TileFilterFunction;
+  TileKeyFunction tileKeyFunction = m_TileKeyFunction;
+  TileConvertFunction tileConvertFunction = m_TileConvertFunction;
+  auto queueTile = [&](size_t index) {
+    IntVec2Type position = positions[index];
+    QtConcurrent::run(&threadPool, [=] {
+      DecodedTile tile;
+      tile.index = index;
+      if(*canceled)
+      {
+        decoded->post(tile);
+        return;
+      }
+
+      IMFTraceSpan readSpan(tr("Decode Tile"), IMFTrace::ImportCategory);
+      readSpan.setArg("Column", position[0]);
+      readSpan.setArg("Row", position[1]);
+
+      QString cacheKey = tileKeyFunction ? tileKeyFunction(position) : QString();
+      if(!cacheKey.isEmpty())
+      {
+        tile.dc = IMFTileCache::Lookup(cacheKey);
+        if(tile.dc)
+        {
+          readSpan.setArg("Cached", true);
+          decoded->post(tile);
+          return;
+        }
+      }
+
+      AbstractFilter::Pointer tileFilter = tileFilterFunction(position);
+      if(!tileFilter)
+      {
+        tile.err = k_ImportError;
+        decoded->post(tile);
+        return;
+      }
+
+      DataContainerArray::Pointer tileDca = DataContainerArray::New();
+      tileFilter->setDataContainerArray(tileDca);
+      {
+        QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(tileFilter) ? IMFHdf5Lock::Mutex() : nullptr);
+        tileFilter->execute();
+      }
+      tile.err = tileFilter->getErrorCode();
+      for(const DataContainer::Pointer& dc : tileDca->getDataContainers())
+      {
+        if(dc->getGeometryAs<ImageGeom>())
+        {
+          tile.dc = dc;
+          break;
+        }
+      }
+
+      // Converted while the decoded arrays are still hot, so only the tiles in flight are held unconverted
+      if(tileConvertFunction && tile.err >= 0 && tile.dc)
+      {
+        tile.err = tileConvertFunction(tile.dc);
+      }
+      if(!cacheKey.isEmpty() && tile.err >= 0)
+      {
+        IMFTileCache::Store(cacheKey, tile.dc);
+      }
+      decoded->post(tile);
+    });
+  };
+
+  size_t window = static_cast<size_t>(m_ThreadCount * k_ReadAheadPerThread);
+  size_t queuedCount = 0;
+  for(; queuedCount < order.size() && queuedCount < window; queuedCount++)
+  {
+    queueTile(order[queuedCount]);
+  }
+
+  // Each decoded tile frees a slot in the window for the next tile in row-major order
+  int err = 0;
+  for(size_t doneCount = 0; doneCount < queuedCount; doneCount++)
+  {
+    DecodedTile tile = decoded->take();
+    if(err >= 0 && getCancel())
+    {
+      *canceled = true;
+      break;
+    }
+    if(err >= 0 && tile.err < 0)
+    {
+      err = tile.err;
+      *canceled = true;
+      setErrorCondition(err, tr("'%1' could not read the tile in row %2, column %3.").arg(m_ImportFilter->getHumanLabel()).arg(positions[tile.index][1]).arg(positions[tile.index][0]));
+      continue;
+    }
+    if(err >= 0 && !tile.dc)
+    {
+      err = k_MissingTileError;
+      *canceled = true;
+      setErrorCondition(err, tr("'%1' did not create the tile in row %2, column %3.").arg(m_ImportFilter->getHumanLabel()).arg(positions[tile.index][1]).arg(positions[tile.index][0]));
+      continue;
+    }
+    if(err < 0)
+    {
+      continue;
+    }
+
+    for(const AttributeMatrix::Pointer& am : tile.dc->getAttributeMatrices())
+    {
+      tiles[tile.index]->addOrReplaceAttributeMatrix(am);
+    }
+
+    if(queuedCount < order.size())
+    {
+      queueTile(order[queuedCount]);
+      queuedCount++;
+    }
+  }
+
+  // Tiles still decoding after a failure or cancel are waited for and discarded
+  threadPool.waitForDone();
+}
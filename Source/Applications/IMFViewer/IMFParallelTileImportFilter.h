@@ -0,0 +1,116 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <functional>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The IMFParallelTileImportFilter class decodes the tiles of a montage on a pool of
+ * worker threads instead of one after the other.  The wrapped import filter is preflighted
+ * to create every tile geometry, and each tile is then decoded by its own import filter
+ * restricted to that tile.  Tiles are queued in row-major order a few at a time ahead of
+ * the decoding threads, so the threads stay busy without every tile being queued at once.
+ * A filter that was preflighted before it executes takes over the preflighted tile geometries
+ * instead of preflighting the import filter again.
+ */
+class IMFParallelTileImportFilter : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(IMFParallelTileImportFilter)
+
+  // Creates an import filter that reads only the tile at the column and row
+  using TileFilterFunction = std::function<AbstractFilter::Pointer(const IntVec2Type& position)>;
+
+  // Returns the IMFTileCache key of the tile at the column and row
+  using TileKeyFunction = std::function<QString(const IntVec2Type& position)>;
+
+  // Converts the arrays of a decoded tile in place, returning a negative error code on failure
+  using TileConvertFunction = std::function<int(const DataContainer::Pointer& tileDC)>;
+
+  /**
+   * @brief Creates a filter that preflights the import filter and decodes its tiles with at
+   * most threadCount tile filters executing at once.  When a key function is given, tiles
+   * held by the tile cache are taken from it and decoded tiles are added to it.  When a
+   * convert function is given, each tile is converted on its decoding thread as soon as it
+   * is decoded, before it is cached or moved into the montage.
+   * @param importFilter
+   * @param tileFilterFunction
+   * @param threadCount
+   * @param tileKeyFunction
+   * @param tileConvertFunction
+   * @return
+   */
+  static Pointer New(const AbstractFilter::Pointer& importFilter, const TileFilterFunction& tileFilterFunction, int threadCount, const TileKeyFunction& tileKeyFunction = TileKeyFunction(),
+                     const TileConvertFunction& tileConvertFunction = TileConvertFunction());
+
+  ~IMFParallelTileImportFilter() override;
+
+  static const int k_ImportError = -89090;
+  static const int k_MissingTileError = -89091;
+
+  QString getNameOfClass() const override;
+  QString getHumanLabel() const override;
+  void preflight() override;
+  void execute() override;
+
+protected:
+  IMFParallelTileImportFilter(const AbstractFilter::Pointer& importFilter, const TileFilterFunction& tileFilterFunction, int threadCount, const TileKeyFunction& tileKeyFunction,
+                              const TileConvertFunction& tileConvertFunction);
+
+private:
+  AbstractFilter::Pointer m_ImportFilter;
+  TileFilterFunction m_TileFilterFunction;
+  int m_ThreadCount = 1;
+  TileKeyFunction m_TileKeyFunction;
+  TileConvertFunction m_TileConvertFunction;
+  DataContainerArray::Pointer m_PreflightedDca;
+
+  /**
+   * @brief Preflights the import filter into this filter's data container array
+   */
+  void dataCheck();
+
+  IMFParallelTileImportFilter(const IMFParallelTileImportFilter&); // Copy Constructor Not Implemented
+  void operator=(const IMFParallelTileImportFilter&);              // Operator '=' Not Implemented
+};
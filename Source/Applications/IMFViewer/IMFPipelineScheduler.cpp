@@ -0,0 +1,550 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "IMFPipelineScheduler.h"
+
+#if defined(_MSC_VER)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+
+#include <QtConcurrent>
+
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QThread>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+#include "SIMPLib/Messages/AbstractMessageHandler.h"
+#include "SIMPLib/Messages/FilterErrorMessage.h"
+#include "SIMPLib/Messages/FilterStatusMessage.h"
+#include "SIMPLib/Messages/FilterWarningMessage.h"
+
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFTrace.h"
+
+namespace
+{
+/**
+ * @brief Hands the messages a filter generates on a worker thread to the scheduler's signals,
+ * the same messages FilterPipeline::execute passes on to its observers
+ */
+class FilterMessageForwarder : public AbstractMessageHandler
+{
+public:
+  FilterMessageForwarder(IMFPipelineScheduler* scheduler, const QString& pipelineName)
+  : m_Scheduler(scheduler)
+  , m_PipelineName(pipelineName)
+  {
+  }
+
+  void processMessage(const FilterErrorMessage* msg) const override
+  {
+    emit m_Scheduler->notifyErrorMessage(m_PipelineName, msg->generateMessageString(), msg->getCode());
+  }
+
+  void processMessage(const FilterWarningMessage* msg) const override
+  {
+    emit m_Scheduler->notifyStatusMessage(QObject::tr("%1: %2").arg(m_PipelineName, msg->generateMessageString()));
+  }
+
+  void processMessage(const FilterStatusMessage* msg) const override
+  {
+    emit m_Scheduler->notifyStatusMessage(QObject::tr("%1: %2").arg(m_PipelineName, msg->generateMessageString()));
+  }
+
+private:
+  IMFPipelineScheduler* m_Scheduler = nullptr;
+  QString m_PipelineName;
+};
+} // namespace
+
+const char* IMFPipelineScheduler::EstimatedBytesProperty = "EstimatedBytes";
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFPipelineScheduler::IMFPipelineScheduler(QObject* parent)
+: QObject(parent)
+{
+  setMaxWorkerCount(DefaultWorkerCount());
+
+  qint64 physicalMemory = PhysicalMemorySize();
+  m_MemoryBudget = physicalMemory / 4 * 3;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFPipelineScheduler::~IMFPipelineScheduler()
+{
+  // Nothing is delivered while the scheduler is destroyed, so the queue is dropped
+  // before the executing pipelines are canceled
+  m_WaitingJobs.clear();
+  cancelAll();
+  m_PreflightPool.waitForDone();
+  m_ThreadPool.waitForDone();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFPipelineScheduler::DefaultWorkerCount()
+{
+  // The registration and stitching filters are multithreaded themselves, so only
+  // a fraction of the cores are handed to whole pipelines.
+  int idealCount = QThread::idealThreadCount() / 4;
+  return std::max(1, std::min(idealCount, 8));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFPipelineScheduler::PhysicalMemorySize()
+{
+#if defined(_MSC_VER)
+  MEMORYSTATUSEX status;
+  status.dwLength = sizeof(status);
+  if(GlobalMemoryStatusEx(&status) == 0)
+  {
+    return 0;
+  }
+  return static_cast<qint64>(status.ullTotalPhys);
+#else
+  long pages = sysconf(_SC_PHYS_PAGES);
+  long pageSize = sysconf(_SC_PAGE_SIZE);
+  if(pages <= 0 || pageSize <= 0)
+  {
+    return 0;
+  }
+  return static_cast<qint64>(pages) * static_cast<qint64>(pageSize);
+#endif
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFPipelineScheduler::EstimateMemoryUsage(const DataContainerArray::Pointer& dca)
+{
+  qint64 bytes = 0;
+  if(dca == DataContainerArray::NullPointer())
+  {
+    return bytes;
+  }
+
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+    {
+      qint64 numTuples = static_cast<qint64>(am->getNumberOfTuples());
+      for(const QString& arrayName : am->getAttributeArrayNames())
+      {
+        IDataArray::Pointer array = am->getAttributeArray(arrayName);
+        if(array != IDataArray::NullPointer())
+        {
+          bytes += numTuples * array->getNumberOfComponents() * array->getTypeSize();
+        }
+      }
+    }
+  }
+
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFPipelineScheduler::EstimatePreflightedPipeline(const FilterPipeline::Pointer& pipeline)
+{
+  FilterPipeline::FilterContainerType filters = pipeline->getFilterContainer();
+  if(filters.isEmpty())
+  {
+    return false;
+  }
+
+  // The first filter keeps its own preflighted data, which it may take over when it executes
+  DataContainerArray::Pointer preflightDca = filters.front()->getDataContainerArray()->deepCopy(true);
+  for(int i = 1; i < filters.size(); i++)
+  {
+    const AbstractFilter::Pointer& filter = filters[i];
+    filter->setDataContainerArray(preflightDca);
+    filter->setInPreflight(true);
+    {
+      QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(filter) ? IMFHdf5Lock::Mutex() : nullptr);
+      filter->preflight();
+    }
+    filter->setInPreflight(false);
+    if(filter->getErrorCode() < 0)
+    {
+      return false;
+    }
+  }
+
+  pipeline->setProperty(EstimatedBytesProperty, EstimateMemoryUsage(preflightDca));
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::setMaxWorkerCount(int count)
+{
+  m_MaxWorkerCount = std::max(1, count);
+  m_ThreadPool.setMaxThreadCount(m_MaxWorkerCount);
+  startWaitingJobs();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFPipelineScheduler::getMaxWorkerCount() const
+{
+  return m_MaxWorkerCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::setMemoryBudget(qint64 bytes)
+{
+  m_MemoryBudget = std::max(static_cast<qint64>(0), bytes);
+  startWaitingJobs();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFPipelineScheduler::getMemoryBudget() const
+{
+  return m_MemoryBudget;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFPipelineScheduler::getQueuedCount() const
+{
+  return static_cast<int>(m_WaitingJobs.size() + m_RunningJobs.size());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::enqueue(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca)
+{
+  enqueue(pipeline, dca, PostExecuteFunction());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::enqueue(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const PostExecuteFunction& postExecute)
+{
+  JobPointer job = std::make_shared<Job>();
+  job->pipeline = pipeline;
+  job->dca = dca;
+  job->postExecute = postExecute;
+  m_WaitingJobs.push_back(job);
+
+  emit notifyStatusMessage(tr("Queued '%1' (%2 pipelines in queue)").arg(pipeline->getName()).arg(getQueuedCount()));
+
+  // Pipelines that run on existing data only allocate what their filters add, and that
+  // data is already resident, so only pipelines that start from scratch are estimated
+  if(dca != DataContainerArray::NullPointer() || m_MemoryBudget <= 0)
+  {
+    job->preflighted = true;
+    startWaitingJobs();
+    return;
+  }
+
+  // Pipelines preflighted before they were enqueued are not preflighted a second time
+  QVariant estimatedBytes = pipeline->property(EstimatedBytesProperty);
+  if(estimatedBytes.isValid())
+  {
+    job->estimatedBytes = estimatedBytes.toLongLong();
+    job->preflighted = true;
+    startWaitingJobs();
+    return;
+  }
+
+  // The preflight only reads headers, so it runs outside the pipeline workers and every
+  // queued pipeline is estimated while the ones ahead of it execute
+  QFutureWatcher<qint64>* watcher = new QFutureWatcher<qint64>(this);
+  connect(watcher, &QFutureWatcher<qint64>::finished, this, [=] {
+    qint64 estimatedBytes = watcher->result();
+    watcher->deleteLater();
+
+    auto iter = std::find(m_WaitingJobs.begin(), m_WaitingJobs.end(), job);
+    if(iter == m_WaitingJobs.end())
+    {
+      return;
+    }
+
+    if(estimatedBytes < 0 && !job->canceled)
+    {
+      emit notifyStatusMessage(tr("Preflight of '%1' failed with error %2").arg(job->pipeline->getName()).arg(estimatedBytes));
+      m_WaitingJobs.erase(iter);
+      job->err = static_cast<int>(estimatedBytes);
+      deliverJob(job);
+      startWaitingJobs();
+      return;
+    }
+
+    job->estimatedBytes = std::max(static_cast<qint64>(0), estimatedBytes);
+    job->preflighted = true;
+    startWaitingJobs();
+  });
+  watcher->setFuture(QtConcurrent::run(&m_PreflightPool, [=] { return preflightJob(job); }));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::cancel(const FilterPipeline::Pointer& pipeline)
+{
+  auto waitingIter = std::find_if(m_WaitingJobs.begin(), m_WaitingJobs.end(), [=](const JobPointer& job) { return job->pipeline == pipeline; });
+  if(waitingIter != m_WaitingJobs.end())
+  {
+    JobPointer job = *waitingIter;
+    job->canceled = true;
+    m_WaitingJobs.erase(waitingIter);
+    deliverJob(job);
+    startWaitingJobs();
+    return;
+  }
+
+  for(const JobPointer& job : m_RunningJobs)
+  {
+    if(job->pipeline == pipeline)
+    {
+      job->canceled = true;
+      for(const AbstractFilter::Pointer& filter : job->pipeline->getFilterContainer())
+      {
+        filter->setCancel(true);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::cancelAll()
+{
+  std::deque<JobPointer> waitingJobs;
+  waitingJobs.swap(m_WaitingJobs);
+  for(const JobPointer& job : waitingJobs)
+  {
+    job->canceled = true;
+    deliverJob(job);
+  }
+
+  for(const JobPointer& job : m_RunningJobs)
+  {
+    job->canceled = true;
+    for(const AbstractFilter::Pointer& filter : job->pipeline->getFilterContainer())
+    {
+      filter->setCancel(true);
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::startWaitingJobs()
+{
+  // Pipelines start in queue order, so a large pipeline at the front is not overtaken by
+  // smaller ones behind it.  A pipeline that is larger than the whole budget is still
+  // started once nothing else is executing, otherwise it could never run.
+  while(!m_WaitingJobs.empty() && static_cast<int>(m_RunningJobs.size()) < m_MaxWorkerCount)
+  {
+    JobPointer job = m_WaitingJobs.front();
+    if(!job->preflighted)
+    {
+      break;
+    }
+    if(m_MemoryBudget > 0 && m_ReservedBytes > 0 && m_ReservedBytes + job->estimatedBytes > m_MemoryBudget)
+    {
+      break;
+    }
+
+    m_WaitingJobs.pop_front();
+    m_ReservedBytes += job->estimatedBytes;
+    m_RunningJobs.push_back(job);
+
+    QFutureWatcher<int>* watcher = new QFutureWatcher<int>(this);
+    connect(watcher, &QFutureWatcher<int>::finished, this, [=] {
+      job->err = watcher->result();
+      watcher->deleteLater();
+
+      m_RunningJobs.erase(std::remove(m_RunningJobs.begin(), m_RunningJobs.end(), job), m_RunningJobs.end());
+      m_ReservedBytes -= job->estimatedBytes;
+      deliverJob(job);
+      startWaitingJobs();
+    });
+
+    emit notifyStatusMessage(tr("Executing '%1' (%2 running)").arg(job->pipeline->getName()).arg(m_RunningJobs.size()));
+    watcher->setFuture(QtConcurrent::run(&m_ThreadPool, [=] { return executeJob(job); }));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFPipelineScheduler::executeJob(const JobPointer& job)
+{
+  if(job->canceled)
+  {
+    return 0;
+  }
+
+  QString pipelineName = job->pipeline->getName();
+
+  DataContainerArray::Pointer dca = job->dca;
+  if(dca == DataContainerArray::NullPointer())
+  {
+    dca = DataContainerArray::New();
+  }
+
+  int err = 0;
+  for(const AbstractFilter::Pointer& filter : job->pipeline->getFilterContainer())
+  {
+    if(job->canceled)
+    {
+      break;
+    }
+
+    IMFTraceSpan filterSpan(filter->getHumanLabel(), IMFTrace::PipelineCategory);
+    filterSpan.setArg("Pipeline", pipelineName);
+    QMetaObject::Connection messageConnection = forwardFilterMessages(filter, pipelineName);
+    filter->setDataContainerArray(dca);
+    {
+      QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(filter) ? IMFHdf5Lock::Mutex() : nullptr);
+      filter->execute();
+    }
+    disconnect(messageConnection);
+    err = filter->getErrorCode();
+    filterSpan.setArg("Error Code", err);
+    if(err < 0)
+    {
+      break;
+    }
+  }
+
+  if(err >= 0 && !job->canceled && job->postExecute)
+  {
+    IMFTraceSpan postExecuteSpan(tr("Post Execute %1").arg(pipelineName), IMFTrace::PipelineCategory);
+    err = job->postExecute(job->pipeline, dca);
+  }
+
+  job->dca = dca;
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFPipelineScheduler::preflightJob(const JobPointer& job)
+{
+  QString pipelineName = job->pipeline->getName();
+  IMFTraceSpan preflightSpan(tr("Preflight %1").arg(pipelineName), IMFTrace::PipelineCategory);
+
+  DataContainerArray::Pointer preflightDca = DataContainerArray::New();
+  for(const AbstractFilter::Pointer& filter : job->pipeline->getFilterContainer())
+  {
+    if(job->canceled)
+    {
+      return 0;
+    }
+
+    QMetaObject::Connection messageConnection = forwardFilterMessages(filter, pipelineName);
+    filter->setDataContainerArray(preflightDca);
+    filter->setInPreflight(true);
+    {
+      QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(filter) ? IMFHdf5Lock::Mutex() : nullptr);
+      filter->preflight();
+    }
+    filter->setInPreflight(false);
+    disconnect(messageConnection);
+
+    int err = filter->getErrorCode();
+    if(err < 0)
+    {
+      return err;
+    }
+  }
+
+  return EstimateMemoryUsage(preflightDca);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QMetaObject::Connection IMFPipelineScheduler::forwardFilterMessages(const AbstractFilter::Pointer& filter, const QString& pipelineName)
+{
+  // The messages are converted on the worker thread, so only strings cross to the GUI thread
+  std::shared_ptr<FilterMessageForwarder> forwarder = std::make_shared<FilterMessageForwarder>(this, pipelineName);
+  return connect(
+      filter.get(), &AbstractFilter::messageGenerated, this, [forwarder](const AbstractMessage::Pointer& msg) { msg->visit(forwarder.get()); }, Qt::DirectConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPipelineScheduler::deliverJob(const JobPointer& job)
+{
+  QString pipelineName = job->pipeline->getName();
+  if(job->canceled)
+  {
+    emit notifyStatusMessage(tr("Canceled '%1'").arg(pipelineName));
+  }
+  else
+  {
+    emit notifyStatusMessage(tr("Finished '%1'").arg(pipelineName));
+  }
+
+  emit pipelineFinished(job->pipeline, job->dca, job->err, job->canceled);
+
+  if(m_WaitingJobs.empty() && m_RunningJobs.empty())
+  {
+    emit notifyStatusMessage(tr("Import queue is empty"));
+  }
+}
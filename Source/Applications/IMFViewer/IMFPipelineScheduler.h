@@ -0,0 +1,235 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <QtCore/QObject>
+#include <QtCore/QThreadPool>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The IMFPipelineScheduler class runs queued FilterPipelines on a private
+ * thread pool so that several montage imports can execute at the same time.
+ * Each pipeline is preflighted to estimate its memory usage, unless it carries an estimate
+ * from a preflight made before it was enqueued, and pipelines are started
+ * in the order they were enqueued once a worker is free and their estimate fits in the
+ * memory budget.  A pipeline is only handed to the thread pool after its memory has been
+ * reserved, so workers never wait for memory.  Results are delivered on the GUI thread
+ * as soon as each pipeline finishes, which is not necessarily the order they were enqueued in.
+ */
+class IMFPipelineScheduler : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFPipelineScheduler(QObject* parent = nullptr);
+  ~IMFPipelineScheduler() override;
+
+  using PostExecuteFunction = std::function<int(const FilterPipeline::Pointer&, const DataContainerArray::Pointer&)>;
+
+  // Set on pipelines whose memory usage was estimated before they were enqueued, which are
+  // then started without being preflighted again
+  static const char* EstimatedBytesProperty;
+
+  /**
+   * @brief Sets the number of pipelines that may execute at the same time
+   * @param count
+   */
+  void setMaxWorkerCount(int count);
+
+  /**
+   * @brief Returns the number of pipelines that may execute at the same time
+   * @return
+   */
+  int getMaxWorkerCount() const;
+
+  /**
+   * @brief Sets the memory budget in bytes shared by all executing pipelines.  A value
+   * of 0 disables the admission check.
+   * @param bytes
+   */
+  void setMemoryBudget(qint64 bytes);
+
+  /**
+   * @brief Returns the memory budget in bytes
+   * @return
+   */
+  qint64 getMemoryBudget() const;
+
+  /**
+   * @brief Returns the number of pipelines that have been enqueued but not yet delivered
+   * @return
+   */
+  int getQueuedCount() const;
+
+  /**
+   * @brief Adds a pipeline to the end of the queue.  If a data container array is given,
+   * the pipeline executes on that array instead of an empty one.
+   * @param pipeline
+   * @param dca
+   */
+  void enqueue(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca = DataContainerArray::NullPointer());
+
+  /**
+   * @brief Adds a pipeline to the end of the queue.  The post execute function is called on
+   * the worker thread after the filters executed without error, and its return value
+   * becomes the pipeline's error code.
+   * @param pipeline
+   * @param dca
+   * @param postExecute
+   */
+  void enqueue(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const PostExecuteFunction& postExecute);
+
+  /**
+   * @brief Returns the default number of concurrent pipelines for this machine
+   * @return
+   */
+  static int DefaultWorkerCount();
+
+  /**
+   * @brief Returns the amount of physical memory in bytes, or 0 if it could not be determined
+   * @return
+   */
+  static qint64 PhysicalMemorySize();
+
+  /**
+   * @brief Returns the number of bytes the arrays in the data container array will occupy
+   * once allocated
+   * @param dca
+   * @return
+   */
+  static qint64 EstimateMemoryUsage(const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief Estimates the memory usage of a pipeline whose first filter was preflighted by
+   * preflighting the remaining filters on a copy of the first filter's data container array.
+   * The estimate is stored in the pipeline's EstimatedBytesProperty.  Returns false without
+   * storing an estimate if a filter fails its preflight, in which case the pipeline is
+   * preflighted again once it is enqueued.  This may be called from a worker thread.
+   * @param pipeline
+   * @return
+   */
+  static bool EstimatePreflightedPipeline(const FilterPipeline::Pointer& pipeline);
+
+public slots:
+  /**
+   * @brief Cancels the pipeline if it is waiting or executing
+   * @param pipeline
+   */
+  void cancel(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Cancels every waiting and executing pipeline
+   */
+  void cancelAll();
+
+signals:
+  /**
+   * @brief Emitted on the GUI thread when a pipeline has finished, failed or was canceled.
+   * Pipelines that execute at the same time are emitted in the order they finish.  The error code of a canceled pipeline is the code of the filter that was interrupted.
+   */
+  void pipelineFinished(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled);
+  void notifyErrorMessage(const QString& title, const QString& msg, int code);
+  void notifyStatusMessage(const QString& msg);
+
+private:
+  struct Job
+  {
+    FilterPipeline::Pointer pipeline;
+    DataContainerArray::Pointer dca;
+    PostExecuteFunction postExecute;
+    std::atomic_bool canceled{false};
+    bool preflighted = false;
+    qint64 estimatedBytes = 0;
+    int err = 0;
+  };
+  using JobPointer = std::shared_ptr<Job>;
+
+  QThreadPool m_ThreadPool;
+  QThreadPool m_PreflightPool;
+  std::deque<JobPointer> m_WaitingJobs;
+  std::vector<JobPointer> m_RunningJobs;
+  int m_MaxWorkerCount = 1;
+  qint64 m_MemoryBudget = 0;
+  qint64 m_ReservedBytes = 0;
+
+  /**
+   * @brief Executes the job's pipeline.  This is called from a worker thread.
+   * @param job
+   * @return
+   */
+  int executeJob(const JobPointer& job);
+
+  /**
+   * @brief Preflights the job's pipeline on a scratch data container array and returns the
+   * estimated memory usage, or a negative error code if the preflight failed.  This is
+   * called from a worker thread.
+   * @param job
+   * @return
+   */
+  qint64 preflightJob(const JobPointer& job);
+
+  /**
+   * @brief Forwards the error, warning and status messages of the filter while it executes
+   * on a worker thread
+   * @param filter
+   * @param pipelineName
+   * @return The connection to disconnect once the filter is done
+   */
+  QMetaObject::Connection forwardFilterMessages(const AbstractFilter::Pointer& filter, const QString& pipelineName);
+
+  /**
+   * @brief Starts waiting jobs in queue order for as long as a worker is free and the
+   * next job's estimate fits in the memory budget
+   */
+  void startWaitingJobs();
+
+  /**
+   * @brief Emits the result of a job that is no longer waiting or executing
+   * @param job
+   */
+  void deliverJob(const JobPointer& job);
+
+  IMFPipelineScheduler(const IMFPipelineScheduler&); // Copy Constructor Not Implemented
+  void operator=(const IMFPipelineScheduler&);       // Operator '=' Not Implemented
+};
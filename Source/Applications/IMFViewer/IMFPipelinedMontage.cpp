@@ -0,0 +1,545 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFPipelinedMontage.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <map>
+#include <memory>
+
+#include <QtConcurrent>
+
+#include <QtCore/QMutex>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFImageCorrelation.h"
+#include "IMFViewer/IMFLazyTileLoader.h"
+#include "IMFViewer/IMFStreamingStitcher.h"
+#include "IMFViewer/IMFTrace.h"
+
+namespace
+{
+// Neighbouring tiles are first registered at the power of two downsampling that fits their overlap in this many pixels
+const size_t k_CoarseRegistrationSize = 128;
+
+// Each finer level refines the offset over a window of at most this many pixels per edge
+const long long k_RegistrationWindowSize = 256;
+
+// Largest correction searched around the nominal offset of two neighbours, as a fraction of the tile size
+const double k_MaxShiftFraction = 0.05;
+
+// Offsets that compare less than this fraction of the nominal overlap are not considered
+const double k_MinOverlapFraction = 0.5;
+
+struct Tile
+{
+  DataContainer::Pointer dc;
+  IntVec2Type position = {0, 0};
+  IMFImageCorrelation::Image image;
+  bool loaded = false;
+  bool placed = false;
+  bool released = false;
+
+  // Pixel offset from the first tile, nominal until the tile is placed
+  long long x = 0;
+  long long y = 0;
+
+  // Pairs with the left and top neighbours, and with the right and bottom ones
+  std::vector<size_t> parentPairs;
+  std::vector<size_t> childPairs;
+};
+
+// Tile b is offset by (sx, sy) pixels from tile a
+struct Pair
+{
+  size_t a = 0;
+  size_t b = 0;
+  long long sx = 0;
+  long long sy = 0;
+  bool registered = false;
+};
+
+struct Event
+{
+  bool isTileRead = true;
+  size_t index = 0;
+  IMFLazyTileLoader::TileRead tileRead;
+  long long sx = 0;
+  long long sy = 0;
+};
+
+// Results of the read and registration tasks, consumed by the thread that places the tiles
+struct Dataflow
+{
+  QMutex mutex;
+  QWaitCondition changed;
+  std::deque<Event> events;
+
+  void post(const Event& event)
+  {
+    QMutexLocker locker(&mutex);
+    events.push_back(event);
+    changed.wakeOne();
+  }
+
+  Event take()
+  {
+    QMutexLocker locker(&mutex);
+    while(events.empty())
+    {
+      changed.wait(&mutex);
+    }
+    Event event = events.front();
+    events.pop_front();
+    return event;
+  }
+};
+
+// -----------------------------------------------------------------------------
+// Refines the offset (sx, sy) of tile b relative to tile a around its nominal value, coarse to fine
+// -----------------------------------------------------------------------------
+void registerPair(const IMFImageCorrelation::Image& a, const IMFImageCorrelation::Image& b, long long& sx, long long& sy)
+{
+  long long overlapX0 = std::max(0LL, sx);
+  long long overlapY0 = std::max(0LL, sy);
+  long long overlapX1 = std::min(static_cast<long long>(a.width), sx + static_cast<long long>(b.width));
+  long long overlapY1 = std::min(static_cast<long long>(a.height), sy + static_cast<long long>(b.height));
+  if(overlapX1 <= overlapX0 || overlapY1 <= overlapY0)
+  {
+    return;
+  }
+
+  size_t longest = static_cast<size_t>(std::max(overlapX1 - overlapX0, overlapY1 - overlapY0));
+  size_t factor = 1;
+  while(longest / factor > k_CoarseRegistrationSize)
+  {
+    factor *= 2;
+  }
+
+  // The nominal overlap of a is compared with all of b at every offset in range at the coarsest level
+  const long long wholeTile = std::numeric_limits<int>::max();
+  long long levelX0 = overlapX0 / static_cast<long long>(factor);
+  long long levelY0 = overlapY0 / static_cast<long long>(factor);
+  IMFImageCorrelation::GrayRegion coarseA = IMFImageCorrelation::SampleGray(a, factor, levelX0, levelY0, IMFImageCorrelation::LevelSize(static_cast<size_t>(overlapX1), factor) - levelX0,
+                                                                            IMFImageCorrelation::LevelSize(static_cast<size_t>(overlapY1), factor) - levelY0);
+  IMFImageCorrelation::GrayRegion coarseB = IMFImageCorrelation::SampleGray(b, factor, 0, 0, wholeTile, wholeTile);
+  double maxShift = k_MaxShiftFraction * static_cast<double>(std::max(a.width, a.height));
+  long long radius = std::max(1LL, static_cast<long long>(std::ceil(maxShift / static_cast<double>(factor))));
+  long long levelX = std::llround(static_cast<double>(sx) / static_cast<double>(factor));
+  long long levelY = std::llround(static_cast<double>(sy) / static_cast<double>(factor));
+  IMFImageCorrelation::SearchTranslation(coarseA, coarseB, radius, k_MinOverlapFraction, levelX, levelY);
+
+  // Finer levels only move the offset by a pixel, so a window in the middle of the overlap is enough
+  while(factor > 1)
+  {
+    factor /= 2;
+    levelX *= 2;
+    levelY *= 2;
+
+    long long windowX0 = std::max(0LL, levelX);
+    long long windowY0 = std::max(0LL, levelY);
+    long long windowX1 = std::min(IMFImageCorrelation::LevelSize(a.width, factor), levelX + IMFImageCorrelation::LevelSize(b.width, factor));
+    long long windowY1 = std::min(IMFImageCorrelation::LevelSize(a.height, factor), levelY + IMFImageCorrelation::LevelSize(b.height, factor));
+    if(windowX1 <= windowX0 || windowY1 <= windowY0)
+    {
+      break;
+    }
+
+    long long windowWidth = std::min(k_RegistrationWindowSize, windowX1 - windowX0);
+    long long windowHeight = std::min(k_RegistrationWindowSize, windowY1 - windowY0);
+    long long windowX = (windowX0 + windowX1 - windowWidth) / 2;
+    long long windowY = (windowY0 + windowY1 - windowHeight) / 2;
+    IMFImageCorrelation::GrayRegion windowA = IMFImageCorrelation::SampleGray(a, factor, windowX, windowY, windowWidth, windowHeight);
+    IMFImageCorrelation::GrayRegion windowB = IMFImageCorrelation::SampleGray(b, factor, windowX - levelX - 1, windowY - levelY - 1, windowWidth + 2, windowHeight + 2);
+    IMFImageCorrelation::SearchTranslation(windowA, windowB, 1, k_MinOverlapFraction, levelX, levelY);
+  }
+
+  sx = levelX * static_cast<long long>(factor);
+  sy = levelY * static_cast<long long>(factor);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFPipelinedMontage::IsPipelinedMontage(const FilterPipeline::Pointer& pipeline)
+{
+  return pipeline && pipeline->property(IMFMontagePipelineBuilder::PipelinedProperty).toBool();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFPipelinedMontage::CreateDataflowPipeline(const FilterPipeline::Pointer& pipeline)
+{
+  FilterPipeline::Pointer dataflowPipeline = FilterPipeline::New();
+  dataflowPipeline->setName(pipeline->getName());
+  for(const QByteArray& name : pipeline->dynamicPropertyNames())
+  {
+    dataflowPipeline->setProperty(name.constData(), pipeline->property(name.constData()));
+  }
+  return dataflowPipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFPipelinedMontage::ExecutePipeline(const IMFMontagePipelineBuilder::MontageSettings& settings, const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca,
+                                         int readThreadCount)
+{
+  QString tilePrefix = pipeline->property(IMFStreamingStitcher::TilePrefixProperty).toString();
+  QString amName = pipeline->property(IMFStreamingStitcher::AttributeMatrixNameProperty).toString();
+  QString daName = pipeline->property(IMFStreamingStitcher::DataArrayNameProperty).toString();
+
+  // The import filters name their tiles <prefix>r<row>c<col>, zero padded to the largest index
+  QRegularExpression positionExpression("r(\\d+)c(\\d+)$");
+  std::vector<Tile> tiles;
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    QRegularExpressionMatch match = positionExpression.match(dc->getName());
+    if(!dc->getName().startsWith(tilePrefix) || !match.hasMatch() || !dc->getGeometryAs<ImageGeom>())
+    {
+      continue;
+    }
+
+    Tile tile;
+    tile.dc = dc;
+    tile.position = {match.captured(2).toInt(), match.captured(1).toInt()};
+    tiles.push_back(tile);
+  }
+
+  if(tiles.empty())
+  {
+    return k_NoTilesError;
+  }
+
+  // Tiles are read, and so become available for registration, in row-major order
+  std::sort(tiles.begin(), tiles.end(), [](const Tile& lhs, const Tile& rhs) { return std::make_pair(lhs.position[1], lhs.position[0]) < std::make_pair(rhs.position[1], rhs.position[0]); });
+
+  ImageGeom::Pointer firstGeom = tiles.front().dc->getGeometryAs<ImageGeom>();
+  FloatVec3Type spacing = firstGeom->getSpacing();
+  FloatVec3Type firstOrigin = firstGeom->getOrigin();
+  std::map<std::pair<int, int>, size_t> tileIndices;
+  for(size_t i = 0; i < tiles.size(); i++)
+  {
+    FloatVec3Type origin = tiles[i].dc->getGeometryAs<ImageGeom>()->getOrigin();
+    tiles[i].x = std::llround((origin[0] - firstOrigin[0]) / spacing[0]);
+    tiles[i].y = std::llround((origin[1] - firstOrigin[1]) / spacing[1]);
+    tileIndices[std::make_pair(tiles[i].position[1], tiles[i].position[0])] = i;
+  }
+
+  // Each tile is registered with its left and top neighbours at their nominal offsets
+  std::vector<Pair> pairs;
+  for(size_t i = 0; i < tiles.size(); i++)
+  {
+    std::vector<std::pair<int, int>> neighbours = {{tiles[i].position[1], tiles[i].position[0] - 1}, {tiles[i].position[1] - 1, tiles[i].position[0]}};
+    for(const std::pair<int, int>& neighbour : neighbours)
+    {
+      auto iter = tileIndices.find(neighbour);
+      if(iter == tileIndices.end())
+      {
+        continue;
+      }
+
+      Pair pair;
+      pair.a = iter->second;
+      pair.b = i;
+      pair.sx = tiles[i].x - tiles[pair.a].x;
+      pair.sy = tiles[i].y - tiles[pair.a].y;
+      tiles[pair.a].childPairs.push_back(pairs.size());
+      tiles[i].parentPairs.push_back(pairs.size());
+      pairs.push_back(pair);
+    }
+  }
+
+  IMFTraceSpan montageSpan(QObject::tr("Pipelined Montage"), IMFTrace::PipelineCategory);
+  montageSpan.setArg("Pipeline", pipeline->getName());
+  montageSpan.setArg("Tiles", static_cast<int>(tiles.size()));
+
+  std::shared_ptr<Dataflow> dataflow = std::make_shared<Dataflow>();
+  std::shared_ptr<std::atomic_bool> wanted = std::make_shared<std::atomic_bool>(true);
+  QThreadPool readPool;
+  readPool.setMaxThreadCount(std::max(1, readThreadCount));
+  QThreadPool registrationPool;
+  registrationPool.setMaxThreadCount(QThread::idealThreadCount());
+
+  // Streamed to a file, each tile's pixels are released once the tile is placed and registered
+  // with its right and bottom neighbours, and the stitcher reads them again strip by strip.  Reads
+  // then stay about a row of tiles ahead, so montages larger than memory can be stitched.
+  QString outputFilePath = pipeline->property(IMFStreamingStitcher::OutputFileProperty).toString();
+  bool releaseTiles = !outputFilePath.isEmpty();
+  size_t readWindow = tiles.size();
+  if(releaseTiles)
+  {
+    std::map<int, size_t> rowLengths;
+    for(const Tile& tile : tiles)
+    {
+      rowLengths[tile.position[1]]++;
+    }
+    size_t rowLength = 0;
+    for(const auto& rowLengthEntry : rowLengths)
+    {
+      rowLength = std::max(rowLength, rowLengthEntry.second);
+    }
+    readWindow = rowLength + 1 + static_cast<size_t>(readPool.maxThreadCount() * 2);
+  }
+
+  QString pipelineName = pipeline->getName();
+  size_t queuedCount = 0;
+  auto queueRead = [&] {
+    size_t index = queuedCount++;
+    IntVec2Type position = tiles[index].position;
+    QtConcurrent::run(&readPool, [=] {
+      Event event;
+      event.index = index;
+      event.tileRead = IMFLazyTileLoader::ReadTile(settings, pipelineName, position, wanted);
+      dataflow->post(event);
+    });
+  };
+  for(size_t i = 0; i < tiles.size() && i < readWindow; i++)
+  {
+    queueRead();
+  }
+
+  auto startRegistration = [&](size_t pairIndex) {
+    IMFImageCorrelation::Image imageA = tiles[pairs[pairIndex].a].image;
+    IMFImageCorrelation::Image imageB = tiles[pairs[pairIndex].b].image;
+    long long nominalX = pairs[pairIndex].sx;
+    long long nominalY = pairs[pairIndex].sy;
+    QtConcurrent::run(&registrationPool, [=] {
+      IMFTraceSpan registerSpan(QObject::tr("Register Tiles"), IMFTrace::PipelineCategory);
+      registerSpan.setArg("Pipeline", pipelineName);
+      Event event;
+      event.isTileRead = false;
+      event.index = pairIndex;
+      event.sx = nominalX;
+      event.sy = nominalY;
+      if(IMFImageCorrelation::IsSupportedType(imageA.data) && IMFImageCorrelation::IsSupportedType(imageB.data))
+      {
+        registerPair(imageA, imageB, event.sx, event.sy);
+      }
+      dataflow->post(event);
+    });
+  };
+
+  // A tile is placed at the mean of the positions its registered parents give it
+  auto tryPlace = [&](size_t index) {
+    Tile& tile = tiles[index];
+    if(tile.placed || !tile.loaded)
+    {
+      return false;
+    }
+
+    long long sumX = 0;
+    long long sumY = 0;
+    for(size_t pairIndex : tile.parentPairs)
+    {
+      const Pair& pair = pairs[pairIndex];
+      if(!pair.registered || !tiles[pair.a].placed)
+      {
+        return false;
+      }
+      sumX += tiles[pair.a].x + pair.sx;
+      sumY += tiles[pair.a].y + pair.sy;
+    }
+
+    long long parentCount = static_cast<long long>(tile.parentPairs.size());
+    if(parentCount > 0)
+    {
+      tile.x = std::llround(static_cast<double>(sumX) / static_cast<double>(parentCount));
+      tile.y = std::llround(static_cast<double>(sumY) / static_cast<double>(parentCount));
+    }
+    tile.placed = true;
+    return true;
+  };
+
+  // Each released tile frees a slot in the read window for the next tile in row-major order
+  auto tryRelease = [&](size_t index) {
+    Tile& tile = tiles[index];
+    if(!releaseTiles || tile.released || !tile.placed)
+    {
+      return;
+    }
+    for(size_t pairIndex : tile.childPairs)
+    {
+      if(!pairs[pairIndex].registered)
+      {
+        return;
+      }
+    }
+
+    tile.dc->removeAttributeMatrix(amName);
+    tile.image.data.reset();
+    tile.released = true;
+    if(queuedCount < tiles.size())
+    {
+      queueRead();
+    }
+  };
+
+  size_t placedCount = 0;
+  int err = 0;
+  while(placedCount < tiles.size() && err >= 0)
+  {
+    Event event = dataflow->take();
+    std::deque<size_t> candidates;
+    if(event.isTileRead)
+    {
+      Tile& tile = tiles[event.index];
+      if(event.tileRead.err < 0)
+      {
+        err = event.tileRead.err;
+        break;
+      }
+      if(!event.tileRead.dc)
+      {
+        err = k_MissingTileError;
+        break;
+      }
+
+      // The pixels move into the preflighted geometry so the stitcher finds every tile in one array
+      for(const AttributeMatrix::Pointer& am : event.tileRead.dc->getAttributeMatrices())
+      {
+        tile.dc->addOrReplaceAttributeMatrix(am);
+      }
+      tile.loaded = true;
+
+      AttributeMatrix::Pointer am = tile.dc->getAttributeMatrix(amName);
+      SizeVec3Type dims = tile.dc->getGeometryAs<ImageGeom>()->getDimensions();
+      tile.image.data = am ? am->getAttributeArray(daName) : IDataArray::NullPointer();
+      tile.image.width = dims[0];
+      tile.image.height = dims[1];
+
+      for(size_t pairIndex : tile.parentPairs)
+      {
+        if(tiles[pairs[pairIndex].a].loaded)
+        {
+          startRegistration(pairIndex);
+        }
+      }
+      for(size_t pairIndex : tile.childPairs)
+      {
+        if(tiles[pairs[pairIndex].b].loaded)
+        {
+          startRegistration(pairIndex);
+        }
+      }
+      candidates.push_back(event.index);
+    }
+    else
+    {
+      Pair& pair = pairs[event.index];
+      pair.sx = event.sx;
+      pair.sy = event.sy;
+      pair.registered = true;
+      candidates.push_back(pair.b);
+      tryRelease(pair.a);
+    }
+
+    // Placing a tile can complete the parents of the tiles to its right and below
+    while(!candidates.empty())
+    {
+      size_t index = candidates.front();
+      candidates.pop_front();
+      if(!tryPlace(index))
+      {
+        continue;
+      }
+
+      placedCount++;
+      for(size_t pairIndex : tiles[index].childPairs)
+      {
+        candidates.push_back(pairs[pairIndex].b);
+      }
+      tryRelease(index);
+    }
+  }
+
+  if(err < 0)
+  {
+    // Reads that have not started are skipped, and the results still in flight are discarded
+    *wanted = false;
+    readPool.waitForDone();
+    registrationPool.waitForDone();
+    return err;
+  }
+
+  for(const Tile& tile : tiles)
+  {
+    ImageGeom::Pointer geom = tile.dc->getGeometryAs<ImageGeom>();
+    FloatVec3Type origin = geom->getOrigin();
+    origin[0] = firstOrigin[0] + static_cast<float>(tile.x) * spacing[0];
+    origin[1] = firstOrigin[1] + static_cast<float>(tile.y) * spacing[1];
+    geom->setOrigin(origin);
+  }
+  montageSpan.setArg("Registered Pairs", static_cast<int>(pairs.size()));
+
+  if(!releaseTiles)
+  {
+    return IMFStreamingStitcher::ExecutePipeline(pipeline, dca);
+  }
+
+  IMFStreamingStitcher::TileReadFunction readTile = [&](const DataContainer::Pointer& tileDC) {
+    QRegularExpressionMatch match = positionExpression.match(tileDC->getName());
+    IntVec2Type position = {match.captured(2).toInt(), match.captured(1).toInt()};
+    IMFLazyTileLoader::TileRead tileRead = IMFLazyTileLoader::ReadTile(settings, pipelineName, position, std::make_shared<std::atomic_bool>(true));
+    if(tileRead.err < 0)
+    {
+      return tileRead.err;
+    }
+    if(!tileRead.dc)
+    {
+      return k_MissingTileError;
+    }
+    for(const AttributeMatrix::Pointer& am : tileRead.dc->getAttributeMatrices())
+    {
+      tileDC->addOrReplaceAttributeMatrix(am);
+    }
+    return 0;
+  };
+  return IMFStreamingStitcher::StitchTiles(dca, tilePrefix, amName, daName, outputFilePath, IMFMontagePipelineBuilder::MontagePath(), readTile);
+}
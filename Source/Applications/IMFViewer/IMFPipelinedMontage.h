@@ -0,0 +1,100 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+/**
+ * @brief The IMFPipelinedMontage class imports a stitched montage as a dataflow instead of
+ * running the import, registration and stitching stages one after the other.  Tiles are
+ * read on a pool of worker threads in row-major order, each pair of neighbouring tiles is
+ * registered as soon as both of them are loaded, and a tile is placed as soon as the pairs
+ * with its left and top neighbours are registered.  Reading the last tiles therefore overlaps
+ * registering the first ones, and the stitcher starts the moment the last tile is placed.
+ *
+ * When the montage is stitched to a file, a tile's pixels are released as soon as it is
+ * placed and registered with its right and bottom neighbours, reads stay about one row of
+ * tiles ahead of the registration, and the stitcher reads each tile again when it reaches
+ * the tile's first strip.  Only a few rows of tiles are then in memory at any time.
+ *
+ * Tiles are placed from the normalized cross-correlation of their overlaps with their left
+ * and top neighbours rather than by the global phase correlation of PCMTileRegistration.
+ */
+class IMFPipelinedMontage
+{
+public:
+  static const int k_NoTilesError = -89070;
+  static const int k_MissingTileError = -89071;
+
+  /**
+   * @brief Returns true if the pipeline was built to be imported as a dataflow by this class.
+   * IMFMontagePipelineBuilder marks these pipelines when MontageSettings::PipelinedImport is set.
+   * @param pipeline
+   * @return
+   */
+  static bool IsPipelinedMontage(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Returns a pipeline without filters that has the name and properties of the montage
+   * pipeline.  It is queued with the preflighted tile geometries and ExecutePipeline as its
+   * post-execute function, so the import filter never runs over the whole montage.
+   * @param pipeline
+   * @return
+   */
+  static FilterPipeline::Pointer CreateDataflowPipeline(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Reads, registers and places every tile geometry of the data container array, then
+   * stitches them with IMFStreamingStitcher using the pipeline's properties.  The tile pixels
+   * are read by single tile import pipelines built from the settings, with at most
+   * readThreadCount tiles read at once.
+   * @param settings
+   * @param pipeline
+   * @param dca
+   * @param readThreadCount
+   * @return
+   */
+  static int ExecutePipeline(const IMFMontagePipelineBuilder::MontageSettings& settings, const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int readThreadCount);
+
+private:
+  IMFPipelinedMontage() = delete;
+};
@@ -0,0 +1,563 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "IMFPluginLoader.h"
+
+#if !defined(_MSC_VER)
+#include <unistd.h>
+#endif
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDateTime>
+#include <QtCore/QDebug>
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutex>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+#include <QtCore/QThread>
+
+#include "SIMPLib/Filtering/FilterManager.h"
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+#include "SIMPLib/Plugin/PluginManager.h"
+
+#include "IMFViewer/IMFDeferredFilterFactory.h"
+#include "IMFViewer/IMFDeferredPlugin.h"
+#include "IMFViewer/IMFTrace.h"
+
+#include "BrandedStrings.h"
+
+namespace
+{
+// Increment when the manifest layout changes so older manifests are rebuilt
+const int k_ManifestVersion = 2;
+
+struct DeferredPlugins
+{
+  QMutex mutex;
+  QStringList filePaths;
+  QMap<QString, ISIMPLibPlugin*> plugins;
+  IMFPluginLoader::PluginLoadedFunction loadedFunction;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DeferredPlugins& deferredPlugins()
+{
+  static DeferredPlugins instance;
+  return instance;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList IMFPluginLoader::FindPluginDirectories()
+{
+  QString applicationDirPath = QCoreApplication::applicationDirPath();
+
+  QStringList pluginDirs;
+  pluginDirs << applicationDirPath;
+
+  QDir aPluginDir = QDir(applicationDirPath);
+  qDebug() << "Loading " << BrandedStrings::ApplicationName << " Plugins....";
+  QString thePath;
+
+#if defined(Q_OS_WIN)
+  if(aPluginDir.cd("Plugins"))
+  {
+    thePath = aPluginDir.absolutePath();
+    pluginDirs << thePath;
+  }
+#elif defined(Q_OS_MAC)
+  // Look to see if we are inside an .app package or inside the 'tools' directory
+  if(aPluginDir.dirName() == "MacOS")
+  {
+    aPluginDir.cdUp();
+    thePath = aPluginDir.absolutePath() + "/Plugins";
+    qDebug() << "  Adding Path " << thePath;
+    pluginDirs << thePath;
+    aPluginDir.cdUp();
+    aPluginDir.cdUp();
+    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
+    chdir(aPluginDir.absolutePath().toLatin1().constData());
+  }
+  if(aPluginDir.dirName() == "bin")
+  {
+    aPluginDir.cdUp();
+    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
+    chdir(aPluginDir.absolutePath().toLatin1().constData());
+  }
+  // aPluginDir.cd("Plugins");
+  thePath = aPluginDir.absolutePath() + "/Plugins";
+  qDebug() << "  Adding Path " << thePath;
+  pluginDirs << thePath;
+
+// This is here for Xcode compatibility
+#ifdef CMAKE_INTDIR
+  aPluginDir.cdUp();
+  thePath = aPluginDir.absolutePath() + "/Plugins/" + CMAKE_INTDIR;
+  pluginDirs << thePath;
+#endif
+#else
+  // We are on Linux - I think
+  // Try the current location of where the application was launched from which is
+  // typically the case when debugging from a build tree
+  if(aPluginDir.cd("Plugins"))
+  {
+    thePath = aPluginDir.absolutePath();
+    pluginDirs << thePath;
+    aPluginDir.cdUp(); // Move back up a directory level
+  }
+
+  if(thePath.isEmpty())
+  {
+    // Now try moving up a directory which is what should happen when running from a
+    // proper distribution of SIMPLView
+    aPluginDir.cdUp();
+    if(aPluginDir.cd("Plugins"))
+    {
+      thePath = aPluginDir.absolutePath();
+      pluginDirs << thePath;
+      aPluginDir.cdUp(); // Move back up a directory level
+      int no_error = chdir(aPluginDir.absolutePath().toLatin1().constData());
+      if(no_error < 0)
+      {
+        qDebug() << "Could not set the working directory.";
+      }
+    }
+  }
+#endif
+
+  QByteArray pluginEnvPath = qgetenv("SIMPL_PLUGIN_PATH");
+  qDebug() << "SIMPL_PLUGIN_PATH:" << pluginEnvPath;
+
+  char sep = ';';
+#if defined(Q_OS_WIN)
+  sep = ':';
+#endif
+  QList<QByteArray> envPaths = pluginEnvPath.split(sep);
+  foreach(QByteArray envPath, envPaths)
+  {
+    if(envPath.size() > 0)
+    {
+      pluginDirs << QString::fromLatin1(envPath);
+    }
+  }
+
+  int dupes = pluginDirs.removeDuplicates();
+  qDebug() << "Removed " << dupes << " duplicate Plugin Paths";
+
+  return pluginDirs;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList IMFPluginLoader::FindPluginFilePaths()
+{
+  QStringList pluginDirs = FindPluginDirectories();
+  QStringList pluginFilePaths;
+
+  foreach(QString pluginDirString, pluginDirs)
+  {
+    qDebug() << "Plugin Directory being Searched: " << pluginDirString;
+    QDir aPluginDir = QDir(pluginDirString);
+    foreach(QString fileName, aPluginDir.entryList(QDir::Files))
+    {
+//   qDebug() << "File: " << fileName() << "\n";
+#ifdef QT_DEBUG
+      if(fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive))
+#else
+      if(fileName.endsWith(".guiplugin", Qt::CaseSensitive)            // We want ONLY Release plugins
+         && !fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive)) // so ignore these plugins
+#endif
+      {
+        pluginFilePaths << aPluginDir.absoluteFilePath(fileName);
+        // qWarning(aPluginDir.absoluteFilePath(fileName).toLatin1(), "%s");
+        // qDebug() << "Adding " << aPluginDir.absoluteFilePath(fileName)() << "\n";
+      }
+    }
+  }
+
+  return pluginFilePaths;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QVector<ISIMPLibPlugin*> IMFPluginLoader::LoadFilterPlugins(const QStringList& pluginFilePaths, QVector<QPluginLoader*>& loaders, QStringList& errorMessages)
+{
+  FilterManager* filterManager = FilterManager::Instance();
+  FilterManager::RegisterKnownFilters(filterManager);
+
+  PluginManager* pluginManager = PluginManager::Instance();
+
+  foreach(QString path, pluginFilePaths)
+  {
+    qDebug() << "Plugin Being Loaded:" << path;
+    IMFTraceSpan pluginSpan(QObject::tr("Load Plugin %1").arg(QFileInfo(path).fileName()), IMFTrace::StartupCategory);
+    QPluginLoader* loader = new QPluginLoader(path);
+    QObject* plugin = loader->instance();
+    ISIMPLibPlugin* ipPlugin = qobject_cast<ISIMPLibPlugin*>(plugin);
+    if(ipPlugin == nullptr)
+    {
+      errorMessages << QObject::tr("The plugin '%1' did not load with the following error: %2").arg(path, loader->errorString());
+      delete loader;
+      continue;
+    }
+
+    RegisterPluginFilters(ipPlugin);
+    ipPlugin->setDidLoad(true);
+    ipPlugin->setLocation(path);
+    pluginManager->addPlugin(ipPlugin);
+    loaders.push_back(loader);
+  }
+
+  return pluginManager->getPluginsVector();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QStringList IMFPluginLoader::RegisterPluginFilters(ISIMPLibPlugin* plugin)
+{
+  FilterManager* filterManager = FilterManager::Instance();
+  FilterManager::Collection factoriesBefore = filterManager->getFactories();
+  plugin->registerFilters(filterManager);
+
+  QStringList filterClassNames;
+  FilterManager::Collection factoriesAfter = filterManager->getFactories();
+  for(FilterManager::Collection::const_iterator iter = factoriesAfter.constBegin(); iter != factoriesAfter.constEnd(); ++iter)
+  {
+    if(factoriesBefore.value(iter.key()) != iter.value())
+    {
+      filterClassNames.push_back(iter.key());
+    }
+  }
+
+  return filterClassNames;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFPluginLoader::DefaultManifestFilePath()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/PluginManifest.json";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFPluginLoader::Manifest IMFPluginLoader::ReadManifest(const QString& filePath)
+{
+  Manifest manifest;
+
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return manifest;
+  }
+
+  QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+  if(root["Version"].toInt() != k_ManifestVersion)
+  {
+    return manifest;
+  }
+
+  for(const QJsonValue& pluginValue : root["Plugins"].toArray())
+  {
+    QJsonObject pluginObj = pluginValue.toObject();
+    PluginRecord record;
+    record.FilePath = pluginObj["FilePath"].toString();
+    record.LastModified = static_cast<qint64>(pluginObj["LastModified"].toDouble());
+    record.FileSize = static_cast<qint64>(pluginObj["FileSize"].toDouble());
+    record.PluginName = pluginObj["PluginName"].toString();
+    record.DisplayName = pluginObj["DisplayName"].toString();
+    record.BaseName = pluginObj["BaseName"].toString();
+    record.Version = pluginObj["Version"].toString();
+    record.CompatibilityVersion = pluginObj["CompatibilityVersion"].toString();
+    record.Vendor = pluginObj["Vendor"].toString();
+    record.URL = pluginObj["URL"].toString();
+    record.Description = pluginObj["Description"].toString();
+    record.Copyright = pluginObj["Copyright"].toString();
+    record.License = pluginObj["License"].toString();
+
+    for(const QJsonValue& filterValue : pluginObj["Filters"].toArray())
+    {
+      QJsonObject filterObj = filterValue.toObject();
+      FilterRecord filter;
+      filter.ClassName = filterObj["ClassName"].toString();
+      filter.HumanLabel = filterObj["HumanLabel"].toString();
+      filter.GroupName = filterObj["GroupName"].toString();
+      filter.SubGroupName = filterObj["SubGroupName"].toString();
+      filter.Uuid = QUuid(filterObj["Uuid"].toString());
+      filter.CompiledLibraryName = filterObj["CompiledLibraryName"].toString();
+      filter.BrandingString = filterObj["BrandingString"].toString();
+      record.Filters.push_back(filter);
+    }
+
+    if(!record.FilePath.isEmpty())
+    {
+      manifest.insert(record.FilePath, record);
+    }
+  }
+
+  return manifest;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFPluginLoader::WriteManifest(const QString& filePath, const Manifest& manifest)
+{
+  QJsonArray pluginArray;
+  for(const PluginRecord& record : manifest)
+  {
+    QJsonArray filterArray;
+    for(const FilterRecord& filter : record.Filters)
+    {
+      QJsonObject filterObj;
+      filterObj["ClassName"] = filter.ClassName;
+      filterObj["HumanLabel"] = filter.HumanLabel;
+      filterObj["GroupName"] = filter.GroupName;
+      filterObj["SubGroupName"] = filter.SubGroupName;
+      filterObj["Uuid"] = filter.Uuid.toString();
+      filterObj["CompiledLibraryName"] = filter.CompiledLibraryName;
+      filterObj["BrandingString"] = filter.BrandingString;
+      filterArray.push_back(filterObj);
+    }
+
+    QJsonObject pluginObj;
+    pluginObj["FilePath"] = record.FilePath;
+    pluginObj["LastModified"] = static_cast<double>(record.LastModified);
+    pluginObj["FileSize"] = static_cast<double>(record.FileSize);
+    pluginObj["PluginName"] = record.PluginName;
+    pluginObj["DisplayName"] = record.DisplayName;
+    pluginObj["BaseName"] = record.BaseName;
+    pluginObj["Version"] = record.Version;
+    pluginObj["CompatibilityVersion"] = record.CompatibilityVersion;
+    pluginObj["Vendor"] = record.Vendor;
+    pluginObj["URL"] = record.URL;
+    pluginObj["Description"] = record.Description;
+    pluginObj["Copyright"] = record.Copyright;
+    pluginObj["License"] = record.License;
+    pluginObj["Filters"] = filterArray;
+    pluginArray.push_back(pluginObj);
+  }
+
+  QJsonObject root;
+  root["Version"] = k_ManifestVersion;
+  root["Plugins"] = pluginArray;
+
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFPluginLoader::PluginRecord IMFPluginLoader::CreatePluginRecord(const QString& pluginFilePath, ISIMPLibPlugin* plugin, const QStringList& filterClassNames)
+{
+  QFileInfo fi(pluginFilePath);
+
+  PluginRecord record;
+  record.FilePath = pluginFilePath;
+  record.LastModified = fi.lastModified().toMSecsSinceEpoch();
+  record.FileSize = fi.size();
+  record.PluginName = plugin->getPluginFileName();
+  record.DisplayName = plugin->getPluginDisplayName();
+  record.BaseName = plugin->getPluginBaseName();
+  record.Version = plugin->getVersion();
+  record.CompatibilityVersion = plugin->getCompatibilityVersion();
+  record.Vendor = plugin->getVendor();
+  record.URL = plugin->getURL();
+  record.Description = plugin->getDescription();
+  record.Copyright = plugin->getCopyright();
+  record.License = plugin->getLicense();
+
+  FilterManager* filterManager = FilterManager::Instance();
+  for(const QString& className : filterClassNames)
+  {
+    IFilterFactory::Pointer factory = filterManager->getFactoryFromClassName(className);
+    if(!factory)
+    {
+      continue;
+    }
+
+    FilterRecord filter;
+    filter.ClassName = className;
+    filter.HumanLabel = factory->getFilterHumanLabel();
+    filter.GroupName = factory->getFilterGroup();
+    filter.SubGroupName = factory->getFilterSubGroup();
+    filter.Uuid = factory->getUuid();
+    filter.CompiledLibraryName = factory->getCompiledLibraryName();
+    filter.BrandingString = factory->getBrandingString();
+    record.Filters.push_back(filter);
+  }
+
+  return record;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFPluginLoader::IsPluginRecordCurrent(const PluginRecord& record)
+{
+  QFileInfo fi(record.FilePath);
+  return fi.exists() && fi.size() == record.FileSize && fi.lastModified().toMSecsSinceEpoch() == record.LastModified;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPluginLoader::RegisterDeferredFilters(const PluginRecord& record)
+{
+  FilterManager* filterManager = FilterManager::Instance();
+  for(const FilterRecord& filter : record.Filters)
+  {
+    filterManager->addFilterFactory(filter.ClassName, IMFDeferredFilterFactory::New(record.FilePath, filter));
+  }
+
+  // The proxy is never deleted because the PluginManager lists it until exit
+  PluginManager::Instance()->addPlugin(new IMFDeferredPlugin(record));
+
+  DeferredPlugins& deferred = deferredPlugins();
+  QMutexLocker locker(&deferred.mutex);
+  deferred.filePaths.push_back(record.FilePath);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ISIMPLibPlugin* IMFPluginLoader::LoadDeferredPlugin(const QString& pluginFilePath)
+{
+  DeferredPlugins& deferred = deferredPlugins();
+  QMutexLocker locker(&deferred.mutex);
+  if(deferred.plugins.contains(pluginFilePath))
+  {
+    return deferred.plugins.value(pluginFilePath);
+  }
+
+  // Waiting for the application thread could deadlock while it waits for the workers, so
+  // plugins needed on workers are loaded beforehand with LoadDeferredPlugins
+  QCoreApplication* application = QCoreApplication::instance();
+  if(application != nullptr && QThread::currentThread() != application->thread())
+  {
+    qWarning() << "The plugin" << pluginFilePath << "was needed on a worker thread before it was loaded on the application thread";
+    return nullptr;
+  }
+
+  // The loader is never deleted because the filters of the plugin stay registered until exit
+  IMFTraceSpan pluginSpan(QObject::tr("Load Deferred Plugin %1").arg(QFileInfo(pluginFilePath).fileName()), IMFTrace::ImportCategory);
+  QPluginLoader* loader = new QPluginLoader(pluginFilePath);
+  ISIMPLibPlugin* plugin = qobject_cast<ISIMPLibPlugin*>(loader->instance());
+  deferred.plugins.insert(pluginFilePath, plugin);
+  if(plugin == nullptr)
+  {
+    qWarning() << "The plugin" << pluginFilePath << "did not load with the following error:" << loader->errorString();
+    delete loader;
+    return nullptr;
+  }
+
+  // The plugin is listed in the PluginManager by the IMFDeferredPlugin added when its filters
+  // were registered, which describes the loaded plugin from now on
+  RegisterPluginFilters(plugin);
+  plugin->setDidLoad(true);
+  plugin->setLocation(pluginFilePath);
+
+  if(deferred.loadedFunction)
+  {
+    deferred.loadedFunction(plugin);
+  }
+
+  return plugin;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+ISIMPLibPlugin* IMFPluginLoader::FindDeferredPlugin(const QString& pluginFilePath)
+{
+  DeferredPlugins& deferred = deferredPlugins();
+  QMutexLocker locker(&deferred.mutex);
+  return deferred.plugins.value(pluginFilePath, nullptr);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPluginLoader::LoadDeferredPlugins()
+{
+  DeferredPlugins& deferred = deferredPlugins();
+  QStringList filePaths;
+  {
+    QMutexLocker locker(&deferred.mutex);
+    for(const QString& filePath : deferred.filePaths)
+    {
+      if(!deferred.plugins.contains(filePath))
+      {
+        filePaths.push_back(filePath);
+      }
+    }
+  }
+
+  for(const QString& filePath : filePaths)
+  {
+    LoadDeferredPlugin(filePath);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFPluginLoader::SetDeferredPluginLoadedFunction(const PluginLoadedFunction& function)
+{
+  DeferredPlugins& deferred = deferredPlugins();
+  QMutexLocker locker(&deferred.mutex);
+  deferred.loadedFunction = function;
+}
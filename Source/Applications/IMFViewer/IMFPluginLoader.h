@@ -0,0 +1,220 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <functional>
+
+#include <QtCore/QMap>
+#include <QtCore/QStringList>
+#include <QtCore/QUuid>
+#include <QtCore/QVector>
+
+class ISIMPLibPlugin;
+class QPluginLoader;
+
+/**
+ * @brief The IMFPluginLoader class locates the SIMPL plugins that ship with the
+ * application.  The search does not depend on any widgets so it is shared by the
+ * GUI and the command line tools.
+ *
+ * The filters of every loaded plugin are recorded in a manifest together with the size
+ * and modification time of the plugin file.  Plugins whose file has not changed since
+ * can be registered from the manifest and loaded only when one of their filters is
+ * created.
+ */
+class IMFPluginLoader
+{
+public:
+  struct FilterRecord
+  {
+    QString ClassName;
+    QString HumanLabel;
+    QString GroupName;
+    QString SubGroupName;
+    QUuid Uuid;
+    QString CompiledLibraryName;
+    QString BrandingString;
+
+    bool operator==(const FilterRecord& other) const
+    {
+      return ClassName == other.ClassName && HumanLabel == other.HumanLabel && GroupName == other.GroupName && SubGroupName == other.SubGroupName && Uuid == other.Uuid &&
+             CompiledLibraryName == other.CompiledLibraryName && BrandingString == other.BrandingString;
+    }
+  };
+
+  struct PluginRecord
+  {
+    QString FilePath;
+    qint64 LastModified = 0;
+    qint64 FileSize = 0;
+    QString PluginName;
+    QString DisplayName;
+    QString BaseName;
+    QString Version;
+    QString CompatibilityVersion;
+    QString Vendor;
+    QString URL;
+    QString Description;
+    QString Copyright;
+    QString License;
+    QVector<FilterRecord> Filters;
+
+    bool operator==(const PluginRecord& other) const
+    {
+      return FilePath == other.FilePath && LastModified == other.LastModified && FileSize == other.FileSize && PluginName == other.PluginName && DisplayName == other.DisplayName &&
+             BaseName == other.BaseName && Version == other.Version && CompatibilityVersion == other.CompatibilityVersion && Vendor == other.Vendor && URL == other.URL &&
+             Description == other.Description && Copyright == other.Copyright && License == other.License && Filters == other.Filters;
+    }
+  };
+
+  using Manifest = QMap<QString, PluginRecord>;
+  using PluginLoadedFunction = std::function<void(ISIMPLibPlugin*)>;
+
+  /**
+   * @brief Returns the directories that are searched for plugins.  This may change
+   * the current working directory to match the layout of an installed package.
+   * @return
+   */
+  static QStringList FindPluginDirectories();
+
+  /**
+   * @brief Returns the plugin files found in the plugin directories
+   * @return
+   */
+  static QStringList FindPluginFilePaths();
+
+  /**
+   * @brief Loads the plugins and registers their filters with the FilterManager without
+   * registering any filter widgets.  The loaders are appended to the loaders vector and
+   * must outlive the plugins.
+   * @param pluginFilePaths
+   * @param loaders
+   * @param errorMessages
+   * @return
+   */
+  static QVector<ISIMPLibPlugin*> LoadFilterPlugins(const QStringList& pluginFilePaths, QVector<QPluginLoader*>& loaders, QStringList& errorMessages);
+
+  /**
+   * @brief Calls registerFilters on the plugin and returns the class names of the
+   * filters it added or replaced in the FilterManager
+   * @param plugin
+   * @return
+   */
+  static QStringList RegisterPluginFilters(ISIMPLibPlugin* plugin);
+
+  /**
+   * @brief Returns the location of the plugin manifest in the user's cache directory
+   * @return
+   */
+  static QString DefaultManifestFilePath();
+
+  /**
+   * @brief Reads the plugin manifest.  The manifest is empty if the file is missing or
+   * was written by a different manifest version.
+   * @param filePath
+   * @return Plugin records keyed by plugin file path
+   */
+  static Manifest ReadManifest(const QString& filePath);
+
+  /**
+   * @brief Writes the plugin manifest
+   * @param filePath
+   * @param manifest
+   * @return
+   */
+  static bool WriteManifest(const QString& filePath, const Manifest& manifest);
+
+  /**
+   * @brief Creates the manifest entry of a loaded plugin from its description and the
+   * factories of its filters
+   * @param pluginFilePath
+   * @param plugin
+   * @param filterClassNames
+   * @return
+   */
+  static PluginRecord CreatePluginRecord(const QString& pluginFilePath, ISIMPLibPlugin* plugin, const QStringList& filterClassNames);
+
+  /**
+   * @brief Returns true if the plugin file still has the size and modification time
+   * stored in the record
+   * @param record
+   * @return
+   */
+  static bool IsPluginRecordCurrent(const PluginRecord& record);
+
+  /**
+   * @brief Registers a factory for every filter of the record that loads the plugin
+   * the first time one of the filters is created, and adds an IMFDeferredPlugin to the
+   * PluginManager that describes the plugin from the record until it is loaded
+   * @param record
+   */
+  static void RegisterDeferredFilters(const PluginRecord& record);
+
+  /**
+   * @brief Loads a plugin whose filters were registered with RegisterDeferredFilters and
+   * registers its filters.  Later calls return the plugin loaded by the first call.
+   * FilterManager and the filter widget registries are not thread safe, so plugins are
+   * only loaded on the application thread.  A call from another thread returns the plugin
+   * if it is already loaded and nullptr otherwise.
+   * @param pluginFilePath
+   * @return The plugin, or nullptr if it could not be loaded
+   */
+  static ISIMPLibPlugin* LoadDeferredPlugin(const QString& pluginFilePath);
+
+  /**
+   * @brief Returns the plugin if LoadDeferredPlugin loaded it, without loading it
+   * @param pluginFilePath
+   * @return
+   */
+  static ISIMPLibPlugin* FindDeferredPlugin(const QString& pluginFilePath);
+
+  /**
+   * @brief Loads every plugin registered with RegisterDeferredFilters that is not loaded
+   * yet.  This must be called on the application thread before filters are created on
+   * worker threads, such as while montage pipelines are built in the background.
+   */
+  static void LoadDeferredPlugins();
+
+  /**
+   * @brief Sets a function that is called with every plugin loaded by LoadDeferredPlugin.
+   * The GUI uses this to register the filter widgets of the plugin.
+   * @param function
+   */
+  static void SetDeferredPluginLoadedFunction(const PluginLoadedFunction& function);
+
+private:
+  IMFPluginLoader() = delete;
+};
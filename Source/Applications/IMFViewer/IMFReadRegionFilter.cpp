@@ -0,0 +1,589 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFReadRegionFilter.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include <hdf5.h>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+namespace
+{
+// Datasets that ImageGeom writes below the geometry group of its data container
+const char* k_GeometryGroup = "_SIMPL_GEOMETRY";
+const char* k_OriginDataset = "ORIGIN";
+const char* k_SpacingDataset = "SPACING";
+
+struct TileInfo
+{
+  SizeVec3Type dims;
+  FloatVec3Type origin;
+  FloatVec3Type spacing;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString attributeMatrixPath(const QString& dcName, const QString& amName)
+{
+  return SIMPL::StringConstants::DataContainerGroupName + "/" + dcName + "/" + amName;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool pathExists(hid_t fileId, const QString& path)
+{
+  // H5Lexists requires every parent of the link to exist
+  QStringList parts = path.split('/');
+  QString partialPath;
+  for(const QString& part : parts)
+  {
+    partialPath += partialPath.isEmpty() ? part : "/" + part;
+    if(H5Lexists(fileId, partialPath.toLatin1().constData(), H5P_DEFAULT) <= 0)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readVec3(hid_t fileId, const QString& path, FloatVec3Type& value)
+{
+  hid_t datasetId = H5Dopen(fileId, path.toLatin1().constData(), H5P_DEFAULT);
+  if(datasetId < 0)
+  {
+    return false;
+  }
+
+  hid_t spaceId = H5Dget_space(datasetId);
+  float values[3] = {0.0f, 0.0f, 0.0f};
+  herr_t err = H5Sget_simple_extent_npoints(spaceId) == 3 ? H5Dread(datasetId, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, values) : -1;
+  H5Sclose(spaceId);
+  H5Dclose(datasetId);
+  if(err < 0)
+  {
+    return false;
+  }
+
+  value = {values[0], values[1], values[2]};
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Reads the dimensions, origin and spacing of a tile without touching its pixels
+// -----------------------------------------------------------------------------
+bool readTileInfo(hid_t fileId, const QString& dcName, const QString& amName, TileInfo& info)
+{
+  QString amPath = attributeMatrixPath(dcName, amName);
+  QString geometryPath = SIMPL::StringConstants::DataContainerGroupName + "/" + dcName + "/" + k_GeometryGroup;
+  if(!pathExists(fileId, amPath) || !pathExists(fileId, geometryPath))
+  {
+    return false;
+  }
+
+  uint64_t tupleDims[3] = {0, 0, 0};
+  hid_t attrId = H5Aopen_by_name(fileId, amPath.toLatin1().constData(), SIMPL::HDF5::TupleDimensions.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT);
+  herr_t err = attrId < 0 ? -1 : H5Aread(attrId, H5T_NATIVE_UINT64, tupleDims);
+  if(attrId >= 0)
+  {
+    H5Aclose(attrId);
+  }
+  if(err < 0)
+  {
+    return false;
+  }
+
+  info.dims = SizeVec3Type(static_cast<size_t>(tupleDims[0]), static_cast<size_t>(tupleDims[1]), static_cast<size_t>(tupleDims[2]));
+  return readVec3(fileId, geometryPath + "/" + k_OriginDataset, info.origin) && readVec3(fileId, geometryPath + "/" + k_SpacingDataset, info.spacing);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QRectF tileBounds(const TileInfo& info)
+{
+  return QRectF(info.origin[0], info.origin[1], info.dims[0] * info.spacing[0], info.dims[1] * info.spacing[1]);
+}
+
+// -----------------------------------------------------------------------------
+// Returns the pixels of the tile that overlap the region, widened to whole pixels
+// -----------------------------------------------------------------------------
+bool cropTile(const TileInfo& info, const QRectF& region, size_t& x0, size_t& y0, size_t& width, size_t& height)
+{
+  auto toPixel = [](double coord, float origin, float spacing, size_t dim, bool roundUp) {
+    double pixel = (coord - origin) / spacing;
+    pixel = roundUp ? std::ceil(pixel) : std::floor(pixel);
+    return static_cast<size_t>(std::max(0.0, std::min(pixel, static_cast<double>(dim))));
+  };
+
+  x0 = toPixel(region.left(), info.origin[0], info.spacing[0], info.dims[0], false);
+  y0 = toPixel(region.top(), info.origin[1], info.spacing[1], info.dims[1], false);
+  size_t x1 = toPixel(region.left() + region.width(), info.origin[0], info.spacing[0], info.dims[0], true);
+  size_t y1 = toPixel(region.top() + region.height(), info.origin[1], info.spacing[1], info.dims[1], true);
+  if(x1 <= x0 || y1 <= y0)
+  {
+    return false;
+  }
+
+  width = x1 - x0;
+  height = y1 - y0;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Datasets with fewer than three dimensions can not select the crop by row and column, so the
+// whole tile is read and the rows inside the crop are copied out of it
+// -----------------------------------------------------------------------------
+herr_t readFlatCrop(hid_t datasetId, hid_t memTypeId, const SizeVec3Type& sourceDims, size_t tupleSize, size_t x0, size_t y0, size_t width, size_t height, void* dst)
+{
+  hid_t spaceId = H5Dget_space(datasetId);
+  hssize_t numElements = H5Sget_simple_extent_npoints(spaceId);
+  H5Sclose(spaceId);
+  size_t sourceSize = sourceDims[0] * sourceDims[1] * sourceDims[2] * tupleSize;
+  if(numElements < 0 || static_cast<size_t>(numElements) * H5Tget_size(memTypeId) != sourceSize)
+  {
+    return -1;
+  }
+
+  std::vector<uint8_t> source(sourceSize);
+  herr_t err = H5Dread(datasetId, memTypeId, H5S_ALL, H5S_ALL, H5P_DEFAULT, source.data());
+  if(err < 0)
+  {
+    return err;
+  }
+
+  uint8_t* target = static_cast<uint8_t*>(dst);
+  size_t rowSize = width * tupleSize;
+  for(size_t z = 0; z < sourceDims[2]; z++)
+  {
+    for(size_t y = 0; y < height; y++)
+    {
+      size_t sourceOffset = ((z * sourceDims[1] + y0 + y) * sourceDims[0] + x0) * tupleSize;
+      std::memcpy(target + (z * height + y) * rowSize, source.data() + sourceOffset, rowSize);
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer createArray(hid_t typeId, size_t numTuples, const std::vector<size_t>& cDims, const QString& name, bool allocate)
+{
+  size_t size = H5Tget_size(typeId);
+  if(H5Tget_class(typeId) == H5T_FLOAT)
+  {
+    if(size == 4)
+    {
+      return FloatArrayType::CreateArray(numTuples, cDims, name, allocate);
+    }
+    if(size == 8)
+    {
+      return DoubleArrayType::CreateArray(numTuples, cDims, name, allocate);
+    }
+    return IDataArray::NullPointer();
+  }
+
+  if(H5Tget_class(typeId) != H5T_INTEGER)
+  {
+    return IDataArray::NullPointer();
+  }
+
+  bool isSigned = H5Tget_sign(typeId) == H5T_SGN_2;
+  switch(size)
+  {
+  case 1:
+    return isSigned ? IDataArray::Pointer(Int8ArrayType::CreateArray(numTuples, cDims, name, allocate)) : IDataArray::Pointer(UInt8ArrayType::CreateArray(numTuples, cDims, name, allocate));
+  case 2:
+    return isSigned ? IDataArray::Pointer(Int16ArrayType::CreateArray(numTuples, cDims, name, allocate)) : IDataArray::Pointer(UInt16ArrayType::CreateArray(numTuples, cDims, name, allocate));
+  case 4:
+    return isSigned ? IDataArray::Pointer(Int32ArrayType::CreateArray(numTuples, cDims, name, allocate)) : IDataArray::Pointer(UInt32ArrayType::CreateArray(numTuples, cDims, name, allocate));
+  case 8:
+    return isSigned ? IDataArray::Pointer(Int64ArrayType::CreateArray(numTuples, cDims, name, allocate)) : IDataArray::Pointer(UInt64ArrayType::CreateArray(numTuples, cDims, name, allocate));
+  default:
+    return IDataArray::NullPointer();
+  }
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFReadRegionFilter::IMFReadRegionFilter(const QString& filePath, const QString& amName, const QString& daName, const QRectF& region, const QStringList& sourceNames,
+                                         const QStringList& targetNames)
+: m_FilePath(filePath)
+, m_AttributeMatrixName(amName)
+, m_DataArrayName(daName)
+, m_Region(region)
+, m_SourceNames(sourceNames)
+, m_TargetNames(targetNames)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFReadRegionFilter::~IMFReadRegionFilter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFReadRegionFilter::Pointer IMFReadRegionFilter::New(const QString& filePath, const QString& amName, const QString& daName, const QRectF& region, const QStringList& sourceNames,
+                                                      const QStringList& targetNames)
+{
+  Pointer sharedPtr(new IMFReadRegionFilter(filePath, amName, daName, region, sourceNames, targetNames));
+  return sharedPtr;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFReadRegionFilter::PlanRegion(const QString& filePath, const QString& dcPrefix, const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& amName, const QRectF& region,
+                                    IntVec2Type& regionStart, IntVec2Type& regionEnd, QStringList& sourceNames, QStringList& targetNames)
+{
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t fileId = -1;
+  H5E_BEGIN_TRY
+  {
+    fileId = H5Fopen(filePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  }
+  H5E_END_TRY;
+  if(fileId < 0)
+  {
+    return k_OpenFileError;
+  }
+
+  int err = 0;
+  regionStart = {std::numeric_limits<int>::max(), std::numeric_limits<int>::max()};
+  regionEnd = {std::numeric_limits<int>::min(), std::numeric_limits<int>::min()};
+  H5E_BEGIN_TRY
+  {
+    for(int32_t row = montageStart[1]; row <= montageEnd[1] && err >= 0; row++)
+    {
+      for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
+      {
+        TileInfo info;
+        if(!readTileInfo(fileId, IMFMontagePipelineBuilder::TileDataContainerName(dcPrefix, montageEnd, row, col), amName, info))
+        {
+          err = k_MissingTileError;
+          break;
+        }
+
+        size_t x0 = 0;
+        size_t y0 = 0;
+        size_t width = 0;
+        size_t height = 0;
+        if(cropTile(info, region, x0, y0, width, height))
+        {
+          regionStart = {std::min(regionStart[0], col), std::min(regionStart[1], row)};
+          regionEnd = {std::max(regionEnd[0], col), std::max(regionEnd[1], row)};
+        }
+      }
+    }
+  }
+  H5E_END_TRY;
+  H5Fclose(fileId);
+
+  if(err < 0)
+  {
+    return err;
+  }
+  if(regionStart[0] > regionEnd[0])
+  {
+    return k_EmptyRegionError;
+  }
+
+  sourceNames.clear();
+  targetNames.clear();
+  for(int32_t row = regionStart[1]; row <= regionEnd[1]; row++)
+  {
+    for(int32_t col = regionStart[0]; col <= regionEnd[0]; col++)
+    {
+      sourceNames.push_back(IMFMontagePipelineBuilder::TileDataContainerName(dcPrefix, montageEnd, row, col));
+      targetNames.push_back(IMFMontagePipelineBuilder::TileDataContainerName(dcPrefix, regionEnd, row, col));
+    }
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QRectF IMFReadRegionFilter::MontageBounds(const QString& filePath, const QString& dcPrefix, const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& amName)
+{
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  QRectF bounds;
+  H5E_BEGIN_TRY
+  {
+    hid_t fileId = H5Fopen(filePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(fileId >= 0)
+    {
+      for(int32_t row = montageStart[1]; row <= montageEnd[1]; row++)
+      {
+        for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
+        {
+          TileInfo info;
+          if(readTileInfo(fileId, IMFMontagePipelineBuilder::TileDataContainerName(dcPrefix, montageEnd, row, col), amName, info))
+          {
+            bounds = bounds.united(tileBounds(info));
+          }
+        }
+      }
+      H5Fclose(fileId);
+    }
+  }
+  H5E_END_TRY;
+
+  return bounds;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFReadRegionFilter::getNameOfClass() const
+{
+  return QString("IMFReadRegionFilter");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFReadRegionFilter::getHumanLabel() const
+{
+  return QString("Read DREAM3D Montage Region");
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFReadRegionFilter::dataCheck()
+{
+  clearErrorCode();
+  clearWarningCode();
+  m_Crops.clear();
+
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t fileId = -1;
+  H5E_BEGIN_TRY
+  {
+    fileId = H5Fopen(m_FilePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  }
+  H5E_END_TRY;
+  if(fileId < 0)
+  {
+    setErrorCondition(k_OpenFileError, tr("The DREAM3D file '%1' could not be opened.").arg(m_FilePath));
+    return;
+  }
+
+  DataContainerArray::Pointer dca = getDataContainerArray();
+  H5E_BEGIN_TRY
+  {
+    for(int i = 0; i < m_SourceNames.size() && i < m_TargetNames.size(); i++)
+    {
+      TileInfo info;
+      QString datasetPath = attributeMatrixPath(m_SourceNames[i], m_AttributeMatrixName) + "/" + m_DataArrayName;
+      hid_t datasetId = readTileInfo(fileId, m_SourceNames[i], m_AttributeMatrixName, info) ? H5Dopen(fileId, datasetPath.toLatin1().constData(), H5P_DEFAULT) : -1;
+      if(datasetId < 0)
+      {
+        setErrorCondition(k_MissingTileError, tr("The tile '%1' was not found in '%2'.").arg(m_SourceNames[i]).arg(m_FilePath));
+        break;
+      }
+
+      // Tiles in the row and column range of the region that miss the region itself are not read
+      TileCrop crop;
+      crop.sourceName = m_SourceNames[i];
+      crop.sourceDims = info.dims;
+      if(!cropTile(info, m_Region, crop.x0, crop.y0, crop.width, crop.height))
+      {
+        H5Dclose(datasetId);
+        continue;
+      }
+
+      // Datasets are stored slowest axis first, with the component dimensions after the tuple dimensions.
+      // Datasets with fewer dimensions hold the same tuples, so their components are found from the size.
+      hid_t spaceId = H5Dget_space(datasetId);
+      int rank = H5Sget_simple_extent_ndims(spaceId);
+      std::vector<hsize_t> dims(static_cast<size_t>(std::max(rank, 0)));
+      H5Sget_simple_extent_dims(spaceId, dims.data(), nullptr);
+      hssize_t numElements = H5Sget_simple_extent_npoints(spaceId);
+      H5Sclose(spaceId);
+      std::vector<size_t> cDims;
+      if(rank > 3)
+      {
+        cDims.assign(dims.begin() + 3, dims.end());
+      }
+      else
+      {
+        size_t numTuples = info.dims[0] * info.dims[1] * info.dims[2];
+        cDims.push_back(numTuples > 0 && numElements > 0 ? static_cast<size_t>(numElements) / numTuples : 1);
+      }
+
+      std::vector<size_t> tupleDims = {crop.width, crop.height, info.dims[2]};
+      hid_t typeId = H5Dget_type(datasetId);
+      crop.data = createArray(typeId, crop.width * crop.height * info.dims[2], cDims, m_DataArrayName, !getInPreflight());
+      H5Tclose(typeId);
+      H5Dclose(datasetId);
+      if(!crop.data)
+      {
+        setErrorCondition(k_UnsupportedTypeError, tr("The array '%1' of tile '%2' has an unsupported type.").arg(m_DataArrayName).arg(m_SourceNames[i]));
+        break;
+      }
+
+      ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+      imageGeom->setDimensions(SizeVec3Type(crop.width, crop.height, info.dims[2]));
+      imageGeom->setSpacing(info.spacing);
+      imageGeom->setOrigin(FloatVec3Type(info.origin[0] + crop.x0 * info.spacing[0], info.origin[1] + crop.y0 * info.spacing[1], info.origin[2]));
+
+      DataContainer::Pointer dc = DataContainer::New(m_TargetNames[i]);
+      dc->setGeometry(imageGeom);
+      AttributeMatrix::Pointer am = AttributeMatrix::New(tupleDims, m_AttributeMatrixName, AttributeMatrix::Type::Cell);
+      am->addOrReplaceAttributeArray(crop.data);
+      dc->addOrReplaceAttributeMatrix(am);
+      dca->addOrReplaceDataContainer(dc);
+
+      m_Crops.push_back(crop);
+    }
+  }
+  H5E_END_TRY;
+  H5Fclose(fileId);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFReadRegionFilter::preflight()
+{
+  setInPreflight(true);
+  dataCheck();
+  setInPreflight(false);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFReadRegionFilter::execute()
+{
+  dataCheck();
+  if(getErrorCode() < 0)
+  {
+    return;
+  }
+
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  hid_t fileId = H5Fopen(m_FilePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+  if(fileId < 0)
+  {
+    setErrorCondition(k_OpenFileError, tr("The DREAM3D file '%1' could not be opened.").arg(m_FilePath));
+    return;
+  }
+
+  // Only the rows and columns inside the region are selected, so HDF5 reads just the chunks they touch
+  for(const TileCrop& crop : m_Crops)
+  {
+    if(getCancel())
+    {
+      break;
+    }
+
+    QString datasetPath = attributeMatrixPath(crop.sourceName, m_AttributeMatrixName) + "/" + m_DataArrayName;
+    hid_t datasetId = H5Dopen(fileId, datasetPath.toLatin1().constData(), H5P_DEFAULT);
+    hid_t fileSpaceId = H5Dget_space(datasetId);
+    int rank = H5Sget_simple_extent_ndims(fileSpaceId);
+    std::vector<hsize_t> start(static_cast<size_t>(std::max(rank, 0)), 0);
+    std::vector<hsize_t> count(start.size(), 0);
+    H5Sget_simple_extent_dims(fileSpaceId, count.data(), nullptr);
+    if(rank >= 3)
+    {
+      start[1] = static_cast<hsize_t>(crop.y0);
+      start[2] = static_cast<hsize_t>(crop.x0);
+      count[1] = static_cast<hsize_t>(crop.height);
+      count[2] = static_cast<hsize_t>(crop.width);
+    }
+
+    herr_t err = 0;
+    hid_t typeId = H5Dget_type(datasetId);
+    hid_t memTypeId = H5Tget_native_type(typeId, H5T_DIR_ASCEND);
+    hid_t memSpaceId = -1;
+    if(rank >= 3)
+    {
+      err = H5Sselect_hyperslab(fileSpaceId, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr);
+      memSpaceId = H5Screate_simple(rank, count.data(), nullptr);
+      if(err >= 0)
+      {
+        err = H5Dread(datasetId, memTypeId, memSpaceId, fileSpaceId, H5P_DEFAULT, crop.data->getVoidPointer(0));
+      }
+    }
+    else
+    {
+      size_t tupleSize = H5Tget_size(memTypeId) * static_cast<size_t>(crop.data->getNumberOfComponents());
+      err = readFlatCrop(datasetId, memTypeId, crop.sourceDims, tupleSize, crop.x0, crop.y0, crop.width, crop.height, crop.data->getVoidPointer(0));
+    }
+    H5Tclose(memTypeId);
+    H5Tclose(typeId);
+    if(memSpaceId >= 0)
+    {
+      H5Sclose(memSpaceId);
+    }
+    H5Sclose(fileSpaceId);
+    H5Dclose(datasetId);
+
+    if(err < 0)
+    {
+      setErrorCondition(k_ReadError, tr("The region of tile '%1' could not be read.").arg(crop.sourceName));
+      break;
+    }
+  }
+
+  H5Fclose(fileId);
+}
@@ -0,0 +1,155 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vector>
+
+#include <QtCore/QRectF>
+#include <QtCore/QStringList>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataArrays/IDataArray.h"
+#include "SIMPLib/Filtering/AbstractFilter.h"
+
+/**
+ * @brief The IMFReadRegionFilter class reads the part of each DREAM3D montage tile that lies
+ * inside a rectangle instead of the whole tile.  Only the pixels of the rectangle are selected
+ * from each tile's image dataset, so a corner of a montage far larger than memory can be opened
+ * without reading the rest of it.  Preflighting only reads the tile geometries, so the memory
+ * estimate and the geometry only imports work the same as for the DataContainerReader.
+ *
+ * The tiles keep their grid positions but are renamed for the row and column range that
+ * intersects the rectangle, which is the range the registration filter is given.  Tiles in
+ * that range that miss the rectangle are skipped.  Datasets stored with fewer than three
+ * dimensions are read whole and cropped in memory.
+ */
+class IMFReadRegionFilter : public AbstractFilter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(IMFReadRegionFilter)
+
+  /**
+   * @brief Creates a filter that reads the rectangle from each source tile into a data
+   * container with the matching target name
+   * @param filePath
+   * @param amName
+   * @param daName
+   * @param region Rectangle in the units of the tile geometries
+   * @param sourceNames
+   * @param targetNames
+   * @return
+   */
+  static Pointer New(const QString& filePath, const QString& amName, const QString& daName, const QRectF& region, const QStringList& sourceNames, const QStringList& targetNames);
+
+  ~IMFReadRegionFilter() override;
+
+  static const int k_OpenFileError = -89040;
+  static const int k_MissingTileError = -89041;
+  static const int k_UnsupportedTypeError = -89042;
+  static const int k_ReadError = -89043;
+  static const int k_EmptyRegionError = -89044;
+
+  /**
+   * @brief Finds the rows and columns of the montage with tiles that overlap the rectangle and
+   * returns the source and target names of every tile in that range.  Tiles inside the range
+   * that miss the rectangle are read whole so that the registration still sees a full grid.
+   * @param filePath
+   * @param dcPrefix
+   * @param montageStart
+   * @param montageEnd
+   * @param amName
+   * @param region
+   * @param regionStart
+   * @param regionEnd
+   * @param sourceNames
+   * @param targetNames
+   * @return
+   */
+  static int PlanRegion(const QString& filePath, const QString& dcPrefix, const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& amName, const QRectF& region,
+                        IntVec2Type& regionStart, IntVec2Type& regionEnd, QStringList& sourceNames, QStringList& targetNames);
+
+  /**
+   * @brief Returns the rectangle covered by the tiles of the montage, or an empty rectangle if
+   * their geometries could not be read
+   * @param filePath
+   * @param dcPrefix
+   * @param montageStart
+   * @param montageEnd
+   * @param amName
+   * @return
+   */
+  static QRectF MontageBounds(const QString& filePath, const QString& dcPrefix, const IntVec2Type& montageStart, const IntVec2Type& montageEnd, const QString& amName);
+
+  QString getNameOfClass() const override;
+  QString getHumanLabel() const override;
+  void preflight() override;
+  void execute() override;
+
+protected:
+  IMFReadRegionFilter(const QString& filePath, const QString& amName, const QString& daName, const QRectF& region, const QStringList& sourceNames, const QStringList& targetNames);
+
+private:
+  struct TileCrop
+  {
+    QString sourceName;
+    IDataArray::Pointer data;
+    SizeVec3Type sourceDims;
+    size_t x0 = 0;
+    size_t y0 = 0;
+    size_t width = 0;
+    size_t height = 0;
+  };
+
+  QString m_FilePath;
+  QString m_AttributeMatrixName;
+  QString m_DataArrayName;
+  QRectF m_Region;
+  QStringList m_SourceNames;
+  QStringList m_TargetNames;
+  std::vector<TileCrop> m_Crops;
+
+  /**
+   * @brief Creates the cropped tiles in the data container array.  Their arrays are only
+   * allocated outside of preflight.
+   */
+  void dataCheck();
+
+  IMFReadRegionFilter(const IMFReadRegionFilter&); // Copy Constructor Not Implemented
+  void operator=(const IMFReadRegionFilter&);      // Operator '=' Not Implemented
+};
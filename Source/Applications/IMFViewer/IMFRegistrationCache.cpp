@@ -0,0 +1,452 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFRegistrationCache.h"
+
+#include <algorithm>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSaveFile>
+#include <QtCore/QSet>
+#include <QtCore/QStandardPaths>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+const char* IMFRegistrationCache::KeyProperty = "RegistrationCacheKey";
+const char* IMFRegistrationCache::TilePrefixProperty = "RegistrationTilePrefix";
+
+namespace
+{
+// Increment when the stored format or the registration filter output changes
+const int k_CacheVersion = 1;
+
+// Config files up to this size are hashed by content, larger inputs by size and time stamp
+const qint64 k_MaxHashedFileSize = 16 * 1024 * 1024;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void addFileIdentity(QCryptographicHash& hash, const QFileInfo& fi)
+{
+  hash.addData(fi.absoluteFilePath().toUtf8());
+  hash.addData(QByteArray::number(fi.size()));
+  hash.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void addFloatVec3(QCryptographicHash& hash, const FloatVec3Type& value)
+{
+  for(size_t i = 0; i < 3; i++)
+  {
+    hash.addData(QByteArray::number(value[i], 'g', 9));
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Returns the tile image files that the montage reads from the directory of its input file
+// -----------------------------------------------------------------------------
+QFileInfoList referencedTileFiles(const IMFMontagePipelineBuilder::MontageSettings& settings, const QByteArray& inputContents)
+{
+  QFileInfo inputInfo(settings.InputFilePath);
+  QDir inputDir = inputInfo.dir();
+  QFileInfoList tileFiles;
+  switch(settings.Type)
+  {
+  case IMFMontagePipelineBuilder::MontageType::DREAM3D:
+    // The tiles are stored in the input file itself
+    return tileFiles;
+  case IMFMontagePipelineBuilder::MontageType::Robomet:
+  {
+    // Robomet tiles are named by the image prefix and extension rather than by the config file
+    QString imagePrefix = settings.ImagePrefix;
+    if(!imagePrefix.endsWith("_"))
+    {
+      imagePrefix.append("_");
+    }
+    for(const QString& fileName : inputDir.entryList({imagePrefix + "*" + settings.ImageExtension}, QDir::Files, QDir::Name))
+    {
+      tileFiles.push_back(QFileInfo(inputDir, fileName));
+    }
+    return tileFiles;
+  }
+  case IMFMontagePipelineBuilder::MontageType::Fiji:
+  case IMFMontagePipelineBuilder::MontageType::Zeiss:
+  case IMFMontagePipelineBuilder::MontageType::ZeissZen:
+    break;
+  }
+
+  QSet<QString> fileNames;
+  if(settings.Type == IMFMontagePipelineBuilder::MontageType::Fiji)
+  {
+    // Each tile line of a Fiji tile configuration starts with the image file: "<file>; ; (x, y)"
+    for(const QString& line : QString::fromUtf8(inputContents).split('\n', QString::SkipEmptyParts))
+    {
+      QString trimmedLine = line.trimmed();
+      if(!trimmedLine.startsWith('#') && trimmedLine.contains(';'))
+      {
+        fileNames.insert(trimmedLine.section(';', 0, 0).trimmed());
+      }
+    }
+  }
+  else
+  {
+    // Zeiss metadata files name each tile image
+    QRegularExpression fileNameExpression("[^\\s;,<>\"'|]+\\.(tiff?|png|bmp|jpe?g|czi)\\b", QRegularExpression::CaseInsensitiveOption);
+    QRegularExpressionMatchIterator iter = fileNameExpression.globalMatch(QString::fromUtf8(inputContents));
+    while(iter.hasNext())
+    {
+      fileNames.insert(iter.next().captured(0));
+    }
+  }
+
+  // Input files too large to read, or that name no tiles, fall back to every file next to them
+  if(fileNames.isEmpty())
+  {
+    for(const QFileInfo& fi : inputDir.entryInfoList(QDir::Files, QDir::Name))
+    {
+      if(fi != inputInfo)
+      {
+        tileFiles.push_back(fi);
+      }
+    }
+    return tileFiles;
+  }
+
+  QStringList sortedNames = fileNames.toList();
+  sortedNames.sort();
+  for(const QString& fileName : sortedNames)
+  {
+    tileFiles.push_back(QFileInfo(inputDir, fileName));
+  }
+  return tileFiles;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFRegistrationCache::IMFRegistrationCache(const QString& cacheDirectory, QObject* parent)
+: QObject(parent)
+, m_CacheDirectory(cacheDirectory)
+, m_MaxSize(64 * 1024 * 1024)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFRegistrationCache::~IMFRegistrationCache() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFRegistrationCache::DefaultCacheDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/RegistrationCache";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFRegistrationCache::ComputeKey(const IMFMontagePipelineBuilder::MontageSettings& settings, int slice, const QString& dcPrefix, const QString& amName, const QString& daName)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QByteArray::number(k_CacheVersion));
+  hash.addData(QByteArray::number(static_cast<int>(settings.Type)));
+
+  // Pipelined imports place the tiles by normalized cross-correlation, the others by the phase
+  // correlation of PCMTileRegistration, and the two give different tile origins
+  hash.addData(settings.PipelinedImport && settings.Type != IMFMontagePipelineBuilder::MontageType::DREAM3D ? "NCC" : "PCM");
+
+  // The input file identifies the tiles, and the names, sizes and time stamps of the tile
+  // images it refers to are part of the key as well
+  QFileInfo inputInfo(settings.InputFilePath);
+  addFileIdentity(hash, inputInfo);
+  QByteArray inputContents;
+  if(settings.Type != IMFMontagePipelineBuilder::MontageType::DREAM3D && inputInfo.size() <= k_MaxHashedFileSize)
+  {
+    QFile inputFile(settings.InputFilePath);
+    if(inputFile.open(QIODevice::ReadOnly))
+    {
+      inputContents = inputFile.readAll();
+      hash.addData(inputContents);
+    }
+  }
+
+  for(const QFileInfo& fi : referencedTileFiles(settings, inputContents))
+  {
+    addFileIdentity(hash, fi);
+  }
+
+  hash.addData(QByteArray::number(slice));
+  hash.addData(QByteArray::number(settings.MontageStart[0]));
+  hash.addData(QByteArray::number(settings.MontageStart[1]));
+  hash.addData(QByteArray::number(settings.MontageEnd[0]));
+  hash.addData(QByteArray::number(settings.MontageEnd[1]));
+
+  // A region import registers the cropped tiles, which overlap differently than the full tiles
+  if(!settings.Region.isEmpty())
+  {
+    hash.addData(QByteArray::number(settings.Region.x()));
+    hash.addData(QByteArray::number(settings.Region.y()));
+    hash.addData(QByteArray::number(settings.Region.width()));
+    hash.addData(QByteArray::number(settings.Region.height()));
+  }
+
+  hash.addData(QByteArray::number(settings.OverrideSpacing));
+  addFloatVec3(hash, settings.Spacing);
+  hash.addData(QByteArray::number(settings.OverrideOrigin));
+  addFloatVec3(hash, settings.Origin);
+  hash.addData(QByteArray::number(settings.LengthUnit));
+
+  hash.addData(QByteArray::number(settings.ConvertToGrayscale));
+  addFloatVec3(hash, settings.ColorWeighting);
+  hash.addData(settings.ImagePrefix.toUtf8());
+  hash.addData(settings.ImageExtension.toUtf8());
+
+  // Registration filter parameters
+  hash.addData(dcPrefix.toUtf8());
+  hash.addData(amName.toUtf8());
+  hash.addData(daName.toUtf8());
+
+  return QString::fromLatin1(hash.result().toHex());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFRegistrationCache::setEnabled(bool enabled)
+{
+  m_Enabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFRegistrationCache::isEnabled() const
+{
+  return m_Enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFRegistrationCache::setMaxSize(qint64 bytes)
+{
+  m_MaxSize = std::max<qint64>(0, bytes);
+  evict();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFRegistrationCache::getMaxSize() const
+{
+  return m_MaxSize;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFRegistrationCache::getCacheDirectory() const
+{
+  return m_CacheDirectory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFRegistrationCache::lookup(const QString& key, TileOrigins& tileOrigins)
+{
+  if(!m_Enabled)
+  {
+    return false;
+  }
+
+  QFile file(QDir(m_CacheDirectory).filePath(key + ".json"));
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return false;
+  }
+
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+  QJsonObject root = doc.object();
+  if(root["Version"].toInt() != k_CacheVersion)
+  {
+    return false;
+  }
+
+  TileOrigins origins;
+  QJsonObject tilesObj = root["Tiles"].toObject();
+  for(auto iter = tilesObj.constBegin(); iter != tilesObj.constEnd(); iter++)
+  {
+    QJsonArray originArray = iter.value().toArray();
+    if(originArray.size() != 3)
+    {
+      return false;
+    }
+    origins.insert(iter.key(), {static_cast<float>(originArray[0].toDouble()), static_cast<float>(originArray[1].toDouble()), static_cast<float>(originArray[2].toDouble())});
+  }
+
+  if(origins.isEmpty())
+  {
+    return false;
+  }
+
+  // The modification time orders the entries for eviction
+  file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+  tileOrigins = origins;
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFRegistrationCache::store(const QString& key, const TileOrigins& tileOrigins)
+{
+  if(!m_Enabled || tileOrigins.isEmpty())
+  {
+    return;
+  }
+
+  if(!QDir().mkpath(m_CacheDirectory))
+  {
+    return;
+  }
+
+  QJsonObject tilesObj;
+  for(auto iter = tileOrigins.constBegin(); iter != tileOrigins.constEnd(); iter++)
+  {
+    const FloatVec3Type& origin = iter.value();
+    tilesObj[iter.key()] = QJsonArray({origin[0], origin[1], origin[2]});
+  }
+
+  QJsonObject root;
+  root["Version"] = k_CacheVersion;
+  root["Tiles"] = tilesObj;
+
+  // A lookup from another import never sees a partly written entry
+  QSaveFile file(QDir(m_CacheDirectory).filePath(key + ".json"));
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return;
+  }
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  if(!file.commit())
+  {
+    return;
+  }
+
+  evict();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFRegistrationCache::storePipelineResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca)
+{
+  QString key = pipeline->property(KeyProperty).toString();
+  QString tilePrefix = pipeline->property(TilePrefixProperty).toString();
+  if(key.isEmpty() || dca == DataContainerArray::NullPointer())
+  {
+    return;
+  }
+
+  QString montageDCName = IMFMontagePipelineBuilder::MontagePath().getDataContainerName();
+  TileOrigins tileOrigins;
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    if(dc->getName() == montageDCName || !dc->getName().startsWith(tilePrefix))
+    {
+      continue;
+    }
+
+    ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+    if(imageGeom)
+    {
+      tileOrigins.insert(dc->getName(), imageGeom->getOrigin());
+    }
+  }
+
+  store(key, tileOrigins);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFRegistrationCache::clear()
+{
+  QDir cacheDir(m_CacheDirectory);
+  for(const QString& fileName : cacheDir.entryList({"*.json"}, QDir::Files))
+  {
+    cacheDir.remove(fileName);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFRegistrationCache::evict()
+{
+  QDir cacheDir(m_CacheDirectory);
+  QFileInfoList entries = cacheDir.entryInfoList({"*.json"}, QDir::Files, QDir::Time);
+
+  qint64 totalSize = 0;
+  for(const QFileInfo& fi : entries)
+  {
+    totalSize += fi.size();
+  }
+
+  // Entries are sorted newest first, so the least recently used are removed from the back
+  while(totalSize > m_MaxSize && !entries.isEmpty())
+  {
+    QFileInfo fi = entries.takeLast();
+    totalSize -= fi.size();
+    cacheDir.remove(fi.fileName());
+  }
+}
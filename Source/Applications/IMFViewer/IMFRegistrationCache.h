@@ -0,0 +1,163 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <atomic>
+
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+/**
+ * @brief The IMFRegistrationCache class stores the tile origins computed by the tile
+ * registration filter so that importing the same montage again can skip registration.
+ * Each entry is a JSON file named after a hash of the tile files, the tile range and the
+ * registration parameters.  The least recently used entries are removed once the cache
+ * grows past its size limit.
+ */
+class IMFRegistrationCache : public QObject
+{
+  Q_OBJECT
+
+public:
+  using TileOrigins = QMap<QString, FloatVec3Type>;
+
+  IMFRegistrationCache(const QString& cacheDirectory = DefaultCacheDirectory(), QObject* parent = nullptr);
+  ~IMFRegistrationCache() override;
+
+  static const char* KeyProperty;
+  static const char* TilePrefixProperty;
+
+  /**
+   * @brief Returns the directory used when no cache directory is given
+   * @return
+   */
+  static QString DefaultCacheDirectory();
+
+  /**
+   * @brief Returns the cache key for the registration of a montage pipeline.  The key
+   * covers the identity of the input file and the tile images it refers to, the slice,
+   * the tile range, the registration method and every setting that changes the
+   * registration result.  The tile files are read, so the key should not be computed
+   * on the GUI thread.
+   * @param settings
+   * @param slice
+   * @param dcPrefix
+   * @param amName
+   * @param daName
+   * @return
+   */
+  static QString ComputeKey(const IMFMontagePipelineBuilder::MontageSettings& settings, int slice, const QString& dcPrefix, const QString& amName, const QString& daName);
+
+  /**
+   * @brief Sets whether lookups and stores are performed
+   * @param enabled
+   */
+  void setEnabled(bool enabled);
+
+  /**
+   * @brief Returns whether lookups and stores are performed
+   * @return
+   */
+  bool isEnabled() const;
+
+  /**
+   * @brief Sets the maximum size of the cache directory in bytes
+   * @param bytes
+   */
+  void setMaxSize(qint64 bytes);
+
+  /**
+   * @brief Returns the maximum size of the cache directory in bytes
+   * @return
+   */
+  qint64 getMaxSize() const;
+
+  /**
+   * @brief Returns the cache directory
+   * @return
+   */
+  QString getCacheDirectory() const;
+
+  /**
+   * @brief Reads the tile origins stored for the key
+   * @param key
+   * @param tileOrigins
+   * @return false if there is no usable entry for the key
+   */
+  bool lookup(const QString& key, TileOrigins& tileOrigins);
+
+  /**
+   * @brief Stores the tile origins for the key and evicts old entries if the cache is too large
+   * @param key
+   * @param tileOrigins
+   */
+  void store(const QString& key, const TileOrigins& tileOrigins);
+
+  /**
+   * @brief Stores the registered tile origins of an executed pipeline.  Pipelines that
+   * did not run the registration filter are ignored.
+   * @param pipeline
+   * @param dca
+   */
+  void storePipelineResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca);
+
+public slots:
+  /**
+   * @brief Removes every cache entry
+   */
+  void clear();
+
+private:
+  QString m_CacheDirectory;
+  qint64 m_MaxSize = 0;
+  std::atomic_bool m_Enabled{true}; // Read by the pipeline builder on worker threads
+
+  /**
+   * @brief Removes the least recently used entries until the cache fits in its size limit
+   */
+  void evict();
+
+  IMFRegistrationCache(const IMFRegistrationCache&); // Copy Constructor Not Implemented
+  void operator=(const IMFRegistrationCache&);       // Operator '=' Not Implemented
+};
@@ -0,0 +1,140 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#include "IMFScheduledImporter.h"
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFScheduledImporter::IMFScheduledImporter(IMFPipelineScheduler* scheduler, const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca,
+                                           const IMFPipelineScheduler::PostExecuteFunction& postExecute)
+: VSAbstractImporter()
+, m_Scheduler(scheduler)
+, m_Pipeline(pipeline)
+, m_Dca(dca)
+, m_PostExecute(postExecute)
+{
+  connect(scheduler, &IMFPipelineScheduler::pipelineFinished, this, &IMFScheduledImporter::handlePipelineFinished);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFScheduledImporter::~IMFScheduledImporter() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFScheduledImporter::getName()
+{
+  return m_Pipeline->getName();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFScheduledImporter::getPipeline() const
+{
+  return m_Pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFScheduledImporter::execute()
+{
+  if(m_Scheduler.isNull())
+  {
+    setState(State::Canceled);
+    return;
+  }
+
+  setState(State::Executing);
+
+  // The queue may execute its entries from a thread of its own, and the scheduler's queue
+  // belongs to the GUI thread
+  IMFPipelineScheduler* scheduler = m_Scheduler.data();
+  FilterPipeline::Pointer pipeline = m_Pipeline;
+  DataContainerArray::Pointer dca = m_Dca;
+  IMFPipelineScheduler::PostExecuteFunction postExecute = m_PostExecute;
+  QMetaObject::invokeMethod(scheduler, [=] { scheduler->enqueue(pipeline, dca, postExecute); }, Qt::AutoConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFScheduledImporter::cancel()
+{
+  State state = getState();
+  if(state == State::Finished || state == State::Canceled)
+  {
+    return;
+  }
+
+  // An entry that never reached the scheduler is finished here, so whoever waits for its result is not left waiting
+  if(state != State::Executing || m_Scheduler.isNull())
+  {
+    setState(State::Canceled);
+    emit resultReady(m_Pipeline, DataContainerArray::NullPointer(), 0, true);
+    return;
+  }
+
+  // The entry is canceled once the scheduler has stopped the pipeline
+  IMFPipelineScheduler* scheduler = m_Scheduler.data();
+  FilterPipeline::Pointer pipeline = m_Pipeline;
+  QMetaObject::invokeMethod(scheduler, [=] { scheduler->cancel(pipeline); }, Qt::AutoConnection);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFScheduledImporter::reset()
+{
+  setState(State::Ready);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFScheduledImporter::handlePipelineFinished(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled)
+{
+  if(pipeline != m_Pipeline || getState() != State::Executing)
+  {
+    return;
+  }
+
+  setState(canceled ? State::Canceled : State::Finished);
+  emit resultReady(pipeline, dca, err, canceled);
+}
@@ -0,0 +1,130 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+#pragma once
+
+#include <QtCore/QPointer>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+#include "SIMPLVtkLib/QtWidgets/VSAbstractImporter.h"
+
+#include "IMFViewer/IMFPipelineScheduler.h"
+
+/**
+ * @brief The IMFScheduledImporter class is the import queue entry of a pipeline executed by
+ * an IMFPipelineScheduler.  The queue widget starts, orders and cancels the entry like any
+ * other importer, but executing it only hands the pipeline to the scheduler, so the queue
+ * moves on to the next entry while several pipelines execute at the same time.  The entry
+ * stays executing until the scheduler delivers its result.
+ */
+class IMFScheduledImporter : public VSAbstractImporter
+{
+  Q_OBJECT
+
+public:
+  SIMPL_SHARED_POINTERS(IMFScheduledImporter)
+
+  /**
+   * @brief Creates a queue entry for the pipeline.  The arguments are passed on to
+   * IMFPipelineScheduler::enqueue when the queue executes the entry.
+   * @param scheduler
+   * @param pipeline
+   * @param dca
+   * @param postExecute
+   * @return
+   */
+  static Pointer New(IMFPipelineScheduler* scheduler, const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca = DataContainerArray::NullPointer(),
+                     const IMFPipelineScheduler::PostExecuteFunction& postExecute = IMFPipelineScheduler::PostExecuteFunction())
+  {
+    Pointer sharedPtr(new IMFScheduledImporter(scheduler, pipeline, dca, postExecute));
+    return sharedPtr;
+  }
+
+  ~IMFScheduledImporter() override;
+
+  /**
+   * @brief Returns the name of the pipeline
+   * @return
+   */
+  QString getName() override;
+
+  /**
+   * @brief Hands the pipeline to the scheduler.  This returns without waiting for the pipeline.
+   */
+  void execute() override;
+
+  /**
+   * @brief Cancels the pipeline if the scheduler is waiting for it or executing it
+   */
+  void cancel() override;
+
+  /**
+   * @brief Makes the entry ready to be executed again
+   */
+  void reset() override;
+
+  /**
+   * @brief Returns the pipeline of the entry
+   * @return
+   */
+  FilterPipeline::Pointer getPipeline() const;
+
+signals:
+  void resultReady(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled);
+
+protected:
+  IMFScheduledImporter(IMFPipelineScheduler* scheduler, const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const IMFPipelineScheduler::PostExecuteFunction& postExecute);
+
+private slots:
+  /**
+   * @brief Finishes the entry when the scheduler delivers the result of its pipeline
+   * @param pipeline
+   * @param dca
+   * @param err
+   * @param canceled
+   */
+  void handlePipelineFinished(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled);
+
+private:
+  QPointer<IMFPipelineScheduler> m_Scheduler;
+  FilterPipeline::Pointer m_Pipeline;
+  DataContainerArray::Pointer m_Dca;
+  IMFPipelineScheduler::PostExecuteFunction m_PostExecute;
+
+  IMFScheduledImporter(const IMFScheduledImporter&); // Copy Constructor Not Implemented
+  void operator=(const IMFScheduledImporter&);       // Operator '=' Not Implemented
+};
@@ -0,0 +1,463 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFSessionLoader.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QStringList>
+#include <QtCore/QTemporaryFile>
+#include <QtCore/QTimer>
+#include <QtCore/QUuid>
+
+#include "SIMPLib/Utilities/SIMPLH5DataReader.h"
+
+#include "SIMPLVtkLib/Common/MontageUtilities.h"
+#include "SIMPLVtkLib/QtWidgets/VSFilterFactory.h"
+#include "SIMPLVtkLib/Visualization/Controllers/VSController.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSDataSetFilter.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSFileNameFilter.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSSIMPLDataContainerFilter.h"
+
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFTrace.h"
+
+const char* IMFSessionLoader::SessionFileProperty = "SessionFile";
+
+namespace
+{
+// Keys written for each filter by VSController::saveSession
+const QString k_UuidKey = "Uuid";
+const QString k_FilePathKey = "File Path";
+const QString k_DataContainerNameKey = "Data Container Name";
+const QString k_ChildFiltersKey = "Child Filters";
+
+// Keys restored for datasets that are read through the import queue.  The transform is
+// applied with VSAbstractFilter::readTransformJson once the dataset is displayed, and the
+// other keys only identify the data.  Entries with any other key go to the controller.
+const QStringList k_RestoredKeys = {k_UuidKey, "Filter Name", "Tool Tip", "Transform", k_FilePathKey, k_DataContainerNameKey, k_ChildFiltersKey};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QUuid filterUuid(const QJsonObject& entry)
+{
+  return QUuid(entry[k_UuidKey].toString());
+}
+
+// -----------------------------------------------------------------------------
+// Returns the child filter entries.  Only entries without children of their own are
+// returned, and the list is cleared if any child has further filters below it.
+// -----------------------------------------------------------------------------
+QList<QJsonObject> leafChildren(const QJsonObject& entry)
+{
+  QList<QJsonObject> children;
+  QJsonObject childrenObj = entry[k_ChildFiltersKey].toObject();
+  for(QJsonObject::const_iterator iter = childrenObj.constBegin(); iter != childrenObj.constEnd(); iter++)
+  {
+    QJsonObject childObj = iter.value().toObject();
+    if(!childObj[k_ChildFiltersKey].toObject().isEmpty())
+    {
+      return QList<QJsonObject>();
+    }
+    children.push_back(childObj);
+  }
+  return children;
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if every key of the entry and of its children is restored for datasets
+// that are read through the import queue
+// -----------------------------------------------------------------------------
+bool hasRestorableState(const QJsonObject& entry)
+{
+  for(const QString& key : entry.keys())
+  {
+    if(!k_RestoredKeys.contains(key))
+    {
+      return false;
+    }
+  }
+
+  QJsonObject childrenObj = entry[k_ChildFiltersKey].toObject();
+  for(QJsonObject::const_iterator iter = childrenObj.constBegin(); iter != childrenObj.constEnd(); iter++)
+  {
+    if(!hasRestorableState(iter.value().toObject()))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void readTransform(VSAbstractFilter* filter, const QJsonObject& entry)
+{
+  if(filter != nullptr && entry.contains("Transform"))
+  {
+    QJsonObject filterObj = entry;
+    filter->readTransformJson(filterObj);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Returns true if the entry is a file whose only child is the dataset read from it, which
+// can be imported through the import queue as if the file had been opened again
+// -----------------------------------------------------------------------------
+bool isPlainFileEntry(const QJsonObject& entry)
+{
+  if(filterUuid(entry) != VSFileNameFilter::GetUuid())
+  {
+    return false;
+  }
+
+  QList<QJsonObject> children = leafChildren(entry);
+  return children.size() == 1 && filterUuid(children.front()) == VSDataSetFilter::GetUuid();
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFSessionLoader::IMFSessionLoader(VSController* controller, QObject* parent)
+: QObject(parent)
+, m_Controller(controller)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFSessionLoader::~IMFSessionLoader() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFSessionLoader::IsSessionPipeline(const FilterPipeline::Pointer& pipeline)
+{
+  return !pipeline->property(SessionFileProperty).toString().isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFSessionLoader::ReadSessionFile(const QString& filePath, QJsonObject& sessionObj, QString& errorMessage)
+{
+  QFile inputFile(filePath);
+  if(!inputFile.open(QIODevice::ReadOnly))
+  {
+    errorMessage = tr("The session file '%1' could not be opened.").arg(filePath);
+    return k_OpenFileError;
+  }
+
+  QJsonParseError parseError;
+  QJsonDocument doc = QJsonDocument::fromJson(inputFile.readAll(), &parseError);
+  if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+  {
+    errorMessage = tr("The session file '%1' could not be parsed: %2.").arg(filePath, parseError.errorString());
+    return k_ParseError;
+  }
+
+  sessionObj = doc.object();
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+FilterPipeline::Pointer IMFSessionLoader::CreateReaderPipeline(const QString& name, const QJsonObject& entry)
+{
+  if(filterUuid(entry) != VSFileNameFilter::GetUuid())
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  QString filePath = entry[k_FilePathKey].toString();
+  if(QFileInfo(filePath).suffix() != "dream3d")
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  QList<QJsonObject> children = leafChildren(entry);
+  QStringList dcNames;
+  for(const QJsonObject& childObj : children)
+  {
+    QString dcName = childObj[k_DataContainerNameKey].toString();
+    if(filterUuid(childObj) != VSSIMPLDataContainerFilter::GetUuid() || dcName.isEmpty())
+    {
+      return FilterPipeline::NullPointer();
+    }
+    dcNames.push_back(dcName);
+  }
+  if(dcNames.isEmpty())
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  SIMPLH5DataReader reader;
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  DataContainerArrayProxy proxy = MontageUtilities::CreateMontageProxy(reader, filePath, dcNames);
+  hdf5Locker.unlock();
+  if(proxy == DataContainerArrayProxy())
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
+  AbstractFilter::Pointer dataContainerReader = filterFactory->createDataContainerReaderFilter(filePath, proxy);
+  if(!dataContainerReader)
+  {
+    return FilterPipeline::NullPointer();
+  }
+
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(name);
+  pipeline->pushBack(dataContainerReader);
+  pipeline->setProperty(SessionFileProperty, filePath);
+  return pipeline;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFSessionLoader::loadSession(const QString& filePath)
+{
+  IMFTraceSpan parseSpan(tr("Parse Session"), IMFTrace::ImportCategory);
+  parseSpan.setArg("File", filePath);
+
+  QJsonObject rootObj;
+  QString errorMessage;
+  int err = ReadSessionFile(filePath, rootObj, errorMessage);
+  if(err < 0)
+  {
+    emit notifyErrorMessage(tr("Load Session"), errorMessage, err);
+    return err;
+  }
+
+  m_DatasetCount += rootObj.size();
+
+  // Everything that can be read in the background is queued first, so the first dataset
+  // is displayed as soon as it has been read no matter where it appears in the session.
+  // Its transform is restored once it is displayed.
+  for(QJsonObject::const_iterator iter = rootObj.constBegin(); iter != rootObj.constEnd(); iter++)
+  {
+    QJsonObject entry = iter.value().toObject();
+    FilterPipeline::Pointer pipeline = hasRestorableState(entry) ? CreateReaderPipeline(iter.key(), entry) : FilterPipeline::NullPointer();
+    if(pipeline)
+    {
+      m_QueuedEntries[iter.key()] = entry;
+      emit pipelineRequested(pipeline);
+    }
+    else if(hasRestorableState(entry) && isPlainFileEntry(entry) && QFileInfo::exists(entry[k_FilePathKey].toString()))
+    {
+      m_QueuedEntries[iter.key()] = entry;
+      emit importRequested(iter.key(), entry[k_FilePathKey].toString());
+    }
+    else
+    {
+      m_PendingEntries.push_back(QJsonObject{{iter.key(), entry}});
+    }
+  }
+
+  if(!m_PendingEntries.isEmpty())
+  {
+    QTimer::singleShot(0, this, &IMFSessionLoader::restoreNextEntry);
+  }
+
+  return rootObj.size();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFSessionLoader::addDataset(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err)
+{
+  if(err < 0)
+  {
+    QString filePath = pipeline->property(SessionFileProperty).toString();
+    emit notifyErrorMessage(tr("Load Session"), tr("The dataset '%1' could not be read from '%2' (error code %3).").arg(pipeline->getName(), filePath).arg(err), err);
+  }
+  else
+  {
+    emit datasetLoaded(pipeline, dca);
+    restoreDisplayedState(pipeline->getName(), dca);
+  }
+
+  m_QueuedEntries.remove(pipeline->getName());
+  datasetRestored();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFSessionLoader::addImportedDataset(const QString& name, VSFileNameFilter* textFilter, VSDataSetFilter* filter)
+{
+  QJsonObject entry = m_QueuedEntries.take(name);
+  if(filter->getOutput() == nullptr)
+  {
+    emit notifyErrorMessage(tr("Load Session"), tr("The dataset '%1' could not be read from '%2'.").arg(name, entry[k_FilePathKey].toString()), k_ImportError);
+  }
+  else
+  {
+    readTransform(textFilter, entry);
+    QList<QJsonObject> children = leafChildren(entry);
+    if(!children.isEmpty())
+    {
+      readTransform(filter, children.front());
+    }
+  }
+
+  datasetRestored();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFSessionLoader::restoreDisplayedState(const QString& name, const DataContainerArray::Pointer& dca)
+{
+  QJsonObject entry = m_QueuedEntries.value(name);
+  if(entry.isEmpty())
+  {
+    return;
+  }
+
+  // The dataset was added last, so its filters are found from the end of the base filters
+  VSAbstractFilter::FilterListType baseFilters = m_Controller->getBaseFilters();
+  for(auto baseIter = baseFilters.rbegin(); baseIter != baseFilters.rend(); baseIter++)
+  {
+    bool isDataset = false;
+    for(VSAbstractFilter* childFilter : (*baseIter)->getChildren())
+    {
+      VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(childFilter);
+      DataContainer::Pointer dc = dcFilter != nullptr ? dcFilter->getWrappedDataContainer()->m_DataContainer : DataContainer::NullPointer();
+      if(!dc || dca->getDataContainer(dc->getName()) != dc)
+      {
+        continue;
+      }
+
+      isDataset = true;
+      for(const QJsonObject& childObj : leafChildren(entry))
+      {
+        if(childObj[k_DataContainerNameKey].toString() == dc->getName())
+        {
+          readTransform(dcFilter, childObj);
+        }
+      }
+    }
+
+    if(isDataset)
+    {
+      readTransform(*baseIter, entry);
+      return;
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFSessionLoader::cancelDataset(const FilterPipeline::Pointer& pipeline)
+{
+  emit notifyStatusMessage(tr("The dataset '%1' of the session was not loaded").arg(pipeline->getName()));
+  m_QueuedEntries.remove(pipeline->getName());
+  datasetRestored();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFSessionLoader::restoreNextEntry()
+{
+  if(m_PendingEntries.isEmpty())
+  {
+    return;
+  }
+
+  QJsonObject sessionObj = m_PendingEntries.takeFirst();
+  QString name = sessionObj.keys().front();
+
+  // The controller only restores whole session files, so each entry is written to a session of its own
+  QTemporaryFile sessionFile;
+  if(sessionFile.open())
+  {
+    IMFTraceSpan restoreSpan(tr("Restore Session Entry"), IMFTrace::ImportCategory);
+    restoreSpan.setArg("Name", name);
+
+    sessionFile.write(QJsonDocument(sessionObj).toJson(QJsonDocument::Compact));
+    sessionFile.close();
+
+    // The controller reads the entry's data files on the GUI thread, while queued pipelines
+    // may be reading or writing HDF5 files on workers
+    QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+    bool restored = m_Controller->loadSession(sessionFile.fileName());
+    hdf5Locker.unlock();
+    if(!restored)
+    {
+      emit notifyErrorMessage(tr("Load Session"), tr("The dataset '%1' could not be restored.").arg(name), k_ParseError);
+    }
+  }
+  else
+  {
+    emit notifyErrorMessage(tr("Load Session"), tr("The dataset '%1' could not be restored because a temporary file could not be created.").arg(name), k_OpenFileError);
+  }
+
+  datasetRestored();
+
+  if(!m_PendingEntries.isEmpty())
+  {
+    QTimer::singleShot(0, this, &IMFSessionLoader::restoreNextEntry);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFSessionLoader::datasetRestored()
+{
+  m_RestoredCount++;
+  if(m_RestoredCount < m_DatasetCount)
+  {
+    emit notifyStatusMessage(tr("Restored %1 of %2 session datasets").arg(m_RestoredCount).arg(m_DatasetCount));
+    return;
+  }
+
+  emit notifyStatusMessage(tr("Restored %1 session datasets").arg(m_DatasetCount));
+  m_DatasetCount = 0;
+  m_RestoredCount = 0;
+}
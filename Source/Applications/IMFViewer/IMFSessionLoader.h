@@ -0,0 +1,169 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+class VSController;
+class VSDataSetFilter;
+class VSFileNameFilter;
+
+/**
+ * @brief The IMFSessionLoader class restores a saved session without blocking the window.
+ * Every dataset of the session that is displayed without further filters is read through the
+ * import queue and added to the view as soon as it is ready, so the first dataset can be used
+ * while the rest are still loading.  Datasets with clips, slices or other filters below them
+ * are restored by the controller one at a time between events, so the window still responds
+ * between them.  So are entries that hold any state other than their data and transform,
+ * and a dataset read through the import queue gets its saved transform once it is displayed.
+ */
+class IMFSessionLoader : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFSessionLoader(VSController* controller, QObject* parent = nullptr);
+  ~IMFSessionLoader() override;
+
+  // Path of the DREAM3D file a session pipeline reads
+  static const char* SessionFileProperty;
+
+  static const int k_OpenFileError = -89050;
+  static const int k_ParseError = -89051;
+  static const int k_ImportError = -89052;
+
+  /**
+   * @brief Returns true if the pipeline reads a DREAM3D dataset of a session
+   * @param pipeline
+   * @return
+   */
+  static bool IsSessionPipeline(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Reads the entries of a session file
+   * @param filePath
+   * @param sessionObj
+   * @param errorMessage
+   * @return 0 or a negative error code
+   */
+  static int ReadSessionFile(const QString& filePath, QJsonObject& sessionObj, QString& errorMessage);
+
+  /**
+   * @brief Creates a pipeline that reads the data containers of a session entry, or a null
+   * pointer if the entry can not be read in the background
+   * @param name
+   * @param entry
+   * @return
+   */
+  static FilterPipeline::Pointer CreateReaderPipeline(const QString& name, const QJsonObject& entry);
+
+  /**
+   * @brief Starts restoring the session file.  The datasets that can be read in the background
+   * are requested through importRequested and pipelineRequested before this returns.
+   * @param filePath
+   * @return The number of datasets in the session, or a negative error code
+   */
+  int loadSession(const QString& filePath);
+
+  /**
+   * @brief Hands the data containers read by a session pipeline on to datasetLoaded, restores
+   * the saved transforms of the displayed filters and reports the progress of the session
+   * @param pipeline
+   * @param dca
+   * @param err
+   */
+  void addDataset(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err);
+
+  /**
+   * @brief Restores the saved transforms of a file requested through importRequested once its
+   * filters have been added to the view, and reports the progress of the session
+   * @param name
+   * @param textFilter
+   * @param filter
+   */
+  void addImportedDataset(const QString& name, VSFileNameFilter* textFilter, VSDataSetFilter* filter);
+
+  /**
+   * @brief Counts the dataset of a canceled session pipeline without reporting an error
+   * @param pipeline
+   */
+  void cancelDataset(const FilterPipeline::Pointer& pipeline);
+
+signals:
+  void importRequested(const QString& name, const QString& filePath);
+  void pipelineRequested(const FilterPipeline::Pointer& pipeline);
+  void datasetLoaded(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca);
+  void notifyErrorMessage(const QString& title, const QString& msg, int code);
+  void notifyStatusMessage(const QString& msg);
+
+private:
+  VSController* m_Controller = nullptr;
+  QList<QJsonObject> m_PendingEntries;
+
+  // Entries read through the import queue, by name, until they are displayed
+  QMap<QString, QJsonObject> m_QueuedEntries;
+  int m_DatasetCount = 0;
+  int m_RestoredCount = 0;
+
+  /**
+   * @brief Counts a restored dataset and reports the progress of the session
+   */
+  void datasetRestored();
+
+  /**
+   * @brief Restores the saved transforms of the filters that display the data containers of
+   * a session pipeline
+   * @param name
+   * @param dca
+   */
+  void restoreDisplayedState(const QString& name, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief Restores the next entry that needs the controller and schedules the one after it
+   */
+  void restoreNextEntry();
+
+  IMFSessionLoader(const IMFSessionLoader&); // Copy Constructor Not Implemented
+  void operator=(const IMFSessionLoader&);   // Operator '=' Not Implemented
+};
@@ -0,0 +1,945 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFStreamingStitcher.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <hdf5.h>
+
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
+#include <QtCore/QMutex>
+
+#include "SIMPLib/Common/Constants.h"
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFDream3dWriter.h"
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+const char* IMFStreamingStitcher::OutputFileProperty = "StreamingStitchOutputFile";
+const char* IMFStreamingStitcher::TilePrefixProperty = "StreamingStitchTilePrefix";
+const char* IMFStreamingStitcher::AttributeMatrixNameProperty = "StreamingStitchAttributeMatrixName";
+const char* IMFStreamingStitcher::DataArrayNameProperty = "StreamingStitchDataArrayName";
+
+namespace
+{
+// Edge length of the square chunks the stitched array is stored in
+const hsize_t k_ChunkSize = 256;
+
+// Pyramid levels are added until both edges of the coarsest level are at most this long
+const size_t k_MinPyramidSize = 1024;
+
+struct TilePlacement
+{
+  DataContainer::Pointer dc;
+  IDataArray::Pointer data;
+  SizeVec3Type dims;
+  size_t xOffset = 0;
+  size_t yOffset = 0;
+};
+
+template <typename T>
+hid_t nativeType();
+
+template <>
+hid_t nativeType<uint8_t>()
+{
+  return H5T_NATIVE_UINT8;
+}
+
+template <>
+hid_t nativeType<uint16_t>()
+{
+  return H5T_NATIVE_UINT16;
+}
+
+template <>
+hid_t nativeType<uint32_t>()
+{
+  return H5T_NATIVE_UINT32;
+}
+
+template <>
+hid_t nativeType<float>()
+{
+  return H5T_NATIVE_FLOAT;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t writeStringAttribute(hid_t objectId, const QString& name, const QString& value)
+{
+  QByteArray bytes = value.toLatin1();
+  hid_t typeId = H5Tcopy(H5T_C_S1);
+  H5Tset_size(typeId, static_cast<size_t>(bytes.size() + 1));
+  H5Tset_strpad(typeId, H5T_STR_NULLTERM);
+  hid_t spaceId = H5Screate(H5S_SCALAR);
+  hid_t attrId = H5Acreate(objectId, name.toLatin1().constData(), typeId, spaceId, H5P_DEFAULT, H5P_DEFAULT);
+  herr_t err = H5Awrite(attrId, typeId, bytes.constData());
+  H5Aclose(attrId);
+  H5Sclose(spaceId);
+  H5Tclose(typeId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+herr_t writeVectorAttribute(hid_t objectId, const QString& name, hid_t typeId, const std::vector<T>& values)
+{
+  hsize_t dims[1] = {static_cast<hsize_t>(values.size())};
+  hid_t spaceId = H5Screate_simple(1, dims, nullptr);
+  hid_t attrId = H5Acreate(objectId, name.toLatin1().constData(), typeId, spaceId, H5P_DEFAULT, H5P_DEFAULT);
+  herr_t err = H5Awrite(attrId, typeId, values.data());
+  H5Aclose(attrId);
+  H5Sclose(spaceId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+herr_t transferRows(hid_t datasetId, hid_t typeId, size_t y0, size_t rows, size_t width, size_t numComps, void* buffer, bool write)
+{
+  hsize_t start[4] = {0, static_cast<hsize_t>(y0), 0, 0};
+  hsize_t count[4] = {1, static_cast<hsize_t>(rows), static_cast<hsize_t>(width), static_cast<hsize_t>(numComps)};
+  hid_t fileSpaceId = H5Dget_space(datasetId);
+  H5Sselect_hyperslab(fileSpaceId, H5S_SELECT_SET, start, nullptr, count, nullptr);
+  hid_t memSpaceId = H5Screate_simple(4, count, nullptr);
+  herr_t err = write ? H5Dwrite(datasetId, typeId, memSpaceId, fileSpaceId, H5P_DEFAULT, buffer) : H5Dread(datasetId, typeId, memSpaceId, fileSpaceId, H5P_DEFAULT, buffer);
+  H5Sclose(memSpaceId);
+  H5Sclose(fileSpaceId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+hid_t createMontageDataset(hid_t dcaGroupId, const DataArrayPath& montagePath, const QString& dcName, size_t width, size_t height, const FloatVec3Type& spacing, const FloatVec3Type& origin,
+                           hid_t typeId, size_t numComps, const QString& objectType)
+{
+  hid_t dcGroupId = H5Gcreate(dcaGroupId, dcName.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  if(dcGroupId < 0)
+  {
+    return -1;
+  }
+
+  // The geometry is small, so SIMPL writes it
+  DataContainer::Pointer montageDC = DataContainer::New(dcName);
+  ImageGeom::Pointer montageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+  montageGeom->setDimensions(SizeVec3Type(width, height, 1));
+  montageGeom->setSpacing(spacing);
+  montageGeom->setOrigin(origin);
+  montageDC->setGeometry(montageGeom);
+  int err = montageDC->writeMeshToHDF5(dcGroupId, false);
+
+  hid_t amGroupId = H5Gcreate(dcGroupId, montagePath.getAttributeMatrixName().toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  std::vector<uint64_t> tupleDims = {static_cast<uint64_t>(width), static_cast<uint64_t>(height), 1};
+  std::vector<uint32_t> amType = {static_cast<uint32_t>(AttributeMatrix::Type::Cell)};
+  writeVectorAttribute(amGroupId, SIMPL::StringConstants::AttributeMatrixType, H5T_NATIVE_UINT32, amType);
+  writeVectorAttribute(amGroupId, SIMPL::HDF5::TupleDimensions, H5T_NATIVE_UINT64, tupleDims);
+
+  hsize_t dims[4] = {1, static_cast<hsize_t>(height), static_cast<hsize_t>(width), static_cast<hsize_t>(numComps)};
+  hsize_t chunkDims[4] = {1, std::min(dims[1], k_ChunkSize), std::min(dims[2], k_ChunkSize), dims[3]};
+  hid_t spaceId = H5Screate_simple(4, dims, nullptr);
+  hid_t plistId = H5Pcreate(H5P_DATASET_CREATE);
+  H5Pset_chunk(plistId, 4, chunkDims);
+  hid_t datasetId = H5Dcreate(amGroupId, montagePath.getDataArrayName().toLatin1().constData(), typeId, spaceId, H5P_DEFAULT, plistId, H5P_DEFAULT);
+  H5Pclose(plistId);
+  H5Sclose(spaceId);
+
+  if(datasetId >= 0)
+  {
+    std::vector<uint64_t> compDims = {static_cast<uint64_t>(numComps)};
+    std::vector<int32_t> arrayVersion = {2};
+    writeVectorAttribute(datasetId, SIMPL::HDF5::ComponentDimensions, H5T_NATIVE_UINT64, compDims);
+    writeVectorAttribute(datasetId, SIMPL::HDF5::DataArrayVersion, H5T_NATIVE_INT32, arrayVersion);
+    writeStringAttribute(datasetId, SIMPL::HDF5::ObjectType, objectType);
+    writeVectorAttribute(datasetId, SIMPL::HDF5::TupleDimensions, H5T_NATIVE_UINT64, tupleDims);
+  }
+
+  H5Gclose(amGroupId);
+  H5Gclose(dcGroupId);
+
+  if(err < 0 && datasetId >= 0)
+  {
+    H5Dclose(datasetId);
+    return -1;
+  }
+  return datasetId;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+// -----------------------------------------------------------------------------
+// Reads the pixels of a tile that was collected with its geometry only
+// -----------------------------------------------------------------------------
+int loadTile(TilePlacement& tile, const QString& amName, const QString& daName, const IDataArray::Pointer& firstData, const IMFStreamingStitcher::TileReadFunction& readTile)
+{
+  int err = readTile(tile.dc);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  AttributeMatrix::Pointer am = tile.dc->getAttributeMatrix(amName);
+  tile.data = am ? am->getAttributeArray(daName) : IDataArray::NullPointer();
+  if(!tile.data || tile.data->getNumberOfTuples() < tile.dims[0] * tile.dims[1])
+  {
+    tile.data.reset();
+    return IMFStreamingStitcher::k_TileReadError;
+  }
+  if(firstData && (tile.data->getTypeAsString() != firstData->getTypeAsString() || tile.data->getNumberOfComponents() != firstData->getNumberOfComponents()))
+  {
+    return IMFStreamingStitcher::k_MixedTileTypesError;
+  }
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T, typename StripWriter>
+int compositeStrips(std::vector<TilePlacement>& tiles, const QString& amName, const QString& daName, size_t width, size_t height, size_t numComps, bool releaseTiles,
+                    const IMFStreamingStitcher::TileReadFunction& readTile, StripWriter writeStrip)
+{
+  IDataArray::Pointer firstData;
+  for(const TilePlacement& tile : tiles)
+  {
+    if(tile.data)
+    {
+      firstData = tile.data;
+      break;
+    }
+  }
+
+  size_t stripHeight = 1;
+  for(const TilePlacement& tile : tiles)
+  {
+    stripHeight = std::max(stripHeight, tile.dims[1]);
+  }
+
+  std::vector<T> strip;
+  for(size_t y0 = 0; y0 < height; y0 += stripHeight)
+  {
+    size_t rows = std::min(stripHeight, height - y0);
+    strip.assign(rows * width * numComps, T(0));
+
+    for(TilePlacement& tile : tiles)
+    {
+      if(tile.yOffset >= y0 + rows || tile.yOffset + tile.dims[1] <= y0)
+      {
+        continue;
+      }
+
+      // Tiles collected without pixels are read when the first strip that overlaps them is composited
+      if(!tile.data && readTile)
+      {
+        int err = loadTile(tile, amName, daName, firstData, readTile);
+        if(err < 0)
+        {
+          return err;
+        }
+      }
+      if(!tile.data)
+      {
+        continue;
+      }
+
+      typename DataArray<T>::Pointer tileArray = std::dynamic_pointer_cast<DataArray<T>>(tile.data);
+      if(!tileArray)
+      {
+        return IMFStreamingStitcher::k_MixedTileTypesError;
+      }
+      const T* src = tileArray->getPointer(0);
+      size_t rowStart = std::max(y0, tile.yOffset);
+      size_t rowEnd = std::min(y0 + rows, tile.yOffset + tile.dims[1]);
+      size_t copyWidth = std::min(tile.dims[0], width - tile.xOffset);
+      for(size_t y = rowStart; y < rowEnd; y++)
+      {
+        const T* srcRow = src + (y - tile.yOffset) * tile.dims[0] * numComps;
+        T* dstRow = strip.data() + ((y - y0) * width + tile.xOffset) * numComps;
+        std::copy(srcRow, srcRow + copyWidth * numComps, dstRow);
+      }
+    }
+
+    int err = writeStrip(y0, rows, strip.data());
+    if(err < 0)
+    {
+      return err;
+    }
+
+    // Tiles that end inside this strip are not needed again
+    for(TilePlacement& tile : tiles)
+    {
+      if(releaseTiles && tile.data && tile.yOffset + tile.dims[1] <= y0 + rows)
+      {
+        tile.data.reset();
+        tile.dc->removeAttributeMatrix(amName);
+      }
+    }
+  }
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+int writeStrips(hid_t datasetId, std::vector<TilePlacement>& tiles, const QString& amName, const QString& daName, size_t width, size_t height, size_t numComps,
+                const IMFStreamingStitcher::TileReadFunction& readTile)
+{
+  return compositeStrips<T>(tiles, amName, daName, width, height, numComps, true, readTile, [=](size_t y0, size_t rows, T* strip) {
+    QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+    return transferRows(datasetId, nativeType<T>(), y0, rows, width, numComps, strip, true) < 0 ? IMFStreamingStitcher::k_WriteError : 0;
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+IDataArray::Pointer stitchInMemory(std::vector<TilePlacement>& tiles, const QString& amName, size_t width, size_t height, size_t numComps, bool releaseTiles, const QString& daName, int& err)
+{
+  // The buffer is not initialized, so its pages only become resident as strips are copied in
+  size_t numTuples = width * height;
+  T* buffer = new(std::nothrow) T[numTuples * numComps];
+  if(buffer == nullptr)
+  {
+    err = IMFStreamingStitcher::k_AllocationError;
+    return IDataArray::NullPointer();
+  }
+
+  typename DataArray<T>::Pointer montageArray = DataArray<T>::WrapPointer(buffer, numTuples, std::vector<size_t>(1, numComps), daName, true);
+  err = compositeStrips<T>(tiles, amName, QString(), width, height, numComps, releaseTiles, IMFStreamingStitcher::TileReadFunction(), [=](size_t y0, size_t rows, T* strip) {
+    std::copy(strip, strip + rows * width * numComps, buffer + y0 * width * numComps);
+    return 0;
+  });
+  return montageArray;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+void compositeRegions(const std::vector<TilePlacement>& tiles, const IDataArray::Pointer& montageData, size_t width, size_t height, size_t numComps, const std::vector<QRect>& regions)
+{
+  T* dst = std::dynamic_pointer_cast<DataArray<T>>(montageData)->getPointer(0);
+  for(const QRect& region : regions)
+  {
+    size_t x0 = static_cast<size_t>(std::max(region.left(), 0));
+    size_t y0 = static_cast<size_t>(std::max(region.top(), 0));
+    size_t x1 = std::min(static_cast<size_t>(std::max(region.right() + 1, 0)), width);
+    size_t y1 = std::min(static_cast<size_t>(std::max(region.bottom() + 1, 0)), height);
+    if(x0 >= x1 || y0 >= y1)
+    {
+      continue;
+    }
+
+    for(size_t y = y0; y < y1; y++)
+    {
+      std::fill(dst + (y * width + x0) * numComps, dst + (y * width + x1) * numComps, T(0));
+    }
+
+    // Later tiles cover earlier ones, as in compositeStrips
+    for(const TilePlacement& tile : tiles)
+    {
+      size_t tileX0 = std::max(x0, tile.xOffset);
+      size_t tileX1 = std::min(x1, tile.xOffset + tile.dims[0]);
+      size_t tileY0 = std::max(y0, tile.yOffset);
+      size_t tileY1 = std::min(y1, tile.yOffset + tile.dims[1]);
+      if(tileX0 >= tileX1 || tileY0 >= tileY1)
+      {
+        continue;
+      }
+
+      typename DataArray<T>::Pointer tileArray = std::dynamic_pointer_cast<DataArray<T>>(tile.data);
+      const T* src = tileArray->getPointer(0);
+      for(size_t y = tileY0; y < tileY1; y++)
+      {
+        const T* srcRow = src + ((y - tile.yOffset) * tile.dims[0] + (tileX0 - tile.xOffset)) * numComps;
+        std::copy(srcRow, srcRow + (tileX1 - tileX0) * numComps, dst + (y * width + tileX0) * numComps);
+      }
+    }
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int collectTiles(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, bool readLater, std::vector<TilePlacement>& tiles, size_t& width,
+                 size_t& height, FloatVec3Type& spacing, FloatVec3Type& origin)
+{
+  FloatVec3Type minOrigin = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0.0f};
+  spacing = {1.0f, 1.0f, 1.0f};
+  for(const DataContainer::Pointer& dc : dca->getDataContainers())
+  {
+    ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+    if(!dc->getName().startsWith(tilePrefix) || !imageGeom)
+    {
+      continue;
+    }
+
+    // Tiles without pixels are only collected when they can be read later
+    AttributeMatrix::Pointer am = dc->getAttributeMatrix(amName);
+    IDataArray::Pointer data = am ? am->getAttributeArray(daName) : IDataArray::NullPointer();
+    if(!data && !readLater)
+    {
+      continue;
+    }
+
+    if(tiles.empty())
+    {
+      spacing = imageGeom->getSpacing();
+    }
+
+    TilePlacement tile;
+    tile.dc = dc;
+    tile.data = data;
+    tile.dims = imageGeom->getDimensions();
+    tiles.push_back(tile);
+
+    FloatVec3Type tileOrigin = imageGeom->getOrigin();
+    minOrigin[0] = std::min(minOrigin[0], tileOrigin[0]);
+    minOrigin[1] = std::min(minOrigin[1], tileOrigin[1]);
+  }
+
+  if(tiles.empty())
+  {
+    return IMFStreamingStitcher::k_NoTilesError;
+  }
+
+  // Place every tile on the pixel grid of the montage
+  width = 0;
+  height = 0;
+  for(TilePlacement& tile : tiles)
+  {
+    FloatVec3Type tileOrigin = tile.dc->getGeometryAs<ImageGeom>()->getOrigin();
+    tile.xOffset = static_cast<size_t>(std::lround((tileOrigin[0] - minOrigin[0]) / spacing[0]));
+    tile.yOffset = static_cast<size_t>(std::lround((tileOrigin[1] - minOrigin[1]) / spacing[1]));
+    width = std::max(width, tile.xOffset + tile.dims[0]);
+    height = std::max(height, tile.yOffset + tile.dims[1]);
+  }
+  origin = {minOrigin[0], minOrigin[1], 0.0f};
+
+  IDataArray::Pointer firstData;
+  for(const TilePlacement& tile : tiles)
+  {
+    if(!tile.data)
+    {
+      continue;
+    }
+    if(!firstData)
+    {
+      firstData = tile.data;
+    }
+    if(tile.data->getTypeAsString() != firstData->getTypeAsString() || tile.data->getNumberOfComponents() != firstData->getNumberOfComponents())
+    {
+      return IMFStreamingStitcher::k_MixedTileTypesError;
+    }
+  }
+
+  // Rows are composited top to bottom so that tile rows can be released in order.  Tiles in
+  // the same row keep their order so that overlaps always resolve the same way.
+  std::stable_sort(tiles.begin(), tiles.end(), [](const TilePlacement& a, const TilePlacement& b) { return a.yOffset < b.yOffset; });
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+template <typename T>
+int writeDownsampledLevel(hid_t srcDatasetId, size_t srcWidth, size_t srcHeight, hid_t dstDatasetId, size_t dstWidth, size_t dstHeight, size_t numComps)
+{
+  std::vector<T> src;
+  std::vector<T> dst;
+  for(size_t dy0 = 0; dy0 < dstHeight; dy0 += k_ChunkSize)
+  {
+    size_t rows = std::min(static_cast<size_t>(k_ChunkSize), dstHeight - dy0);
+    size_t sy0 = dy0 * 2;
+    size_t srcRows = std::min(rows * 2, srcHeight - sy0);
+    src.resize(srcRows * srcWidth * numComps);
+    {
+      QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+      if(transferRows(srcDatasetId, nativeType<T>(), sy0, srcRows, srcWidth, numComps, src.data(), false) < 0)
+      {
+        return IMFStreamingStitcher::k_WriteError;
+      }
+    }
+
+    // Average each 2x2 block of the finer level
+    dst.resize(rows * dstWidth * numComps);
+    for(size_t y = 0; y < rows; y++)
+    {
+      size_t sy = y * 2;
+      size_t ny = std::min(static_cast<size_t>(2), srcRows - sy);
+      for(size_t x = 0; x < dstWidth; x++)
+      {
+        size_t sx = x * 2;
+        size_t nx = std::min(static_cast<size_t>(2), srcWidth - sx);
+        for(size_t c = 0; c < numComps; c++)
+        {
+          double sum = 0.0;
+          for(size_t j = 0; j < ny; j++)
+          {
+            for(size_t i = 0; i < nx; i++)
+            {
+              sum += static_cast<double>(src[((sy + j) * srcWidth + sx + i) * numComps + c]);
+            }
+          }
+          double average = sum / static_cast<double>(nx * ny);
+          dst[(y * dstWidth + x) * numComps + c] = static_cast<T>(std::is_integral<T>::value ? std::round(average) : average);
+        }
+      }
+    }
+
+    QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+    if(transferRows(dstDatasetId, nativeType<T>(), dy0, rows, dstWidth, numComps, dst.data(), true) < 0)
+    {
+      return IMFStreamingStitcher::k_WriteError;
+    }
+  }
+
+  return 0;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFStreamingStitcher::IsStreamingPipeline(const FilterPipeline::Pointer& pipeline)
+{
+  return !pipeline->property(OutputFileProperty).toString().isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFStreamingStitcher::IsStitchingPipeline(const FilterPipeline::Pointer& pipeline)
+{
+  return !pipeline->property(TilePrefixProperty).toString().isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFStreamingStitcher::ExecutePipeline(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca)
+{
+  QString outputFilePath = pipeline->property(OutputFileProperty).toString();
+  QString tilePrefix = pipeline->property(TilePrefixProperty).toString();
+  QString amName = pipeline->property(AttributeMatrixNameProperty).toString();
+  QString daName = pipeline->property(DataArrayNameProperty).toString();
+  if(outputFilePath.isEmpty())
+  {
+    return StitchTilesInMemory(dca, tilePrefix, amName, daName, IMFMontagePipelineBuilder::MontagePath());
+  }
+  return StitchTiles(dca, tilePrefix, amName, daName, outputFilePath, IMFMontagePipelineBuilder::MontagePath());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFStreamingStitcher::StitchTilesInMemory(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const DataArrayPath& montagePath,
+                                              bool releaseTiles)
+{
+  std::vector<TilePlacement> tiles;
+  size_t width = 0;
+  size_t height = 0;
+  FloatVec3Type spacing;
+  FloatVec3Type origin;
+  int err = collectTiles(dca, tilePrefix, amName, daName, false, tiles, width, height, spacing, origin);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  IDataArray::Pointer firstData = tiles.front().data;
+  size_t numComps = static_cast<size_t>(firstData->getNumberOfComponents());
+  QString montageDaName = montagePath.getDataArrayName();
+  IDataArray::Pointer montageArray;
+  if(std::dynamic_pointer_cast<UInt8ArrayType>(firstData))
+  {
+    montageArray = stitchInMemory<uint8_t>(tiles, amName, width, height, numComps, releaseTiles, montageDaName, err);
+  }
+  else if(std::dynamic_pointer_cast<UInt16ArrayType>(firstData))
+  {
+    montageArray = stitchInMemory<uint16_t>(tiles, amName, width, height, numComps, releaseTiles, montageDaName, err);
+  }
+  else if(std::dynamic_pointer_cast<UInt32ArrayType>(firstData))
+  {
+    montageArray = stitchInMemory<uint32_t>(tiles, amName, width, height, numComps, releaseTiles, montageDaName, err);
+  }
+  else if(std::dynamic_pointer_cast<FloatArrayType>(firstData))
+  {
+    montageArray = stitchInMemory<float>(tiles, amName, width, height, numComps, releaseTiles, montageDaName, err);
+  }
+  else
+  {
+    return k_UnsupportedTypeError;
+  }
+
+  if(err < 0)
+  {
+    return err;
+  }
+
+  DataContainer::Pointer montageDC = DataContainer::New(montagePath.getDataContainerName());
+  ImageGeom::Pointer montageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+  montageGeom->setDimensions(SizeVec3Type(width, height, 1));
+  montageGeom->setSpacing(spacing);
+  montageGeom->setOrigin(origin);
+  montageDC->setGeometry(montageGeom);
+
+  std::vector<size_t> tupleDims = {width, height, 1};
+  AttributeMatrix::Pointer montageAM = AttributeMatrix::New(tupleDims, montagePath.getAttributeMatrixName(), AttributeMatrix::Type::Cell);
+  montageAM->addOrReplaceAttributeArray(montageArray);
+  montageDC->addOrReplaceAttributeMatrix(montageAM);
+  dca->addOrReplaceDataContainer(montageDC);
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFStreamingStitcher::RestitchRegions(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const DataContainer::Pointer& montageDC,
+                                          const DataArrayPath& montagePath, const std::vector<QRect>& regions)
+{
+  std::vector<TilePlacement> tiles;
+  size_t width = 0;
+  size_t height = 0;
+  FloatVec3Type spacing;
+  FloatVec3Type origin;
+  int err = collectTiles(dca, tilePrefix, amName, daName, false, tiles, width, height, spacing, origin);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  ImageGeom::Pointer montageGeom = montageDC ? montageDC->getGeometryAs<ImageGeom>() : ImageGeom::NullPointer();
+  AttributeMatrix::Pointer montageAM = montageDC ? montageDC->getAttributeMatrix(montagePath.getAttributeMatrixName()) : AttributeMatrix::NullPointer();
+  IDataArray::Pointer montageData = montageAM ? montageAM->getAttributeArray(montagePath.getDataArrayName()) : IDataArray::NullPointer();
+  if(!montageGeom || !montageData)
+  {
+    return k_MontageChangedError;
+  }
+
+  // The montage's z origin may have been moved to its slice, so only x and y are compared
+  SizeVec3Type montageDims = montageGeom->getDimensions();
+  FloatVec3Type montageOrigin = montageGeom->getOrigin();
+  if(montageDims[0] != width || montageDims[1] != height || std::lround((origin[0] - montageOrigin[0]) / spacing[0]) != 0 || std::lround((origin[1] - montageOrigin[1]) / spacing[1]) != 0)
+  {
+    return k_MontageChangedError;
+  }
+
+  IDataArray::Pointer firstData = tiles.front().data;
+  size_t numComps = static_cast<size_t>(firstData->getNumberOfComponents());
+  if(montageData->getTypeAsString() != firstData->getTypeAsString() || static_cast<size_t>(montageData->getNumberOfComponents()) != numComps ||
+     montageData->getNumberOfTuples() != width * height)
+  {
+    return k_MontageChangedError;
+  }
+
+  if(std::dynamic_pointer_cast<UInt8ArrayType>(firstData))
+  {
+    compositeRegions<uint8_t>(tiles, montageData, width, height, numComps, regions);
+  }
+  else if(std::dynamic_pointer_cast<UInt16ArrayType>(firstData))
+  {
+    compositeRegions<uint16_t>(tiles, montageData, width, height, numComps, regions);
+  }
+  else if(std::dynamic_pointer_cast<UInt32ArrayType>(firstData))
+  {
+    compositeRegions<uint32_t>(tiles, montageData, width, height, numComps, regions);
+  }
+  else if(std::dynamic_pointer_cast<FloatArrayType>(firstData))
+  {
+    compositeRegions<float>(tiles, montageData, width, height, numComps, regions);
+  }
+  else
+  {
+    return k_UnsupportedTypeError;
+  }
+
+  return 0;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFStreamingStitcher::StitchTiles(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const QString& outputFilePath,
+                                      const DataArrayPath& montagePath, const TileReadFunction& readTile)
+{
+  std::vector<TilePlacement> tiles;
+  size_t width = 0;
+  size_t height = 0;
+  FloatVec3Type spacing;
+  FloatVec3Type origin;
+  int err = collectTiles(dca, tilePrefix, amName, daName, static_cast<bool>(readTile), tiles, width, height, spacing, origin);
+  if(err < 0)
+  {
+    return err;
+  }
+
+  // The top tile overlaps the first strip anyway, so reading it early to find the pixel type costs no memory
+  if(!tiles.front().data)
+  {
+    err = loadTile(tiles.front(), amName, daName, IDataArray::NullPointer(), readTile);
+    if(err < 0)
+    {
+      return err;
+    }
+  }
+
+  IDataArray::Pointer firstData = tiles.front().data;
+  size_t numComps = static_cast<size_t>(firstData->getNumberOfComponents());
+  hid_t memTypeId = -1;
+  if(std::dynamic_pointer_cast<UInt8ArrayType>(firstData))
+  {
+    memTypeId = nativeType<uint8_t>();
+  }
+  else if(std::dynamic_pointer_cast<UInt16ArrayType>(firstData))
+  {
+    memTypeId = nativeType<uint16_t>();
+  }
+  else if(std::dynamic_pointer_cast<UInt32ArrayType>(firstData))
+  {
+    memTypeId = nativeType<uint32_t>();
+  }
+  else if(std::dynamic_pointer_cast<FloatArrayType>(firstData))
+  {
+    memTypeId = nativeType<float>();
+  }
+  else
+  {
+    return k_UnsupportedTypeError;
+  }
+
+  // HDF5 is locked around each group of calls rather than for the whole stitch, so other
+  // pipelines can read and write their files while tiles are read and strips composited
+  QDir().mkpath(QFileInfo(outputFilePath).absolutePath());
+  QString objectType = firstData->getNameOfClass();
+  hid_t fileId = -1;
+  hid_t dcaGroupId = -1;
+  hid_t datasetId = -1;
+  {
+    QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+    fileId = H5Fcreate(outputFilePath.toLocal8Bit().constData(), H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+    if(fileId < 0)
+    {
+      return k_CreateFileError;
+    }
+
+    writeStringAttribute(fileId, SIMPL::HDF5::FileVersionName, SIMPL::HDF5::FileVersion);
+    dcaGroupId = H5Gcreate(fileId, SIMPL::StringConstants::DataContainerGroupName.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    datasetId = createMontageDataset(dcaGroupId, montagePath, montagePath.getDataContainerName(), width, height, spacing, origin, memTypeId, numComps, objectType);
+  }
+
+  if(datasetId < 0)
+  {
+    err = k_WriteError;
+  }
+  else if(memTypeId == nativeType<uint8_t>())
+  {
+    err = writeStrips<uint8_t>(datasetId, tiles, amName, daName, width, height, numComps, readTile);
+  }
+  else if(memTypeId == nativeType<uint16_t>())
+  {
+    err = writeStrips<uint16_t>(datasetId, tiles, amName, daName, width, height, numComps, readTile);
+  }
+  else if(memTypeId == nativeType<uint32_t>())
+  {
+    err = writeStrips<uint32_t>(datasetId, tiles, amName, daName, width, height, numComps, readTile);
+  }
+  else
+  {
+    err = writeStrips<float>(datasetId, tiles, amName, daName, width, height, numComps, readTile);
+  }
+
+  // Each pyramid level halves the previous one and is read back from the file one strip at a time
+  size_t levelWidth = width;
+  size_t levelHeight = height;
+  FloatVec3Type levelSpacing = spacing;
+  for(int level = 1; err >= 0 && std::max(levelWidth, levelHeight) > k_MinPyramidSize; level++)
+  {
+    size_t nextWidth = (levelWidth + 1) / 2;
+    size_t nextHeight = (levelHeight + 1) / 2;
+    levelSpacing = {levelSpacing[0] * 2.0f, levelSpacing[1] * 2.0f, levelSpacing[2]};
+    hid_t levelDatasetId = -1;
+    {
+      QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+      levelDatasetId = createMontageDataset(dcaGroupId, montagePath, PyramidLevelName(montagePath.getDataContainerName(), level), nextWidth, nextHeight, levelSpacing, origin, memTypeId, numComps,
+                                            objectType);
+    }
+    if(levelDatasetId < 0)
+    {
+      err = k_WriteError;
+      break;
+    }
+
+    if(memTypeId == nativeType<uint8_t>())
+    {
+      err = writeDownsampledLevel<uint8_t>(datasetId, levelWidth, levelHeight, levelDatasetId, nextWidth, nextHeight, numComps);
+    }
+    else if(memTypeId == nativeType<uint16_t>())
+    {
+      err = writeDownsampledLevel<uint16_t>(datasetId, levelWidth, levelHeight, levelDatasetId, nextWidth, nextHeight, numComps);
+    }
+    else if(memTypeId == nativeType<uint32_t>())
+    {
+      err = writeDownsampledLevel<uint32_t>(datasetId, levelWidth, levelHeight, levelDatasetId, nextWidth, nextHeight, numComps);
+    }
+    else
+    {
+      err = writeDownsampledLevel<float>(datasetId, levelWidth, levelHeight, levelDatasetId, nextWidth, nextHeight, numComps);
+    }
+
+    QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+    H5Dclose(datasetId);
+    datasetId = levelDatasetId;
+    levelWidth = nextWidth;
+    levelHeight = nextHeight;
+  }
+
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  if(datasetId >= 0)
+  {
+    H5Dclose(datasetId);
+  }
+  H5Gclose(dcaGroupId);
+
+  hid_t bundleGroupId = H5Gcreate(fileId, SIMPL::StringConstants::DataContainerBundleGroupName.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+  H5Gclose(bundleGroupId);
+
+  if(err >= 0 && IMFDream3dWriter::WritePipelineGroup(fileId) < 0)
+  {
+    err = k_WriteError;
+  }
+
+  H5Fclose(fileId);
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFStreamingStitcher::PyramidLevelName(const QString& dcName, int level)
+{
+  if(level <= 0)
+  {
+    return dcName;
+  }
+  return QString("%1_L%2").arg(dcName).arg(level);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<SizeVec3Type> IMFStreamingStitcher::ReadPyramidLevels(const QString& filePath, const DataArrayPath& montagePath)
+{
+  std::vector<SizeVec3Type> levels;
+
+  QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+  H5E_BEGIN_TRY
+  {
+    hid_t fileId = H5Fopen(filePath.toLocal8Bit().constData(), H5F_ACC_RDONLY, H5P_DEFAULT);
+    if(fileId >= 0)
+    {
+      for(int level = 0;; level++)
+      {
+        QString dcGroupPath = SIMPL::StringConstants::DataContainerGroupName + "/" + PyramidLevelName(montagePath.getDataContainerName(), level);
+        QString amGroupPath = dcGroupPath + "/" + montagePath.getAttributeMatrixName();
+        if(H5Lexists(fileId, dcGroupPath.toLatin1().constData(), H5P_DEFAULT) <= 0 || H5Lexists(fileId, amGroupPath.toLatin1().constData(), H5P_DEFAULT) <= 0)
+        {
+          break;
+        }
+
+        uint64_t tupleDims[3] = {0, 0, 0};
+        hid_t attrId = H5Aopen_by_name(fileId, amGroupPath.toLatin1().constData(), SIMPL::HDF5::TupleDimensions.toLatin1().constData(), H5P_DEFAULT, H5P_DEFAULT);
+        herr_t err = attrId < 0 ? -1 : H5Aread(attrId, H5T_NATIVE_UINT64, tupleDims);
+        if(attrId >= 0)
+        {
+          H5Aclose(attrId);
+        }
+        if(err < 0)
+        {
+          break;
+        }
+
+        levels.push_back(SizeVec3Type(static_cast<size_t>(tupleDims[0]), static_cast<size_t>(tupleDims[1]), static_cast<size_t>(tupleDims[2])));
+      }
+      H5Fclose(fileId);
+    }
+  }
+  H5E_END_TRY;
+
+  return levels;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFStreamingStitcher::SelectPyramidLevel(const std::vector<SizeVec3Type>& levels, int viewWidth, int viewHeight)
+{
+  if(levels.empty() || viewWidth <= 0 || viewHeight <= 0)
+  {
+    return 0;
+  }
+
+  // When the whole montage fits the view, one screen pixel covers 1 / scale montage pixels,
+  // so the level that halves the resolution no further than that keeps every visible detail
+  double scale = std::min(static_cast<double>(viewWidth) / levels[0][0], static_cast<double>(viewHeight) / levels[0][1]);
+  if(scale >= 1.0)
+  {
+    return 0;
+  }
+
+  int level = static_cast<int>(std::floor(std::log2(1.0 / scale)));
+  return std::max(0, std::min(level, static_cast<int>(levels.size()) - 1));
+}
@@ -0,0 +1,195 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include <QtCore/QRect>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The IMFStreamingStitcher class composites registered tiles into a stitched montage
+ * one strip at a time and writes each strip straight into a chunked array of a .dream3d
+ * file.  The stitched montage is never held in memory, and the pixels of each tile row
+ * are released as soon as the last strip that overlaps them has been written.
+ *
+ * With low memory stitching, montages that are displayed without an output file are
+ * composited the same way into an array of the data container array, so the tiles are
+ * released while the montage fills in and peak memory stays close to the larger of the
+ * two instead of their sum.  Overlaps are not blended: the later tile covers the earlier
+ * one, unlike the ITK stitching filter used otherwise.
+ *
+ * Power-of-two downsampled copies of the montage are written next to it as pyramid
+ * levels named <montage>_L1, <montage>_L2, ... so the viewer can load the level that
+ * matches the view instead of the full resolution image.
+ */
+class IMFStreamingStitcher
+{
+public:
+  static const char* OutputFileProperty;
+  static const char* TilePrefixProperty;
+  static const char* AttributeMatrixNameProperty;
+  static const char* DataArrayNameProperty;
+
+  static const int k_NoTilesError = -89000;
+  static const int k_MixedTileTypesError = -89001;
+  static const int k_UnsupportedTypeError = -89002;
+  static const int k_CreateFileError = -89003;
+  static const int k_WriteError = -89004;
+  static const int k_AllocationError = -89005;
+  static const int k_MontageChangedError = -89006;
+  static const int k_TileReadError = -89007;
+
+  /**
+   * @brief Reads the pixels of a tile whose data container only holds its geometry by adding
+   * the tile's attribute matrix to the data container.  Returns a negative value on failure.
+   */
+  using TileReadFunction = std::function<int(const DataContainer::Pointer& tileDC)>;
+
+  /**
+   * @brief Returns true if the pipeline was built to stitch its tiles with this class
+   * @param pipeline
+   * @return
+   */
+  static bool IsStreamingPipeline(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Returns true if the pipeline's tiles are stitched by this class after the
+   * pipeline executed, either into a file or into memory
+   * @param pipeline
+   * @return
+   */
+  static bool IsStitchingPipeline(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Stitches the tiles of an executed stitching pipeline using the output file and
+   * tile names stored in the pipeline's properties.  Without an output file the montage is
+   * added to the data container array at IMFMontagePipelineBuilder::MontagePath.  This matches
+   * IMFPipelineScheduler::PostExecuteFunction.
+   * @param pipeline
+   * @param dca
+   * @return
+   */
+  static int ExecutePipeline(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca);
+
+  /**
+   * @brief Stitches the image data containers whose names start with the tile prefix and
+   * writes the montage to the output file at the montage path.  The tile geometries stay
+   * in the data container array but their attribute matrices are removed.  When a tile
+   * reader is given, tiles that only hold their geometry are read when the first strip
+   * that overlaps them is composited, so only about one strip of tiles is in memory at
+   * a time.  HDF5 calls are made with IMFHdf5Lock held.
+   * @param dca
+   * @param tilePrefix
+   * @param amName
+   * @param daName
+   * @param outputFilePath
+   * @param montagePath
+   * @param readTile
+   * @return
+   */
+  static int StitchTiles(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const QString& outputFilePath, const DataArrayPath& montagePath,
+                         const TileReadFunction& readTile = TileReadFunction());
+
+  /**
+   * @brief Stitches the image data containers whose names start with the tile prefix into a
+   * new data container at the montage path.  Unless releaseTiles is false, each tile's
+   * attribute matrix is removed as soon as the last strip that overlaps it has been composited.
+   * @param dca
+   * @param tilePrefix
+   * @param amName
+   * @param daName
+   * @param montagePath
+   * @param releaseTiles
+   * @return
+   */
+  static int StitchTilesInMemory(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const DataArrayPath& montagePath,
+                                 bool releaseTiles = true);
+
+  /**
+   * @brief Recomposites the pixel regions of an existing montage from the tiles that overlap
+   * them.  Overlaps inside the regions are not blended: the later tile covers the earlier one,
+   * as in StitchTilesInMemory.  k_MontageChangedError is returned without modifying the
+   * montage if the tiles no longer span exactly the montage's extent.
+   * @param dca
+   * @param tilePrefix
+   * @param amName
+   * @param daName
+   * @param montageDC
+   * @param montagePath
+   * @param regions Rectangles in montage pixel coordinates
+   * @return
+   */
+  static int RestitchRegions(const DataContainerArray::Pointer& dca, const QString& tilePrefix, const QString& amName, const QString& daName, const DataContainer::Pointer& montageDC,
+                             const DataArrayPath& montagePath, const std::vector<QRect>& regions);
+
+  /**
+   * @brief Returns the name of the data container holding the pyramid level.  Level 0 is
+   * the full resolution montage.
+   * @param dcName
+   * @param level
+   * @return
+   */
+  static QString PyramidLevelName(const QString& dcName, int level);
+
+  /**
+   * @brief Returns the dimensions of every pyramid level stored in the file, starting with
+   * the full resolution montage.  The vector is empty if the montage could not be found.
+   * @param filePath
+   * @param montagePath
+   * @return
+   */
+  static std::vector<SizeVec3Type> ReadPyramidLevels(const QString& filePath, const DataArrayPath& montagePath);
+
+  /**
+   * @brief Returns the coarsest pyramid level that still has at least one pixel per screen
+   * pixel when the whole montage is fit to a view of the given size
+   * @param levels
+   * @param viewWidth
+   * @param viewHeight
+   * @return
+   */
+  static int SelectPyramidLevel(const std::vector<SizeVec3Type>& levels, int viewWidth, int viewHeight);
+
+private:
+  IMFStreamingStitcher() = delete;
+};
@@ -0,0 +1,935 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFTileCache.h"
+
+#include <algorithm>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDataStream>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QMutex>
+#include <QtCore/QPair>
+#include <QtCore/QSaveFile>
+#include <QtCore/QStandardPaths>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFPipelineScheduler.h"
+
+const char* IMFTileCache::ImportStage = "Import";
+const char* IMFTileCache::TileStage = "Tile";
+
+namespace
+{
+// Increment when the keyed settings or the format of the spilled files change
+const qint32 k_CacheVersion = 1;
+
+// Spilled arrays are written and read in blocks of at most this many bytes
+const qint64 k_BlockSize = 64 * 1024 * 1024;
+
+// Tuple and component dimensions longer than this are treated as a corrupt file
+const quint32 k_MaxDimensionCount = 16;
+
+using EvictedEntries = std::vector<std::pair<QString, DataContainer::Pointer>>;
+
+struct CacheEntry
+{
+  DataContainer::Pointer dc;
+  qint64 bytes = 0;
+  std::list<QString>::iterator usage;
+};
+
+struct TileCacheState
+{
+  QMutex mutex;
+  bool enabled = true;
+  qint64 memoryLimit = IMFPipelineScheduler::PhysicalMemorySize() / 8;
+  bool diskSpillEnabled = false;
+  QString diskDirectory = IMFTileCache::DefaultDiskDirectory();
+  qint64 diskLimit = 4LL * 1024 * 1024 * 1024;
+
+  QHash<QString, CacheEntry> entries;
+  std::list<QString> usage; // Most recently used first
+  qint64 memoryBytes = 0;
+
+  // Hash of the file listing of each input directory and the directory time stamp it was computed for
+  QHash<QString, QPair<qint64, QByteArray>> directoryFingerprints;
+
+  IMFTileCache::Statistics statistics;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+TileCacheState& tileCacheState()
+{
+  static TileCacheState instance;
+  return instance;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void addFileIdentity(QCryptographicHash& hash, const QFileInfo& fi)
+{
+  hash.addData(fi.absoluteFilePath().toUtf8());
+  hash.addData(QByteArray::number(fi.size()));
+  hash.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void addFloatVec3(QCryptographicHash& hash, const FloatVec3Type& value)
+{
+  for(size_t i = 0; i < 3; i++)
+  {
+    hash.addData(QByteArray::number(value[i], 'g', 9));
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QByteArray directoryFingerprint(const QString& dirPath)
+{
+  // Adding, removing or renaming a file updates the time stamp of the directory, so the
+  // listing of a directory with thousands of tiles is only hashed again after it changed
+  qint64 dirTime = QFileInfo(dirPath).lastModified().toMSecsSinceEpoch();
+  TileCacheState& state = tileCacheState();
+  {
+    QMutexLocker locker(&state.mutex);
+    auto iter = state.directoryFingerprints.constFind(dirPath);
+    if(iter != state.directoryFingerprints.constEnd() && iter.value().first == dirTime)
+    {
+      return iter.value().second;
+    }
+  }
+
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  for(const QFileInfo& fi : QDir(dirPath).entryInfoList(QDir::Files, QDir::Name))
+  {
+    addFileIdentity(hash, fi);
+  }
+  QByteArray fingerprint = hash.result();
+
+  QMutexLocker locker(&state.mutex);
+  state.directoryFingerprints.insert(dirPath, qMakePair(dirTime, fingerprint));
+  return fingerprint;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 arrayBytes(const IDataArray::Pointer& data)
+{
+  return static_cast<qint64>(data->getNumberOfTuples()) * data->getNumberOfComponents() * data->getTypeSize();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 tileBytes(const DataContainer::Pointer& dc)
+{
+  qint64 bytes = 0;
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      bytes += arrayBytes(am->getAttributeArray(arrayName));
+    }
+  }
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+// Returns a data container with its own geometry, attribute matrices and arrays.  Decoded tiles
+// are displayed without copying and may be written to in place, so the cache never shares its
+// arrays with the data containers it stores or hands out.
+// -----------------------------------------------------------------------------
+DataContainer::Pointer cloneTile(const DataContainer::Pointer& dc)
+{
+  ImageGeom::Pointer sourceGeom = dc->getGeometryAs<ImageGeom>();
+  ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+  imageGeom->setDimensions(sourceGeom->getDimensions());
+  imageGeom->setSpacing(sourceGeom->getSpacing());
+  imageGeom->setOrigin(sourceGeom->getOrigin());
+  imageGeom->setUnits(sourceGeom->getUnits());
+
+  DataContainer::Pointer copy = DataContainer::New(dc->getName());
+  copy->setGeometry(imageGeom);
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    AttributeMatrix::Pointer amCopy = AttributeMatrix::New(am->getTupleDimensions(), am->getName(), am->getType());
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      amCopy->addOrReplaceAttributeArray(am->getAttributeArray(arrayName)->deepCopy());
+    }
+    copy->addOrReplaceAttributeMatrix(amCopy);
+  }
+  return copy;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IDataArray::Pointer createArray(const QString& typeName, size_t numTuples, const std::vector<size_t>& cDims, const QString& name)
+{
+  // bool arrays and arrays without a single flat buffer are not spilled
+  if(typeName == "int8_t")
+  {
+    return Int8ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "uint8_t")
+  {
+    return UInt8ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "int16_t")
+  {
+    return Int16ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "uint16_t")
+  {
+    return UInt16ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "int32_t")
+  {
+    return Int32ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "uint32_t")
+  {
+    return UInt32ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "int64_t")
+  {
+    return Int64ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "uint64_t")
+  {
+    return UInt64ArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "float")
+  {
+    return FloatArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  if(typeName == "double")
+  {
+    return DoubleArrayType::CreateArray(numTuples, cDims, name, true);
+  }
+  return IDataArray::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool isSpillableType(const QString& typeName)
+{
+  static const QStringList spillableTypes = {"int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t", "float", "double"};
+  return spillableTypes.contains(typeName);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void writeSizes(QDataStream& stream, const std::vector<size_t>& sizes)
+{
+  stream << static_cast<quint32>(sizes.size());
+  for(size_t size : sizes)
+  {
+    stream << static_cast<quint64>(size);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readSizes(QDataStream& stream, std::vector<size_t>& sizes)
+{
+  quint32 count = 0;
+  stream >> count;
+  if(count == 0 || count > k_MaxDimensionCount)
+  {
+    return false;
+  }
+
+  sizes.resize(count);
+  for(size_t& size : sizes)
+  {
+    quint64 value = 0;
+    stream >> value;
+    size = static_cast<size_t>(value);
+  }
+  return stream.status() == QDataStream::Ok;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool writeTileFile(const QString& filePath, const DataContainer::Pointer& dc)
+{
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      if(!isSpillableType(am->getAttributeArray(arrayName)->getTypeAsString()))
+      {
+        return false;
+      }
+    }
+  }
+
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+
+  ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
+  SizeVec3Type dims = imageGeom->getDimensions();
+  FloatVec3Type spacing = imageGeom->getSpacing();
+  FloatVec3Type origin = imageGeom->getOrigin();
+
+  QDataStream stream(&file);
+  stream << k_CacheVersion << dc->getName();
+  for(size_t i = 0; i < 3; i++)
+  {
+    stream << static_cast<quint64>(dims[i]) << spacing[i] << origin[i];
+  }
+  stream << static_cast<qint32>(imageGeom->getUnits());
+
+  stream << static_cast<qint32>(dc->getAttributeMatrices().size());
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    stream << am->getName() << static_cast<qint32>(am->getType());
+    writeSizes(stream, am->getTupleDimensions());
+
+    QStringList arrayNames = am->getAttributeArrayNames();
+    stream << static_cast<qint32>(arrayNames.size());
+    for(const QString& arrayName : arrayNames)
+    {
+      IDataArray::Pointer data = am->getAttributeArray(arrayName);
+      stream << data->getName() << data->getTypeAsString();
+      writeSizes(stream, data->getComponentDimensions());
+
+      const char* buffer = static_cast<const char*>(data->getVoidPointer(0));
+      qint64 numBytes = arrayBytes(data);
+      for(qint64 offset = 0; offset < numBytes; offset += k_BlockSize)
+      {
+        int blockBytes = static_cast<int>(std::min(k_BlockSize, numBytes - offset));
+        if(stream.writeRawData(buffer + offset, blockBytes) != blockBytes)
+        {
+          return false;
+        }
+      }
+    }
+  }
+
+  return stream.status() == QDataStream::Ok && file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainer::Pointer readTileFile(const QString& filePath)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    return DataContainer::NullPointer();
+  }
+
+  QDataStream stream(&file);
+  qint32 version = 0;
+  QString dcName;
+  stream >> version >> dcName;
+  if(version != k_CacheVersion)
+  {
+    return DataContainer::NullPointer();
+  }
+
+  SizeVec3Type dims;
+  FloatVec3Type spacing;
+  FloatVec3Type origin;
+  for(size_t i = 0; i < 3; i++)
+  {
+    quint64 dim = 0;
+    stream >> dim >> spacing[i] >> origin[i];
+    dims[i] = static_cast<size_t>(dim);
+  }
+  qint32 units = 0;
+  stream >> units;
+
+  ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+  imageGeom->setDimensions(dims);
+  imageGeom->setSpacing(spacing);
+  imageGeom->setOrigin(origin);
+  imageGeom->setUnits(static_cast<IGeometry::LengthUnit>(units));
+
+  DataContainer::Pointer dc = DataContainer::New(dcName);
+  dc->setGeometry(imageGeom);
+
+  qint32 amCount = 0;
+  stream >> amCount;
+  for(qint32 i = 0; i < amCount && stream.status() == QDataStream::Ok; i++)
+  {
+    QString amName;
+    qint32 amType = 0;
+    std::vector<size_t> tupleDims;
+    stream >> amName >> amType;
+    if(!readSizes(stream, tupleDims))
+    {
+      return DataContainer::NullPointer();
+    }
+
+    AttributeMatrix::Pointer am = AttributeMatrix::New(tupleDims, amName, static_cast<AttributeMatrix::Type>(amType));
+    qint32 arrayCount = 0;
+    stream >> arrayCount;
+    for(qint32 j = 0; j < arrayCount && stream.status() == QDataStream::Ok; j++)
+    {
+      QString arrayName;
+      QString typeName;
+      std::vector<size_t> cDims;
+      stream >> arrayName >> typeName;
+      if(!readSizes(stream, cDims))
+      {
+        return DataContainer::NullPointer();
+      }
+
+      IDataArray::Pointer data = createArray(typeName, am->getNumberOfTuples(), cDims, arrayName);
+      if(!data)
+      {
+        return DataContainer::NullPointer();
+      }
+
+      char* buffer = static_cast<char*>(data->getVoidPointer(0));
+      qint64 numBytes = arrayBytes(data);
+      for(qint64 offset = 0; offset < numBytes; offset += k_BlockSize)
+      {
+        int blockBytes = static_cast<int>(std::min(k_BlockSize, numBytes - offset));
+        if(stream.readRawData(buffer + offset, blockBytes) != blockBytes)
+        {
+          return DataContainer::NullPointer();
+        }
+      }
+      am->addOrReplaceAttributeArray(data);
+    }
+    dc->addOrReplaceAttributeMatrix(am);
+  }
+
+  if(stream.status() != QDataStream::Ok)
+  {
+    return DataContainer::NullPointer();
+  }
+  return dc;
+}
+
+// -----------------------------------------------------------------------------
+// Removes the least recently used spilled entries until the directory fits in its size limit
+// -----------------------------------------------------------------------------
+void evictDisk(const QString& directory, qint64 limit)
+{
+  QDir cacheDir(directory);
+  QFileInfoList entries = cacheDir.entryInfoList({"*.tile"}, QDir::Files, QDir::Time);
+
+  qint64 totalSize = 0;
+  for(const QFileInfo& fi : entries)
+  {
+    totalSize += fi.size();
+  }
+
+  // Entries are sorted newest first, so the least recently used are removed from the back
+  while(totalSize > limit && !entries.isEmpty())
+  {
+    QFileInfo fi = entries.takeLast();
+    totalSize -= fi.size();
+    cacheDir.remove(fi.fileName());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Must be called with the state mutex held
+// -----------------------------------------------------------------------------
+void removeEntry(TileCacheState& state, const QString& key)
+{
+  auto iter = state.entries.find(key);
+  if(iter == state.entries.end())
+  {
+    return;
+  }
+
+  state.usage.erase(iter.value().usage);
+  state.memoryBytes -= iter.value().bytes;
+  state.entries.erase(iter);
+}
+
+// -----------------------------------------------------------------------------
+// Must be called with the state mutex held
+// -----------------------------------------------------------------------------
+EvictedEntries trimEntries(TileCacheState& state)
+{
+  EvictedEntries evicted;
+  while(state.memoryBytes > state.memoryLimit && !state.usage.empty())
+  {
+    QString key = state.usage.back();
+    state.usage.pop_back();
+    CacheEntry entry = state.entries.take(key);
+    state.memoryBytes -= entry.bytes;
+    evicted.push_back(std::make_pair(key, entry.dc));
+  }
+  return evicted;
+}
+
+// -----------------------------------------------------------------------------
+// Must be called with the state mutex held
+// -----------------------------------------------------------------------------
+EvictedEntries insertEntry(TileCacheState& state, const QString& key, const DataContainer::Pointer& dc)
+{
+  removeEntry(state, key);
+
+  CacheEntry entry;
+  entry.dc = dc;
+  entry.bytes = tileBytes(dc);
+  state.usage.push_front(key);
+  entry.usage = state.usage.begin();
+  state.entries.insert(key, entry);
+  state.memoryBytes += entry.bytes;
+  return trimEntries(state);
+}
+
+// -----------------------------------------------------------------------------
+// Writes the entries dropped from memory to the disk cache directory.  This is called without
+// the state mutex held so that other threads can use the cache while the files are written.
+// -----------------------------------------------------------------------------
+void spillEntries(const EvictedEntries& evicted)
+{
+  if(evicted.empty())
+  {
+    return;
+  }
+
+  TileCacheState& state = tileCacheState();
+  QString directory;
+  qint64 diskLimit = 0;
+  {
+    QMutexLocker locker(&state.mutex);
+    if(!state.diskSpillEnabled)
+    {
+      return;
+    }
+    directory = state.diskDirectory;
+    diskLimit = state.diskLimit;
+  }
+
+  if(!QDir().mkpath(directory))
+  {
+    return;
+  }
+
+  qint64 spills = 0;
+  QDir cacheDir(directory);
+  for(const std::pair<QString, DataContainer::Pointer>& entry : evicted)
+  {
+    // An entry read back from disk is still there unless the directory was trimmed since
+    QString filePath = cacheDir.filePath(entry.first + ".tile");
+    if(!QFileInfo::exists(filePath) && writeTileFile(filePath, entry.second))
+    {
+      spills++;
+    }
+  }
+
+  evictDisk(directory, diskLimit);
+
+  QMutexLocker locker(&state.mutex);
+  state.statistics.spills += spills;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFTileCache::DefaultDiskDirectory()
+{
+  return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/TileCache";
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFTileCache::ComputeFileKey(const QString& filePath)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QByteArray::number(k_CacheVersion));
+  hash.addData("Image");
+  addFileIdentity(hash, QFileInfo(filePath));
+  return QString::fromLatin1(hash.result().toHex());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFTileCache::ComputeTileKey(const IMFMontagePipelineBuilder::MontageSettings& settings, int slice, const QString& stage, const IntVec2Type& position)
+{
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  hash.addData(QByteArray::number(k_CacheVersion));
+  hash.addData(stage.toUtf8());
+  hash.addData(QByteArray::number(static_cast<int>(settings.Type)));
+
+  // DREAM3D tiles are stored in the input file itself.  The other types read tile images that
+  // live next to the input file, whose names, sizes and time stamps are part of the key as well.
+  QFileInfo inputInfo(settings.InputFilePath);
+  addFileIdentity(hash, inputInfo);
+  if(settings.Type != IMFMontagePipelineBuilder::MontageType::DREAM3D)
+  {
+    hash.addData(directoryFingerprint(inputInfo.absolutePath()));
+  }
+
+  hash.addData(QByteArray::number(slice));
+  hash.addData(QByteArray::number(position[0]));
+  hash.addData(QByteArray::number(position[1]));
+
+  if(!settings.Region.isEmpty())
+  {
+    hash.addData(QByteArray::number(settings.Region.x()));
+    hash.addData(QByteArray::number(settings.Region.y()));
+    hash.addData(QByteArray::number(settings.Region.width()));
+    hash.addData(QByteArray::number(settings.Region.height()));
+  }
+
+  hash.addData(QByteArray::number(settings.OverrideSpacing));
+  addFloatVec3(hash, settings.Spacing);
+  hash.addData(QByteArray::number(settings.OverrideOrigin));
+  addFloatVec3(hash, settings.Origin);
+  hash.addData(QByteArray::number(settings.LengthUnit));
+  hash.addData(settings.ImagePrefix.toUtf8());
+  hash.addData(settings.ImageExtension.toUtf8());
+  hash.addData(settings.DataContainerPrefix.toUtf8());
+  hash.addData(settings.AttributeMatrixName.toUtf8());
+  hash.addData(settings.DataArrayName.toUtf8());
+
+  // Zeiss tiles are converted to grayscale as they are decoded, before they are cached
+  hash.addData(QByteArray::number(settings.ConvertToGrayscale));
+  addFloatVec3(hash, settings.ColorWeighting);
+
+  return QString::fromLatin1(hash.result().toHex());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::SetEnabled(bool enabled)
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  state.enabled = enabled;
+
+  // A disabled cache does not hold on to any memory
+  if(!enabled)
+  {
+    state.entries.clear();
+    state.usage.clear();
+    state.memoryBytes = 0;
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFTileCache::IsEnabled()
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  return state.enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::SetMemoryLimit(qint64 bytes)
+{
+  TileCacheState& state = tileCacheState();
+  EvictedEntries evicted;
+  {
+    QMutexLocker locker(&state.mutex);
+    state.memoryLimit = std::max<qint64>(0, bytes);
+    evicted = trimEntries(state);
+  }
+  spillEntries(evicted);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFTileCache::GetMemoryLimit()
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  return state.memoryLimit;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::SetDiskSpillEnabled(bool enabled)
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  state.diskSpillEnabled = enabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFTileCache::IsDiskSpillEnabled()
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  return state.diskSpillEnabled;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::SetDiskDirectory(const QString& directory)
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  state.diskDirectory = directory.isEmpty() ? DefaultDiskDirectory() : directory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QString IMFTileCache::GetDiskDirectory()
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  return state.diskDirectory;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::SetDiskLimit(qint64 bytes)
+{
+  TileCacheState& state = tileCacheState();
+  QString directory;
+  {
+    QMutexLocker locker(&state.mutex);
+    state.diskLimit = std::max<qint64>(0, bytes);
+    directory = state.diskDirectory;
+    bytes = state.diskLimit;
+  }
+  evictDisk(directory, bytes);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFTileCache::GetDiskLimit()
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  return state.diskLimit;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainer::Pointer IMFTileCache::Lookup(const QString& key)
+{
+  TileCacheState& state = tileCacheState();
+  QString filePath;
+  DataContainer::Pointer cachedDC;
+  {
+    QMutexLocker locker(&state.mutex);
+    if(!state.enabled)
+    {
+      return DataContainer::NullPointer();
+    }
+
+    auto iter = state.entries.find(key);
+    if(iter != state.entries.end())
+    {
+      state.usage.splice(state.usage.begin(), state.usage, iter.value().usage);
+      state.statistics.hits++;
+      cachedDC = iter.value().dc;
+    }
+    else if(state.diskSpillEnabled)
+    {
+      filePath = QDir(state.diskDirectory).filePath(key + ".tile");
+    }
+  }
+
+  // Cached tiles are never modified, so they are copied outside of the lock
+  if(cachedDC)
+  {
+    return cloneTile(cachedDC);
+  }
+
+  DataContainer::Pointer dc = filePath.isEmpty() ? DataContainer::NullPointer() : readTileFile(filePath);
+  if(!dc)
+  {
+    QMutexLocker locker(&state.mutex);
+    state.statistics.misses++;
+    return DataContainer::NullPointer();
+  }
+
+  // The modification time orders the spilled entries for eviction
+  QFile file(filePath);
+  if(file.open(QIODevice::ReadOnly))
+  {
+    file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+  }
+
+  EvictedEntries evicted;
+  {
+    QMutexLocker locker(&state.mutex);
+    state.statistics.diskHits++;
+    evicted = insertEntry(state, key, dc);
+  }
+  spillEntries(evicted);
+
+  return cloneTile(dc);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::Store(const QString& key, const DataContainer::Pointer& dc)
+{
+  if(!dc || !dc->getGeometryAs<ImageGeom>())
+  {
+    return;
+  }
+
+  // Arrays that were only preflighted have nothing to cache
+  for(const AttributeMatrix::Pointer& am : dc->getAttributeMatrices())
+  {
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      IDataArray::Pointer data = am->getAttributeArray(arrayName);
+      if(data->getNumberOfTuples() > 0 && data->getVoidPointer(0) == nullptr)
+      {
+        return;
+      }
+    }
+  }
+
+  TileCacheState& state = tileCacheState();
+  if(!IsEnabled())
+  {
+    return;
+  }
+
+  DataContainer::Pointer copy = cloneTile(dc);
+  EvictedEntries evicted;
+  {
+    QMutexLocker locker(&state.mutex);
+    if(!state.enabled)
+    {
+      return;
+    }
+    evicted = insertEntry(state, key, copy);
+  }
+  spillEntries(evicted);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFTileCache::Statistics IMFTileCache::GetStatistics()
+{
+  TileCacheState& state = tileCacheState();
+  Statistics statistics;
+  QString directory;
+  {
+    QMutexLocker locker(&state.mutex);
+    statistics = state.statistics;
+    statistics.memoryEntries = state.entries.size();
+    statistics.memoryBytes = state.memoryBytes;
+    directory = state.diskDirectory;
+  }
+
+  for(const QFileInfo& fi : QDir(directory).entryInfoList({"*.tile"}, QDir::Files))
+  {
+    statistics.diskEntries++;
+    statistics.diskBytes += fi.size();
+  }
+  return statistics;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::ResetStatistics()
+{
+  TileCacheState& state = tileCacheState();
+  QMutexLocker locker(&state.mutex);
+  state.statistics = Statistics();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTileCache::Clear()
+{
+  TileCacheState& state = tileCacheState();
+  QString directory;
+  {
+    QMutexLocker locker(&state.mutex);
+    state.entries.clear();
+    state.usage.clear();
+    state.memoryBytes = 0;
+    state.directoryFingerprints.clear();
+    directory = state.diskDirectory;
+  }
+
+  QDir cacheDir(directory);
+  for(const QString& fileName : cacheDir.entryList({"*.tile"}, QDir::Files))
+  {
+    cacheDir.remove(fileName);
+  }
+}
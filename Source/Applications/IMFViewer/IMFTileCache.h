@@ -0,0 +1,195 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QString>
+
+#include "SIMPLib/Common/SIMPLArray.hpp"
+#include "SIMPLib/DataContainers/DataContainer.h"
+
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+
+/**
+ * @brief The IMFTileCache class keeps decoded montage tiles and images for the whole process,
+ * so importing the same files again with another display type or tile range does not decode
+ * them again.  Entries are keyed by a hash of the path, size and modification time of the
+ * files they were decoded from and of every setting that changes the decoded pixels.  The
+ * least recently used entries are dropped once the cache grows past its memory limit, or
+ * written to the disk cache directory when spilling is enabled and read back from there by a
+ * later lookup.
+ *
+ * Store and Lookup copy the arrays of a tile, so the data containers given to and returned
+ * by the cache can be modified in place without changing the cached tile.
+ */
+class IMFTileCache
+{
+public:
+  struct Statistics
+  {
+    qint64 hits = 0;
+    qint64 diskHits = 0;
+    qint64 misses = 0;
+    qint64 spills = 0;
+    int memoryEntries = 0;
+    qint64 memoryBytes = 0;
+    int diskEntries = 0;
+    qint64 diskBytes = 0;
+  };
+
+  // A tile as decoded by the import filter alone, and a tile after its whole single tile pipeline
+  static const char* ImportStage;
+  static const char* TileStage;
+
+  /**
+   * @brief Returns the directory entries are spilled to when no directory is given
+   * @return
+   */
+  static QString DefaultDiskDirectory();
+
+  /**
+   * @brief Returns the cache key for an image file read on its own
+   * @param filePath
+   * @return
+   */
+  static QString ComputeFileKey(const QString& filePath);
+
+  /**
+   * @brief Returns the cache key for a montage tile.  The key covers the identity of the input
+   * file and the files next to it, the slice, the tile position and the settings that change
+   * the tile decoded at the stage, but not the tile range or the display type.
+   * @param settings
+   * @param slice
+   * @param stage
+   * @param position
+   * @return
+   */
+  static QString ComputeTileKey(const IMFMontagePipelineBuilder::MontageSettings& settings, int slice, const QString& stage, const IntVec2Type& position);
+
+  /**
+   * @brief Sets whether lookups and stores are performed
+   * @param enabled
+   */
+  static void SetEnabled(bool enabled);
+
+  /**
+   * @brief Returns whether lookups and stores are performed
+   * @return
+   */
+  static bool IsEnabled();
+
+  /**
+   * @brief Sets the number of bytes the cached tiles may hold in memory
+   * @param bytes
+   */
+  static void SetMemoryLimit(qint64 bytes);
+
+  /**
+   * @brief Returns the number of bytes the cached tiles may hold in memory
+   * @return
+   */
+  static qint64 GetMemoryLimit();
+
+  /**
+   * @brief Sets whether tiles dropped from memory are written to the disk cache directory
+   * @param enabled
+   */
+  static void SetDiskSpillEnabled(bool enabled);
+
+  /**
+   * @brief Returns whether tiles dropped from memory are written to the disk cache directory
+   * @return
+   */
+  static bool IsDiskSpillEnabled();
+
+  /**
+   * @brief Sets the disk cache directory
+   * @param directory
+   */
+  static void SetDiskDirectory(const QString& directory);
+
+  /**
+   * @brief Returns the disk cache directory
+   * @return
+   */
+  static QString GetDiskDirectory();
+
+  /**
+   * @brief Sets the maximum size of the disk cache directory in bytes
+   * @param bytes
+   */
+  static void SetDiskLimit(qint64 bytes);
+
+  /**
+   * @brief Returns the maximum size of the disk cache directory in bytes
+   * @return
+   */
+  static qint64 GetDiskLimit();
+
+  /**
+   * @brief Returns a new data container with the geometry and arrays cached for the key, or
+   * a null pointer if the key is not cached in memory or on disk
+   * @param key
+   * @return
+   */
+  static DataContainer::Pointer Lookup(const QString& key);
+
+  /**
+   * @brief Caches the image geometry and attribute arrays of the data container for the key
+   * @param key
+   * @param dc
+   */
+  static void Store(const QString& key, const DataContainer::Pointer& dc);
+
+  /**
+   * @brief Returns the lookup counts since the last reset and the current size of the cache
+   * @return
+   */
+  static Statistics GetStatistics();
+
+  /**
+   * @brief Resets the lookup counts
+   */
+  static void ResetStatistics();
+
+  /**
+   * @brief Removes every entry from memory and from the disk cache directory
+   */
+  static void Clear();
+
+private:
+  IMFTileCache() = delete;
+};
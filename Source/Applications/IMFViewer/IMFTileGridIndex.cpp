@@ -0,0 +1,227 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFTileGridIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace
+{
+// Fraction of the tile extent two positions can differ by and still share a row or column
+const double k_ExtentTolerance = 0.25;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double median(std::vector<double> values)
+{
+  if(values.empty())
+  {
+    return 0.0;
+  }
+
+  std::vector<double>::iterator middle = values.begin() + values.size() / 2;
+  std::nth_element(values.begin(), middle, values.end());
+  return *middle;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFTileGridIndex::IMFTileGridIndex(const std::vector<Tile>& tiles)
+{
+  std::vector<double> xValues;
+  std::vector<double> yValues;
+  std::vector<double> widths;
+  std::vector<double> heights;
+  for(const Tile& tile : tiles)
+  {
+    xValues.push_back(tile.x);
+    yValues.push_back(tile.y);
+    if(tile.width > 0.0)
+    {
+      widths.push_back(tile.width);
+    }
+    if(tile.height > 0.0)
+    {
+      heights.push_back(tile.height);
+    }
+  }
+
+  m_ColumnCount = ClusterAxis(xValues, AxisTolerance(xValues, widths), m_Columns);
+  m_RowCount = ClusterAxis(yValues, AxisTolerance(yValues, heights), m_Rows);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFTileGridIndex::~IMFTileGridIndex() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFTileGridIndex::getRowCount() const
+{
+  return m_RowCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFTileGridIndex::getColumnCount() const
+{
+  return m_ColumnCount;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFTileGridIndex::getRow(size_t index) const
+{
+  return m_Rows[index];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFTileGridIndex::getColumn(size_t index) const
+{
+  return m_Columns[index];
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<size_t> IMFTileGridIndex::getTileOrder() const
+{
+  std::vector<size_t> order(m_Rows.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) { return m_Rows[a] < m_Rows[b] || (m_Rows[a] == m_Rows[b] && m_Columns[a] < m_Columns[b]); });
+  return order;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+double IMFTileGridIndex::AxisTolerance(const std::vector<double>& values, const std::vector<double>& extents)
+{
+  if(!extents.empty())
+  {
+    return k_ExtentTolerance * median(extents);
+  }
+
+  // Without extents the grid step is estimated from the larger gaps between sorted positions.
+  // Gaps within a row or column are jitter and gaps over a missing tile are a multiple of the step.
+  std::vector<double> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<double> gaps;
+  double maxGap = 0.0;
+  for(size_t i = 1; i < sorted.size(); i++)
+  {
+    gaps.push_back(sorted[i] - sorted[i - 1]);
+    maxGap = std::max(maxGap, gaps.back());
+  }
+
+  std::vector<double> steps;
+  for(double gap : gaps)
+  {
+    if(gap > 0.0 && gap >= maxGap / 3.0)
+    {
+      steps.push_back(gap);
+    }
+  }
+  return 0.5 * median(steps);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFTileGridIndex::ClusterAxis(const std::vector<double>& values, double tolerance, std::vector<int>& clusters)
+{
+  clusters.assign(values.size(), 0);
+  if(values.empty())
+  {
+    return 0;
+  }
+
+  std::vector<size_t> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&values](size_t a, size_t b) { return values[a] < values[b]; });
+
+  // A position starts a new cluster once it is past the tolerance from the cluster's mean,
+  // so a slow drift along a row cannot chain into the next column
+  std::vector<double> means;
+  double sum = 0.0;
+  int count = 0;
+  for(size_t index : order)
+  {
+    double value = values[index];
+    if(count > 0 && value - sum / count > tolerance)
+    {
+      means.push_back(sum / count);
+      sum = 0.0;
+      count = 0;
+    }
+    sum += value;
+    count++;
+    clusters[index] = static_cast<int>(means.size());
+  }
+  means.push_back(sum / count);
+
+  // Clusters are numbered by grid step so that a row or column with no tiles keeps its place
+  std::vector<double> steps;
+  for(size_t i = 1; i < means.size(); i++)
+  {
+    steps.push_back(means[i] - means[i - 1]);
+  }
+  double step = median(steps);
+
+  std::vector<int> gridIndices(means.size(), 0);
+  for(size_t i = 1; i < means.size(); i++)
+  {
+    int gridIndex = static_cast<int>(std::lround((means[i] - means[0]) / step));
+    gridIndices[i] = std::max(gridIndex, gridIndices[i - 1] + 1);
+  }
+
+  for(int& cluster : clusters)
+  {
+    cluster = gridIndices[cluster];
+  }
+  return gridIndices.back() + 1;
+}
@@ -0,0 +1,125 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief The IMFTileGridIndex class assigns montage tiles to the rows and columns of their
+ * grid from the tile positions alone.  The x and y positions are clustered separately, each
+ * in a single sorted pass, so a tile's column is shared with every tile above and below it
+ * even when tiles are missing from the grid or the rows are slightly staggered.
+ */
+class IMFTileGridIndex
+{
+public:
+  struct Tile
+  {
+    double x = 0.0;
+    double y = 0.0;
+
+    // The extents set the clustering tolerance.  Zero means the extent is unknown.
+    double width = 0.0;
+    double height = 0.0;
+  };
+
+  IMFTileGridIndex(const std::vector<Tile>& tiles);
+  ~IMFTileGridIndex();
+
+  /**
+   * @brief Returns the number of rows in the grid, including rows between the first and
+   * last one that have no tiles
+   * @return
+   */
+  int getRowCount() const;
+
+  /**
+   * @brief Returns the number of columns in the grid, including columns between the first
+   * and last one that have no tiles
+   * @return
+   */
+  int getColumnCount() const;
+
+  /**
+   * @brief Returns the row of the tile
+   * @param index
+   * @return
+   */
+  int getRow(size_t index) const;
+
+  /**
+   * @brief Returns the column of the tile
+   * @param index
+   * @return
+   */
+  int getColumn(size_t index) const;
+
+  /**
+   * @brief Returns the tile indices ordered by row and then by column
+   * @return
+   */
+  std::vector<size_t> getTileOrder() const;
+
+private:
+  std::vector<int> m_Rows;
+  std::vector<int> m_Columns;
+  int m_RowCount = 0;
+  int m_ColumnCount = 0;
+
+  /**
+   * @brief Returns how far apart two positions on an axis can be and still belong to the same
+   * row or column.  A quarter of the median tile extent is used when the extents are known,
+   * otherwise half of the typical step between neighbouring rows or columns.
+   * @param values
+   * @param extents
+   * @return
+   */
+  static double AxisTolerance(const std::vector<double>& values, const std::vector<double>& extents);
+
+  /**
+   * @brief Groups the positions of one axis into clusters numbered from the lowest position
+   * @param values
+   * @param tolerance
+   * @param clusters The cluster of each position
+   * @return The number of clusters
+   */
+  static int ClusterAxis(const std::vector<double>& values, double tolerance, std::vector<int>& clusters);
+
+  IMFTileGridIndex(const IMFTileGridIndex&); // Copy Constructor Not Implemented
+  void operator=(const IMFTileGridIndex&);   // Operator '=' Not Implemented
+};
@@ -0,0 +1,257 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFTrace.h"
+
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QMutex>
+#include <QtCore/QSaveFile>
+#include <QtCore/QThread>
+
+const char* IMFTrace::StartupCategory = "Startup";
+const char* IMFTrace::ImportCategory = "Import";
+const char* IMFTrace::PipelineCategory = "Pipeline";
+const char* IMFTrace::RenderCategory = "Render";
+
+namespace
+{
+struct TraceEvent
+{
+  QString name;
+  QString category;
+  qint64 start = 0;
+  qint64 duration = 0;
+  int threadId = 0;
+  QJsonObject args;
+};
+
+struct TraceLog
+{
+  QElapsedTimer clock;
+  QMutex mutex;
+  std::vector<TraceEvent> events;
+  QHash<QThread*, int> threadIds;
+  QStringList threadNames;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+TraceLog& traceLog()
+{
+  static TraceLog instance;
+  return instance;
+}
+
+// -----------------------------------------------------------------------------
+// Must be called with the log mutex held
+// -----------------------------------------------------------------------------
+int currentThreadId(TraceLog& log)
+{
+  QThread* thread = QThread::currentThread();
+  if(log.threadIds.contains(thread))
+  {
+    return log.threadIds.value(thread);
+  }
+
+  int threadId = log.threadNames.size();
+  QString threadName = thread->objectName();
+  if(QCoreApplication::instance() != nullptr && thread == QCoreApplication::instance()->thread())
+  {
+    threadName = "Main Thread";
+  }
+  else if(threadName.isEmpty())
+  {
+    threadName = QString("Worker %1").arg(threadId);
+  }
+
+  log.threadIds.insert(thread, threadId);
+  log.threadNames.push_back(threadName);
+  return threadId;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFTrace::Now()
+{
+  TraceLog& log = traceLog();
+  QMutexLocker locker(&log.mutex);
+  if(!log.clock.isValid())
+  {
+    log.clock.start();
+  }
+  return log.clock.nsecsElapsed() / 1000;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTrace::AddSpan(const QString& name, const QString& category, qint64 start, const QJsonObject& args)
+{
+  qint64 end = Now();
+
+  TraceLog& log = traceLog();
+  QMutexLocker locker(&log.mutex);
+  if(log.events.size() >= static_cast<size_t>(k_MaxEventCount))
+  {
+    return;
+  }
+
+  TraceEvent event;
+  event.name = name;
+  event.category = category;
+  event.start = start;
+  event.duration = end - start;
+  event.threadId = currentThreadId(log);
+  event.args = args;
+  log.events.push_back(event);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int IMFTrace::GetEventCount()
+{
+  TraceLog& log = traceLog();
+  QMutexLocker locker(&log.mutex);
+  return static_cast<int>(log.events.size());
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTrace::Clear()
+{
+  TraceLog& log = traceLog();
+  QMutexLocker locker(&log.mutex);
+  log.events.clear();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QJsonDocument IMFTrace::ToChromeTrace()
+{
+  TraceLog& log = traceLog();
+  QMutexLocker locker(&log.mutex);
+
+  qint64 pid = QCoreApplication::applicationPid();
+  QJsonArray traceEvents;
+  for(int i = 0; i < log.threadNames.size(); i++)
+  {
+    QJsonObject metadata;
+    metadata["name"] = "thread_name";
+    metadata["ph"] = "M";
+    metadata["pid"] = pid;
+    metadata["tid"] = i;
+    metadata["args"] = QJsonObject{{"name", log.threadNames[i]}};
+    traceEvents.push_back(metadata);
+  }
+
+  for(const TraceEvent& event : log.events)
+  {
+    QJsonObject eventObj;
+    eventObj["name"] = event.name;
+    eventObj["cat"] = event.category;
+    eventObj["ph"] = "X";
+    eventObj["ts"] = static_cast<double>(event.start);
+    eventObj["dur"] = static_cast<double>(event.duration);
+    eventObj["pid"] = pid;
+    eventObj["tid"] = event.threadId;
+    if(!event.args.isEmpty())
+    {
+      eventObj["args"] = event.args;
+    }
+    traceEvents.push_back(eventObj);
+  }
+
+  QJsonObject root;
+  root["traceEvents"] = traceEvents;
+  root["displayTimeUnit"] = "ms";
+  return QJsonDocument(root);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFTrace::WriteChromeTrace(const QString& filePath)
+{
+  QJsonDocument doc = ToChromeTrace();
+
+  QDir().mkpath(QFileInfo(filePath).absolutePath());
+  QSaveFile file(filePath);
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    return false;
+  }
+  file.write(doc.toJson(QJsonDocument::Compact));
+  return file.commit();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFTraceSpan::IMFTraceSpan(const QString& name, const QString& category)
+: m_Name(name)
+, m_Category(category)
+, m_Start(IMFTrace::Now())
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFTraceSpan::~IMFTraceSpan()
+{
+  IMFTrace::AddSpan(m_Name, m_Category, m_Start, m_Args);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFTraceSpan::setArg(const QString& key, const QJsonValue& value)
+{
+  m_Args[key] = value;
+}
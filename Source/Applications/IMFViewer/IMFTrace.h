@@ -0,0 +1,126 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QString>
+
+/**
+ * @brief The IMFTrace class collects timed spans from any thread and exports them in the
+ * Chrome trace event format, which chrome://tracing and Perfetto can open.  Timestamps
+ * are microseconds since the first use of the class.  Recording stops once
+ * k_MaxEventCount events have been collected.
+ */
+class IMFTrace
+{
+public:
+  static const int k_MaxEventCount = 500000;
+
+  static const char* StartupCategory;
+  static const char* ImportCategory;
+  static const char* PipelineCategory;
+  static const char* RenderCategory;
+
+  /**
+   * @brief Returns the current trace time in microseconds
+   * @return
+   */
+  static qint64 Now();
+
+  /**
+   * @brief Records a span that started at the given trace time and ended now
+   * @param name
+   * @param category
+   * @param start
+   * @param args
+   */
+  static void AddSpan(const QString& name, const QString& category, qint64 start, const QJsonObject& args = QJsonObject());
+
+  /**
+   * @brief Returns the number of recorded spans
+   * @return
+   */
+  static int GetEventCount();
+
+  /**
+   * @brief Removes every recorded span
+   */
+  static void Clear();
+
+  /**
+   * @brief Returns the recorded spans as a Chrome trace event document
+   * @return
+   */
+  static QJsonDocument ToChromeTrace();
+
+  /**
+   * @brief Writes the recorded spans to a Chrome trace event JSON file
+   * @param filePath
+   * @return
+   */
+  static bool WriteChromeTrace(const QString& filePath);
+
+private:
+  IMFTrace() = delete;
+};
+
+/**
+ * @brief The IMFTraceSpan class records a span from its construction to its destruction
+ */
+class IMFTraceSpan
+{
+public:
+  IMFTraceSpan(const QString& name, const QString& category);
+  ~IMFTraceSpan();
+
+  /**
+   * @brief Adds an argument that is shown with the span in the trace viewer
+   * @param key
+   * @param value
+   */
+  void setArg(const QString& key, const QJsonValue& value);
+
+private:
+  QString m_Name;
+  QString m_Category;
+  qint64 m_Start = 0;
+  QJsonObject m_Args;
+
+  IMFTraceSpan(const IMFTraceSpan&);   // Copy Constructor Not Implemented
+  void operator=(const IMFTraceSpan&); // Operator '=' Not Implemented
+};
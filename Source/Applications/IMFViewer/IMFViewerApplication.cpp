@@ -44,7 +44,9 @@
 #include <ctime>
 
 #include <QtCore/QFile>
+#include <QtCore/QDebug>
 #include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <QtCore/QPluginLoader>
 #include <QtCore/QThread>
 
@@ -62,6 +64,8 @@
 #include "SVWidgetsLib/QtSupport/QtSSettings.h"
 #include "SVWidgetsLib/Widgets/SVStyle.h"
 
+#include "IMFViewer/IMFPluginLoader.h"
+#include "IMFViewer/IMFTrace.h"
 #include "IMFViewer/IMFViewer_UI.h"
 
 #include "BrandedStrings.h"
@@ -84,6 +88,13 @@ IMFViewerApplication::~IMFViewerApplication()
   this->m_SplashScreen = nullptr;
 
   writeSettings();
+
+  // Traces of whole sessions can be collected without using the menu
+  QString traceFilePath = QString::fromLocal8Bit(qgetenv("IMFVIEWER_TRACE_FILE"));
+  if(!traceFilePath.isEmpty())
+  {
+    IMFTrace::WriteChromeTrace(traceFilePath);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -116,6 +127,7 @@ bool IMFViewerApplication::initialize(int argc, char* argv[])
   this->m_SplashScreen->show();
 
   std::clock_t startClock = std::clock();
+  m_StartupTimer.start();
 
   // Load application plugins.
   QVector<ISIMPLibPlugin*> plugins = loadPlugins();
@@ -142,6 +154,7 @@ bool IMFViewerApplication::initialize(int argc, char* argv[])
     this->m_SplashScreen->finish(nullptr);
   }
   QApplication::instance()->processEvents();
+  addStartupTime(tr("Splash screen"));
 
   return true;
 }
@@ -158,6 +171,22 @@ IMFViewer_UI* IMFViewerApplication::getNewIMFViewerInstance()
 
   setActiveInstance(newInstance);
 
+  // The first window completes the startup
+  if(m_StartupTimer.isValid())
+  {
+    addStartupTime(tr("Main window"));
+
+    qint64 totalTime = 0;
+    qInfo().noquote() << "Startup time breakdown:";
+    for(const QPair<QString, qint64>& startupTime : m_StartupTimes)
+    {
+      qInfo().noquote() << QString("  %1: %2 ms").arg(startupTime.first).arg(startupTime.second);
+      totalTime += startupTime.second;
+    }
+    qInfo().noquote() << QString("  Total: %1 ms").arg(totalTime);
+    m_StartupTimer.invalidate();
+  }
+
   return newInstance;
 }
 
@@ -177,119 +206,8 @@ void IMFViewerApplication::loadStyleSheet(const QString& sheetName)
 // -----------------------------------------------------------------------------
 QVector<ISIMPLibPlugin*> IMFViewerApplication::loadPlugins()
 {
-  QStringList pluginDirs;
-  pluginDirs << applicationDirPath();
-
-  QDir aPluginDir = QDir(applicationDirPath());
-  qDebug() << "Loading " << BrandedStrings::ApplicationName << " Plugins....";
-  QString thePath;
-
-#if defined(Q_OS_WIN)
-  if(aPluginDir.cd("Plugins"))
-  {
-    thePath = aPluginDir.absolutePath();
-    pluginDirs << thePath;
-  }
-#elif defined(Q_OS_MAC)
-  // Look to see if we are inside an .app package or inside the 'tools' directory
-  if(aPluginDir.dirName() == "MacOS")
-  {
-    aPluginDir.cdUp();
-    thePath = aPluginDir.absolutePath() + "/Plugins";
-    qDebug() << "  Adding Path " << thePath;
-    pluginDirs << thePath;
-    aPluginDir.cdUp();
-    aPluginDir.cdUp();
-    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
-    chdir(aPluginDir.absolutePath().toLatin1().constData());
-  }
-  if(aPluginDir.dirName() == "bin")
-  {
-    aPluginDir.cdUp();
-    // We need this because Apple (in their infinite wisdom) changed how the current working directory is set in OS X 10.9 and above. Thanks Apple.
-    chdir(aPluginDir.absolutePath().toLatin1().constData());
-  }
-  // aPluginDir.cd("Plugins");
-  thePath = aPluginDir.absolutePath() + "/Plugins";
-  qDebug() << "  Adding Path " << thePath;
-  pluginDirs << thePath;
-
-// This is here for Xcode compatibility
-#ifdef CMAKE_INTDIR
-  aPluginDir.cdUp();
-  thePath = aPluginDir.absolutePath() + "/Plugins/" + CMAKE_INTDIR;
-  pluginDirs << thePath;
-#endif
-#else
-  // We are on Linux - I think
-  // Try the current location of where the application was launched from which is
-  // typically the case when debugging from a build tree
-  if(aPluginDir.cd("Plugins"))
-  {
-    thePath = aPluginDir.absolutePath();
-    pluginDirs << thePath;
-    aPluginDir.cdUp(); // Move back up a directory level
-  }
-
-  if(thePath.isEmpty())
-  {
-    // Now try moving up a directory which is what should happen when running from a
-    // proper distribution of SIMPLView
-    aPluginDir.cdUp();
-    if(aPluginDir.cd("Plugins"))
-    {
-      thePath = aPluginDir.absolutePath();
-      pluginDirs << thePath;
-      aPluginDir.cdUp(); // Move back up a directory level
-      int no_error = chdir(aPluginDir.absolutePath().toLatin1().constData());
-      if(no_error < 0)
-      {
-        qDebug() << "Could not set the working directory.";
-      }
-    }
-  }
-#endif
-
-  QByteArray pluginEnvPath = qgetenv("SIMPL_PLUGIN_PATH");
-  qDebug() << "SIMPL_PLUGIN_PATH:" << pluginEnvPath;
-
-  char sep = ';';
-#if defined(Q_OS_WIN)
-  sep = ':';
-#endif
-  QList<QByteArray> envPaths = pluginEnvPath.split(sep);
-  foreach(QByteArray envPath, envPaths)
-  {
-    if(envPath.size() > 0)
-    {
-      pluginDirs << QString::fromLatin1(envPath);
-    }
-  }
-
-  int dupes = pluginDirs.removeDuplicates();
-  qDebug() << "Removed " << dupes << " duplicate Plugin Paths";
-  QStringList pluginFilePaths;
-
-  foreach(QString pluginDirString, pluginDirs)
-  {
-    qDebug() << "Plugin Directory being Searched: " << pluginDirString;
-    aPluginDir = QDir(pluginDirString);
-    foreach(QString fileName, aPluginDir.entryList(QDir::Files))
-    {
-//   qDebug() << "File: " << fileName() << "\n";
-#ifdef QT_DEBUG
-      if(fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive))
-#else
-      if(fileName.endsWith(".guiplugin", Qt::CaseSensitive)            // We want ONLY Release plugins
-         && !fileName.endsWith("_debug.guiplugin", Qt::CaseSensitive)) // so ignore these plugins
-#endif
-      {
-        pluginFilePaths << aPluginDir.absoluteFilePath(fileName);
-        // qWarning(aPluginDir.absoluteFilePath(fileName).toLatin1(), "%s");
-        // qDebug() << "Adding " << aPluginDir.absoluteFilePath(fileName)() << "\n";
-      }
-    }
-  }
+  QStringList pluginFilePaths = IMFPluginLoader::FindPluginFilePaths();
+  addStartupTime(tr("Plugin search"));
 
   FilterManager* filterManager = FilterManager::Instance();
   FilterWidgetManager* fwm = FilterWidgetManager::Instance();
@@ -308,11 +226,34 @@ QVector<ISIMPLibPlugin*> IMFViewerApplication::loadPlugins()
     loadingMap.insert(proxy->getPluginName(), proxy->getEnabled());
   }
 
+  QString manifestFilePath = IMFPluginLoader::DefaultManifestFilePath();
+  IMFPluginLoader::Manifest manifest = IMFPluginLoader::ReadManifest(manifestFilePath);
+  IMFPluginLoader::Manifest updatedManifest;
+  addStartupTime(tr("Plugin manifest read"));
+
+  // Deferred plugins register their filter widgets when they are loaded
+  IMFPluginLoader::SetDeferredPluginLoadedFunction([fwm](ISIMPLibPlugin* plugin) { plugin->registerFilterWidgets(fwm); });
+
+  int loadedCount = 0;
+  int deferredCount = 0;
+
   // Now that we have a sorted list of plugins, go ahead and load them all from the
   // file system and add each to the toolbar and menu
   foreach(QString path, pluginFilePaths)
   {
+    // Enabled plugins that have not changed since they were recorded are only loaded
+    // once one of their filters is created
+    IMFPluginLoader::PluginRecord record = manifest.value(path);
+    if(manifest.contains(path) && loadingMap.value(record.PluginName, true) && IMFPluginLoader::IsPluginRecordCurrent(record))
+    {
+      IMFPluginLoader::RegisterDeferredFilters(record);
+      updatedManifest.insert(path, record);
+      deferredCount++;
+      continue;
+    }
+
     qDebug() << "Plugin Being Loaded:" << path;
+    IMFTraceSpan pluginSpan(tr("Load Plugin %1").arg(QFileInfo(path).fileName()), IMFTrace::StartupCategory);
     QApplication::instance()->processEvents();
     QPluginLoader* loader = new QPluginLoader(path);
     QFileInfo fi(path);
@@ -331,8 +272,9 @@ QVector<ISIMPLibPlugin*> IMFViewerApplication::loadPlugins()
           this->m_SplashScreen->showMessage(msg, Qt::AlignVCenter | Qt::AlignRight, Qt::white);
           // ISIMPLibPlugin::Pointer ipPluginPtr(ipPlugin);
           ipPlugin->registerFilterWidgets(fwm);
-          ipPlugin->registerFilters(filterManager);
+          QStringList filterClassNames = IMFPluginLoader::RegisterPluginFilters(ipPlugin);
           ipPlugin->setDidLoad(true);
+          updatedManifest.insert(path, IMFPluginLoader::CreatePluginRecord(path, ipPlugin, filterClassNames));
         }
         else
         {
@@ -343,6 +285,7 @@ QVector<ISIMPLibPlugin*> IMFViewerApplication::loadPlugins()
         pluginManager->addPlugin(ipPlugin);
       }
       m_PluginLoaders.push_back(loader);
+      loadedCount++;
     }
     else
     {
@@ -360,10 +303,31 @@ QVector<ISIMPLibPlugin*> IMFViewerApplication::loadPlugins()
       delete loader;
     }
   }
+  addStartupTime(tr("Plugin loading (%1 loaded, %2 deferred)").arg(loadedCount).arg(deferredCount));
+
+  // Disabled plugins are never recorded, so the manifest is only rewritten when a record changed
+  if(updatedManifest != manifest)
+  {
+    IMFPluginLoader::WriteManifest(manifestFilePath, updatedManifest);
+    addStartupTime(tr("Plugin manifest write"));
+  }
 
   return pluginManager->getPluginsVector();
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewerApplication::addStartupTime(const QString& phase)
+{
+  if(m_StartupTimer.isValid())
+  {
+    qint64 elapsed = m_StartupTimer.restart();
+    m_StartupTimes.push_back(qMakePair(phase, elapsed));
+    IMFTrace::AddSpan(phase, IMFTrace::StartupCategory, IMFTrace::Now() - elapsed * 1000);
+  }
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
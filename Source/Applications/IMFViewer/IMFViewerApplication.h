@@ -37,7 +37,10 @@
 
 #pragma once
 
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QObject>
+#include <QtCore/QPair>
+#include <QtCore/QVector>
 #include <QtWidgets/QMenuBar>
 
 #include <QtWidgets/QApplication>
@@ -82,6 +85,9 @@ private:
   int m_MinSplashTime = 3;
   QVector<QPluginLoader*> m_PluginLoaders;
 
+  QElapsedTimer m_StartupTimer;
+  QVector<QPair<QString, qint64>> m_StartupTimes;
+
   /**
    * @brief loadStyleSheet
    * @param sheetName
@@ -94,6 +100,13 @@ private:
    */
   QVector<ISIMPLibPlugin*> loadPlugins();
 
+  /**
+   * @brief Records the time since the previous startup phase ended.  The breakdown is
+   * printed when the first main window has been created.
+   * @param phase
+   */
+  void addStartupTime(const QString& phase);
+
   /**
    * @brief setActiveInstance
    * @param instance
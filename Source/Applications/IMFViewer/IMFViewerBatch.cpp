@@ -0,0 +1,557 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDebug>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QPluginLoader>
+#include <QtCore/QSaveFile>
+
+#include "SIMPLib/Filtering/QMetaObjectUtilities.h"
+#include "SIMPLib/Plugin/ISIMPLibPlugin.h"
+
+#include "IMFViewer/IMFBatchRunner.h"
+#include "IMFViewer/IMFBenchmark.h"
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+#include "IMFViewer/IMFPluginLoader.h"
+#include "IMFViewer/IMFTileCache.h"
+#include "IMFViewer/IMFTrace.h"
+
+namespace
+{
+using MontageEntry = std::pair<IMFMontagePipelineBuilder::MontageSettings, QString>;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool parseValues(const QString& text, int count, QVector<double>& values)
+{
+  QStringList tokens = text.split(',', QString::SkipEmptyParts);
+  if(tokens.size() != count)
+  {
+    return false;
+  }
+
+  values.clear();
+  for(const QString& token : tokens)
+  {
+    bool ok = false;
+    values.push_back(token.trimmed().toDouble(&ok));
+    if(!ok)
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readCommandLineSettings(const QCommandLineParser& parser, IMFMontagePipelineBuilder::MontageSettings& settings, QString& errorMessage)
+{
+  bool ok = false;
+  settings.Type = IMFMontagePipelineBuilder::MontageTypeFromString(parser.value("type"), &ok);
+  if(!ok)
+  {
+    errorMessage = QObject::tr("Unknown montage type '%1'").arg(parser.value("type"));
+    return false;
+  }
+
+  settings.InputFilePath = parser.value("input");
+  if(parser.isSet("name"))
+  {
+    settings.MontageName = parser.value("name");
+  }
+
+  QVector<double> values;
+  if(parser.isSet("start"))
+  {
+    if(!parseValues(parser.value("start"), 2, values))
+    {
+      errorMessage = QObject::tr("--start expects 'column,row'");
+      return false;
+    }
+    settings.MontageStart = {static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1])};
+  }
+  if(parser.isSet("end"))
+  {
+    if(!parseValues(parser.value("end"), 2, values))
+    {
+      errorMessage = QObject::tr("--end expects 'column,row'");
+      return false;
+    }
+    settings.MontageEnd = {static_cast<int32_t>(values[0]), static_cast<int32_t>(values[1])};
+  }
+  if(parser.isSet("spacing"))
+  {
+    if(!parseValues(parser.value("spacing"), 3, values))
+    {
+      errorMessage = QObject::tr("--spacing expects 'x,y,z'");
+      return false;
+    }
+    settings.OverrideSpacing = true;
+    settings.Spacing = {static_cast<float>(values[0]), static_cast<float>(values[1]), static_cast<float>(values[2])};
+  }
+  if(parser.isSet("origin"))
+  {
+    if(!parseValues(parser.value("origin"), 3, values))
+    {
+      errorMessage = QObject::tr("--origin expects 'x,y,z'");
+      return false;
+    }
+    settings.OverrideOrigin = true;
+    settings.Origin = {static_cast<float>(values[0]), static_cast<float>(values[1]), static_cast<float>(values[2])};
+  }
+  if(parser.isSet("length-unit"))
+  {
+    settings.LengthUnit = parser.value("length-unit").toInt();
+  }
+  if(parser.isSet("display"))
+  {
+    settings.Display = IMFMontagePipelineBuilder::DisplayTypeFromString(parser.value("display"), &ok);
+    if(!ok)
+    {
+      errorMessage = QObject::tr("Unknown display type '%1'").arg(parser.value("display"));
+      return false;
+    }
+  }
+
+  if(parser.isSet("decode-threads"))
+  {
+    settings.DecodeThreadCount = std::max(1, parser.value("decode-threads").toInt());
+  }
+
+  settings.ConvertToGrayscale = parser.isSet("grayscale");
+  settings.LowMemoryStitching = parser.isSet("low-memory-stitch");
+  if(parser.isSet("color-weighting"))
+  {
+    if(!parseValues(parser.value("color-weighting"), 3, values))
+    {
+      errorMessage = QObject::tr("--color-weighting expects 'r,g,b'");
+      return false;
+    }
+    settings.ColorWeighting = {static_cast<float>(values[0]), static_cast<float>(values[1]), static_cast<float>(values[2])};
+  }
+
+  if(parser.isSet("slices"))
+  {
+    if(!parseValues(parser.value("slices"), 2, values))
+    {
+      errorMessage = QObject::tr("--slices expects 'min,max'");
+      return false;
+    }
+    settings.SliceMin = static_cast<int>(values[0]);
+    settings.SliceMax = static_cast<int>(values[1]);
+  }
+  if(parser.isSet("image-prefix"))
+  {
+    settings.ImagePrefix = parser.value("image-prefix");
+  }
+  if(parser.isSet("image-extension"))
+  {
+    settings.ImageExtension = parser.value("image-extension");
+  }
+
+  if(parser.isSet("dc-prefix"))
+  {
+    settings.DataContainerPrefix = parser.value("dc-prefix");
+  }
+  if(parser.isSet("am-name"))
+  {
+    settings.AttributeMatrixName = parser.value("am-name");
+  }
+  if(parser.isSet("da-name"))
+  {
+    settings.DataArrayName = parser.value("da-name");
+  }
+
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool readConfigFile(const QString& filePath, std::vector<MontageEntry>& montageEntries)
+{
+  QFile file(filePath);
+  if(!file.open(QIODevice::ReadOnly))
+  {
+    qCritical().noquote() << QObject::tr("Could not open config file %1").arg(filePath);
+    return false;
+  }
+
+  QJsonParseError parseError;
+  QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+  if(parseError.error != QJsonParseError::NoError || !doc.isObject())
+  {
+    qCritical().noquote() << QObject::tr("Could not parse config file %1: %2").arg(filePath, parseError.errorString());
+    return false;
+  }
+
+  QJsonArray montages;
+  QJsonObject root = doc.object();
+  if(root.contains("Montages"))
+  {
+    montages = root["Montages"].toArray();
+  }
+  else
+  {
+    montages.append(root);
+  }
+
+  bool success = true;
+  for(const QJsonValue& value : montages)
+  {
+    QJsonObject montageObj = value.toObject();
+    IMFMontagePipelineBuilder::MontageSettings settings;
+    QString outputFilePath = montageObj["OutputFile"].toString();
+    if(!IMFMontagePipelineBuilder::ReadSettings(montageObj, settings) || outputFilePath.isEmpty())
+    {
+      qCritical().noquote() << QObject::tr("Invalid montage entry in %1: 'Type' and 'OutputFile' are required").arg(filePath);
+      success = false;
+      continue;
+    }
+
+    montageEntries.push_back({settings, outputFilePath});
+  }
+
+  return success;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int runBenchmark(const QCommandLineParser& parser, const std::vector<MontageEntry>& montageEntries)
+{
+  // Every repeat decodes the tiles again, so the import is timed rather than the tile cache
+  IMFTileCache::SetEnabled(false);
+
+  IMFBenchmark benchmark;
+  benchmark.setRepeatCount(parser.value("benchmark-repeat").toInt());
+  benchmark.setStreamingEnabled(parser.isSet("stream"));
+
+  std::vector<IMFBenchmark::Result> results;
+  auto runMontage = [&](const IMFMontagePipelineBuilder::MontageSettings& settings, int tileSize) {
+    qInfo().noquote() << QObject::tr("Benchmarking %1").arg(settings.MontageName);
+    IMFBenchmark::Result result = benchmark.run(settings);
+    result.TileSize = tileSize;
+    if(result.ErrorCode < 0)
+    {
+      qCritical().noquote() << QObject::tr("Montage '%1' failed with error code %2").arg(settings.MontageName).arg(result.ErrorCode);
+    }
+    results.push_back(result);
+  };
+
+  for(const MontageEntry& montageEntry : montageEntries)
+  {
+    runMontage(montageEntry.first, 0);
+  }
+
+  // Synthetic grids are only generated when no montages were given
+  if(montageEntries.empty())
+  {
+    int tileSize = parser.value("benchmark-tile-size").toInt();
+    if(tileSize <= 0)
+    {
+      qCritical().noquote() << QObject::tr("--benchmark-tile-size expects a positive size");
+      return 1;
+    }
+
+    QVector<int> gridSizes;
+    for(const QString& token : parser.value("benchmark-grids").split(',', QString::SkipEmptyParts))
+    {
+      int gridSize = token.trimmed().toInt();
+      if(gridSize <= 0)
+      {
+        qCritical().noquote() << QObject::tr("--benchmark-grids expects positive tile counts");
+        return 1;
+      }
+      gridSizes.push_back(gridSize);
+    }
+
+    // Every type is checked before the first grid is written, so an unsupported type does not stop a run halfway
+    QVector<IMFMontagePipelineBuilder::MontageType> types;
+    for(const QString& typeName : parser.value("benchmark-types").split(',', QString::SkipEmptyParts))
+    {
+      bool ok = false;
+      IMFMontagePipelineBuilder::MontageType type = IMFMontagePipelineBuilder::MontageTypeFromString(typeName.trimmed(), &ok);
+      if(!ok)
+      {
+        qCritical().noquote() << QObject::tr("Unknown montage type '%1'").arg(typeName);
+        return 1;
+      }
+      if(!IMFBenchmark::IsSyntheticTypeSupported(type))
+      {
+        qCritical().noquote() << QObject::tr("Synthetic %1 montages are not supported.  Benchmark them with a configuration file that points at a real dataset instead.").arg(typeName.trimmed());
+        return 1;
+      }
+      types.push_back(type);
+    }
+
+    for(IMFMontagePipelineBuilder::MontageType type : types)
+    {
+      for(int gridSize : gridSizes)
+      {
+        IMFMontagePipelineBuilder::MontageSettings settings;
+        QString errorMessage;
+        if(!benchmark.createSyntheticMontage(type, gridSize, gridSize, tileSize, settings, errorMessage))
+        {
+          qCritical().noquote() << errorMessage;
+          return 1;
+        }
+        runMontage(settings, tileSize);
+      }
+    }
+  }
+
+  QSaveFile file(parser.value("benchmark"));
+  if(!file.open(QIODevice::WriteOnly))
+  {
+    qCritical().noquote() << QObject::tr("Could not write %1").arg(parser.value("benchmark"));
+    return 1;
+  }
+  file.write(QJsonDocument(IMFBenchmark::ToJson(results, parser.value("benchmark-label"))).toJson());
+  if(!file.commit())
+  {
+    qCritical().noquote() << QObject::tr("Could not write %1").arg(parser.value("benchmark"));
+    return 1;
+  }
+
+  bool success = std::all_of(results.begin(), results.end(), [](const IMFBenchmark::Result& result) { return result.ErrorCode >= 0; });
+  return success ? 0 : 1;
+}
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  QCoreApplication::setApplicationName("IMFViewerBatch");
+  QCoreApplication::setOrganizationDomain("bluequartz.net");
+  QCoreApplication::setOrganizationName("BlueQuartz Software");
+
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Imports, registers and stitches montages without a user interface and writes the result to disk.");
+  parser.addHelpOption();
+  parser.addPositionalArgument("configs", "JSON montage configuration files.  Each file holds one montage object or a \"Montages\" array.", "[configs...]");
+  parser.addOptions({
+      {"type", "Montage type: DREAM3D, Fiji, Robomet, Zeiss or ZeissZen.", "type"},
+      {"input", "Montage input file (configuration, XML or .dream3d file).", "file"},
+      {"output", "Output file.  A .dream3d extension writes the data container array, any other extension writes the stitched image.", "file"},
+      {"name", "Montage name.", "name"},
+      {"start", "First tile as 'column,row'.", "column,row"},
+      {"end", "Last tile as 'column,row'.", "column,row"},
+      {"spacing", "Override the tile spacing.", "x,y,z"},
+      {"origin", "Override the tile origin.", "x,y,z"},
+      {"length-unit", "Length unit index used with the spacing override.", "index"},
+      {"display", "Display type: Montage, SideBySide or Outline.", "display"},
+      {"decode-threads", "Number of Fiji tiles decoded at the same time.", "count"},
+      {"grayscale", "Convert Zeiss tiles to grayscale."},
+      {"color-weighting", "Grayscale color weighting.", "r,g,b"},
+      {"slices", "Robomet slice range.", "min,max"},
+      {"image-prefix", "Robomet image file prefix.", "prefix"},
+      {"image-extension", "Robomet image file extension.", "extension"},
+      {"dc-prefix", "DREAM3D tile data container prefix.", "prefix"},
+      {"am-name", "DREAM3D tile attribute matrix name.", "name"},
+      {"da-name", "DREAM3D tile data array name.", "name"},
+      {"jobs", "Number of montages that execute at the same time.", "count"},
+      {"stream", "Stitch montages with a .dream3d output file strip by strip straight to disk.  Use this for montages larger than memory."},
+      {"low-memory-stitch", "Stitch montages in memory strip by strip, releasing the tiles as they are copied, instead of with the ITK stitching filter.  "
+                            "Overlapping tiles are not blended."},
+      {"no-registration-cache", "Always run the tile registration instead of reusing earlier registration results."},
+      {"no-tile-cache", "Decode every tile instead of reusing the tiles decoded for an earlier montage of the same files."},
+      {"tile-cache-dir", "Spill decoded tiles that do not fit in memory to this directory, where later runs find them as well.", "directory"},
+      {"trace", "Write the timing of plugin loading, preflights and filter executions to a Chrome trace event file.", "file"},
+      {"benchmark", "Time the preflight, import, registration, stitching and viewer handoff of each montage instead of writing it, and write the results as JSON.  "
+                    "Synthetic tile grids are benchmarked when no montage is given.",
+       "file"},
+      {"benchmark-types", "Montage types of the synthetic grids: Fiji and/or DREAM3D.", "types", "Fiji,DREAM3D"},
+      {"benchmark-grids", "Tiles per side of the synthetic grids.", "n,n,...", "4,8,16"},
+      {"benchmark-tile-size", "Width and height of the synthetic tiles in pixels.", "pixels", "256"},
+      {"benchmark-repeat", "Number of times each montage is imported.  The median time is reported.", "count", "3"},
+      {"benchmark-label", "Label stored with the results, such as the commit being measured.", "label"},
+  });
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  parser.addOptions({
+      {"render-size", "Render image outputs without a window at this size instead of writing the stitched image at full resolution.  "
+                      "A size of 0 follows the aspect ratio of the montage, and 0,0 renders one pixel per montage pixel.",
+       "width,height"},
+      {"render-tile-size", "Largest render window used to draw --render-size images.  Larger images are drawn in tiles.", "pixels", "2048"},
+      {"render-session", "Render the DREAM3D datasets of a saved session into the --output image.", "file"},
+  });
+#endif
+  parser.process(app);
+
+  bool renderSession = false;
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+  renderSession = parser.isSet("render-session");
+#endif
+
+  QStringList configFiles = parser.positionalArguments();
+  if(configFiles.isEmpty() && !parser.isSet("type") && !parser.isSet("benchmark") && !renderSession)
+  {
+    parser.showHelp(1);
+  }
+
+  QMetaObjectUtilities::RegisterMetaTypes();
+  qRegisterMetaType<DataContainerArray::Pointer>();
+
+  QVector<QPluginLoader*> pluginLoaders;
+  QStringList pluginErrors;
+  IMFPluginLoader::LoadFilterPlugins(IMFPluginLoader::FindPluginFilePaths(), pluginLoaders, pluginErrors);
+  for(const QString& pluginError : pluginErrors)
+  {
+    qCritical().noquote() << pluginError;
+  }
+
+  bool success = true;
+  std::vector<MontageEntry> montageEntries;
+  for(const QString& configFile : configFiles)
+  {
+    success = readConfigFile(configFile, montageEntries) && success;
+  }
+
+  if(parser.isSet("type"))
+  {
+    IMFMontagePipelineBuilder::MontageSettings settings;
+    QString errorMessage;
+    if(!parser.isSet("output") && !parser.isSet("benchmark"))
+    {
+      qCritical().noquote() << QObject::tr("--output is required when the montage is given on the command line");
+      success = false;
+    }
+    else if(!readCommandLineSettings(parser, settings, errorMessage))
+    {
+      qCritical().noquote() << errorMessage;
+      success = false;
+    }
+    else
+    {
+      montageEntries.push_back({settings, parser.value("output")});
+    }
+  }
+
+  int exitCode = success ? 0 : 1;
+  if(parser.isSet("benchmark"))
+  {
+    exitCode = success ? runBenchmark(parser, montageEntries) : 1;
+  }
+  else
+  {
+    IMFBatchRunner runner;
+    if(parser.isSet("jobs"))
+    {
+      runner.setJobCount(parser.value("jobs").toInt());
+    }
+    runner.setRegistrationCacheEnabled(!parser.isSet("no-registration-cache"));
+    IMFTileCache::SetEnabled(!parser.isSet("no-tile-cache"));
+    if(parser.isSet("tile-cache-dir"))
+    {
+      IMFTileCache::SetDiskDirectory(parser.value("tile-cache-dir"));
+      IMFTileCache::SetDiskSpillEnabled(true);
+    }
+    runner.setStreamingEnabled(parser.isSet("stream"));
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+    if(parser.isSet("render-size") || renderSession)
+    {
+      IMFOffscreenRenderer::Options renderOptions;
+      renderOptions.MaxTileSize = parser.value("render-tile-size").toInt();
+      QVector<double> values;
+      if(parser.isSet("render-size") && (!parseValues(parser.value("render-size"), 2, values) || values[0] < 0 || values[1] < 0))
+      {
+        qCritical().noquote() << QObject::tr("--render-size expects 'width,height'");
+        success = false;
+      }
+      else if(parser.isSet("render-size"))
+      {
+        renderOptions.Width = static_cast<int>(values[0]);
+        renderOptions.Height = static_cast<int>(values[1]);
+      }
+      runner.setRenderOptions(renderOptions);
+    }
+#endif
+
+    for(const MontageEntry& montageEntry : montageEntries)
+    {
+      success = runner.addMontage(montageEntry.first, montageEntry.second) && success;
+    }
+
+#if defined(IMFViewerBatch_ENABLE_RENDERING)
+    if(renderSession)
+    {
+      if(!parser.isSet("output") || parser.isSet("type"))
+      {
+        qCritical().noquote() << QObject::tr("--render-session needs an --output image and can not be combined with --type");
+        success = false;
+      }
+      else
+      {
+        success = runner.addSession(parser.value("render-session"), parser.value("output")) && success;
+      }
+    }
+#endif
+
+    exitCode = success ? 0 : 1;
+    if(runner.getPendingCount() > 0)
+    {
+      QObject::connect(&runner, &IMFBatchRunner::finished, &app, [&app](int failureCount) { app.exit(failureCount > 0 ? 1 : 0); });
+      exitCode = app.exec() | exitCode;
+    }
+
+    if(IMFTileCache::IsEnabled())
+    {
+      IMFTileCache::Statistics statistics = IMFTileCache::GetStatistics();
+      qInfo().noquote() << QObject::tr("Decoded tile cache: %1 hits from memory, %2 hits from disk, %3 misses").arg(statistics.hits).arg(statistics.diskHits).arg(statistics.misses);
+    }
+  }
+
+  if(parser.isSet("trace") && !IMFTrace::WriteChromeTrace(parser.value("trace")))
+  {
+    qCritical().noquote() << QObject::tr("The trace could not be written to %1").arg(parser.value("trace"));
+  }
+
+  return exitCode;
+}
@@ -35,16 +35,38 @@
 
 #include "IMFViewer_UI.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+
 #include <QDesktopServices>
 #include <QtConcurrent>
 #include <vtkImageData.h>
 
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QMimeDatabase>
+#include <QtCore/QPointer>
+#include <QtCore/QThread>
+#include <QtCore/QThreadPool>
+
+#include <QVTKOpenGLWidget.h>
 
+#include <QtWidgets/QCheckBox>
+#include <QtWidgets/QDialogButtonBox>
+#include <QtWidgets/QDoubleSpinBox>
 #include <QtWidgets/QFileDialog>
+#include <QtWidgets/QFormLayout>
+#include <QtWidgets/QGridLayout>
+#include <QtWidgets/QHBoxLayout>
+#include <QtWidgets/QInputDialog>
+#include <QtWidgets/QLabel>
 #include <QtWidgets/QMessageBox>
+#include <QtWidgets/QProgressDialog>
+#include <QtWidgets/QPushButton>
+#include <QtWidgets/QSpinBox>
 
 #include "SIMPLib/FilterParameters/FloatVec3.h"
 #include "SIMPLib/FilterParameters/IntVec3FilterParameter.h"
@@ -70,9 +92,10 @@
 #include "SIMPLVtkLib/Dialogs/Utilities/TileConfigFileGenerator.h"
 #include "SIMPLVtkLib/QtWidgets/VSDatasetImporter.h"
 #include "SIMPLVtkLib/QtWidgets/VSFilterFactory.h"
-#include "SIMPLVtkLib/QtWidgets/VSMontageImporter.h"
 #include "SIMPLVtkLib/QtWidgets/VSQueueModel.h"
 #include "SIMPLVtkLib/Visualization/VisualFilters/VSDataSetFilter.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSPipelineFilter.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSSIMPLDataContainerFilter.h"
 
 #include "SIMPLVtkLib/Dialogs/DatasetListWidget.h"
 #include "SIMPLVtkLib/Dialogs/RobometListWidget.h"
@@ -83,10 +106,210 @@
 #include "SIMPLVtkLib/Wizards/ExecutePipeline/ExecutePipelineWizard.h"
 #include "SIMPLVtkLib/Wizards/ExecutePipeline/PipelineWorker.h"
 
+#include "IMFViewer/IMFDream3dWriter.h"
+#include "IMFViewer/IMFHdf5Lock.h"
+#include "IMFViewer/IMFImageImporter.h"
+#include "IMFViewer/IMFIncrementalStitcher.h"
+#include "IMFViewer/IMFLazyTileLoader.h"
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+#include "IMFViewer/IMFOffscreenRenderer.h"
+#include "IMFViewer/IMFPipelinedMontage.h"
+#include "IMFViewer/IMFPipelineScheduler.h"
+#include "IMFViewer/IMFPluginLoader.h"
+#include "IMFViewer/IMFReadRegionFilter.h"
+#include "IMFViewer/IMFRegistrationCache.h"
+#include "IMFViewer/IMFScheduledImporter.h"
+#include "IMFViewer/IMFSessionLoader.h"
+#include "IMFViewer/IMFStreamingStitcher.h"
+#include "IMFViewer/IMFTileCache.h"
+#include "IMFViewer/IMFTileGridIndex.h"
+#include "IMFViewer/IMFTrace.h"
+#include "IMFViewer/IMFVolumeAssembler.h"
+#include "IMFViewer/IMFVtkArrayBridge.h"
+
 #include "BrandedStrings.h"
 
 #include "ui_IMFViewer_UI.h"
 
+namespace
+{
+const char* k_DisplayTypeProperty = "DisplayType";
+
+// Trace time at which the import of the pipeline was requested
+const char* k_TraceStartProperty = "TraceStart";
+
+// Set on montages stitched from displayed tiles, which can later be restitched incrementally
+const char* k_IncrementalStitchProperty = "IncrementalStitch";
+
+// Resolution setting that picks the stitched montage pyramid level from the size of the view
+const int k_MatchViewPyramidLevel = -1;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int preflightImportFilter(const FilterPipeline::Pointer& pipeline)
+{
+  IMFTraceSpan preflightSpan(QObject::tr("Preflight %1").arg(pipeline->getName()), IMFTrace::ImportCategory);
+  AbstractFilter::Pointer importFilter = pipeline->getFilterContainer().front();
+  {
+    QMutexLocker hdf5Locker(IMFHdf5Lock::IsHdf5Filter(importFilter) ? IMFHdf5Lock::Mutex() : nullptr);
+    importFilter->preflight();
+  }
+  int err = importFilter->getErrorCode();
+
+  // The scheduler reserves memory for queued pipelines from this estimate instead of
+  // preflighting them again.  Pipelined montages only ever run their import as a preflight.
+  if(err >= 0 && !IMFPipelinedMontage::IsPipelinedMontage(pipeline))
+  {
+    IMFPipelineScheduler::EstimatePreflightedPipeline(pipeline);
+  }
+  return err;
+}
+
+// -----------------------------------------------------------------------------
+// Pipeline filters hold their data containers as children
+// -----------------------------------------------------------------------------
+void collectDataContainers(const VSAbstractFilter::FilterListType& filters, std::vector<DataContainer::Pointer>& dataContainers)
+{
+  for(VSAbstractFilter* filter : filters)
+  {
+    VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(filter);
+    if(dcFilter != nullptr && dcFilter->getWrappedDataContainer())
+    {
+      dataContainers.push_back(dcFilter->getWrappedDataContainer()->m_DataContainer);
+      continue;
+    }
+
+    collectDataContainers(filter->getChildren(), dataContainers);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void traceDialogToEnqueue(const FilterPipeline::Pointer& pipeline)
+{
+  QVariant traceStartVar = pipeline->property(k_TraceStartProperty);
+  if(traceStartVar.isValid())
+  {
+    IMFTrace::AddSpan(QObject::tr("Dialog To Enqueue"), IMFTrace::ImportCategory, traceStartVar.toLongLong(), QJsonObject{{"Pipeline", pipeline->getName()}});
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Asks for the part of the montage bounds to import.  Returns false if the dialog was canceled.
+// -----------------------------------------------------------------------------
+bool getMontageRegion(const QRectF& bounds, QRectF& region, QWidget* parent)
+{
+  QDialog dialog(parent);
+  dialog.setWindowTitle(QObject::tr("Import DREAM3D Montage Region"));
+  QFormLayout* layout = new QFormLayout(&dialog);
+
+  auto addSpinBox = [&](const QString& label, double value, double minimum, double maximum) {
+    QDoubleSpinBox* spinBox = new QDoubleSpinBox(&dialog);
+    spinBox->setDecimals(3);
+    spinBox->setRange(minimum, maximum);
+    spinBox->setValue(value);
+    layout->addRow(label, spinBox);
+    return spinBox;
+  };
+
+  QDoubleSpinBox* xSpinBox = addSpinBox(QObject::tr("X"), bounds.x(), bounds.left(), bounds.right());
+  QDoubleSpinBox* ySpinBox = addSpinBox(QObject::tr("Y"), bounds.y(), bounds.top(), bounds.bottom());
+  QDoubleSpinBox* widthSpinBox = addSpinBox(QObject::tr("Width"), bounds.width(), 0.0, bounds.width());
+  QDoubleSpinBox* heightSpinBox = addSpinBox(QObject::tr("Height"), bounds.height(), 0.0, bounds.height());
+
+  QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+  QObject::connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+  QObject::connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+  layout->addRow(buttonBox);
+
+  if(dialog.exec() == QDialog::Rejected)
+  {
+    return false;
+  }
+
+  region = QRectF(xSpinBox->value(), ySpinBox->value(), widthSpinBox->value(), heightSpinBox->value()).intersected(bounds);
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Asks for the size of the exported images.  Returns false if the dialog was canceled.
+// -----------------------------------------------------------------------------
+bool getImageExportOptions(bool multipleDatasets, IMFOffscreenRenderer::Options& options, bool& separateImages, QWidget* parent)
+{
+  QDialog dialog(parent);
+  dialog.setWindowTitle(QObject::tr("Save As Image File"));
+  QFormLayout* layout = new QFormLayout(&dialog);
+
+  auto addSpinBox = [&](const QString& label, int value) {
+    QSpinBox* spinBox = new QSpinBox(&dialog);
+    spinBox->setRange(0, 65536);
+    spinBox->setSpecialValueText(QObject::tr("Automatic"));
+    spinBox->setSuffix(QObject::tr(" px"));
+    spinBox->setValue(value);
+    layout->addRow(label, spinBox);
+    return spinBox;
+  };
+
+  QSpinBox* widthSpinBox = addSpinBox(QObject::tr("Width"), options.Width);
+  QSpinBox* heightSpinBox = addSpinBox(QObject::tr("Height"), options.Height);
+
+  QCheckBox* separateCheckBox = new QCheckBox(QObject::tr("One image per dataset"), &dialog);
+  separateCheckBox->setEnabled(multipleDatasets);
+  layout->addRow(separateCheckBox);
+
+  QDialogButtonBox* buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, &dialog);
+  QObject::connect(buttonBox, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+  QObject::connect(buttonBox, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+  layout->addRow(buttonBox);
+
+  if(dialog.exec() == QDialog::Rejected)
+  {
+    return false;
+  }
+
+  options.Width = widthSpinBox->value();
+  options.Height = heightSpinBox->value();
+  separateImages = separateCheckBox->isChecked();
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+// Adds a row for the number of tiles decoded at once to the bottom of an import dialog
+// -----------------------------------------------------------------------------
+QSpinBox* addDecodeThreadsRow(QDialog* dialog, int threadCount)
+{
+  QWidget* row = new QWidget(dialog);
+  QHBoxLayout* rowLayout = new QHBoxLayout(row);
+  rowLayout->setContentsMargins(0, 0, 0, 0);
+  rowLayout->addWidget(new QLabel(QObject::tr("Decode Threads"), row));
+
+  QSpinBox* spinBox = new QSpinBox(row);
+  spinBox->setRange(1, std::max(64, QThread::idealThreadCount() * 4));
+  spinBox->setValue(threadCount);
+  spinBox->setToolTip(QObject::tr("Number of tile images read and decoded at the same time.  1 reads the tiles one after the other."));
+  rowLayout->addWidget(spinBox);
+  rowLayout->addStretch();
+
+  QLayout* layout = dialog->layout();
+  if(QGridLayout* gridLayout = qobject_cast<QGridLayout*>(layout))
+  {
+    gridLayout->addWidget(row, gridLayout->rowCount(), 0, 1, std::max(1, gridLayout->columnCount()));
+  }
+  else if(QBoxLayout* boxLayout = qobject_cast<QBoxLayout*>(layout))
+  {
+    // The buttons stay at the bottom
+    boxLayout->insertWidget(std::max(0, boxLayout->count() - 1), row);
+  }
+  else if(layout != nullptr)
+  {
+    layout->addWidget(row);
+  }
+  return spinBox;
+}
+} // namespace
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -108,6 +331,7 @@ IMFViewer_UI::IMFViewer_UI(QWidget* parent)
   setupGui();
 
   qRegisterMetaType<FilterPipeline::Pointer>();
+  qRegisterMetaType<DataContainerArray::Pointer>();
 }
 
 // -----------------------------------------------------------------------------
@@ -115,6 +339,18 @@ IMFViewer_UI::IMFViewer_UI(QWidget* parent)
 // -----------------------------------------------------------------------------
 IMFViewer_UI::~IMFViewer_UI()
 {
+  m_PipelineScheduler->cancelAll();
+  m_ImageImporter->cancelAll();
+  m_LazyTileLoader->clear();
+
+  // The render window is deleted on the thread that owns its OpenGL context
+  if(m_RenderCanceled)
+  {
+    *m_RenderCanceled = true;
+  }
+  IMFOffscreenRenderer* renderer = m_OffscreenRenderer;
+  QtConcurrent::run(m_RenderThreadPool, [renderer] { delete renderer; }).waitForFinished();
+
   delete m_RecentFilesMenu;
   delete m_ClearRecentsAction;
 
@@ -134,6 +370,52 @@ void IMFViewer_UI::setupGui()
   m_Ui->queueWidget->setQueueModel(queueModel);
   connect(m_Ui->queueWidget, &VSQueueWidget::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
 
+  // Montage pipelines are entries of the import queue that execute on the scheduler, so several run at once
+  m_PipelineScheduler = new IMFPipelineScheduler(this);
+  connect(m_PipelineScheduler, &IMFPipelineScheduler::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
+  connect(m_PipelineScheduler, &IMFPipelineScheduler::notifyErrorMessage, this, [=](const QString& title, const QString& msg, int code) { processStatusMessage(tr("%1: %2").arg(title, msg)); });
+
+  m_RegistrationCache = new IMFRegistrationCache(IMFRegistrationCache::DefaultCacheDirectory(), this);
+
+  m_ImageImporter = new IMFImageImporter(this);
+  connect(m_ImageImporter, &IMFImageImporter::importFinished, this, &IMFViewer_UI::handleImageResults);
+  connect(m_ImageImporter, &IMFImageImporter::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
+
+  m_LazyTileLoader = new IMFLazyTileLoader(dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget), this);
+  connect(m_LazyTileLoader, &IMFLazyTileLoader::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
+
+  m_IncrementalStitcher = new IMFIncrementalStitcher(dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget), this);
+  connect(m_IncrementalStitcher, &IMFIncrementalStitcher::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
+
+  m_VolumeAssembler = new IMFVolumeAssembler(this);
+  connect(m_VolumeAssembler, &IMFVolumeAssembler::volumeAssembled, this, &IMFViewer_UI::handleVolumeResults);
+  connect(m_VolumeAssembler, &IMFVolumeAssembler::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
+
+  m_Dream3dWriter = new IMFDream3dWriter(this);
+  m_OffscreenRenderer = new IMFOffscreenRenderer();
+
+  // Images are always drawn on the same thread because the render window's OpenGL context belongs to it
+  m_RenderThreadPool = new QThreadPool(this);
+  m_RenderThreadPool->setMaxThreadCount(1);
+  m_RenderThreadPool->setExpiryTimeout(-1);
+  connect(m_Dream3dWriter, &IMFDream3dWriter::saveFinished, this, &IMFViewer_UI::handleSaveResults);
+
+  m_SessionLoader = new IMFSessionLoader(m_Ui->vsWidget->getController(), this);
+  connect(m_SessionLoader, &IMFSessionLoader::importRequested, this, [=](const QString& name, const QString& filePath) {
+    // Connected after handleDatasetResults, so the filters are in the view when the session restores their state
+    VSDatasetImporter::Pointer importer = importData(filePath);
+    connect(importer.get(), &VSDatasetImporter::resultReady, this,
+            [=](VSFileNameFilter* textFilter, VSDataSetFilter* filter) { m_SessionLoader->addImportedDataset(name, textFilter, filter); });
+  });
+  connect(m_SessionLoader, &IMFSessionLoader::pipelineRequested, this, [=](const FilterPipeline::Pointer& pipeline) {
+    pipeline->setProperty(k_TraceStartProperty, IMFTrace::Now());
+    enqueuePipeline(pipeline);
+  });
+  connect(m_SessionLoader, &IMFSessionLoader::datasetLoaded, this, [=](const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca) { displayPipelineOutput(pipeline, dca); });
+  connect(m_SessionLoader, &IMFSessionLoader::notifyStatusMessage, this, &IMFViewer_UI::processStatusMessage);
+  connect(m_SessionLoader, &IMFSessionLoader::notifyErrorMessage,
+          [=](const QString& title, const QString& msg, int code) { QMessageBox::critical(this, title, msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok); });
+
   createMenu();
 
   m_Ui->queueDockWidget->hide();
@@ -173,11 +455,9 @@ void IMFViewer_UI::importData()
     QMimeDatabase db;
     QMimeType mimeType = db.mimeTypeForFile(filePath, QMimeDatabase::MatchContent);
 
-    VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-
     if(ext == "dream3d")
     {
-      baseWidget->launchHDF5SelectionDialog(filePath);
+      importDream3dFile(filePath);
     }
     else if(ext == "vtk" || ext == "vti" || ext == "vtp" || ext == "vtr" || ext == "vts" || ext == "vtu")
     {
@@ -211,16 +491,13 @@ void IMFViewer_UI::importData()
 void IMFViewer_UI::importGenericMontage()
 {
   ImportGenericMontageDialog::Pointer dialog = ImportGenericMontageDialog::New(this);
+  QSpinBox* decodeThreadsSpinBox = addDecodeThreadsRow(dialog.get(), m_DecodeThreadCount);
   int ret = dialog->exec();
   if(ret == QDialog::Rejected)
   {
     return;
   }
-
-  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
-  m_DisplayType = dialog->getDisplayType();
-  filterViewModel->setDisplayType(m_DisplayType);
+  m_DecodeThreadCount = decodeThreadsSpinBox->value();
 
   QString tileConfigFile = "TileConfiguration.txt";
 
@@ -241,15 +518,21 @@ void IMFViewer_UI::importGenericMontage()
   fijiFilePath.append(tileConfigFile);
 
   // Change wizard data for Fiji use case
-  QString montageName = dialog->getMontageName();
-  FijiListInfo_t fijiListInfo;
-  fijiListInfo.FijiFilePath = fijiFilePath;
-  bool overrideSpacing = dialog->getOverrideSpacing();
-  SpacingTuple spacing = dialog->getSpacing();
-  OriginTuple origin = dialog->getOrigin();
-  int32_t lengthUnit = dialog->getLengthUnit();
-
-  importFijiMontage(montageName, fijiListInfo, overrideSpacing, spacing, true, origin, montageStart, montageEnd, lengthUnit);
+  IMFMontagePipelineBuilder::MontageSettings settings;
+  settings.Type = IMFMontagePipelineBuilder::MontageType::Fiji;
+  settings.MontageName = dialog->getMontageName();
+  settings.InputFilePath = fijiFilePath;
+  settings.OverrideSpacing = dialog->getOverrideSpacing();
+  settings.Spacing = dialog->getSpacing();
+  settings.OverrideOrigin = true;
+  settings.Origin = dialog->getOrigin();
+  settings.MontageStart = montageStart;
+  settings.MontageEnd = montageEnd;
+  settings.LengthUnit = dialog->getLengthUnit();
+  settings.Display = dialog->getDisplayType();
+  settings.DecodeThreadCount = m_DecodeThreadCount;
+
+  importMontage(settings);
 }
 
 // -----------------------------------------------------------------------------
@@ -264,68 +547,37 @@ void IMFViewer_UI::importDREAM3DMontage()
     return;
   }
 
-  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
-  m_DisplayType = dialog->getDisplayType();
-  filterViewModel->setDisplayType(m_DisplayType);
-
-  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
-  connect(filterFactory.get(), &VSFilterFactory::notifyErrorMessage,
-          [=](const QString& msg, int code) { QMessageBox::critical(this, "Import DREAM3D Montage", msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok); });
-
-  FilterPipeline::Pointer pipeline = FilterPipeline::New();
-  QString montageName = dialog->getMontageName();
-  pipeline->setName(montageName);
-
-  QString dataFilePath = dialog->getDataFilePath();
-
-  QString dcPrefix = dialog->getDataContainerPrefix();
-
-  IntVec2Type montageStart = dialog->getMontageStart();
-  IntVec2Type montageEnd = dialog->getMontageEnd();
-  IntVec3Type montageSize = dialog->getMontageSize();
-
-  QStringList dcNames;
-  for(int32_t row = montageStart[1]; row <= montageEnd[1]; row++)
+  IMFMontagePipelineBuilder::MontageSettings settings;
+  settings.Type = IMFMontagePipelineBuilder::MontageType::DREAM3D;
+  settings.MontageName = dialog->getMontageName();
+  settings.InputFilePath = dialog->getDataFilePath();
+  settings.DataContainerPrefix = dialog->getDataContainerPrefix();
+  settings.AttributeMatrixName = dialog->getAttributeMatrixName();
+  settings.DataArrayName = dialog->getDataArrayName();
+  settings.MontageStart = dialog->getMontageStart();
+  settings.MontageEnd = dialog->getMontageEnd();
+  settings.Display = dialog->getDisplayType();
+
+  if(m_ImportRegionAction->isChecked())
   {
-    for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
+    QRectF bounds = IMFReadRegionFilter::MontageBounds(settings.InputFilePath, settings.DataContainerPrefix, settings.MontageStart, settings.MontageEnd, settings.AttributeMatrixName);
+    if(bounds.isEmpty())
     {
-      dcNames.push_back(MontageUtilities::GenerateDataContainerName(dcPrefix, montageEnd, row, col));
+      QMessageBox::critical(this, "Import DREAM3D Montage", tr("The tile positions could not be read from '%1'.").arg(settings.InputFilePath));
+      return;
+    }
+    if(!getMontageRegion(bounds, settings.Region, this))
+    {
+      return;
+    }
+    if(settings.Region.isEmpty())
+    {
+      QMessageBox::critical(this, "Import DREAM3D Montage", tr("The region is empty."));
+      return;
     }
   }
 
-  SIMPLH5DataReader reader;
-  connect(&reader, &SIMPLH5DataReader::errorGenerated,
-          [=](const QString& title, const QString& msg, const int& code) { QMessageBox::critical(this, title, msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok); });
-
-  DataContainerArrayProxy dream3dProxy = MontageUtilities::CreateMontageProxy(reader, dataFilePath, dcNames);
-  if(dream3dProxy == DataContainerArrayProxy())
-  {
-    return;
-  }
-
-  AbstractFilter::Pointer dataContainerReader = filterFactory->createDataContainerReaderFilter(dataFilePath, dream3dProxy);
-  if(!dataContainerReader)
-  {
-    // Error!
-  }
-
-  pipeline->pushBack(dataContainerReader);
-
-  QString amName = dialog->getAttributeMatrixName();
-  QString daName = dialog->getDataArrayName();
-
-  if(m_DisplayType != AbstractImportMontageDialog::DisplayType::SideBySide && m_DisplayType != AbstractImportMontageDialog::DisplayType::Outline)
-  {
-    AbstractFilter::Pointer itkRegistrationFilter = filterFactory->createPCMTileRegistrationFilter(montageStart, montageEnd, dcPrefix, amName, daName);
-    pipeline->pushBack(itkRegistrationFilter);
-
-    DataArrayPath montagePath("MontageDC", "MontageAM", "MontageData");
-    AbstractFilter::Pointer itkStitchingFilter = filterFactory->createTileStitchingFilter(montageStart, montageEnd, dcPrefix, amName, daName, montagePath);
-    pipeline->pushBack(itkStitchingFilter);
-  }
-
-  addPipelineToQueue(pipeline);
+  importMontage(settings);
 }
 
 // -----------------------------------------------------------------------------
@@ -334,371 +586,323 @@ void IMFViewer_UI::importDREAM3DMontage()
 void IMFViewer_UI::importFijiMontage()
 {
   ImportFijiMontageDialog::Pointer dialog = ImportFijiMontageDialog::New(this);
+  QSpinBox* decodeThreadsSpinBox = addDecodeThreadsRow(dialog.get(), m_DecodeThreadCount);
   int ret = dialog->exec();
   if(ret == QDialog::Rejected)
   {
     return;
   }
+  m_DecodeThreadCount = decodeThreadsSpinBox->value();
 
-  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
-  m_DisplayType = dialog->getDisplayType();
-  filterViewModel->setDisplayType(m_DisplayType);
-
-  QString montageName = dialog->getMontageName();
   FijiListInfo_t fijiListInfo = dialog->getFijiListInfo();
-  bool overrideSpacing = dialog->getOverrideSpacing();
-  FloatVec3Type spacing = dialog->getSpacing();
-  bool overrideOrigin = dialog->getOverrideOrigin();
-  FloatVec3Type origin = dialog->getOrigin();
-  int32_t lengthUnit = dialog->getLengthUnit();
 
-  IntVec2Type montageStart = dialog->getMontageStart();
-  IntVec2Type montageEnd = dialog->getMontageEnd();
-
-  importFijiMontage(montageName, fijiListInfo, overrideSpacing, spacing, overrideOrigin, origin, montageStart, montageEnd, lengthUnit);
+  IMFMontagePipelineBuilder::MontageSettings settings;
+  settings.Type = IMFMontagePipelineBuilder::MontageType::Fiji;
+  settings.MontageName = dialog->getMontageName();
+  settings.InputFilePath = fijiListInfo.FijiFilePath;
+  settings.OverrideSpacing = dialog->getOverrideSpacing();
+  settings.Spacing = dialog->getSpacing();
+  settings.OverrideOrigin = dialog->getOverrideOrigin();
+  settings.Origin = dialog->getOrigin();
+  settings.MontageStart = dialog->getMontageStart();
+  settings.MontageEnd = dialog->getMontageEnd();
+  settings.LengthUnit = dialog->getLengthUnit();
+  settings.Display = dialog->getDisplayType();
+  settings.DecodeThreadCount = m_DecodeThreadCount;
+
+  importMontage(settings);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::importFijiMontage(const QString& montageName, FijiListInfo_t fijiListInfo, bool overrideSpacing, FloatVec3Type spacing, bool overrideOrigin, FloatVec3Type origin,
-                                     IntVec2Type montageStart, IntVec2Type montageEnd, int32_t lengthUnit)
+void IMFViewer_UI::importRobometMontage()
 {
-  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
-
-  FilterPipeline::Pointer pipeline = FilterPipeline::New();
-  pipeline->setName(montageName);
-
-  QString fijiConfigFilePath = fijiListInfo.FijiFilePath;
-  DataArrayPath dcPath("UntitledMontage_", "", "");
-  QString amName = "Cell Attribute Matrix";
-  QString daName = "Image Data";
-  AbstractFilter::Pointer importFijiMontageFilter =
-      filterFactory->createImportFijiMontageFilter(fijiConfigFilePath, dcPath, amName, daName, overrideOrigin, origin.data(), montageStart, montageEnd, overrideSpacing, spacing.data(), lengthUnit);
-  if(!importFijiMontageFilter)
-  {
-    // Error!
-  }
-
-  pipeline->pushBack(importFijiMontageFilter);
-
-  // Set Image Data Containers
-  importFijiMontageFilter->preflight();
-  QStringList dcNames;
-  QString dcPrefix = dcPath.getDataContainerName() + "_";
-
-  int rowCount;
-  int colCount;
-  if(montageEnd.getX() == 0 && montageEnd.getY() == 0)
-  {
-    rowCount = importFijiMontageFilter->property("RowCount").toInt();
-    colCount = importFijiMontageFilter->property("ColumnCount").toInt();
-    DataContainerArray::Pointer dca = importFijiMontageFilter->getDataContainerArray();
-    dcNames = dca->getDataContainerNames();
-  }
-  else
+  ImportRobometMontageDialog::Pointer dialog = ImportRobometMontageDialog::New(this);
+  int ret = dialog->exec();
+  if(ret == QDialog::Rejected)
   {
-    rowCount = montageEnd.getY() - montageStart.getY() + 1;
-    colCount = montageEnd.getX() - montageStart.getX() + 1;
-    for(int32_t row = montageStart[1]; row <= montageEnd[1]; row++)
-    {
-      for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
-      {
-        dcNames.push_back(MontageUtilities::GenerateDataContainerName(dcPrefix, montageEnd, row, col));
-      }
-    }
+    return;
   }
 
-  IntVec3Type montageSize = {colCount, rowCount, 1};
-
-  if(m_DisplayType != AbstractImportMontageDialog::DisplayType::SideBySide && m_DisplayType != AbstractImportMontageDialog::DisplayType::Outline)
-  {
-    AbstractFilter::Pointer itkRegistrationFilter = filterFactory->createPCMTileRegistrationFilter(montageStart, montageEnd, dcPrefix, amName, daName);
-    pipeline->pushBack(itkRegistrationFilter);
-
-    DataArrayPath montagePath("MontageDC", "MontageAM", "MontageData");
-    AbstractFilter::Pointer itkStitchingFilter = filterFactory->createTileStitchingFilter(montageStart, montageEnd, dcPrefix, amName, daName, montagePath);
-    pipeline->pushBack(itkStitchingFilter);
-  }
+  RobometListInfo_t rbmListInfo = dialog->getRobometListInfo();
 
-  // Run the pipeline
-  addPipelineToQueue(pipeline);
+  IMFMontagePipelineBuilder::MontageSettings settings;
+  settings.Type = IMFMontagePipelineBuilder::MontageType::Robomet;
+  settings.MontageName = dialog->getMontageName();
+  settings.InputFilePath = rbmListInfo.RobometFilePath;
+  settings.OverrideSpacing = dialog->getOverrideSpacing();
+  settings.Spacing = dialog->getSpacing();
+  settings.OverrideOrigin = dialog->getOverrideOrigin();
+  settings.Origin = dialog->getOrigin();
+  settings.MontageStart = {rbmListInfo.MontageStartCol, rbmListInfo.MontageStartRow};
+  settings.MontageEnd = {rbmListInfo.MontageEndCol, rbmListInfo.MontageEndRow};
+  settings.LengthUnit = dialog->getLengthUnit();
+  settings.Display = dialog->getDisplayType();
+  settings.SliceMin = rbmListInfo.SliceMin;
+  settings.SliceMax = rbmListInfo.SliceMax;
+  settings.ImagePrefix = rbmListInfo.ImagePrefix;
+  settings.ImageExtension = rbmListInfo.ImageExtension;
+  settings.AssembleVolume = m_AssembleVolumeAction->isChecked() && settings.Display == AbstractImportMontageDialog::DisplayType::Montage && settings.SliceMax > settings.SliceMin;
+  settings.AlignSlices = m_AlignSlicesAction->isChecked();
+
+  importMontage(settings);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::importRobometMontage()
+void IMFViewer_UI::importZeissMontage()
 {
-  ImportRobometMontageDialog::Pointer dialog = ImportRobometMontageDialog::New(this);
+  ImportZeissMontageDialog::Pointer dialog = ImportZeissMontageDialog::New(this);
   int ret = dialog->exec();
   if(ret == QDialog::Rejected)
   {
     return;
   }
 
-  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
-  m_DisplayType = dialog->getDisplayType();
-  filterViewModel->setDisplayType(m_DisplayType);
-
-  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
-
-  bool overrideSpacing = dialog->getOverrideSpacing();
-  FloatVec3Type spacing = dialog->getSpacing();
-  bool overrideOrigin = dialog->getOverrideOrigin();
-  FloatVec3Type origin = dialog->getOrigin();
-  RobometListInfo_t rbmListInfo = dialog->getRobometListInfo();
-  int sliceMin = rbmListInfo.SliceMin;
-  int sliceMax = rbmListInfo.SliceMax;
-  int32_t lengthUnit = dialog->getLengthUnit();
-
-  for(int slice = sliceMin; slice <= sliceMax; slice++)
-  {
-    FilterPipeline::Pointer pipeline = FilterPipeline::New();
-    QString montageName = dialog->getMontageName();
-    QString pipelineName = montageName;
-    pipelineName.append(tr("_%1").arg(slice));
-    pipeline->setName(pipelineName);
-
-    QString robometFilePath = rbmListInfo.RobometFilePath;
-    DataArrayPath dcPath("UntitledMontage_", "", "");
-    QString amName = "Cell Attribute Matrix";
-    QString daName = "Image Data";
-    QString imagePrefix = rbmListInfo.ImagePrefix;
-    if(!imagePrefix.endsWith("_"))
-    {
-      imagePrefix.append("_");
-    }
-    QString imageFileExtension = rbmListInfo.ImageExtension;
-
-    int montageStartCol = rbmListInfo.MontageStartCol;
-    int montageStartRow = rbmListInfo.MontageStartRow;
-    int montageEndCol = rbmListInfo.MontageEndCol;
-    int montageEndRow = rbmListInfo.MontageEndRow;
-    IntVec2Type montageStart = {montageStartCol, montageStartRow};
-    IntVec2Type montageEnd = {montageEndCol, montageEndRow};
-    IntVec3Type montageSize = {montageEndCol - montageStartCol + 1, montageEndRow - montageStartRow + 1, 1};
-
-    AbstractFilter::Pointer importRoboMetMontageFilter = filterFactory->createImportRobometMontageFilter(
-        robometFilePath, dcPath, amName, daName, slice, imagePrefix, imageFileExtension, overrideOrigin, origin.data(), montageStart, montageEnd, overrideSpacing, spacing.data(), lengthUnit);
-    if(!importRoboMetMontageFilter)
-    {
-      // Error!
-    }
-
-    pipeline->pushBack(importRoboMetMontageFilter);
-
-    importRoboMetMontageFilter->preflight();
-    DataContainerArray::Pointer dca = importRoboMetMontageFilter->getDataContainerArray();
-    QStringList dcNames = dca->getDataContainerNames();
-
-    if(m_DisplayType != AbstractImportMontageDialog::DisplayType::SideBySide && m_DisplayType != AbstractImportMontageDialog::DisplayType::Outline)
-    {
-      QString dcPrefix = dcPath.getDataContainerName() + "_";
-      AbstractFilter::Pointer itkRegistrationFilter = filterFactory->createPCMTileRegistrationFilter(montageStart, montageEnd, dcPrefix, amName, daName);
-      pipeline->pushBack(itkRegistrationFilter);
-
-      DataArrayPath montagePath("MontageDC", "MontageAM", "MontageData");
-      AbstractFilter::Pointer itkStitchingFilter = filterFactory->createTileStitchingFilter(montageStart, montageEnd, dcPrefix, amName, daName, montagePath);
-      pipeline->pushBack(itkStitchingFilter);
-    }
+  ZeissListInfo_t zeissListInfo = dialog->getZeissListInfo();
 
-    addPipelineToQueue(pipeline);
-  }
+  IMFMontagePipelineBuilder::MontageSettings settings;
+  settings.Type = IMFMontagePipelineBuilder::MontageType::Zeiss;
+  settings.MontageName = dialog->getMontageName();
+  settings.InputFilePath = zeissListInfo.ZeissFilePath;
+  settings.OverrideSpacing = dialog->getOverrideSpacing();
+  settings.Spacing = dialog->getSpacing();
+  settings.OverrideOrigin = dialog->getOverrideOrigin();
+  settings.Origin = dialog->getOrigin();
+  settings.MontageStart = dialog->getMontageStart();
+  settings.MontageEnd = dialog->getMontageEnd();
+  settings.ConvertToGrayscale = dialog->getConvertToGrayscale();
+  settings.ColorWeighting = dialog->getColorWeighting();
+  settings.Display = dialog->getDisplayType();
+
+  importMontage(settings);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::importZeissMontage()
+void IMFViewer_UI::importZeissZenMontage()
 {
-  ImportZeissMontageDialog::Pointer dialog = ImportZeissMontageDialog::New(this);
+  ImportZeissZenMontageDialog::Pointer dialog = ImportZeissZenMontageDialog::New(this);
   int ret = dialog->exec();
   if(ret == QDialog::Rejected)
   {
     return;
   }
 
-  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
-  m_DisplayType = dialog->getDisplayType();
-  filterViewModel->setDisplayType(m_DisplayType);
-
-  FilterPipeline::Pointer pipeline = FilterPipeline::New();
-  AbstractFilter::Pointer importZeissMontage;
-  QString montageName = dialog->getMontageName();
-  pipeline->setName(montageName);
-
-  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
-
-  ZeissListInfo_t zeissListInfo = dialog->getZeissListInfo();
-
-  QString configFilePath = zeissListInfo.ZeissFilePath;
-  QString dcPrefix = "UntitledMontage_";
-  DataArrayPath dcPath("UntitledMontage", "", "");
-  QString amName = "Cell Attribute Matrix";
-  QString daName = "Image Data";
-  QString metadataAMName = "Metadata Attribute Matrix";
-  bool importAllMetadata = true;
-  bool convertToGrayscale = dialog->getConvertToGrayscale();
-  bool changeSpacing = dialog->getOverrideSpacing();
-  bool changeOrigin = dialog->getOverrideOrigin();
-
-  FloatVec3Type spacing = dialog->getSpacing();
-  FloatVec3Type origin = dialog->getOrigin();
-  IntVec2Type montageStart = dialog->getMontageStart();
-  IntVec2Type montageEnd = dialog->getMontageEnd();
-  FloatVec3Type colorWeighting = dialog->getColorWeighting();
-
-  importZeissMontage = filterFactory->createImportZeissMontageFilter(configFilePath, dcPath, amName, daName, metadataAMName, importAllMetadata, convertToGrayscale, colorWeighting, changeOrigin,
-                                                                     origin, montageStart, montageEnd, changeSpacing, spacing);
+  ZeissZenListInfo_t zeissListInfo = dialog->getZeissZenListInfo();
 
-  if(!importZeissMontage)
-  {
-    // Error!
-  }
+  IMFMontagePipelineBuilder::MontageSettings settings;
+  settings.Type = IMFMontagePipelineBuilder::MontageType::ZeissZen;
+  settings.MontageName = dialog->getMontageName();
+  settings.InputFilePath = zeissListInfo.ZeissFilePath;
+  settings.OverrideOrigin = dialog->getOverrideOrigin();
+  settings.Origin = dialog->getOrigin();
+  settings.MontageStart = dialog->getMontageStart();
+  settings.MontageEnd = dialog->getMontageEnd();
+  settings.ConvertToGrayscale = dialog->getConvertToGrayscale();
+  settings.ColorWeighting = dialog->getColorWeighting();
+  settings.Display = dialog->getDisplayType();
+
+  importMontage(settings);
+}
 
-  pipeline->pushBack(importZeissMontage);
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::importMontage(const IMFMontagePipelineBuilder::MontageSettings& settings)
+{
+  qint64 traceStart = IMFTrace::Now();
 
-  // Set Image Data Containers
-  importZeissMontage->preflight();
-  QStringList dcNames;
+  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
+  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
 
-  int rowCount;
-  int colCount;
-  if(montageEnd.getX() == 0 && montageEnd.getY() == 0)
+  IMFMontagePipelineBuilder::MontageSettings montageSettings = settings;
+  // Volumes are assembled from slices stitched in memory
+  if(m_StitchToDiskAction->isChecked() && montageSettings.Display == AbstractImportMontageDialog::DisplayType::Montage && montageSettings.Type != IMFMontagePipelineBuilder::MontageType::DREAM3D &&
+     !montageSettings.AssembleVolume)
   {
-    rowCount = importZeissMontage->property("RowCount").toInt();
-    colCount = importZeissMontage->property("ColumnCount").toInt();
-    DataContainerArray::Pointer dca = importZeissMontage->getDataContainerArray();
-    dcNames = dca->getDataContainerNames();
-  }
-  else
-  {
-    rowCount = montageEnd.getY() - montageStart.getY() + 1;
-    colCount = montageEnd.getX() - montageStart.getX() + 1;
-    for(int32_t row = montageStart[1]; row <= montageEnd[1]; row++)
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Stitched Montage"), m_OpenDialogLastDirectory + QDir::separator() + montageSettings.MontageName + ".dream3d", tr("DREAM3D File (*.dream3d)"));
+    if(filePath.isEmpty())
     {
-      for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
-      {
-        dcNames.push_back(MontageUtilities::GenerateDataContainerName(dcPrefix, montageEnd, row, col));
-      }
+      return;
     }
+    montageSettings.StitchedOutputFile = filePath;
   }
+  montageSettings.PipelinedImport = m_PipelinedImportAction->isChecked();
+  montageSettings.LowMemoryStitching = m_LowMemoryStitchingAction->isChecked();
 
-  IntVec3Type montageSize = {colCount, rowCount, 1};
-
-  if(m_DisplayType != AbstractImportMontageDialog::DisplayType::SideBySide && m_DisplayType != AbstractImportMontageDialog::DisplayType::Outline)
-  {
-    AbstractFilter::Pointer itkRegistrationFilter = filterFactory->createPCMTileRegistrationFilter(montageStart, montageEnd, dcPrefix, amName, daName);
-    pipeline->pushBack(itkRegistrationFilter);
-
-    DataArrayPath montagePath("MontageDC", "MontageAM", "MontageData");
-    AbstractFilter::Pointer itkStitchingFilter = filterFactory->createTileStitchingFilter(montageStart, montageEnd, dcPrefix, amName, daName, montagePath);
-    pipeline->pushBack(itkStitchingFilter);
-  }
+  m_DisplayType = montageSettings.Display;
+  filterViewModel->setDisplayType(m_DisplayType);
 
-  addPipelineToQueue(pipeline);
+  // Building the pipelines computes the registration cache keys, which reads the tile
+  // configuration and the time stamps of the tile files, so it runs on a worker thread.
+  // Plugins can only be loaded here, so the ones whose loading was deferred are loaded first.
+  IMFPluginLoader::LoadDeferredPlugins();
+  IMFMontagePipelineBuilder* builder = new IMFMontagePipelineBuilder();
+  builder->setRegistrationCache(m_RegistrationCache);
+  connect(builder, &IMFMontagePipelineBuilder::notifyErrorMessage, this,
+          [=](const QString& title, const QString& msg, int code) { QMessageBox::critical(this, title, msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok); });
+
+  QFutureWatcher<std::vector<FilterPipeline::Pointer>>* builderWatcher = new QFutureWatcher<std::vector<FilterPipeline::Pointer>>(this);
+  connect(builderWatcher, &QFutureWatcher<std::vector<FilterPipeline::Pointer>>::finished, this, [=] {
+    builder->deleteLater();
+    builderWatcher->deleteLater();
+    queueMontagePipelines(montageSettings, builderWatcher->result(), traceStart);
+  });
+  builderWatcher->setFuture(QtConcurrent::run([=] { return builder->createPipelines(montageSettings); }));
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::importZeissZenMontage()
+void IMFViewer_UI::queueMontagePipelines(const IMFMontagePipelineBuilder::MontageSettings& montageSettings, const std::vector<FilterPipeline::Pointer>& pipelines, qint64 traceStart)
 {
-  ImportZeissZenMontageDialog::Pointer dialog = ImportZeissZenMontageDialog::New(this);
-  int ret = dialog->exec();
-  if(ret == QDialog::Rejected)
+  for(const FilterPipeline::Pointer& pipeline : pipelines)
   {
+    pipeline->setProperty(k_TraceStartProperty, traceStart);
+  }
+  if(montageSettings.AssembleVolume)
+  {
+    FilterPipeline::Pointer volumePipeline = FilterPipeline::New();
+    volumePipeline->setName(montageSettings.MontageName);
+    volumePipeline->setProperty(k_TraceStartProperty, traceStart);
+    m_VolumeAssembler->addVolume(volumePipeline, pipelines, montageSettings.AlignSlices);
+  }
+  if(montageSettings.Type == IMFMontagePipelineBuilder::MontageType::DREAM3D)
+  {
+    for(const FilterPipeline::Pointer& pipeline : pipelines)
+    {
+      addPipelineToQueue(pipeline);
+    }
     return;
   }
 
-  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
-  m_DisplayType = dialog->getDisplayType();
-  filterViewModel->setDisplayType(m_DisplayType);
+  // Outline montages never need the tile pixels, and side by side montages read them as the tiles come into view
+  bool loadOnDemand = m_LoadTilesOnDemandAction->isChecked() &&
+                      (montageSettings.Display == AbstractImportMontageDialog::DisplayType::SideBySide || montageSettings.Display == AbstractImportMontageDialog::DisplayType::Outline);
+
+  // Preflight the import filters on worker threads to catch configuration errors before the
+  // pipelines are queued.  Reading large tile configurations can take several seconds.
+  QProgressDialog* progressDialog = new QProgressDialog(tr("Reading montage '%1'...").arg(montageSettings.MontageName), tr("Cancel"), 0, static_cast<int>(pipelines.size()), this);
+  progressDialog->setWindowTitle(tr("Import Montage"));
+  progressDialog->setWindowModality(Qt::WindowModal);
+  progressDialog->setMinimumDuration(500);
+  progressDialog->setValue(0);
+
+  QFutureWatcher<int>* preflightWatcher = new QFutureWatcher<int>(this);
+  connect(preflightWatcher, &QFutureWatcher<int>::progressValueChanged, progressDialog, &QProgressDialog::setValue);
+  connect(progressDialog, &QProgressDialog::canceled, preflightWatcher, &QFutureWatcher<int>::cancel);
+  connect(preflightWatcher, &QFutureWatcher<int>::finished, this, [=] {
+    progressDialog->deleteLater();
+    preflightWatcher->deleteLater();
+    if(preflightWatcher->isCanceled())
+    {
+      m_VolumeAssembler->removeVolume(pipelines);
+      return;
+    }
 
-  FilterPipeline::Pointer pipeline = FilterPipeline::New();
-  AbstractFilter::Pointer importZeissMontage;
-  QString montageName = dialog->getMontageName();
-  pipeline->setName(montageName);
+    for(size_t i = 0; i < pipelines.size(); i++)
+    {
+      int err = preflightWatcher->resultAt(static_cast<int>(i));
+      if(err < 0)
+      {
+        QString msg = tr("The montage '%1' could not be read.  The import filter failed with error code %2.").arg(pipelines[i]->getName()).arg(err);
+        QMessageBox::critical(this, tr("Import Montage"), msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+        if(IMFVolumeAssembler::IsSlicePipeline(pipelines[i]))
+        {
+          m_VolumeAssembler->addSlice(pipelines[i], DataContainerArray::NullPointer(), err);
+        }
+        continue;
+      }
 
-  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
+      if(loadOnDemand)
+      {
+        importMontageGeometry(montageSettings, pipelines[i]);
+        continue;
+      }
 
-  ZeissZenListInfo_t zeissListInfo = dialog->getZeissZenListInfo();
+      if(IMFPipelinedMontage::IsPipelinedMontage(pipelines[i]))
+      {
+        importPipelinedMontage(montageSettings, pipelines[i]);
+        continue;
+      }
 
-  QString configFilePath = zeissListInfo.ZeissFilePath;
-  QString dcPrefix = "UntitledMontage_";
-  DataArrayPath dcPath("UntitledMontage", "", "");
-  QString amName = "Cell Attribute Matrix";
-  QString daName = "Image Data";
-  bool convertToGrayscale = dialog->getConvertToGrayscale();
-  bool changeOrigin = dialog->getOverrideOrigin();
+      addPipelineToQueue(pipelines[i]);
+    }
+  });
 
-  IntVec2Type montageStart = dialog->getMontageStart();
-  IntVec2Type montageEnd = dialog->getMontageEnd();
-  FloatVec3Type origin = dialog->getOrigin();
-  FloatVec3Type colorWeighting = dialog->getColorWeighting();
+  preflightWatcher->setFuture(QtConcurrent::mapped(pipelines, preflightImportFilter));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::importMontageGeometry(const IMFMontagePipelineBuilder::MontageSettings& settings, const FilterPipeline::Pointer& pipeline)
+{
+  // The preflight already created every tile geometry, so the import filter is never executed
+  DataContainerArray::Pointer geometryDca = pipeline->getFilterContainer().front()->getDataContainerArray();
+  IMFLazyTileLoader::StripAttributeMatrices(geometryDca);
+  pipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(settings.Display));
+  traceDialogToEnqueue(pipeline);
 
-  importZeissMontage = filterFactory->createImportZeissZenMontageFilter(configFilePath, dcPath, amName, daName, convertToGrayscale, colorWeighting, changeOrigin, origin, montageStart, montageEnd);
+  displayPipelineOutput(pipeline, geometryDca);
 
-  if(!importZeissMontage)
+  if(settings.Display == AbstractImportMontageDialog::DisplayType::SideBySide)
   {
-    // Error!
+    m_LazyTileLoader->addMontage(settings, pipeline->getName(), geometryDca);
   }
+}
 
-  pipeline->pushBack(importZeissMontage);
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::importPipelinedMontage(const IMFMontagePipelineBuilder::MontageSettings& settings, const FilterPipeline::Pointer& pipeline)
+{
+  // The tiles are read one at a time by the dataflow, so the import filter only ever runs as a preflight
+  DataContainerArray::Pointer geometryDca = pipeline->getFilterContainer().front()->getDataContainerArray();
+  IMFLazyTileLoader::StripAttributeMatrices(geometryDca);
 
-  // Set Image Data Containers
-  importZeissMontage->preflight();
-  QStringList dcNames;
+  FilterPipeline::Pointer dataflowPipeline = IMFPipelinedMontage::CreateDataflowPipeline(pipeline);
+  dataflowPipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(settings.Display));
+  traceDialogToEnqueue(dataflowPipeline);
 
-  int rowCount;
-  int colCount;
-  if(montageEnd.getX() == 0 && montageEnd.getY() == 0)
-  {
-    rowCount = importZeissMontage->property("RowCount").toInt();
-    colCount = importZeissMontage->property("ColumnCount").toInt();
-    DataContainerArray::Pointer dca = importZeissMontage->getDataContainerArray();
-    dcNames = dca->getDataContainerNames();
-  }
-  else
-  {
-    rowCount = montageEnd.getY() - montageStart.getY() + 1;
-    colCount = montageEnd.getX() - montageStart.getX() + 1;
-    for(int32_t row = montageStart[1]; row <= montageEnd[1]; row++)
-    {
-      for(int32_t col = montageStart[0]; col <= montageEnd[0]; col++)
-      {
-        dcNames.push_back(MontageUtilities::GenerateDataContainerName(dcPrefix, montageEnd, row, col));
-      }
-    }
-  }
+  int readThreadCount = m_DecodeThreadCount;
+  enqueuePipeline(dataflowPipeline, geometryDca, [=](const FilterPipeline::Pointer& queuedPipeline, const DataContainerArray::Pointer& dca) {
+    return IMFPipelinedMontage::ExecutePipeline(settings, queuedPipeline, dca, readThreadCount);
+  });
+}
 
-  IntVec3Type montageSize = {colCount, rowCount, 1};
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::addPipelineToQueue(const FilterPipeline::Pointer& pipeline)
+{
+  // Several pipelines may be executing at once, so each one remembers the display type it was imported with
+  pipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(m_DisplayType));
+  traceDialogToEnqueue(pipeline);
 
-  if(m_DisplayType != AbstractImportMontageDialog::DisplayType::SideBySide && m_DisplayType != AbstractImportMontageDialog::DisplayType::Outline)
+  if(IMFStreamingStitcher::IsStitchingPipeline(pipeline))
   {
-    AbstractFilter::Pointer itkRegistrationFilter = filterFactory->createPCMTileRegistrationFilter(montageStart, montageEnd, dcPrefix, amName, daName);
-    pipeline->pushBack(itkRegistrationFilter);
-
-    DataArrayPath montagePath("MontageDC", "MontageAM", "MontageData");
-    AbstractFilter::Pointer itkStitchingFilter = filterFactory->createTileStitchingFilter(montageStart, montageEnd, dcPrefix, amName, daName, montagePath);
-    pipeline->pushBack(itkStitchingFilter);
+    enqueuePipeline(pipeline, DataContainerArray::NullPointer(), &IMFStreamingStitcher::ExecutePipeline);
+    return;
   }
 
-  addPipelineToQueue(pipeline);
+  enqueuePipeline(pipeline);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::addPipelineToQueue(const FilterPipeline::Pointer& pipeline)
+void IMFViewer_UI::enqueuePipeline(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const IMFPipelineScheduler::PostExecuteFunction& postExecute)
 {
-  VSMontageImporter::Pointer importer = VSMontageImporter::New(pipeline);
-  connect(importer.get(), &VSMontageImporter::resultReady, this, &IMFViewer_UI::handleMontageResults);
+  // Queued pipelines create filters on the workers, for example to decode single tiles
+  IMFPluginLoader::LoadDeferredPlugins();
+
+  IMFScheduledImporter::Pointer importer = IMFScheduledImporter::New(m_PipelineScheduler, pipeline, dca, postExecute);
+  connect(importer.get(), &IMFScheduledImporter::resultReady, this, &IMFViewer_UI::handleMontageResults);
 
   m_Ui->queueWidget->addDataImporter(pipeline->getName(), importer);
 }
@@ -708,10 +912,9 @@ void IMFViewer_UI::addPipelineToQueue(const FilterPipeline::Pointer& pipeline)
 // -----------------------------------------------------------------------------
 void IMFViewer_UI::executePipeline(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca)
 {
-  VSMontageImporter::Pointer importer = VSMontageImporter::New(pipeline, dca);
-  connect(importer.get(), &VSMontageImporter::resultReady, this, &IMFViewer_UI::handleMontageResults);
+  pipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(m_DisplayType));
 
-  m_Ui->queueWidget->addDataImporter(pipeline->getName(), importer);
+  enqueuePipeline(pipeline, dca);
 }
 
 // -----------------------------------------------------------------------------
@@ -739,49 +942,207 @@ void IMFViewer_UI::handleDatasetResults(VSFileNameFilter* textFilter, VSDataSetF
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::handleMontageResults(const FilterPipeline::Pointer& pipeline, int err)
+void IMFViewer_UI::handleImageResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const QStringList& errorMessages)
 {
-  if(err >= 0)
+  if(!errorMessages.isEmpty())
   {
-    DataContainerArray::Pointer dca = pipeline->getDataContainerArray();
-    QStringList pipelineNameTokens = pipeline->getName().split("_", QString::SplitBehavior::SkipEmptyParts);
-    int slice = 0;
-    if(pipelineNameTokens.size() > 1)
+    QString msg = tr("%1 of the selected images could not be imported:\n\n%2").arg(errorMessages.size()).arg(errorMessages.join("\n"));
+    QMessageBox::warning(this, tr("Import Images"), msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+  }
+
+  if(dca->getNumDataContainers() > 0)
+  {
+    displayPipelineOutput(pipeline, dca);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::handleMontageResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled)
+{
+  if(canceled)
+  {
+    if(IMFSessionLoader::IsSessionPipeline(pipeline))
+    {
+      m_SessionLoader->cancelDataset(pipeline);
+    }
+    else if(IMFVolumeAssembler::IsSlicePipeline(pipeline))
     {
-      slice = pipelineNameTokens[1].toInt();
+      // The volume can not be assembled without the canceled slice
+      m_VolumeAssembler->removeVolume({pipeline});
     }
+    return;
+  }
+
+  if(IMFSessionLoader::IsSessionPipeline(pipeline))
+  {
+    m_SessionLoader->addDataset(pipeline, dca, err);
+    return;
+  }
 
-    // If Display Montage was selected, remove non-stitched image data containers
-    if(m_DisplayType == AbstractImportMontageDialog::DisplayType::Montage)
+  if(IMFVolumeAssembler::IsSlicePipeline(pipeline))
+  {
+    if(err >= 0)
     {
-      for(const DataContainer::Pointer& dc : dca->getDataContainers())
-      {
-        if(dc->getName() == "MontageDC")
-        {
-          ImageGeom::Pointer imageGeom = dc->getGeometryAs<ImageGeom>();
-          if(imageGeom)
-          {
-            FloatVec3Type origin = imageGeom->getOrigin();
-            origin[2] += slice;
-            imageGeom->setOrigin(origin);
-          }
-        }
-        else
-        {
-          dca->removeDataContainer(dc->getName());
-        }
-      }
+      m_RegistrationCache->storePipelineResults(pipeline, dca);
     }
+    m_VolumeAssembler->addSlice(pipeline, dca, err);
+    return;
+  }
+
+  if(err >= 0 && IMFStreamingStitcher::IsStreamingPipeline(pipeline))
+  {
+    m_RegistrationCache->storePipelineResults(pipeline, dca);
+
+    // The stitched montage only exists on disk, so it is read back from there for display
+    QString stitchedFilePath = pipeline->property(IMFStreamingStitcher::OutputFileProperty).toString();
+    std::vector<SizeVec3Type> levels = IMFStreamingStitcher::ReadPyramidLevels(stitchedFilePath, IMFMontagePipelineBuilder::MontagePath());
+    int level = m_PyramidLevelActionGroup->checkedAction() != nullptr ? m_PyramidLevelActionGroup->checkedAction()->data().toInt() : k_MatchViewPyramidLevel;
+    if(level == k_MatchViewPyramidLevel)
+    {
+      level = IMFStreamingStitcher::SelectPyramidLevel(levels, m_Ui->vsWidget->width(), m_Ui->vsWidget->height());
+    }
+    level = std::max(0, std::min(level, static_cast<int>(levels.size()) - 1));
+
+    FilterPipeline::Pointer readerPipeline = IMFMontagePipelineBuilder::CreateStitchedFileReaderPipeline(pipeline->getName(), stitchedFilePath, level);
+    if(!readerPipeline)
+    {
+      QMessageBox::critical(this, tr("Import Montage"), tr("The stitched montage could not be read from '%1'.").arg(stitchedFilePath), QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+      return;
+    }
+
+    readerPipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(AbstractImportMontageDialog::DisplayType::Montage));
+    readerPipeline->setProperty(k_TraceStartProperty, pipeline->property(k_TraceStartProperty));
+    enqueuePipeline(readerPipeline);
+  }
+  else if(err >= 0)
+  {
+    AbstractImportMontageDialog::DisplayType displayType = m_DisplayType;
+    QVariant displayTypeVar = pipeline->property(k_DisplayTypeProperty);
+    if(displayTypeVar.isValid())
+    {
+      displayType = static_cast<AbstractImportMontageDialog::DisplayType>(displayTypeVar.toInt());
+    }
+
+    // The tile origins are only available until the tiles are removed from the stitched output
+    m_RegistrationCache->storePipelineResults(pipeline, dca);
+    if(pipeline->property(k_IncrementalStitchProperty).toBool())
+    {
+      QString tilePrefix = pipeline->property(IMFStreamingStitcher::TilePrefixProperty).toString();
+      QString amName = pipeline->property(IMFStreamingStitcher::AttributeMatrixNameProperty).toString();
+      QString daName = pipeline->property(IMFStreamingStitcher::DataArrayNameProperty).toString();
+      m_IncrementalStitcher->record(dca, tilePrefix, amName, daName, IMFMontagePipelineBuilder::MontagePath());
+    }
+    IMFMontagePipelineBuilder::FinalizeMontageOutput(pipeline, dca, displayType);
+
+    displayPipelineOutput(pipeline, dca);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::handleVolumeResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err)
+{
+  if(err < 0)
+  {
+    QString msg = tr("The slices of '%1' could not be assembled into a volume (error code %2).").arg(pipeline->getName()).arg(err);
+    QMessageBox::critical(this, tr("Import Montage"), msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+    return;
+  }
+
+  displayPipelineOutput(pipeline, dca);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::displayPipelineOutput(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca)
+{
+  VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
+  {
+    IMFTraceSpan conversionSpan(tr("VTK Conversion"), IMFTrace::RenderCategory);
+    conversionSpan.setArg("Pipeline", pipeline->getName());
+    conversionSpan.setArg("Data Containers", dca->getNumDataContainers());
 
-    VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
     baseWidget->importPipelineOutput(pipeline, dca);
+
+    // Render straight from the pipeline's buffers instead of keeping a VTK copy of each array
+    qint64 sharedBytes = IMFVtkArrayBridge::ShareFilterArrays(baseWidget->getController()->getBaseFilters(), dca);
+    conversionSpan.setArg("Shared Bytes", sharedBytes);
+  }
+
+  // The first frame drawn after the import closes the span that started when the import was requested
+  QList<QVTKOpenGLWidget*> vtkWidgets = baseWidget->getActiveViewWidget()->findChildren<QVTKOpenGLWidget*>();
+  if(vtkWidgets.isEmpty())
+  {
+    return;
+  }
+
+  QVariant traceStartVar = pipeline->property(k_TraceStartProperty);
+  qint64 traceStart = traceStartVar.isValid() ? traceStartVar.toLongLong() : IMFTrace::Now();
+  QString pipelineName = pipeline->getName();
+  std::shared_ptr<QMetaObject::Connection> connection = std::make_shared<QMetaObject::Connection>();
+  QVTKOpenGLWidget* vtkWidget = vtkWidgets.front();
+  *connection = connect(vtkWidget, &QOpenGLWidget::frameSwapped, this, [=] {
+    IMFTrace::AddSpan(tr("First Render"), IMFTrace::RenderCategory, traceStart, QJsonObject{{"Pipeline", pipelineName}});
+    disconnect(*connection);
+
+    // Datasets that finished converting after the import are shared once they have been drawn
+    if(IMFVtkArrayBridge::ShareFilterArrays(baseWidget->getController()->getBaseFilters(), dca) > 0)
+    {
+      vtkWidget->update();
+    }
+  });
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::importDream3dFile(const QString& filePath)
+{
+  DataContainerArrayProxy proxy;
+  int err = 0;
+  {
+    SIMPLH5DataReader reader;
+    QMutexLocker hdf5Locker(IMFHdf5Lock::Mutex());
+    if(reader.openFile(filePath))
+    {
+      SIMPLH5DataReaderRequirements req(SIMPL::Defaults::AnyPrimitive, SIMPL::Defaults::AnyComponentSize, AttributeMatrix::Type::Any, IGeometry::Type::Any);
+      proxy = reader.readDataContainerArrayStructure(&req, err);
+      reader.closeFile();
+    }
+    else
+    {
+      err = -1;
+    }
+  }
+
+  if(err < 0 || proxy.getDataContainers().isEmpty())
+  {
+    QMessageBox::critical(this, tr("Import Data"), tr("The data containers of '%1' could not be read.").arg(filePath), QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+    return;
+  }
+  proxy.setAllFlags(Qt::Checked);
+
+  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
+  AbstractFilter::Pointer dataContainerReader = filterFactory->createDataContainerReaderFilter(filePath, proxy);
+  if(!dataContainerReader)
+  {
+    return;
   }
+
+  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  pipeline->setName(QFileInfo(filePath).fileName());
+  pipeline->pushBack(dataContainerReader);
+  addPipelineToQueue(pipeline);
 }
 
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
-void IMFViewer_UI::importData(const QString& filePath)
+VSDatasetImporter::Pointer IMFViewer_UI::importData(const QString& filePath)
 {
   VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
   VSFilterModel* filterModel = baseWidget->getController()->getFilterModel();
@@ -794,6 +1155,7 @@ void IMFViewer_UI::importData(const QString& filePath)
 
   QFileInfo fi(filePath);
   m_Ui->queueWidget->addDataImporter(fi.fileName(), importer);
+  return importer;
 }
 
 // -----------------------------------------------------------------------------
@@ -806,29 +1168,9 @@ void IMFViewer_UI::importImages(const QStringList& filePaths)
     return;
   }
 
-  VSFilterFactory::Pointer filterFactory = VSFilterFactory::New();
-
-  FilterPipeline::Pointer pipeline = FilterPipeline::New();
+  // The images are decoded in parallel and arrive as a single dataset in handleImageResults
   QFileInfo fi(filePaths[0]);
-  pipeline->setName(fi.dir().dirName());
-
-  for(int i = 0; i < filePaths.size(); i++)
-  {
-    QString filePath = filePaths[i];
-    fi.setFile(filePath);
-    DataArrayPath dcPath(fi.fileName(), "", "");
-    AbstractFilter::Pointer imageReaderFilter = filterFactory->createImageFileReaderFilter(filePath, dcPath);
-    if(!imageReaderFilter)
-    {
-      // Error!
-      continue;
-    }
-
-    pipeline->pushBack(imageReaderFilter);
-  }
-
-  // Run the pipeline
-  addPipelineToQueue(pipeline);
+  m_ImageImporter->importImages(fi.dir().dirName(), filePaths);
 }
 
 // -----------------------------------------------------------------------------
@@ -1029,19 +1371,22 @@ void IMFViewer_UI::performMontage()
       VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(selectedFilter);
       if(dcFilter != nullptr)
       {
+        SIMPLVtkBridge::WrappedDataContainerPtr wrappedDc = dcFilter->getWrappedDataContainer();
+        DataContainer::Pointer dataContainer = wrappedDc ? wrappedDc->m_DataContainer : DataContainer::NullPointer();
+        if(dataContainer == DataContainer::NullPointer())
+        {
+          continue;
+        }
+
         validSIMPL = true;
-        DataContainer::Pointer dataContainer = dcFilter->getWrappedDataContainer()->m_DataContainer;
-        if(dataContainer != DataContainer::NullPointer())
+        for(const AttributeMatrix::Pointer& am : dataContainer->getAttributeMatrices())
         {
-          for(const AttributeMatrix::Pointer& am : dataContainer->getAttributeMatrices())
+          std::vector<size_t> tupleDims = am->getTupleDimensions();
+          if(tupleDims.size() >= 2)
           {
-            std::vector<size_t> tupleDims = am->getTupleDimensions();
-            if(tupleDims.size() >= 2)
-            {
-              amName = am->getName();
-              daName = am->getAttributeArrayNames().first();
-              break;
-            }
+            amName = am->getName();
+            daName = am->getAttributeArrayNames().first();
+            break;
           }
         }
         montageDatasets.push_back(selectedFilter);
@@ -1054,6 +1399,19 @@ void IMFViewer_UI::performMontage()
     // Build the data container array
     rowColPair = buildCustomDCA(dca, montageDatasets);
 
+    // The registration and stitching filters expect a data container in every cell of the grid
+    int cellCount = rowColPair.first * rowColPair.second;
+    if(static_cast<int>(dca->getNumDataContainers()) != cellCount)
+    {
+      QString msg = tr("The selected datasets do not form a complete grid of tiles.  %1 of the %2 cells of the %3 x %4 grid hold a dataset.  Select one dataset for every row and column of the montage.")
+                        .arg(dca->getNumDataContainers())
+                        .arg(cellCount)
+                        .arg(rowColPair.first)
+                        .arg(rowColPair.second);
+      QMessageBox::critical(this, tr("Perform Montage"), msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+      return;
+    }
+
     QStringList dcNames = dca->getDataContainerNames();
 
     IntVec2Type montageSize = {rowColPair.second, rowColPair.first};
@@ -1061,6 +1419,13 @@ void IMFViewer_UI::performMontage()
     IntVec2Type montageEnd = {montageSize[0] - 1, montageSize[1] - 1};
 
     QString dcPrefix = MontageUtilities::FindDataContainerPrefix(dcNames);
+    bool saveToFile = performMontageDialog->getSaveToFile();
+
+    // Restitching the tiles of the displayed montage only recomposites the tiles that moved
+    if(stitchingOnly && !saveToFile && m_IncrementalStitcher->canUpdate(dca, dcPrefix, amName, daName) && m_IncrementalStitcher->update(dca) >= 0)
+    {
+      return;
+    }
 
     if(!stitchingOnly)
     {
@@ -1068,12 +1433,14 @@ void IMFViewer_UI::performMontage()
       pipeline->pushBack(itkRegistrationFilter);
     }
 
-    DataArrayPath montagePath("MontageDC", "MontageAM", "MontageData");
+    // A full restitch blends the tile overlaps with the ITK stitching filter.  Only the regions
+    // of moved tiles are recomposited, by the incremental stitcher above.
+    DataArrayPath montagePath = IMFMontagePipelineBuilder::MontagePath();
     AbstractFilter::Pointer itkStitchingFilter = filterFactory->createTileStitchingFilter(montageStart, montageEnd, dcPrefix, amName, daName, montagePath);
     pipeline->pushBack(itkStitchingFilter);
 
-    // Check if output to file was requested
-    bool saveToFile = performMontageDialog->getSaveToFile();
+    // Check if output to file was requested.  The writer is part of the pipeline, so it is
+    // preflighted with the other filters before anything executes.
     if(saveToFile)
     {
       QString outputFilePath = performMontageDialog->getOutputPath();
@@ -1081,7 +1448,13 @@ void IMFViewer_UI::performMontage()
       pipeline->pushBack(itkImageWriterFilter);
     }
 
-    executePipeline(pipeline, dca);
+    pipeline->setProperty(k_DisplayTypeProperty, static_cast<int>(m_DisplayType));
+    pipeline->setProperty(k_IncrementalStitchProperty, true);
+    pipeline->setProperty(IMFStreamingStitcher::TilePrefixProperty, dcPrefix);
+    pipeline->setProperty(IMFStreamingStitcher::AttributeMatrixNameProperty, amName);
+    pipeline->setProperty(IMFStreamingStitcher::DataArrayNameProperty, daName);
+
+    enqueuePipeline(pipeline, dca);
   }
 }
 
@@ -1169,35 +1542,131 @@ void IMFViewer_UI::saveSession()
 // -----------------------------------------------------------------------------
 void IMFViewer_UI::saveImage()
 {
-  QString filter = tr("Image File (*.png *.tiff *.jpeg *.bmp)");
-  QString filePath = QFileDialog::getSaveFileName(this, "Save As Image File", m_OpenDialogLastDirectory, filter);
-  if(filePath.isEmpty())
+  if(m_RenderCanceled)
   {
+    QMessageBox::critical(this, "Save As Image File", tr("Other images are still being saved."), QMessageBox::StandardButton::Ok);
     return;
   }
 
-  m_OpenDialogLastDirectory = filePath;
-  VSController* controller = m_Ui->vsWidget->getController();
   VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
-  //  VSFilterViewModel* filterViewModel = baseWidget->getActiveViewWidget()->getFilterViewModel();
   VSAbstractFilter::FilterListType selectedFilters = baseWidget->getActiveViewWidget()->getSelectedFilters();
 
-  bool success = controller->saveAsImage(filePath, selectedFilters.front());
+  // Without a selection every dataset of the session is exported
+  if(selectedFilters.empty())
+  {
+    selectedFilters = baseWidget->getController()->getBaseFilters();
+  }
 
-  if(success)
+  std::vector<DataContainer::Pointer> dataContainers;
+  collectDataContainers(selectedFilters, dataContainers);
+  if(dataContainers.empty())
   {
-    // Add file to the recent files list
-    QtSRecentFileList* list = QtSRecentFileList::Instance();
-    list->addFile(filePath);
+    QMessageBox::critical(this, "Invalid Filter Type", tr("The filter must be a data container or pipeline filter."), QMessageBox::StandardButton::Ok);
+    return;
+  }
 
-    // Open the image in the default application for the system
-    QDesktopServices::openUrl(QUrl::fromLocalFile(filePath));
+  IMFOffscreenRenderer::Options options;
+  options.Width = m_Ui->vsWidget->width();
+  bool separateImages = false;
+  if(!getImageExportOptions(dataContainers.size() > 1, options, separateImages, this))
+  {
+    return;
   }
-  else
+
+  QString filter = tr("Image File (*.png *.tiff *.jpeg *.bmp)");
+  QString filePath = QFileDialog::getSaveFileName(this, "Save As Image File", m_OpenDialogLastDirectory, filter);
+  if(filePath.isEmpty())
+  {
+    return;
+  }
+  if(!IMFOffscreenRenderer::IsSupportedImageFile(filePath))
   {
-    QMessageBox::critical(this, "Invalid Filter Type", tr("The filter must be a data container filter."), QMessageBox::StandardButton::Ok);
+    QMessageBox::critical(this, "Save As Image File", tr("'%1' does not have a PNG, TIFF, JPEG or BMP file extension.").arg(filePath), QMessageBox::StandardButton::Ok);
     return;
   }
+
+  m_OpenDialogLastDirectory = filePath;
+
+  // Each image is drawn without a window at the requested size, independent of the view
+  std::vector<std::pair<QString, std::vector<DataContainer::Pointer>>> images;
+  if(separateImages)
+  {
+    QFileInfo fi(filePath);
+    for(const DataContainer::Pointer& dc : dataContainers)
+    {
+      images.push_back({fi.dir().filePath(QString("%1_%2.%3").arg(fi.completeBaseName(), dc->getName(), fi.suffix())), {dc}});
+    }
+  }
+  else
+  {
+    images.push_back({filePath, dataContainers});
+  }
+
+  // The images are drawn on the render thread so the view stays usable while large images are saved.
+  // A single image shows a busy indicator, since its tiles are drawn by one VTK call.
+  int imageCount = static_cast<int>(images.size());
+  QPointer<QProgressDialog> progressDialog = new QProgressDialog(tr("Saving images..."), tr("Cancel"), 0, imageCount > 1 ? imageCount : 0, this);
+  progressDialog->setWindowTitle(tr("Save As Image File"));
+  progressDialog->setWindowModality(Qt::NonModal);
+  progressDialog->setMinimumDuration(500);
+  progressDialog->setAutoClose(false);
+  progressDialog->setValue(0);
+
+  std::shared_ptr<std::atomic_bool> canceled = std::make_shared<std::atomic_bool>(false);
+  m_RenderCanceled = canceled;
+  connect(progressDialog, &QProgressDialog::canceled, this, [canceled] { *canceled = true; });
+
+  QFutureWatcher<QStringList>* renderWatcher = new QFutureWatcher<QStringList>(this);
+  connect(renderWatcher, &QFutureWatcher<QStringList>::finished, this, [=] {
+    m_RenderCanceled.reset();
+    renderWatcher->deleteLater();
+    if(progressDialog)
+    {
+      progressDialog->deleteLater();
+    }
+
+    QStringList errorMessages = renderWatcher->result();
+    if(!errorMessages.isEmpty())
+    {
+      QString msg = tr("%1 of the images could not be rendered:\n\n%2").arg(errorMessages.size()).arg(errorMessages.join("\n"));
+      QMessageBox::critical(this, "Save As Image File", msg, QMessageBox::StandardButton::Ok);
+      return;
+    }
+    if(*canceled)
+    {
+      processStatusMessage(tr("Saving images to '%1' was canceled").arg(QFileInfo(filePath).absolutePath()));
+      return;
+    }
+
+    if(images.size() == 1)
+    {
+      // Add file to the recent files list
+      QtSRecentFileList* list = QtSRecentFileList::Instance();
+      list->addFile(filePath);
+
+      // Open the image in the default application for the system
+      QDesktopServices::openUrl(QUrl::fromLocalFile(filePath));
+    }
+    else
+    {
+      processStatusMessage(tr("Saved %1 images to '%2'").arg(images.size()).arg(QFileInfo(filePath).absolutePath()));
+    }
+  });
+
+  IMFOffscreenRenderer* renderer = m_OffscreenRenderer;
+  renderWatcher->setFuture(QtConcurrent::run(m_RenderThreadPool, [=] {
+    QStringList errorMessages;
+    for(int i = 0; i < imageCount && !*canceled; i++)
+    {
+      int err = renderer->render(images[i].second, images[i].first, options);
+      if(err < 0)
+      {
+        errorMessages.push_back(tr("'%1' (error code %2)").arg(images[i].first).arg(err));
+      }
+      QMetaObject::invokeMethod(progressDialog, "setValue", Qt::QueuedConnection, Q_ARG(int, i + 1));
+    }
+    return errorMessages;
+  }));
 }
 
 // -----------------------------------------------------------------------------
@@ -1205,7 +1674,6 @@ void IMFViewer_UI::saveImage()
 // -----------------------------------------------------------------------------
 void IMFViewer_UI::saveDream3d()
 {
-  VSController* controller = m_Ui->vsWidget->getController();
   VSMainWidgetBase* baseWidget = dynamic_cast<VSMainWidgetBase*>(m_Ui->vsWidget);
   VSAbstractFilter::FilterListType selectedFilters = baseWidget->getActiveViewWidget()->getSelectedFilters();
   if(selectedFilters.empty())
@@ -1214,6 +1682,20 @@ void IMFViewer_UI::saveDream3d()
     return;
   }
 
+  std::vector<DataContainer::Pointer> dataContainers;
+  collectDataContainers({selectedFilters.front()}, dataContainers);
+  if(dataContainers.empty())
+  {
+    QMessageBox::critical(this, "Invalid Filter Type", tr("The filter must be a data container or pipeline filter."), QMessageBox::StandardButton::Ok);
+    return;
+  }
+
+  if(m_Dream3dWriter->isSaving())
+  {
+    QMessageBox::critical(this, "Save As DREAM3D File", tr("Another DREAM3D file is still being saved."), QMessageBox::StandardButton::Ok);
+    return;
+  }
+
   QString filter = tr("DREAM3D File (*.dream3d)");
   QString filePath = QFileDialog::getSaveFileName(this, "Save As DREAM3D File", m_OpenDialogLastDirectory, filter);
   if(filePath.isEmpty())
@@ -1223,19 +1705,113 @@ void IMFViewer_UI::saveDream3d()
 
   m_OpenDialogLastDirectory = filePath;
 
-  bool success = controller->saveAsDREAM3D(filePath, selectedFilters.front());
+  IMFDream3dWriter::Options options;
+  if(m_CompressionActionGroup->checkedAction() != nullptr)
+  {
+    options.Filter = static_cast<IMFDream3dWriter::Compression>(m_CompressionActionGroup->checkedAction()->data().toInt());
+  }
+  options.Level = m_CompressionLevel;
+
+  // The file is written on a worker thread so the view stays usable while large montages are saved
+  QProgressDialog* progressDialog = new QProgressDialog(tr("Saving '%1'...").arg(QFileInfo(filePath).fileName()), tr("Cancel"), 0, 100, this);
+  progressDialog->setWindowTitle(tr("Save As DREAM3D File"));
+  progressDialog->setWindowModality(Qt::NonModal);
+  progressDialog->setMinimumDuration(500);
+  progressDialog->setAutoClose(false);
+  progressDialog->setValue(0);
+  connect(m_Dream3dWriter, &IMFDream3dWriter::progressChanged, progressDialog, &QProgressDialog::setValue);
+  connect(m_Dream3dWriter, &IMFDream3dWriter::saveFinished, progressDialog, &QObject::deleteLater);
+  connect(progressDialog, &QProgressDialog::canceled, m_Dream3dWriter, &IMFDream3dWriter::cancel);
+
+  m_Dream3dWriter->save(filePath, dataContainers, options);
+}
 
-  if(success)
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::handleSaveResults(const QString& filePath, int err)
+{
+  if(err == IMFDream3dWriter::k_CanceledError)
   {
-    // Add file to the recent files list
-    QtSRecentFileList* list = QtSRecentFileList::Instance();
-    list->addFile(filePath);
+    processStatusMessage(tr("Saving '%1' was canceled").arg(QFileInfo(filePath).fileName()));
+    return;
   }
-  else
+  if(err < 0)
   {
-    QMessageBox::critical(this, "Invalid Filter Type", tr("The filter must be a data container or pipeline filter."), QMessageBox::StandardButton::Ok);
+    QString msg = tr("The DREAM3D file '%1' could not be written (error code %2).").arg(filePath).arg(err);
+    QMessageBox::critical(this, "Save As DREAM3D File", msg, QMessageBox::StandardButton::Ok, QMessageBox::StandardButton::Ok);
+    return;
+  }
+
+  // Add file to the recent files list
+  QtSRecentFileList* list = QtSRecentFileList::Instance();
+  list->addFile(filePath);
+  processStatusMessage(tr("Saved '%1'").arg(QFileInfo(filePath).fileName()));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::exportTrace()
+{
+  QString filter = tr("Chrome Trace File (*.json)");
+  QString filePath = QFileDialog::getSaveFileName(this, "Export Trace", m_OpenDialogLastDirectory + QDir::separator() + "IMFViewerTrace.json", filter);
+  if(filePath.isEmpty())
+  {
+    return;
+  }
+
+  m_OpenDialogLastDirectory = filePath;
+
+  if(!IMFTrace::WriteChromeTrace(filePath))
+  {
+    QMessageBox::critical(this, "Export Trace", tr("The trace could not be written to '%1'.").arg(filePath), QMessageBox::StandardButton::Ok);
     return;
   }
+
+  processStatusMessage(tr("Exported %1 trace events to '%2'").arg(IMFTrace::GetEventCount()).arg(filePath));
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::showTileCacheStatistics()
+{
+  IMFTileCache::Statistics statistics = IMFTileCache::GetStatistics();
+  qint64 lookupCount = statistics.hits + statistics.diskHits + statistics.misses;
+  double hitRate = (lookupCount > 0) ? 100.0 * (statistics.hits + statistics.diskHits) / lookupCount : 0.0;
+
+  QString text = tr("Hits: %1 from memory, %2 from disk\nMisses: %3\nHit rate: %4%\n\n").arg(statistics.hits).arg(statistics.diskHits).arg(statistics.misses).arg(hitRate, 0, 'f', 1);
+  text += tr("In memory: %1 tiles, %2 of %3 MB\n").arg(statistics.memoryEntries).arg(statistics.memoryBytes / (1024 * 1024)).arg(IMFTileCache::GetMemoryLimit() / (1024 * 1024));
+  text += tr("On disk: %1 tiles, %2 of %3 MB, %4 spilled\n").arg(statistics.diskEntries).arg(statistics.diskBytes / (1024 * 1024)).arg(IMFTileCache::GetDiskLimit() / (1024 * 1024)).arg(statistics.spills);
+  text += tr("Disk cache directory: %1").arg(IMFTileCache::GetDiskDirectory());
+
+  QMessageBox messageBox(QMessageBox::Information, "Decoded Tile Cache Statistics", text, QMessageBox::Ok, this);
+  QPushButton* resetButton = messageBox.addButton(tr("Reset Counts"), QMessageBox::ResetRole);
+  messageBox.exec();
+  if(messageBox.clickedButton() == resetButton)
+  {
+    IMFTileCache::ResetStatistics();
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFViewer_UI::editMemoryBudget()
+{
+  int physicalMemoryMB = static_cast<int>(std::min(IMFPipelineScheduler::PhysicalMemorySize() / (1024 * 1024), static_cast<qint64>(std::numeric_limits<int>::max())));
+  int memoryBudgetMB = static_cast<int>(std::min(m_PipelineScheduler->getMemoryBudget() / (1024 * 1024), static_cast<qint64>(std::numeric_limits<int>::max())));
+
+  bool ok = false;
+  int value = QInputDialog::getInt(this, tr("Memory Budget"),
+                                   tr("Memory the executing pipelines may use together, in MB.  A pipeline that does not fit waits until others finish.  0 starts pipelines regardless "
+                                      "of their size."),
+                                   memoryBudgetMB, 0, std::max(physicalMemoryMB, memoryBudgetMB), 256, &ok);
+  if(ok)
+  {
+    m_PipelineScheduler->setMemoryBudget(static_cast<qint64>(value) * 1024 * 1024);
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -1268,10 +1844,10 @@ void IMFViewer_UI::loadSession()
 // -----------------------------------------------------------------------------
 void IMFViewer_UI::loadSessionFromFile(const QString& filePath)
 {
-  VSController* controller = m_Ui->vsWidget->getController();
-  bool success = controller->loadSession(filePath);
+  // The datasets arrive in handleMontageResults and importData while the window stays usable
+  int datasetCount = m_SessionLoader->loadSession(filePath);
 
-  if(success)
+  if(datasetCount >= 0)
   {
     // Add file to the recent files list
     QtSRecentFileList* list = QtSRecentFileList::Instance();
@@ -1297,6 +1873,56 @@ void IMFViewer_UI::readSettings()
 
   prefs->endGroup();
 
+  prefs->beginGroup("Import Queue");
+  int workerCount = prefs->value("Concurrent Pipelines", QVariant(IMFPipelineScheduler::DefaultWorkerCount())).toInt();
+  m_PipelineScheduler->setMaxWorkerCount(workerCount);
+  for(QAction* action : m_WorkerCountActionGroup->actions())
+  {
+    action->setChecked(action->text().toInt() == workerCount);
+  }
+  qint64 defaultBudgetMB = IMFPipelineScheduler::PhysicalMemorySize() / 4 * 3 / (1024 * 1024);
+  qint64 memoryBudgetMB = prefs->value("Memory Budget (MB)", QVariant(defaultBudgetMB)).toLongLong();
+  m_PipelineScheduler->setMemoryBudget(memoryBudgetMB * 1024 * 1024);
+  qint64 defaultImageBudgetMB = IMFPipelineScheduler::PhysicalMemorySize() / 4 / (1024 * 1024);
+  qint64 imageBudgetMB = prefs->value("Image Import Memory Budget (MB)", QVariant(defaultImageBudgetMB)).toLongLong();
+  m_ImageImporter->setMemoryBudget(imageBudgetMB * 1024 * 1024);
+  m_StitchToDiskAction->setChecked(prefs->value("Stitch Montages To Disk", QVariant(false)).toBool());
+  m_LowMemoryStitchingAction->setChecked(prefs->value("Low Memory Stitching", QVariant(false)).toBool());
+  m_AssembleVolumeAction->setChecked(prefs->value("Assemble Robomet Slices Into Volume", QVariant(false)).toBool());
+  m_AlignSlicesAction->setChecked(prefs->value("Align Volume Slices", QVariant(false)).toBool());
+  m_ImportRegionAction->setChecked(prefs->value("Import DREAM3D Montage Region", QVariant(false)).toBool());
+  m_PipelinedImportAction->setChecked(prefs->value("Pipelined Montage Import", QVariant(false)).toBool());
+  int pyramidLevel = prefs->value("Stitched Montage Resolution", QVariant(k_MatchViewPyramidLevel)).toInt();
+  for(QAction* action : m_PyramidLevelActionGroup->actions())
+  {
+    action->setChecked(action->data().toInt() == pyramidLevel);
+  }
+  m_LoadTilesOnDemandAction->setChecked(prefs->value("Load Tiles On Demand", QVariant(true)).toBool());
+  m_DecodeThreadCount = std::max(1, prefs->value("Tile Decode Threads", QVariant(QThread::idealThreadCount())).toInt());
+  qint64 tileCacheMB = prefs->value("Tile Cache Size (MB)", QVariant(m_LazyTileLoader->getCacheSize() / (1024 * 1024))).toLongLong();
+  m_LazyTileLoader->setCacheSize(tileCacheMB * 1024 * 1024);
+  bool useRegistrationCache = prefs->value("Reuse Registration Results", QVariant(true)).toBool();
+  m_UseRegistrationCacheAction->setChecked(useRegistrationCache);
+  qint64 registrationCacheMB = prefs->value("Registration Cache Size (MB)", QVariant(m_RegistrationCache->getMaxSize() / (1024 * 1024))).toLongLong();
+  m_RegistrationCache->setMaxSize(registrationCacheMB * 1024 * 1024);
+  m_CacheDecodedTilesAction->setChecked(prefs->value("Cache Decoded Tiles", QVariant(true)).toBool());
+  qint64 decodedTileCacheMB = prefs->value("Decoded Tile Cache Size (MB)", QVariant(IMFTileCache::GetMemoryLimit() / (1024 * 1024))).toLongLong();
+  IMFTileCache::SetMemoryLimit(decodedTileCacheMB * 1024 * 1024);
+  IMFTileCache::SetDiskDirectory(prefs->value("Decoded Tile Cache Directory", QVariant(IMFTileCache::DefaultDiskDirectory())).toString());
+  qint64 decodedTileDiskCacheMB = prefs->value("Decoded Tile Disk Cache Size (MB)", QVariant(IMFTileCache::GetDiskLimit() / (1024 * 1024))).toLongLong();
+  IMFTileCache::SetDiskLimit(decodedTileDiskCacheMB * 1024 * 1024);
+  m_SpillDecodedTilesAction->setChecked(prefs->value("Spill Decoded Tiles To Disk", QVariant(false)).toBool());
+  prefs->endGroup();
+
+  prefs->beginGroup("Save As DREAM3D");
+  int compression = prefs->value("Compression", QVariant(static_cast<int>(IMFDream3dWriter::Options().Filter))).toInt();
+  for(QAction* action : m_CompressionActionGroup->actions())
+  {
+    action->setChecked(action->data().toInt() == compression);
+  }
+  m_CompressionLevel = std::max(1, std::min(prefs->value("Compression Level", QVariant(IMFDream3dWriter::Options().Level)).toInt(), 9));
+  prefs->endGroup();
+
   QtSRecentFileList::Instance()->readList(prefs.data());
 }
 
@@ -1361,6 +1987,40 @@ void IMFViewer_UI::writeSettings()
 
   prefs->endGroup();
 
+  prefs->beginGroup("Import Queue");
+  prefs->setValue("Concurrent Pipelines", m_PipelineScheduler->getMaxWorkerCount());
+  prefs->setValue("Memory Budget (MB)", QVariant(m_PipelineScheduler->getMemoryBudget() / (1024 * 1024)));
+  prefs->setValue("Image Import Memory Budget (MB)", QVariant(m_ImageImporter->getMemoryBudget() / (1024 * 1024)));
+  prefs->setValue("Stitch Montages To Disk", QVariant(m_StitchToDiskAction->isChecked()));
+  prefs->setValue("Low Memory Stitching", QVariant(m_LowMemoryStitchingAction->isChecked()));
+  prefs->setValue("Assemble Robomet Slices Into Volume", QVariant(m_AssembleVolumeAction->isChecked()));
+  prefs->setValue("Align Volume Slices", QVariant(m_AlignSlicesAction->isChecked()));
+  prefs->setValue("Import DREAM3D Montage Region", QVariant(m_ImportRegionAction->isChecked()));
+  prefs->setValue("Pipelined Montage Import", QVariant(m_PipelinedImportAction->isChecked()));
+  if(m_PyramidLevelActionGroup->checkedAction() != nullptr)
+  {
+    prefs->setValue("Stitched Montage Resolution", m_PyramidLevelActionGroup->checkedAction()->data());
+  }
+  prefs->setValue("Load Tiles On Demand", QVariant(m_LoadTilesOnDemandAction->isChecked()));
+  prefs->setValue("Tile Decode Threads", QVariant(m_DecodeThreadCount));
+  prefs->setValue("Tile Cache Size (MB)", QVariant(m_LazyTileLoader->getCacheSize() / (1024 * 1024)));
+  prefs->setValue("Reuse Registration Results", QVariant(m_RegistrationCache->isEnabled()));
+  prefs->setValue("Registration Cache Size (MB)", QVariant(m_RegistrationCache->getMaxSize() / (1024 * 1024)));
+  prefs->setValue("Cache Decoded Tiles", QVariant(IMFTileCache::IsEnabled()));
+  prefs->setValue("Decoded Tile Cache Size (MB)", QVariant(IMFTileCache::GetMemoryLimit() / (1024 * 1024)));
+  prefs->setValue("Decoded Tile Cache Directory", QVariant(IMFTileCache::GetDiskDirectory()));
+  prefs->setValue("Decoded Tile Disk Cache Size (MB)", QVariant(IMFTileCache::GetDiskLimit() / (1024 * 1024)));
+  prefs->setValue("Spill Decoded Tiles To Disk", QVariant(IMFTileCache::IsDiskSpillEnabled()));
+  prefs->endGroup();
+
+  prefs->beginGroup("Save As DREAM3D");
+  if(m_CompressionActionGroup->checkedAction() != nullptr)
+  {
+    prefs->setValue("Compression", m_CompressionActionGroup->checkedAction()->data());
+  }
+  prefs->setValue("Compression Level", QVariant(m_CompressionLevel));
+  prefs->endGroup();
+
   QtSRecentFileList::Instance()->writeList(prefs.data());
 }
 
@@ -1466,6 +2126,21 @@ void IMFViewer_UI::createMenu()
   connect(saveDream3dAction, &QAction::triggered, this, &IMFViewer_UI::saveDream3d);
   fileMenu->addAction(saveDream3dAction);
 
+  QMenu* menuCompression = new QMenu("DREAM3D Compression", fileMenu);
+  fileMenu->addMenu(menuCompression);
+
+  m_CompressionActionGroup = new QActionGroup(this);
+  std::vector<std::pair<QString, IMFDream3dWriter::Compression>> compressions = {
+      {"None", IMFDream3dWriter::Compression::None}, {"Deflate", IMFDream3dWriter::Compression::Deflate}, {"Shuffle + Deflate", IMFDream3dWriter::Compression::ShuffleDeflate}};
+  for(const std::pair<QString, IMFDream3dWriter::Compression>& compression : compressions)
+  {
+    QAction* action = menuCompression->addAction(compression.first);
+    action->setCheckable(true);
+    action->setData(static_cast<int>(compression.second));
+    action->setChecked(compression.second == IMFDream3dWriter::Options().Filter);
+    m_CompressionActionGroup->addAction(action);
+  }
+
   fileMenu->addSeparator();
 
   //  m_RecentFilesMenu = new QMenu("Recent Sessions", this);
@@ -1505,6 +2180,9 @@ void IMFViewer_UI::createMenu()
 
   viewMenu->addAction(m_Ui->queueDockWidget->toggleViewAction());
 
+  m_WorkerCountActionGroup = new QActionGroup(this);
+  viewMenu->addMenu(createImportQueueMenu(m_WorkerCountActionGroup, viewMenu));
+
   m_MenuBar->addMenu(viewMenu);
 
   // Add Filter Menu
@@ -1549,6 +2227,111 @@ QMenu* IMFViewer_UI::createThemeMenu(QActionGroup* actionGroup, QWidget* parent)
   return menuThemes;
 }
 
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+QMenu* IMFViewer_UI::createImportQueueMenu(QActionGroup* actionGroup, QWidget* parent)
+{
+  QMenu* menuImportQueue = new QMenu("Import Queue", parent);
+
+  QMenu* menuWorkers = new QMenu("Concurrent Pipelines", menuImportQueue);
+  menuImportQueue->addMenu(menuWorkers);
+
+  std::vector<int> workerCounts = {1, 2, 4, 8, QThread::idealThreadCount()};
+  std::sort(workerCounts.begin(), workerCounts.end());
+  workerCounts.erase(std::unique(workerCounts.begin(), workerCounts.end()), workerCounts.end());
+  for(int workerCount : workerCounts)
+  {
+    QAction* action = menuWorkers->addAction(QString::number(workerCount), [=] { m_PipelineScheduler->setMaxWorkerCount(workerCount); });
+    action->setCheckable(true);
+    if(workerCount == m_PipelineScheduler->getMaxWorkerCount())
+    {
+      action->setChecked(true);
+    }
+    actionGroup->addAction(action);
+  }
+
+  QAction* memoryBudgetAction = menuImportQueue->addAction("Memory Budget...");
+  connect(memoryBudgetAction, &QAction::triggered, this, &IMFViewer_UI::editMemoryBudget);
+
+  menuImportQueue->addSeparator();
+
+  m_StitchToDiskAction = menuImportQueue->addAction("Stitch Montages To Disk");
+  m_StitchToDiskAction->setCheckable(true);
+
+  m_LowMemoryStitchingAction = menuImportQueue->addAction("Low Memory Stitching");
+  m_LowMemoryStitchingAction->setCheckable(true);
+
+  m_AssembleVolumeAction = menuImportQueue->addAction("Assemble Robomet Slices Into Volume");
+  m_AssembleVolumeAction->setCheckable(true);
+
+  m_AlignSlicesAction = menuImportQueue->addAction("Align Volume Slices");
+  m_AlignSlicesAction->setCheckable(true);
+  m_AlignSlicesAction->setEnabled(false);
+  connect(m_AssembleVolumeAction, &QAction::toggled, m_AlignSlicesAction, &QAction::setEnabled);
+
+  m_ImportRegionAction = menuImportQueue->addAction("Import DREAM3D Montage Region");
+  m_ImportRegionAction->setCheckable(true);
+
+  m_PipelinedImportAction = menuImportQueue->addAction("Pipelined Montage Import");
+  m_PipelinedImportAction->setCheckable(true);
+
+  QMenu* menuResolution = new QMenu("Stitched Montage Resolution", menuImportQueue);
+  menuImportQueue->addMenu(menuResolution);
+
+  m_PyramidLevelActionGroup = new QActionGroup(this);
+  std::vector<std::pair<QString, int>> resolutions = {{"Match View", k_MatchViewPyramidLevel}, {"Full Resolution", 0}, {"1/2", 1}, {"1/4", 2}, {"1/8", 3}, {"1/16", 4}};
+  for(const std::pair<QString, int>& resolution : resolutions)
+  {
+    QAction* action = menuResolution->addAction(resolution.first);
+    action->setCheckable(true);
+    action->setData(resolution.second);
+    action->setChecked(resolution.second == k_MatchViewPyramidLevel);
+    m_PyramidLevelActionGroup->addAction(action);
+  }
+
+  m_LoadTilesOnDemandAction = menuImportQueue->addAction("Load Tiles On Demand");
+  m_LoadTilesOnDemandAction->setCheckable(true);
+  m_LoadTilesOnDemandAction->setChecked(true);
+
+  m_UseRegistrationCacheAction = menuImportQueue->addAction("Reuse Registration Results");
+  m_UseRegistrationCacheAction->setCheckable(true);
+  m_UseRegistrationCacheAction->setChecked(m_RegistrationCache->isEnabled());
+  connect(m_UseRegistrationCacheAction, &QAction::toggled, [=](bool checked) { m_RegistrationCache->setEnabled(checked); });
+
+  QAction* clearCacheAction = menuImportQueue->addAction("Clear Registration Cache");
+  connect(clearCacheAction, &QAction::triggered, m_RegistrationCache, &IMFRegistrationCache::clear);
+
+  m_CacheDecodedTilesAction = menuImportQueue->addAction("Cache Decoded Tiles");
+  m_CacheDecodedTilesAction->setCheckable(true);
+  m_CacheDecodedTilesAction->setChecked(IMFTileCache::IsEnabled());
+  connect(m_CacheDecodedTilesAction, &QAction::toggled, [=](bool checked) { IMFTileCache::SetEnabled(checked); });
+
+  m_SpillDecodedTilesAction = menuImportQueue->addAction("Spill Decoded Tiles To Disk");
+  m_SpillDecodedTilesAction->setCheckable(true);
+  m_SpillDecodedTilesAction->setChecked(IMFTileCache::IsDiskSpillEnabled());
+  connect(m_SpillDecodedTilesAction, &QAction::toggled, [=](bool checked) { IMFTileCache::SetDiskSpillEnabled(checked); });
+
+  QAction* tileCacheStatisticsAction = menuImportQueue->addAction("Decoded Tile Cache Statistics...");
+  connect(tileCacheStatisticsAction, &QAction::triggered, this, &IMFViewer_UI::showTileCacheStatistics);
+
+  QAction* clearTileCacheAction = menuImportQueue->addAction("Clear Decoded Tile Cache");
+  connect(clearTileCacheAction, &QAction::triggered, [=] { IMFTileCache::Clear(); });
+
+  menuImportQueue->addSeparator();
+
+  QAction* exportTraceAction = menuImportQueue->addAction("Export Trace...");
+  connect(exportTraceAction, &QAction::triggered, this, &IMFViewer_UI::exportTrace);
+
+  menuImportQueue->addSeparator();
+
+  QAction* cancelAction = menuImportQueue->addAction("Cancel All Imports");
+  connect(cancelAction, &QAction::triggered, m_PipelineScheduler, &IMFPipelineScheduler::cancelAll);
+  connect(cancelAction, &QAction::triggered, m_ImageImporter, &IMFImageImporter::cancelAll);
+
+  return menuImportQueue;
+}
+
 // -----------------------------------------------------------------------------
 //
 // -----------------------------------------------------------------------------
@@ -1597,116 +2380,45 @@ void IMFViewer_UI::listenSelectionChanged(VSAbstractFilter::FilterListType filte
 // -----------------------------------------------------------------------------
 std::pair<int, int> IMFViewer_UI::buildCustomDCA(const DataContainerArray::Pointer& dca, VSAbstractFilter::FilterListType montageDatasets)
 {
-  // Get the minimum X and minimum Y coordinates to use as a 'base'
-  // This is useful to handle edge cases where the position values are large
-  double minX = 0.0;
-  double minY = 0.0;
-  bool firstDataset = true;
-  std::list<VSAbstractFilter*>::const_iterator iterator;
-  for(iterator = montageDatasets.begin(); iterator != montageDatasets.end(); ++iterator)
-  {
-    VSAbstractFilter* montageDataset = *iterator;
-    double* pos = montageDataset->getTransform()->getLocalPosition();
-    if(dynamic_cast<VSFileNameFilter*>(montageDataset) != nullptr)
-    {
-      pos = montageDataset->getChildren().front()->getTransform()->getLocalPosition();
-    }
-    if(firstDataset)
+  // Read each tile's position and extent once
+  std::vector<VSAbstractFilter*> datasets(montageDatasets.begin(), montageDatasets.end());
+  std::vector<IMFTileGridIndex::Tile> tiles;
+  for(VSAbstractFilter* montageDataset : datasets)
+  {
+    // A file name filter only groups the dataset that was read from the file
+    VSAbstractFilter* tileDataset = montageDataset;
+    if(dynamic_cast<VSFileNameFilter*>(montageDataset) != nullptr && !montageDataset->getChildren().isEmpty())
     {
-      minX = pos[0];
-      minY = pos[1];
-      firstDataset = false;
+      tileDataset = montageDataset->getChildren().front();
     }
-    else
+    double* pos = tileDataset->getTransform()->getLocalPosition();
+
+    IMFTileGridIndex::Tile tile;
+    tile.x = pos[0];
+    tile.y = pos[1];
+    VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(tileDataset);
+    DataContainer::Pointer tileDC = (dcFilter != nullptr && dcFilter->getWrappedDataContainer()) ? dcFilter->getWrappedDataContainer()->m_DataContainer : DataContainer::NullPointer();
+    ImageGeom::Pointer imageGeom = tileDC ? tileDC->getGeometryAs<ImageGeom>() : ImageGeom::NullPointer();
+    if(imageGeom != ImageGeom::NullPointer())
     {
-      if(pos[0] < minX)
-      {
-        minX = pos[0];
-      }
-      if(pos[1] < minY)
-      {
-        minY = pos[1];
-      }
+      SizeVec3Type dims = imageGeom->getDimensions();
+      FloatVec3Type spacing = imageGeom->getSpacing();
+      tile.width = dims[0] * spacing[0];
+      tile.height = dims[1] * spacing[1];
     }
+    tiles.push_back(tile);
   }
 
-  montageDatasets.sort([minX](VSAbstractFilter* first, VSAbstractFilter* second) {
-    VSTransform* firstTransform = first->getTransform();
-    VSTransform* secondTransform = second->getTransform();
-    if(dynamic_cast<VSFileNameFilter*>(first) != nullptr && dynamic_cast<VSFileNameFilter*>(second) != nullptr)
-    {
-      firstTransform = first->getChildren().front()->getTransform();
-      secondTransform = second->getChildren().front()->getTransform();
-    }
-    int firstX = firstTransform->getLocalPosition()[0] - minX;
-    int secondX = secondTransform->getLocalPosition()[0] - minX;
-    bool secondXGreaterThanFirstX = floor(1.05 * firstX) < secondX;
-    return secondXGreaterThanFirstX;
-  });
-  montageDatasets.sort([minY](VSAbstractFilter* first, VSAbstractFilter* second) {
-    VSTransform* firstTransform = first->getTransform();
-    VSTransform* secondTransform = second->getTransform();
-    if(dynamic_cast<VSFileNameFilter*>(first) != nullptr && dynamic_cast<VSFileNameFilter*>(second) != nullptr)
-    {
-      firstTransform = first->getChildren().front()->getTransform();
-      secondTransform = second->getChildren().front()->getTransform();
-    }
-    int firstY = firstTransform->getLocalPosition()[1] - minY;
-    int secondY = secondTransform->getLocalPosition()[1] - minY;
-    bool secondYGreaterThanFirstY = floor(1.05 * firstY) < secondY;
-    return secondYGreaterThanFirstY;
-  });
-
-  int row = 0;
-  int col = 0;
-  int numRows = 0;
-  int numCols = 0;
-  firstDataset = true;
-  double prevX;
-  double prevY;
-
-  for(iterator = montageDatasets.begin(); iterator != montageDatasets.end(); ++iterator)
+  IMFTileGridIndex gridIndex(tiles);
+  for(size_t index : gridIndex.getTileOrder())
   {
-    VSAbstractFilter* montageDataset = *iterator;
-    double* pos = montageDataset->getTransform()->getLocalPosition();
-    if(dynamic_cast<VSFileNameFilter*>(montageDataset) != nullptr)
-    {
-      pos = montageDataset->getChildren().front()->getTransform()->getLocalPosition();
-    }
-    if(firstDataset)
-    {
-      prevX = pos[0];
-      prevY = pos[1];
-      firstDataset = false;
-    }
-    else
-    {
-      if(pos[0] > prevX)
-      {
-        col++;
-      }
-      else
-      {
-        row++;
-        col = 0;
-      }
-      if((row + 1) > numRows)
-      {
-        numRows = row + 1;
-      }
-      if((col + 1) > numCols)
-      {
-        numCols = col + 1;
-      }
-      prevX = pos[0];
-      prevY = pos[1];
-    }
+    VSAbstractFilter* montageDataset = datasets[index];
     DataContainer::Pointer dataContainer;
     VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(montageDataset);
     VSFileNameFilter* filenameFilter = dynamic_cast<VSFileNameFilter*>(montageDataset);
     QString dataContainerPrefix;
-    QString rowColIdString = tr("r%1c%2").arg(row).arg(col);
-    if(dcFilter != nullptr)
+    QString rowColIdString = tr("r%1c%2").arg(gridIndex.getRow(index)).arg(gridIndex.getColumn(index));
+    if(dcFilter != nullptr && dcFilter->getWrappedDataContainer() && dcFilter->getWrappedDataContainer()->m_DataContainer)
     {
       dataContainer = dcFilter->getWrappedDataContainer()->m_DataContainer;
       QString dataContainerName = dataContainer->getName();
@@ -1718,6 +2430,10 @@ std::pair<int, int> IMFViewer_UI::buildCustomDCA(const DataContainerArray::Point
       dataContainerPrefix = filenameFilter->getFilterName();
       dataContainer = DataContainer::New(dataContainerPrefix);
     }
+    else
+    {
+      continue;
+    }
     QString dcName = tr("%1_%2").arg(dataContainerPrefix, rowColIdString);
     dataContainer->setName(dcName);
 
@@ -1727,8 +2443,8 @@ std::pair<int, int> IMFViewer_UI::buildCustomDCA(const DataContainerArray::Point
       geom = ImageGeom::New();
       dataContainer->setGeometry(geom);
     }
-    geom->setOrigin(pos[0], pos[1], 1.0f);
+    geom->setOrigin(tiles[index].x, tiles[index].y, 1.0f);
     dca->addOrReplaceDataContainer(dataContainer);
   }
-  return {numRows, numCols};
+  return {gridIndex.getRowCount(), gridIndex.getColumnCount()};
 }
@@ -35,6 +35,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include <QtWidgets/QMainWindow>
 #include <QtWidgets/QMenuBar>
 
@@ -43,9 +46,14 @@
 
 #include "SIMPLVtkLib/Dialogs/AbstractImportMontageDialog.h"
 #include "SIMPLVtkLib/Dialogs/FijiListWidget.h"
+#include "SIMPLVtkLib/QtWidgets/VSDatasetImporter.h"
 #include "SIMPLVtkLib/QtWidgets/VSQueueWidget.h"
 #include "SIMPLVtkLib/Visualization/VisualFilters/VSAbstractFilter.h"
 
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+#include "IMFViewer/IMFPipelineScheduler.h"
+
+class QThreadPool;
 class QtSSettings;
 class ImportMontageWizard;
 class ExecutePipelineWizard;
@@ -54,6 +62,14 @@ class PipelineWorker;
 class VSFileNameFilter;
 class VSDataSetFilter;
 class PerformMontageWizard;
+class IMFDream3dWriter;
+class IMFImageImporter;
+class IMFIncrementalStitcher;
+class IMFLazyTileLoader;
+class IMFOffscreenRenderer;
+class IMFRegistrationCache;
+class IMFSessionLoader;
+class IMFVolumeAssembler;
 
 class IMFViewer_UI : public QMainWindow
 {
@@ -82,7 +98,9 @@ public:
   QMenuBar* getMenuBar();
 
   /**
-   * @brief Saves an image to a file
+   * @brief Renders the selected datasets, or the whole session if nothing is selected, to
+   * image files of any size without using the view.  The images are drawn on a worker
+   * thread while a progress dialog is shown.
    * @return
    */
   void saveImage();
@@ -93,6 +111,21 @@ public:
    */
   void saveDream3d();
 
+  /**
+   * @brief Writes the recorded startup and import spans to a Chrome trace event file
+   */
+  void exportTrace();
+
+  /**
+   * @brief Shows the hit and miss counts and the size of the decoded tile cache
+   */
+  void showTileCacheStatistics();
+
+  /**
+   * @brief Asks for the memory budget shared by the executing import queue pipelines
+   */
+  void editMemoryBudget();
+
 protected:
   /**
    * @brief setupGui
@@ -147,9 +180,19 @@ protected slots:
   void importData();
 
   /**
-   * @brief importData
+   * @brief Queues the import of a data file
+   * @param filePath
+   * @return The importer, which emits resultReady once the file has been read
+   */
+  VSDatasetImporter::Pointer importData(const QString& filePath);
+
+  /**
+   * @brief Queues a pipeline that reads every data container of a .dream3d file.  The file
+   * structure is read with the HDF5 lock held and the data containers are read by a queue
+   * worker, so the file is never read while another pipeline uses HDF5.
+   * @param filePath
    */
-  void importData(const QString& filePath);
+  void importDream3dFile(const QString& filePath);
 
   /**
    * @brief importImages
@@ -198,11 +241,38 @@ protected slots:
   void handleDatasetResults(VSFileNameFilter* textFilter, VSDataSetFilter* filter);
 
   /**
-   * @brief handleMontageResults
+   * @brief Adds the decoded images to the view and reports the files that could not be read
+   * @param pipeline
+   * @param dca
+   * @param errorMessages
+   */
+  void handleImageResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, const QStringList& errorMessages);
+
+  /**
+   * @brief Displays the output of a queued pipeline.  The scheduler delivers each pipeline as
+   * soon as it finishes, so results arrive in completion order rather than the order the
+   * pipelines were queued in.
+   * @param pipeline
+   * @param dca
+   * @param err
+   * @param canceled
+   */
+  void handleMontageResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err, bool canceled);
+
+  /**
+   * @brief Displays a volume assembled from the stitched slices of a multi-slice montage
    * @param pipeline
+   * @param dca
+   * @param err
+   */
+  void handleVolumeResults(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err);
+
+  /**
+   * @brief Adds a saved DREAM3D file to the recent files or reports why it could not be written
+   * @param filePath
    * @param err
    */
-  void handleMontageResults(const FilterPipeline::Pointer& pipeline, int err);
+  void handleSaveResults(const QString& filePath, int err);
 
   /**
    * @brief listenSelectionChanged
@@ -220,6 +290,11 @@ private:
   QAction* m_ClearRecentsAction = nullptr;
 
   QActionGroup* m_ThemeActionGroup = nullptr;
+  QActionGroup* m_WorkerCountActionGroup = nullptr;
+  QActionGroup* m_PyramidLevelActionGroup = nullptr;
+  QActionGroup* m_CompressionActionGroup = nullptr;
+  int m_CompressionLevel = 4;
+  int m_DecodeThreadCount = 1;
 
   QString m_OpenDialogLastDirectory = "";
   AbstractImportMontageDialog::DisplayType m_DisplayType = AbstractImportMontageDialog::DisplayType::NotSpecified;
@@ -228,6 +303,27 @@ private:
 
   QThread* m_PipelineWorkerThread = nullptr;
   PipelineWorker* m_PipelineWorker = nullptr;
+  IMFPipelineScheduler* m_PipelineScheduler = nullptr;
+  IMFImageImporter* m_ImageImporter = nullptr;
+  IMFRegistrationCache* m_RegistrationCache = nullptr;
+  IMFLazyTileLoader* m_LazyTileLoader = nullptr;
+  IMFIncrementalStitcher* m_IncrementalStitcher = nullptr;
+  IMFVolumeAssembler* m_VolumeAssembler = nullptr;
+  IMFDream3dWriter* m_Dream3dWriter = nullptr;
+  IMFSessionLoader* m_SessionLoader = nullptr;
+  IMFOffscreenRenderer* m_OffscreenRenderer = nullptr;
+  QThreadPool* m_RenderThreadPool = nullptr;
+  std::shared_ptr<std::atomic_bool> m_RenderCanceled;
+  QAction* m_LoadTilesOnDemandAction = nullptr;
+  QAction* m_UseRegistrationCacheAction = nullptr;
+  QAction* m_CacheDecodedTilesAction = nullptr;
+  QAction* m_SpillDecodedTilesAction = nullptr;
+  QAction* m_StitchToDiskAction = nullptr;
+  QAction* m_LowMemoryStitchingAction = nullptr;
+  QAction* m_AssembleVolumeAction = nullptr;
+  QAction* m_AlignSlicesAction = nullptr;
+  QAction* m_ImportRegionAction = nullptr;
+  QAction* m_PipelinedImportAction = nullptr;
 
   /**
    * @brief createThemeMenu
@@ -238,7 +334,16 @@ private:
   QMenu* createThemeMenu(QActionGroup* actionGroup, QWidget* parent = nullptr);
 
   /**
-   * @brief loadSession
+   * @brief createImportQueueMenu
+   * @param actionGroup
+   * @param parent
+   * @return
+   */
+  QMenu* createImportQueueMenu(QActionGroup* actionGroup, QWidget* parent = nullptr);
+
+  /**
+   * @brief Restores the session through the import queue.  Each dataset is displayed as soon
+   * as it has been read, and the window can be used while the rest are loading.
    * @param filePath
    * @return
    */
@@ -259,24 +364,6 @@ private:
    */
   void importFijiMontage();
 
-  using SpacingTuple = std::tuple<float, float, float>;
-  using OriginTuple = std::tuple<float, float, float>;
-  using ColorWeightingTuple = std::tuple<float, float, float>;
-
-  /**
-   * @brief importFijiMontage
-   * @param montageName
-   * @param fijiListInfo
-   * @param overrideSpacing
-   * @param spacing
-   * @param overrideOrigin
-   * @param origin
-   * @param montageStart
-   * @param montageEnd
-   */
-  void importFijiMontage(const QString& montageName, FijiListInfo_t fijiListInfo, bool overrideSpacing, FloatVec3Type spacing, bool overrideOrigin, FloatVec3Type origin, IntVec2Type montageStart,
-                         IntVec2Type montageEnd, int32_t lengthUnit);
-
   /**
    * @brief importRobometMontage
    */
@@ -292,12 +379,62 @@ private:
    */
   void importZeissZenMontage();
 
+  /**
+   * @brief Builds the montage pipelines for the settings on a worker thread and adds them to
+   * the import queue.  The import filters are preflighted on worker threads first so the window
+   * stays responsive while large tile configurations are read.
+   * @param settings
+   */
+  void importMontage(const IMFMontagePipelineBuilder::MontageSettings& settings);
+
+  /**
+   * @brief Preflights the built montage pipelines on worker threads and adds them to the import queue
+   * @param montageSettings
+   * @param pipelines
+   * @param traceStart
+   */
+  void queueMontagePipelines(const IMFMontagePipelineBuilder::MontageSettings& montageSettings, const std::vector<FilterPipeline::Pointer>& pipelines, qint64 traceStart);
+
+  /**
+   * @brief Displays the tile geometries created by preflighting the montage import filter
+   * without reading any pixels.  Side by side montages are handed to the lazy tile loader.
+   * @param settings
+   * @param pipeline
+   */
+  void importMontageGeometry(const IMFMontagePipelineBuilder::MontageSettings& settings, const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Queues a montage whose tiles are read, registered and stitched as a dataflow by
+   * IMFPipelinedMontage, starting from the tile geometries created by the preflight
+   * @param settings
+   * @param pipeline
+   */
+  void importPipelinedMontage(const IMFMontagePipelineBuilder::MontageSettings& settings, const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Adds the pipeline output to the view and traces the conversion to VTK and
+   * the first frame drawn afterwards
+   * @param pipeline
+   * @param dca
+   */
+  void displayPipelineOutput(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca);
+
   /**
    * @brief runPipeline
    * @param pipeline
    */
   void addPipelineToQueue(const FilterPipeline::Pointer& pipeline);
 
+  /**
+   * @brief Adds an entry to the import queue that executes the pipeline on the pipeline
+   * scheduler once the queue reaches it
+   * @param pipeline
+   * @param dca
+   * @param postExecute
+   */
+  void enqueuePipeline(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca = DataContainerArray::NullPointer(),
+                       const IMFPipelineScheduler::PostExecuteFunction& postExecute = IMFPipelineScheduler::PostExecuteFunction());
+
   /**
    * @brief executePipeline
    * @param pipeline
@@ -305,9 +442,12 @@ private:
   void executePipeline(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca);
 
   /**
-   * @brief Build a custom data container array for montaging
+   * @brief Build a custom data container array for montaging.  Each dataset is named after
+   * the grid row and column that IMFTileGridIndex assigns from its position.  Datasets
+   * without a data container are skipped, and cells without a dataset are left empty.
    * @param dataContainerArray
    * @param montageDatasets
+   * @return The number of rows and columns in the grid
    */
   std::pair<int, int> buildCustomDCA(const DataContainerArray::Pointer& dca, VSAbstractFilter::FilterListType montageDatasets);
 
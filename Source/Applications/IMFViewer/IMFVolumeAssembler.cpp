@@ -0,0 +1,468 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFVolumeAssembler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <new>
+
+#include <QtConcurrent>
+
+#include <QtCore/QFutureWatcher>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "IMFViewer/IMFImageCorrelation.h"
+#include "IMFViewer/IMFMontagePipelineBuilder.h"
+#include "IMFViewer/IMFTrace.h"
+
+const char* IMFVolumeAssembler::VolumeProperty = "VolumeId";
+
+namespace
+{
+// Slices are first aligned at the power of two downsampling that fits their longest edge in this many pixels
+const size_t k_CoarseAlignmentSize = 128;
+
+// Each finer level refines the alignment over a window of at most this many pixels per edge
+const long long k_AlignmentWindowSize = 256;
+
+// Largest translation searched between consecutive slices, as a fraction of the slice size
+const double k_MaxShiftFraction = 0.1;
+
+// Translations that compare less than this fraction of a region are not considered
+const double k_MinOverlapFraction = 0.25;
+
+struct SliceImage
+{
+  IDataArray::Pointer data;
+  size_t width = 0;
+  size_t height = 0;
+  long long xOffset = 0;
+  long long yOffset = 0;
+};
+
+// -----------------------------------------------------------------------------
+// Refines the position (sx, sy) of slice b relative to slice a, coarse to fine
+// -----------------------------------------------------------------------------
+void alignPair(const SliceImage& a, const SliceImage& b, long long& sx, long long& sy)
+{
+  IMFImageCorrelation::Image imageA = {a.data, a.width, a.height};
+  IMFImageCorrelation::Image imageB = {b.data, b.width, b.height};
+  size_t longest = std::max(std::max(a.width, a.height), std::max(b.width, b.height));
+  size_t factor = 1;
+  while(longest / factor > k_CoarseAlignmentSize)
+  {
+    factor *= 2;
+  }
+
+  // Every translation in range is tried on the whole slices at the coarsest level
+  const long long wholeSlice = std::numeric_limits<int>::max();
+  IMFImageCorrelation::GrayRegion coarseA = IMFImageCorrelation::SampleGray(imageA, factor, 0, 0, wholeSlice, wholeSlice);
+  IMFImageCorrelation::GrayRegion coarseB = IMFImageCorrelation::SampleGray(imageB, factor, 0, 0, wholeSlice, wholeSlice);
+  long long radius = std::max(1LL, static_cast<long long>(std::ceil(k_MaxShiftFraction * static_cast<double>(longest) / static_cast<double>(factor))));
+  long long levelX = std::llround(static_cast<double>(sx) / static_cast<double>(factor));
+  long long levelY = std::llround(static_cast<double>(sy) / static_cast<double>(factor));
+  IMFImageCorrelation::SearchTranslation(coarseA, coarseB, radius, k_MinOverlapFraction, levelX, levelY);
+
+  // Finer levels only move the translation by a pixel, so a window in the middle of the overlap is enough
+  while(factor > 1)
+  {
+    factor /= 2;
+    levelX *= 2;
+    levelY *= 2;
+
+    long long overlapX0 = std::max(0LL, levelX);
+    long long overlapY0 = std::max(0LL, levelY);
+    long long overlapX1 = std::min(IMFImageCorrelation::LevelSize(a.width, factor), levelX + IMFImageCorrelation::LevelSize(b.width, factor));
+    long long overlapY1 = std::min(IMFImageCorrelation::LevelSize(a.height, factor), levelY + IMFImageCorrelation::LevelSize(b.height, factor));
+    if(overlapX1 <= overlapX0 || overlapY1 <= overlapY0)
+    {
+      break;
+    }
+
+    long long windowWidth = std::min(k_AlignmentWindowSize, overlapX1 - overlapX0);
+    long long windowHeight = std::min(k_AlignmentWindowSize, overlapY1 - overlapY0);
+    long long windowX = (overlapX0 + overlapX1 - windowWidth) / 2;
+    long long windowY = (overlapY0 + overlapY1 - windowHeight) / 2;
+    IMFImageCorrelation::GrayRegion windowA = IMFImageCorrelation::SampleGray(imageA, factor, windowX, windowY, windowWidth, windowHeight);
+    IMFImageCorrelation::GrayRegion windowB = IMFImageCorrelation::SampleGray(imageB, factor, windowX - levelX - 1, windowY - levelY - 1, windowWidth + 2, windowHeight + 2);
+    IMFImageCorrelation::SearchTranslation(windowA, windowB, 1, k_MinOverlapFraction, levelX, levelY);
+  }
+
+  sx = levelX * static_cast<long long>(factor);
+  sy = levelY * static_cast<long long>(factor);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void alignSlicePair(const SliceImage& a, const SliceImage& b, long long& sx, long long& sy)
+{
+  if(IMFImageCorrelation::IsSupportedType(a.data))
+  {
+    alignPair(a, b, sx, sy);
+  }
+}
+
+// -----------------------------------------------------------------------------
+// Copies each slice into its plane of the volume and releases it
+// -----------------------------------------------------------------------------
+template <typename T>
+IDataArray::Pointer stackSlices(std::vector<SliceImage>& images, std::vector<DataContainer::Pointer>& slices, size_t width, size_t height, size_t numComps, const QString& daName, int& err)
+{
+  // Regions that no slice covers stay zero
+  size_t planeTuples = width * height;
+  size_t numTuples = planeTuples * images.size();
+  T* buffer = new(std::nothrow) T[numTuples * numComps]();
+  if(buffer == nullptr)
+  {
+    err = IMFVolumeAssembler::k_AllocationError;
+    return IDataArray::NullPointer();
+  }
+
+  typename DataArray<T>::Pointer volumeArray = DataArray<T>::WrapPointer(buffer, numTuples, std::vector<size_t>(1, numComps), daName, true);
+  for(size_t z = 0; z < images.size(); z++)
+  {
+    SliceImage& image = images[z];
+    if(!image.data)
+    {
+      continue;
+    }
+
+    const T* src = std::dynamic_pointer_cast<DataArray<T>>(image.data)->getPointer(0);
+    T* plane = buffer + z * planeTuples * numComps;
+    for(size_t y = 0; y < image.height; y++)
+    {
+      const T* srcRow = src + y * image.width * numComps;
+      T* dstRow = plane + ((static_cast<size_t>(image.yOffset) + y) * width + static_cast<size_t>(image.xOffset)) * numComps;
+      std::copy(srcRow, srcRow + image.width * numComps, dstRow);
+    }
+
+    image.data.reset();
+    slices[z].reset();
+  }
+  return volumeArray;
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFVolumeAssembler::IMFVolumeAssembler(QObject* parent)
+: QObject(parent)
+{
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+IMFVolumeAssembler::~IMFVolumeAssembler() = default;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFVolumeAssembler::IsSlicePipeline(const FilterPipeline::Pointer& pipeline)
+{
+  return !pipeline->property(VolumeProperty).toString().isEmpty();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainer::Pointer IMFVolumeAssembler::AssembleVolume(std::vector<DataContainer::Pointer> slices, int firstSlice, const DataArrayPath& montagePath, bool alignSlices, int& err)
+{
+  err = 0;
+
+  std::vector<SliceImage> images(slices.size());
+  std::vector<FloatVec3Type> origins(slices.size());
+  std::vector<size_t> planes;
+  IDataArray::Pointer firstData;
+  FloatVec3Type spacing = {1.0f, 1.0f, 1.0f};
+  FloatVec3Type minOrigin = {std::numeric_limits<float>::max(), std::numeric_limits<float>::max(), 0.0f};
+  for(size_t z = 0; z < slices.size(); z++)
+  {
+    ImageGeom::Pointer imageGeom = slices[z] ? slices[z]->getGeometryAs<ImageGeom>() : ImageGeom::NullPointer();
+    AttributeMatrix::Pointer am = slices[z] ? slices[z]->getAttributeMatrix(montagePath.getAttributeMatrixName()) : AttributeMatrix::NullPointer();
+    IDataArray::Pointer data = am ? am->getAttributeArray(montagePath.getDataArrayName()) : IDataArray::NullPointer();
+    if(!imageGeom || !data)
+    {
+      continue;
+    }
+
+    if(!firstData)
+    {
+      firstData = data;
+      spacing = imageGeom->getSpacing();
+    }
+    else if(data->getTypeAsString() != firstData->getTypeAsString() || data->getNumberOfComponents() != firstData->getNumberOfComponents())
+    {
+      err = k_MixedSliceTypesError;
+      return DataContainer::NullPointer();
+    }
+
+    SizeVec3Type dims = imageGeom->getDimensions();
+    images[z].data = data;
+    images[z].width = dims[0];
+    images[z].height = dims[1];
+    origins[z] = imageGeom->getOrigin();
+    minOrigin[0] = std::min(minOrigin[0], origins[z][0]);
+    minOrigin[1] = std::min(minOrigin[1], origins[z][1]);
+    planes.push_back(z);
+  }
+
+  if(!firstData)
+  {
+    err = k_NoSlicesError;
+    return DataContainer::NullPointer();
+  }
+
+  // Only the images keep the slice arrays from here on, so they can be released one by one
+  size_t numComps = static_cast<size_t>(firstData->getNumberOfComponents());
+  firstData.reset();
+
+  for(size_t z : planes)
+  {
+    images[z].xOffset = std::llround((origins[z][0] - minOrigin[0]) / spacing[0]);
+    images[z].yOffset = std::llround((origins[z][1] - minOrigin[1]) / spacing[1]);
+  }
+
+  if(alignSlices && planes.size() > 1)
+  {
+    // Each pair of neighbouring slices is aligned on its own, then the translations are chained from the first slice
+    std::vector<std::pair<long long, long long>> translations(planes.size());
+    std::vector<size_t> pairs;
+    for(size_t i = 1; i < planes.size(); i++)
+    {
+      const SliceImage& previous = images[planes[i - 1]];
+      const SliceImage& next = images[planes[i]];
+      translations[i] = {next.xOffset - previous.xOffset, next.yOffset - previous.yOffset};
+      pairs.push_back(i);
+    }
+
+    QtConcurrent::blockingMap(pairs, [&](size_t i) { alignSlicePair(images[planes[i - 1]], images[planes[i]], translations[i].first, translations[i].second); });
+
+    for(size_t i = 1; i < planes.size(); i++)
+    {
+      images[planes[i]].xOffset = images[planes[i - 1]].xOffset + translations[i].first;
+      images[planes[i]].yOffset = images[planes[i - 1]].yOffset + translations[i].second;
+    }
+  }
+
+  // The volume spans every slice, with its first pixel at the smallest offset
+  long long minX = std::numeric_limits<long long>::max();
+  long long minY = std::numeric_limits<long long>::max();
+  for(size_t z : planes)
+  {
+    minX = std::min(minX, images[z].xOffset);
+    minY = std::min(minY, images[z].yOffset);
+  }
+
+  size_t width = 0;
+  size_t height = 0;
+  for(size_t z : planes)
+  {
+    images[z].xOffset -= minX;
+    images[z].yOffset -= minY;
+    width = std::max(width, static_cast<size_t>(images[z].xOffset) + images[z].width);
+    height = std::max(height, static_cast<size_t>(images[z].yOffset) + images[z].height);
+  }
+
+  QString daName = montagePath.getDataArrayName();
+  const IDataArray::Pointer& firstImage = images[planes.front()].data;
+  IDataArray::Pointer volumeData;
+  if(std::dynamic_pointer_cast<UInt8ArrayType>(firstImage))
+  {
+    volumeData = stackSlices<uint8_t>(images, slices, width, height, numComps, daName, err);
+  }
+  else if(std::dynamic_pointer_cast<UInt16ArrayType>(firstImage))
+  {
+    volumeData = stackSlices<uint16_t>(images, slices, width, height, numComps, daName, err);
+  }
+  else if(std::dynamic_pointer_cast<UInt32ArrayType>(firstImage))
+  {
+    volumeData = stackSlices<uint32_t>(images, slices, width, height, numComps, daName, err);
+  }
+  else if(std::dynamic_pointer_cast<FloatArrayType>(firstImage))
+  {
+    volumeData = stackSlices<float>(images, slices, width, height, numComps, daName, err);
+  }
+  else
+  {
+    err = k_UnsupportedTypeError;
+  }
+
+  if(err < 0)
+  {
+    return DataContainer::NullPointer();
+  }
+
+  // Slice n is placed at z = n, as when each slice is displayed on its own
+  DataContainer::Pointer volumeDC = DataContainer::New(montagePath.getDataContainerName());
+  ImageGeom::Pointer volumeGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+  volumeGeom->setDimensions(SizeVec3Type(width, height, slices.size()));
+  volumeGeom->setSpacing(FloatVec3Type(spacing[0], spacing[1], 1.0f));
+  volumeGeom->setOrigin(FloatVec3Type(minOrigin[0] + minX * spacing[0], minOrigin[1] + minY * spacing[1], static_cast<float>(firstSlice)));
+  volumeDC->setGeometry(volumeGeom);
+
+  std::vector<size_t> tupleDims = {width, height, slices.size()};
+  AttributeMatrix::Pointer volumeAM = AttributeMatrix::New(tupleDims, montagePath.getAttributeMatrixName(), AttributeMatrix::Type::Cell);
+  volumeAM->addOrReplaceAttributeArray(volumeData);
+  volumeDC->addOrReplaceAttributeMatrix(volumeAM);
+  return volumeDC;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFVolumeAssembler::addVolume(const FilterPipeline::Pointer& volumePipeline, const std::vector<FilterPipeline::Pointer>& slicePipelines, bool alignSlices)
+{
+  if(slicePipelines.empty())
+  {
+    return;
+  }
+
+  QString volumeId = QString::number(++m_VolumeCount);
+  Volume volume;
+  volume.pipeline = volumePipeline;
+  volume.pendingCount = static_cast<int>(slicePipelines.size());
+  volume.alignSlices = alignSlices;
+  volume.firstSlice = std::numeric_limits<int>::max();
+  volume.lastSlice = std::numeric_limits<int>::min();
+  for(const FilterPipeline::Pointer& pipeline : slicePipelines)
+  {
+    int slice = pipeline->property(IMFMontagePipelineBuilder::SliceProperty).toInt();
+    volume.firstSlice = std::min(volume.firstSlice, slice);
+    volume.lastSlice = std::max(volume.lastSlice, slice);
+    pipeline->setProperty(VolumeProperty, volumeId);
+  }
+  m_Volumes.insert(volumeId, volume);
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFVolumeAssembler::addSlice(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err)
+{
+  QString volumeId = pipeline->property(VolumeProperty).toString();
+  if(!m_Volumes.contains(volumeId))
+  {
+    return;
+  }
+
+  Volume& volume = m_Volumes[volumeId];
+  volume.pendingCount--;
+  DataContainer::Pointer montageDC = (err >= 0 && dca) ? dca->getDataContainer(IMFMontagePipelineBuilder::MontagePath().getDataContainerName()) : DataContainer::NullPointer();
+  if(montageDC)
+  {
+    int slice = pipeline->property(IMFMontagePipelineBuilder::SliceProperty).toInt();
+    volume.slices[slice] = montageDC;
+  }
+  else
+  {
+    volume.failedCount++;
+  }
+
+  int sliceCount = volume.lastSlice - volume.firstSlice + 1;
+  emit notifyStatusMessage(tr("Stitched %1 of %2 slices of '%3'").arg(sliceCount - volume.pendingCount).arg(sliceCount).arg(volume.pipeline->getName()));
+
+  if(volume.pendingCount == 0)
+  {
+    assemble(volumeId);
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFVolumeAssembler::removeVolume(const std::vector<FilterPipeline::Pointer>& slicePipelines)
+{
+  for(const FilterPipeline::Pointer& pipeline : slicePipelines)
+  {
+    m_Volumes.remove(pipeline->property(VolumeProperty).toString());
+  }
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+void IMFVolumeAssembler::assemble(const QString& volumeId)
+{
+  Volume volume = m_Volumes.take(volumeId);
+
+  // The slices are moved out so that each one is released as soon as it has been copied
+  std::shared_ptr<std::vector<DataContainer::Pointer>> slices = std::make_shared<std::vector<DataContainer::Pointer>>(volume.lastSlice - volume.firstSlice + 1);
+  for(const std::pair<const int, DataContainer::Pointer>& slice : volume.slices)
+  {
+    (*slices)[slice.first - volume.firstSlice] = slice.second;
+  }
+  volume.slices.clear();
+
+  if(volume.failedCount > 0)
+  {
+    emit notifyStatusMessage(tr("%1 slices of '%2' could not be stitched and are left empty").arg(volume.failedCount).arg(volume.pipeline->getName()));
+  }
+
+  FilterPipeline::Pointer volumePipeline = volume.pipeline;
+  int firstSlice = volume.firstSlice;
+  bool alignSlices = volume.alignSlices;
+  std::shared_ptr<int> err = std::make_shared<int>(0);
+  QFutureWatcher<DataContainerArray::Pointer>* watcher = new QFutureWatcher<DataContainerArray::Pointer>(this);
+  connect(watcher, &QFutureWatcher<DataContainerArray::Pointer>::finished, this, [=] {
+    watcher->deleteLater();
+    emit volumeAssembled(volumePipeline, watcher->result(), *err);
+  });
+
+  emit notifyStatusMessage(tr("Assembling volume '%1'...").arg(volumePipeline->getName()));
+  watcher->setFuture(QtConcurrent::run([=]() {
+    IMFTraceSpan span(tr("Assemble Volume %1").arg(volumePipeline->getName()), IMFTrace::PipelineCategory);
+    span.setArg("Slices", static_cast<int>(slices->size()));
+    span.setArg("Aligned", alignSlices);
+
+    DataContainerArray::Pointer dca = DataContainerArray::New();
+    DataContainer::Pointer volumeDC = AssembleVolume(std::move(*slices), firstSlice, IMFMontagePipelineBuilder::MontagePath(), alignSlices, *err);
+    if(volumeDC)
+    {
+      dca->addOrReplaceDataContainer(volumeDC);
+    }
+    return dca;
+  }));
+}
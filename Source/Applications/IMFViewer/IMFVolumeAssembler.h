@@ -0,0 +1,145 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+#include <QtCore/QMap>
+#include <QtCore/QObject>
+#include <QtCore/QString>
+
+#include "SIMPLib/DataContainers/DataArrayPath.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+#include "SIMPLib/Filtering/FilterPipeline.h"
+
+/**
+ * @brief The IMFVolumeAssembler class collects the stitched slices of a multi-slice montage
+ * as their pipelines finish and assembles them into a single 3D image once every slice is
+ * done.  The slice pipelines run side by side in the pipeline scheduler, so registration and
+ * stitching of the slices overlap.  Consecutive slices can be aligned to each other by the
+ * translation that best correlates them before they are stacked.
+ */
+class IMFVolumeAssembler : public QObject
+{
+  Q_OBJECT
+
+public:
+  IMFVolumeAssembler(QObject* parent = nullptr);
+  ~IMFVolumeAssembler() override;
+
+  static const char* VolumeProperty;
+
+  static const int k_NoSlicesError = -89020;
+  static const int k_MixedSliceTypesError = -89021;
+  static const int k_UnsupportedTypeError = -89022;
+  static const int k_AllocationError = -89023;
+
+  /**
+   * @brief Returns true if the pipeline stitches a slice of a volume
+   * @param pipeline
+   * @return
+   */
+  static bool IsSlicePipeline(const FilterPipeline::Pointer& pipeline);
+
+  /**
+   * @brief Stacks stitched slices into a 3D image at the montage path.  Each slice is placed by
+   * its origin, or by its origin corrected by the best matching translation to the previous
+   * slice when alignSlices is set.  Null slices leave an empty plane.  The slices are released
+   * as they are copied.
+   * @param slices The stitched data container of each plane, in z order
+   * @param firstSlice Slice number of the first plane, used as the z origin
+   * @param montagePath
+   * @param alignSlices
+   * @param err
+   * @return
+   */
+  static DataContainer::Pointer AssembleVolume(std::vector<DataContainer::Pointer> slices, int firstSlice, const DataArrayPath& montagePath, bool alignSlices, int& err);
+
+  /**
+   * @brief Starts collecting the slices of the pipelines, which must have been created with
+   * IMFMontagePipelineBuilder::SliceProperty set.  The volume pipeline is returned with the
+   * assembled volume and carries its name and properties to the display.
+   * @param volumePipeline
+   * @param slicePipelines
+   * @param alignSlices
+   */
+  void addVolume(const FilterPipeline::Pointer& volumePipeline, const std::vector<FilterPipeline::Pointer>& slicePipelines, bool alignSlices);
+
+  /**
+   * @brief Stores the stitched montage of a finished slice pipeline.  The volume is assembled
+   * on a worker thread after its last slice finished, whether or not the slice succeeded.
+   * @param pipeline
+   * @param dca
+   * @param err
+   */
+  void addSlice(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err);
+
+  /**
+   * @brief Stops collecting the slices of a volume whose slice pipelines were not queued
+   * @param slicePipelines
+   */
+  void removeVolume(const std::vector<FilterPipeline::Pointer>& slicePipelines);
+
+signals:
+  void volumeAssembled(const FilterPipeline::Pointer& pipeline, const DataContainerArray::Pointer& dca, int err);
+  void notifyStatusMessage(const QString& msg);
+
+private:
+  struct Volume
+  {
+    FilterPipeline::Pointer pipeline;
+    std::map<int, DataContainer::Pointer> slices;
+    int firstSlice = 0;
+    int lastSlice = 0;
+    int pendingCount = 0;
+    int failedCount = 0;
+    bool alignSlices = false;
+  };
+
+  QMap<QString, Volume> m_Volumes;
+  int m_VolumeCount = 0;
+
+  /**
+   * @brief Assembles a volume whose slices have all finished on a worker thread
+   * @param volumeId
+   */
+  void assemble(const QString& volumeId);
+
+  IMFVolumeAssembler(const IMFVolumeAssembler&); // Copy Constructor Not Implemented
+  void operator=(const IMFVolumeAssembler&);     // Operator '=' Not Implemented
+};
@@ -0,0 +1,333 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include "IMFVtkArrayBridge.h"
+
+#include <QtCore/QMap>
+
+#include <vtkCellData.h>
+#include <vtkCommand.h>
+#include <vtkDataSet.h>
+#include <vtkImageData.h>
+#include <vtkType.h>
+
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSSIMPLDataContainerFilter.h"
+
+namespace
+{
+/**
+ * @brief Keeps a SIMPL array alive for as long as the VTK array that wraps its buffer.
+ * The command is attached as a DeleteEvent observer and is destroyed with the VTK array.
+ */
+class SIMPLArrayOwner : public vtkCommand
+{
+public:
+  static SIMPLArrayOwner* New()
+  {
+    return new SIMPLArrayOwner();
+  }
+
+  void Execute(vtkObject* /*caller*/, unsigned long /*eventId*/, void* /*callData*/) override
+  {
+  }
+
+  IDataArray::Pointer m_Array;
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int vtkTypeFromSIMPLType(const QString& typeName)
+{
+  // bool arrays are bit packed in VTK, so they cannot share the SIMPL buffer
+  static const QMap<QString, int> vtkTypes = {{"int8_t", VTK_SIGNED_CHAR},   {"uint8_t", VTK_UNSIGNED_CHAR},         {"int16_t", VTK_SHORT},
+                                              {"uint16_t", VTK_UNSIGNED_SHORT}, {"int32_t", VTK_INT},                 {"uint32_t", VTK_UNSIGNED_INT},
+                                              {"int64_t", VTK_LONG_LONG},       {"uint64_t", VTK_UNSIGNED_LONG_LONG}, {"float", VTK_FLOAT},
+                                              {"double", VTK_DOUBLE}};
+  return vtkTypes.value(typeName, VTK_VOID);
+}
+} // namespace
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+vtkSmartPointer<vtkDataArray> IMFVtkArrayBridge::WrapDataArray(const IDataArray::Pointer& array)
+{
+  if(array == IDataArray::NullPointer() || array->getNumberOfTuples() == 0)
+  {
+    return nullptr;
+  }
+
+  int vtkType = vtkTypeFromSIMPLType(array->getTypeAsString());
+  if(vtkType == VTK_VOID)
+  {
+    return nullptr;
+  }
+
+  vtkSmartPointer<vtkDataArray> vtkArray = vtkSmartPointer<vtkDataArray>::Take(vtkDataArray::CreateDataArray(vtkType));
+  vtkArray->SetName(array->getName().toLatin1().constData());
+  vtkArray->SetNumberOfComponents(array->getNumberOfComponents());
+
+  // save = 1, VTK never frees the SIMPL buffer
+  vtkIdType size = static_cast<vtkIdType>(array->getNumberOfTuples()) * array->getNumberOfComponents();
+  vtkArray->SetVoidArray(array->getVoidPointer(0), size, 1);
+
+  SIMPLArrayOwner* owner = SIMPLArrayOwner::New();
+  owner->m_Array = array;
+  vtkArray->AddObserver(vtkCommand::DeleteEvent, owner);
+  owner->Delete();
+
+  return vtkArray;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFVtkArrayBridge::FinishWrappingDataContainer(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc)
+{
+  ImageGeom::Pointer imageGeom = (wrappedDc && wrappedDc->m_DataContainer) ? wrappedDc->m_DataContainer->getGeometryAs<ImageGeom>() : ImageGeom::NullPointer();
+  if(!imageGeom)
+  {
+    return false;
+  }
+
+  // Every cell array has to be shareable, otherwise the data container is left to SIMPLVtkBridge
+  std::vector<vtkSmartPointer<vtkDataArray>> sharedArrays;
+  for(const AttributeMatrix::Pointer& am : wrappedDc->m_DataContainer->getAttributeMatrices())
+  {
+    if(am->getType() != AttributeMatrix::Type::Cell)
+    {
+      continue;
+    }
+
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      vtkSmartPointer<vtkDataArray> sharedArray = WrapDataArray(am->getAttributeArray(arrayName));
+      if(sharedArray == nullptr)
+      {
+        return false;
+      }
+      sharedArrays.push_back(sharedArray);
+    }
+  }
+
+  // The same layout SIMPLVtkBridge gives image geometries: one point more than cells along each axis
+  SizeVec3Type dims = imageGeom->getDimensions();
+  FloatVec3Type spacing = imageGeom->getSpacing();
+  FloatVec3Type origin = imageGeom->getOrigin();
+  vtkSmartPointer<vtkImageData> imageData = vtkSmartPointer<vtkImageData>::New();
+  imageData->SetDimensions(static_cast<int>(dims[0] + 1), static_cast<int>(dims[1] + 1), static_cast<int>(dims[2] + 1));
+  imageData->SetSpacing(spacing[0], spacing[1], spacing[2]);
+  imageData->SetOrigin(origin[0], origin[1], origin[2]);
+
+  vtkCellData* cellData = imageData->GetCellData();
+  for(const vtkSmartPointer<vtkDataArray>& sharedArray : sharedArrays)
+  {
+    cellData->AddArray(sharedArray);
+  }
+  if(!sharedArrays.empty())
+  {
+    cellData->SetActiveScalars(sharedArrays.front()->GetName());
+  }
+
+  wrappedDc->m_DataSet = imageData;
+  for(const SIMPLVtkBridge::WrappedDataArrayPtr& wrappedArray : wrappedDc->m_CellData)
+  {
+    wrappedArray->m_VtkArray = cellData->GetArray(wrappedArray->m_Name.toLatin1().constData());
+  }
+  return true;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFVtkArrayBridge::ShareCellArrays(vtkDataSet* dataSet, const AttributeMatrix::Pointer& am)
+{
+  if(dataSet == nullptr || am == AttributeMatrix::NullPointer())
+  {
+    return 0;
+  }
+
+  qint64 bytes = 0;
+  vtkCellData* cellData = dataSet->GetCellData();
+  for(const QString& arrayName : am->getAttributeArrayNames())
+  {
+    QByteArray vtkName = arrayName.toLatin1();
+    IDataArray::Pointer array = am->getAttributeArray(arrayName);
+    vtkDataArray* vtkArray = cellData->GetArray(vtkName.constData());
+    if(array == IDataArray::NullPointer() || vtkArray == nullptr || vtkArray->GetVoidPointer(0) == array->getVoidPointer(0))
+    {
+      continue;
+    }
+
+    // Only exact copies are replaced.  Arrays the conversion changed keep their own buffer.
+    if(vtkArray->GetNumberOfTuples() != static_cast<vtkIdType>(array->getNumberOfTuples()) || vtkArray->GetNumberOfComponents() != array->getNumberOfComponents())
+    {
+      continue;
+    }
+
+    vtkSmartPointer<vtkDataArray> sharedArray = WrapDataArray(array);
+    if(sharedArray == nullptr || sharedArray->GetDataType() != vtkArray->GetDataType())
+    {
+      continue;
+    }
+
+    bytes += static_cast<qint64>(vtkArray->GetActualMemorySize()) * 1024;
+    bool activeScalars = (cellData->GetScalars() == vtkArray);
+    cellData->RemoveArray(vtkName.constData());
+    cellData->AddArray(sharedArray);
+    if(activeScalars)
+    {
+      cellData->SetActiveScalars(vtkName.constData());
+    }
+  }
+
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFVtkArrayBridge::ShareWrappedDataContainer(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc)
+{
+  if(!wrappedDc || !wrappedDc->m_DataSet || !wrappedDc->m_DataContainer)
+  {
+    return 0;
+  }
+
+  qint64 bytes = 0;
+  for(const AttributeMatrix::Pointer& am : wrappedDc->m_DataContainer->getAttributeMatrices())
+  {
+    if(am->getType() == AttributeMatrix::Type::Cell)
+    {
+      bytes += ShareCellArrays(wrappedDc->m_DataSet, am);
+    }
+  }
+
+  if(bytes == 0)
+  {
+    return 0;
+  }
+
+  // The bridge holds its own reference to each converted array, which would keep the copy alive
+  vtkCellData* cellData = wrappedDc->m_DataSet->GetCellData();
+  for(const SIMPLVtkBridge::WrappedDataArrayPtr& wrappedArray : wrappedDc->m_CellData)
+  {
+    vtkDataArray* sharedArray = cellData->GetArray(wrappedArray->m_Name.toLatin1().constData());
+    if(sharedArray != nullptr)
+    {
+      wrappedArray->m_VtkArray = sharedArray;
+    }
+  }
+
+  // Downstream filters drop their references to the copies when they update
+  wrappedDc->m_DataSet->Modified();
+  return bytes;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool IMFVtkArrayBridge::MarkCellArraysModified(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc)
+{
+  if(!wrappedDc || !wrappedDc->m_DataSet || !wrappedDc->m_DataContainer)
+  {
+    return false;
+  }
+
+  bool shared = true;
+  vtkCellData* cellData = wrappedDc->m_DataSet->GetCellData();
+  for(const AttributeMatrix::Pointer& am : wrappedDc->m_DataContainer->getAttributeMatrices())
+  {
+    if(am->getType() != AttributeMatrix::Type::Cell)
+    {
+      continue;
+    }
+
+    for(const QString& arrayName : am->getAttributeArrayNames())
+    {
+      IDataArray::Pointer array = am->getAttributeArray(arrayName);
+      vtkDataArray* vtkArray = cellData->GetArray(arrayName.toLatin1().constData());
+      if(array == IDataArray::NullPointer() || vtkArray == nullptr)
+      {
+        continue;
+      }
+
+      if(vtkArray->GetVoidPointer(0) == array->getVoidPointer(0))
+      {
+        vtkArray->Modified();
+      }
+      else
+      {
+        shared = false;
+      }
+    }
+  }
+
+  wrappedDc->m_DataSet->Modified();
+  return shared;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+qint64 IMFVtkArrayBridge::ShareFilterArrays(const VSAbstractFilter::FilterListType& filters, const DataContainerArray::Pointer& dca)
+{
+  qint64 bytes = 0;
+  for(VSAbstractFilter* filter : filters)
+  {
+    VSSIMPLDataContainerFilter* dcFilter = dynamic_cast<VSSIMPLDataContainerFilter*>(filter);
+    if(dcFilter != nullptr && dcFilter->getWrappedDataContainer())
+    {
+      DataContainer::Pointer dc = dcFilter->getWrappedDataContainer()->m_DataContainer;
+      if(dc && dca->getDataContainer(dc->getName()) == dc)
+      {
+        // A data container SIMPLVtkLib has not converted yet gets the wrapping dataset, so no copy is made
+        SIMPLVtkBridge::WrappedDataContainerPtr wrappedDc = dcFilter->getWrappedDataContainer();
+        if(wrappedDc->m_DataSet == nullptr && FinishWrappingDataContainer(wrappedDc))
+        {
+          continue;
+        }
+        bytes += ShareWrappedDataContainer(wrappedDc);
+      }
+    }
+    bytes += ShareFilterArrays(filter->getChildren(), dca);
+  }
+  return bytes;
+}
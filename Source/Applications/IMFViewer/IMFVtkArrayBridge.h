@@ -0,0 +1,118 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#pragma once
+
+#include <vtkDataArray.h>
+#include <vtkSmartPointer.h>
+
+#include "SIMPLib/DataArrays/IDataArray.h"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainerArray.h"
+
+#include "SIMPLVtkLib/SIMPLBridge/SIMPLVtkBridge.h"
+#include "SIMPLVtkLib/Visualization/VisualFilters/VSAbstractFilter.h"
+
+class vtkDataSet;
+
+/**
+ * @brief The IMFVtkArrayBridge class lets VTK render SIMPL arrays in place.  Wrapped
+ * arrays point at the SIMPL buffer and keep the SIMPL array alive until VTK releases
+ * them, so an imported image occupies memory once instead of once in the pipeline
+ * output and again in the render view.  Image data containers imported by SIMPLVtkLib
+ * are wrapped before they are converted, so the copy is never made; datasets it already
+ * converted have their copies replaced.
+ */
+class IMFVtkArrayBridge
+{
+public:
+  /**
+   * @brief Returns a VTK array that uses the buffer of the SIMPL array without copying it
+   * and shares ownership of the SIMPL array, or a null pointer if the type has no matching
+   * VTK array type
+   * @param array
+   * @return
+   */
+  static vtkSmartPointer<vtkDataArray> WrapDataArray(const IDataArray::Pointer& array);
+
+  /**
+   * @brief Creates the VTK dataset of a wrapped data container from wrappers of its SIMPL
+   * arrays in place of SIMPLVtkBridge::FinishWrappingDataContainerStruct, so the arrays are
+   * never copied
+   * @param wrappedDc
+   * @return false, leaving the struct unchanged, if the data container is not an image
+   * geometry or holds an array VTK can not share
+   */
+  static bool FinishWrappingDataContainer(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc);
+
+  /**
+   * @brief Replaces the cell arrays of the dataset that are copies of arrays in the
+   * attribute matrix with arrays that wrap the SIMPL buffers
+   * @param dataSet
+   * @param am
+   * @return The number of bytes held by the replaced copies
+   */
+  static qint64 ShareCellArrays(vtkDataSet* dataSet, const AttributeMatrix::Pointer& am);
+
+  /**
+   * @brief Shares the cell arrays of every wrapped data container that has been converted
+   * to a VTK dataset, including the bridge's own references to the copies
+   * @param wrappedDc
+   * @return The number of bytes held by the replaced copies
+   */
+  static qint64 ShareWrappedDataContainer(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc);
+
+  /**
+   * @brief Marks the cell arrays that share a SIMPL buffer as modified after the buffer was
+   * written to in place, so that the views draw the new values
+   * @param wrappedDc
+   * @return false if a cell array holds its own copy, which is now out of date
+   */
+  static bool MarkCellArraysModified(const SIMPLVtkBridge::WrappedDataContainerPtr& wrappedDc);
+
+  /**
+   * @brief Shares the cell arrays of the data container filters, and their children, that
+   * display a data container of the data container array.  Image data containers that
+   * SIMPLVtkLib has not converted yet are wrapped instead, so their arrays are never copied.
+   * @param filters
+   * @param dca
+   * @return The number of bytes held by the replaced copies
+   */
+  static qint64 ShareFilterArrays(const VSAbstractFilter::FilterListType& filters, const DataContainerArray::Pointer& dca);
+
+private:
+  IMFVtkArrayBridge() = delete;
+};
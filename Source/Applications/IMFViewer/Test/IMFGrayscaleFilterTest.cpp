@@ -0,0 +1,194 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/Testing/UnitTestSupport.hpp"
+
+#include "IMFViewer/IMFGrayscaleFilter.h"
+
+namespace
+{
+// Values past the end of the converted pixels that no kernel may overwrite
+const uint8_t k_Guard = 0xA5;
+
+// Odd counts below, at and above the four and eight pixel widths of the vector kernels
+const std::vector<size_t> k_PixelCounts = {1, 3, 5, 7, 9, 15, 17, 31, 33, 1001};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<uint8_t> createPixels(size_t numComps, size_t count)
+{
+  std::mt19937 generator(static_cast<std::mt19937::result_type>(numComps * 7919 + count));
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> pixels(numComps * count);
+  for(uint8_t& value : pixels)
+  {
+    value = static_cast<uint8_t>(distribution(generator));
+  }
+
+  // Saturated pixels make sums that need clamping
+  if(count > 1)
+  {
+    std::fill(pixels.begin(), pixels.begin() + numComps, static_cast<uint8_t>(255));
+    std::fill(pixels.end() - numComps, pixels.end(), static_cast<uint8_t>(0));
+  }
+  return pixels;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+std::vector<uint8_t> convert(const std::vector<uint8_t>& pixels, size_t numComps, size_t count, const FloatVec3Type& weights, IMFGrayscaleFilter::Kernel kernel)
+{
+  std::vector<uint8_t> gray(count + 8, k_Guard);
+  IMFGrayscaleFilter::ConvertToLuminance(pixels.data(), numComps, count, weights, gray.data(), kernel);
+  return gray;
+}
+} // namespace
+
+class IMFGrayscaleFilterTest
+{
+public:
+  IMFGrayscaleFilterTest() = default;
+  ~IMFGrayscaleFilterTest() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestScalarKernel()
+  {
+    // Rounded to the nearest integer and clamped to 0-255
+    std::vector<uint8_t> pixels = {10, 20, 30, 255, 255, 255, 0, 0, 0};
+    std::vector<uint8_t> gray = convert(pixels, 3, 3, FloatVec3Type(0.5f, 0.25f, 0.25f), IMFGrayscaleFilter::Kernel::Scalar);
+    DREAM3D_REQUIRE_EQUAL(gray[0], 18)
+    DREAM3D_REQUIRE_EQUAL(gray[1], 255)
+    DREAM3D_REQUIRE_EQUAL(gray[2], 0)
+    DREAM3D_REQUIRE_EQUAL(gray[3], k_Guard)
+
+    gray = convert(pixels, 3, 3, FloatVec3Type(1.0f, 1.0f, 1.0f), IMFGrayscaleFilter::Kernel::Scalar);
+    DREAM3D_REQUIRE_EQUAL(gray[0], 60)
+    DREAM3D_REQUIRE_EQUAL(gray[1], 255)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int CompareKernel(IMFGrayscaleFilter::Kernel kernel)
+  {
+    if(!IMFGrayscaleFilter::IsKernelAvailable(kernel))
+    {
+      return EXIT_SUCCESS;
+    }
+
+    const std::vector<FloatVec3Type> weightings = {FloatVec3Type(0.2125f, 0.7154f, 0.0721f), FloatVec3Type(0.299f, 0.587f, 0.114f), FloatVec3Type(0.9f, 0.8f, 0.7f),
+                                                   FloatVec3Type(-0.5f, 1.25f, 0.5f)};
+    for(size_t numComps : {3, 4})
+    {
+      for(size_t count : k_PixelCounts)
+      {
+        std::vector<uint8_t> pixels = createPixels(numComps, count);
+        for(const FloatVec3Type& weights : weightings)
+        {
+          std::vector<uint8_t> expected = convert(pixels, numComps, count, weights, IMFGrayscaleFilter::Kernel::Scalar);
+          std::vector<uint8_t> actual = convert(pixels, numComps, count, weights, kernel);
+          DREAM3D_REQUIRE(actual == expected)
+        }
+      }
+    }
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestSse2Kernel()
+  {
+    return CompareKernel(IMFGrayscaleFilter::Kernel::SSE2);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestAvx2Kernel()
+  {
+    return CompareKernel(IMFGrayscaleFilter::Kernel::AVX2);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestAutomaticKernel()
+  {
+    return CompareKernel(IMFGrayscaleFilter::Kernel::Automatic);
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+
+    DREAM3D_REGISTER_TEST(TestScalarKernel())
+    DREAM3D_REGISTER_TEST(TestSse2Kernel())
+    DREAM3D_REGISTER_TEST(TestAvx2Kernel())
+    DREAM3D_REGISTER_TEST(TestAutomaticKernel())
+  }
+
+private:
+  IMFGrayscaleFilterTest(const IMFGrayscaleFilterTest&); // Copy Constructor Not Implemented
+  void operator=(const IMFGrayscaleFilterTest&);         // Operator '=' Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  int err = EXIT_SUCCESS;
+  IMFGrayscaleFilterTest()();
+  PRINT_TEST_SUMMARY();
+  return err;
+}
@@ -0,0 +1,197 @@
+/* ============================================================================
+ * Copyright (c) 2009-2015 BlueQuartz Software, LLC
+ *
+ * Redistribution and use in source and binary forms, with or without modification,
+ * are permitted provided that the following conditions are met:
+ *
+ * Redistributions of source code must retain the above copyright notice, this
+ * list of conditions and the following disclaimer.
+ *
+ * Redistributions in binary form must reproduce the above copyright notice, this
+ * list of conditions and the following disclaimer in the documentation and/or
+ * other materials provided with the distribution.
+ *
+ * Neither the name of BlueQuartz Software, the US Air Force, nor the names of its
+ * contributors may be used to endorse or promote products derived from this software
+ * without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+ * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+ * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+ * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+ * USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * The code contained herein was partially funded by the followig contracts:
+ *    United States Air Force Prime Contract FA8650-07-D-5800
+ *    United States Air Force Prime Contract FA8650-10-D-5210
+ *    United States Prime Contract Navy N00173-07-C-2068
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ */
+
+
+
+#include <cstdlib>
+
+#include <QtCore/QCoreApplication>
+
+#include "SIMPLib/DataArrays/DataArray.hpp"
+#include "SIMPLib/DataContainers/AttributeMatrix.h"
+#include "SIMPLib/DataContainers/DataContainer.h"
+#include "SIMPLib/Geometry/ImageGeom.h"
+#include "SIMPLib/Testing/UnitTestSupport.hpp"
+
+#include "IMFViewer/IMFTileCache.h"
+
+namespace
+{
+const QString k_AttributeMatrixName("Cell Data");
+const QString k_DataArrayName("Image Data");
+const size_t k_Width = 5;
+const size_t k_Height = 3;
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+DataContainer::Pointer createTile(const QString& name)
+{
+  ImageGeom::Pointer imageGeom = ImageGeom::CreateGeometry(SIMPL::Geometry::ImageGeometry);
+  imageGeom->setDimensions(SizeVec3Type(k_Width, k_Height, 1));
+
+  std::vector<size_t> tDims = {k_Width, k_Height, 1};
+  AttributeMatrix::Pointer am = AttributeMatrix::New(tDims, k_AttributeMatrixName, AttributeMatrix::Type::Cell);
+  UInt8ArrayType::Pointer data = UInt8ArrayType::CreateArray(k_Width * k_Height, std::vector<size_t>(1, 3), k_DataArrayName, true);
+  for(size_t i = 0; i < data->getSize(); i++)
+  {
+    data->setValue(i, static_cast<uint8_t>(i));
+  }
+  am->addOrReplaceAttributeArray(data);
+
+  DataContainer::Pointer dc = DataContainer::New(name);
+  dc->setGeometry(imageGeom);
+  dc->addOrReplaceAttributeMatrix(am);
+  return dc;
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+UInt8ArrayType::Pointer tileData(const DataContainer::Pointer& dc)
+{
+  AttributeMatrix::Pointer am = dc->getAttributeMatrix(k_AttributeMatrixName);
+  return am ? am->getAttributeArrayAs<UInt8ArrayType>(k_DataArrayName) : UInt8ArrayType::NullPointer();
+}
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+bool hasOriginalValues(const UInt8ArrayType::Pointer& data)
+{
+  for(size_t i = 0; i < data->getSize(); i++)
+  {
+    if(data->getValue(i) != static_cast<uint8_t>(i))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+class IMFTileCacheTest
+{
+public:
+  IMFTileCacheTest() = default;
+  ~IMFTileCacheTest() = default;
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestModifyStoredTile()
+  {
+    IMFTileCache::Clear();
+    DataContainer::Pointer dc = createTile("Stored");
+    IMFTileCache::Store("StoredTile", dc);
+
+    // The decoded tile keeps being used after it was stored
+    tileData(dc)->setValue(0, 255);
+
+    DataContainer::Pointer cachedDC = IMFTileCache::Lookup("StoredTile");
+    DREAM3D_REQUIRE_VALID_POINTER(cachedDC.get())
+    UInt8ArrayType::Pointer cachedData = tileData(cachedDC);
+    DREAM3D_REQUIRE_VALID_POINTER(cachedData.get())
+    DREAM3D_REQUIRE(hasOriginalValues(cachedData))
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  int TestModifyLookedUpTile()
+  {
+    IMFTileCache::Clear();
+    IMFTileCache::Store("LookedUpTile", createTile("LookedUp"));
+
+    DataContainer::Pointer firstDC = IMFTileCache::Lookup("LookedUpTile");
+    DREAM3D_REQUIRE_VALID_POINTER(firstDC.get())
+    UInt8ArrayType::Pointer firstData = tileData(firstDC);
+    DREAM3D_REQUIRE_VALID_POINTER(firstData.get())
+
+    // Displayed tiles are written to in place, for example by the grayscale conversion
+    for(size_t i = 0; i < firstData->getSize(); i++)
+    {
+      firstData->setValue(i, 0);
+    }
+    firstDC->getGeometryAs<ImageGeom>()->setOrigin(FloatVec3Type(10.0f, 20.0f, 0.0f));
+
+    DataContainer::Pointer secondDC = IMFTileCache::Lookup("LookedUpTile");
+    DREAM3D_REQUIRE_VALID_POINTER(secondDC.get())
+    UInt8ArrayType::Pointer secondData = tileData(secondDC);
+    DREAM3D_REQUIRE_VALID_POINTER(secondData.get())
+    DREAM3D_REQUIRE(secondData.get() != firstData.get())
+    DREAM3D_REQUIRE(secondData->getPointer(0) != firstData->getPointer(0))
+    DREAM3D_REQUIRE(hasOriginalValues(secondData))
+
+    FloatVec3Type origin = secondDC->getGeometryAs<ImageGeom>()->getOrigin();
+    DREAM3D_REQUIRE_EQUAL(origin[0], 0.0f)
+    DREAM3D_REQUIRE_EQUAL(origin[1], 0.0f)
+    return EXIT_SUCCESS;
+  }
+
+  // -----------------------------------------------------------------------------
+  //
+  // -----------------------------------------------------------------------------
+  void operator()()
+  {
+    int err = EXIT_SUCCESS;
+
+    IMFTileCache::SetEnabled(true);
+    IMFTileCache::SetDiskSpillEnabled(false);
+
+    DREAM3D_REGISTER_TEST(TestModifyStoredTile())
+    DREAM3D_REGISTER_TEST(TestModifyLookedUpTile())
+
+    IMFTileCache::Clear();
+  }
+
+private:
+  IMFTileCacheTest(const IMFTileCacheTest&); // Copy Constructor Not Implemented
+  void operator=(const IMFTileCacheTest&);   // Operator '=' Not Implemented
+};
+
+// -----------------------------------------------------------------------------
+//
+// -----------------------------------------------------------------------------
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+
+  int err = EXIT_SUCCESS;
+  IMFTileCacheTest()();
+  PRINT_TEST_SUMMARY();
+  return err;
+}